@@ -25,15 +25,16 @@ namespace Chroma
   public:
     //! Use only a SimpleFermBC with a boundary flag and a Q
     SimpleFermState(const multi1d<int>& boundary, const Q& q_) : 
-      fbc(new SimpleFermBC<T,P,Q>(boundary)), q(q_)
+      fbc(new SimpleFermBC<T,P,Q>(boundary)), q(q_), link_compress(LINK_COMPRESS_NONE)
       {
 	// Apply the BC
 	fbc->modify(q);
       }
 
     //! Full constructor
-    SimpleFermState(Handle< FermBC<T,P,Q> > fbc_, const Q& q_) : 
-      fbc(fbc_), q(q_) 
+    SimpleFermState(Handle< FermBC<T,P,Q> > fbc_, const Q& q_,
+		    LinkCompressType link_compress_ = LINK_COMPRESS_NONE) : 
+      fbc(fbc_), q(q_), link_compress(link_compress_)
       {
 	// Apply the BC
 	fbc->modify(q);
@@ -51,6 +52,9 @@ namespace Chroma
     //! Return the ferm BC object for this state
     Handle< FermBC<T,P,Q> > getFermBC() const {return fbc;}
 
+    //! Storage the linops should use for the links
+    LinkCompressType getLinkCompression() const {return link_compress;}
+
   private:
     SimpleFermState() {}  // hide default constructur
     void operator=(const SimpleFermState&) {} // hide =
@@ -58,6 +62,7 @@ namespace Chroma
   private:
     Handle< FermBC<T,P,Q> >  fbc;
     Q q;
+    LinkCompressType link_compress;
   };
 
 
@@ -73,10 +78,12 @@ namespace Chroma
   public:
     //! Use only a SimpleFermBC with a boundary flag
     CreateSimpleFermState(const multi1d<int>& boundary) : 
-      fbc(new SimpleFermBC<T,P,Q>(boundary)) {}
+      fbc(new SimpleFermBC<T,P,Q>(boundary)), link_compress(LINK_COMPRESS_NONE) {}
 
     //! Full constructor
-    CreateSimpleFermState(Handle< FermBC<T,P,Q> > fbc_) : fbc(fbc_) {}
+    CreateSimpleFermState(Handle< FermBC<T,P,Q> > fbc_,
+			  LinkCompressType link_compress_ = LINK_COMPRESS_NONE) : 
+      fbc(fbc_), link_compress(link_compress_) {}
 
     //! Destructor
     ~CreateSimpleFermState() {}
@@ -84,7 +91,7 @@ namespace Chroma
     //! Construct a ConnectState
     SimpleFermState<T,P,Q>* operator()(const Q& q) const
       {
-	return new SimpleFermState<T,P,Q>(fbc, q);
+	return new SimpleFermState<T,P,Q>(fbc, q, link_compress);
       }
 
     //! Return the ferm BC object for this state
@@ -99,6 +106,7 @@ namespace Chroma
 
   private:
     Handle< FermBC<T,P,Q> >  fbc;
+    LinkCompressType link_compress;
   };
 
 }
@@ -2,6 +2,7 @@
  *  \brief Simple ferm state and a creator
  */
 
+#include "chroma_config.h"
 #include "actions/ferm/fermstates/simple_fermstate.h"
 #include "actions/ferm/fermstates/simple_fermstate_w.h"
 #include "actions/ferm/fermstates/ferm_createstate_factory_w.h"
@@ -19,10 +20,29 @@ namespace Chroma
 		    multi1d<LatticeColorMatrix> >* createFerm(XMLReader& xml, 
 							      const std::string& path) 
     {
+      // Optional storage of the links in the linops
+      LinkCompressType link_compress = LINK_COMPRESS_NONE;
+      if (xml.count(path + "/LinkCompression") != 0)
+      {
+	XMLReader paramtop(xml, path);
+	read(paramtop, "LinkCompression", link_compress);
+      }
+
+#if defined(BUILD_SSE_WILSON_DSLASH) || defined(BUILD_CPP_WILSON_DSLASH) || defined(BUILD_PAB_WILSON_DSLASH) || defined(BUILD_LLVM_WILSON_DSLASH)
+      // Only the QDP Wilson dslash holds compressed links. An optimised
+      // WilsonDslash (and the clover term in any build) keeps full links.
+      if (link_compress != LINK_COMPRESS_NONE)
+      {
+	QDPIO::cout << "SIMPLE_FERM_STATE: WARNING: LinkCompression is only honoured by the QDP Wilson dslash."
+		    << " This build uses an optimised WilsonDslash, which ignores it" << std::endl;
+      }
+#endif
+
       return new CreateSimpleFermState<LatticeFermion,
 	                               multi1d<LatticeColorMatrix>, 
 	                               multi1d<LatticeColorMatrix> >(WilsonTypeFermBCEnv::reader(xml, 
-												 path));
+												 path),
+								     link_compress);
     }
 
     const std::string name = "SIMPLE_FERM_STATE";
@@ -16,6 +16,7 @@ namespace Chroma
     n_smear = 0;
     rho = sm_fact = zero;
     smear_in_this_dirP = true;
+    cache_force = false;
   }
 
 
@@ -34,6 +35,10 @@ namespace Chroma
       read(paramtop, "rho", sm_fact);
       read(paramtop, "n_smear", n_smear);
 
+      cache_force = false;
+      if( paramtop.count("CacheForce") == 1 )
+	read(paramtop, "CacheForce", cache_force);
+
       switch (version) 
       {
       case 1:
@@ -134,6 +139,7 @@ namespace Chroma
     write(xml, "rho", p.sm_fact);
     write(xml, "n_smear", p.n_smear);
     write(xml, "smear_in_this_dirP", p.smear_in_this_dirP);
+    write(xml, "CacheForce", p.cache_force);
     pop(xml);
   }
 
@@ -23,6 +23,7 @@ namespace Chroma
 
     int            n_smear;
     Real           sm_fact;
+    bool           cache_force;   /*!< keep per level Q, C and the f and b coefficients for the force (default false) */
   };
 
   void read(XMLReader& xml, const std::string& path, StoutFermStateParams& p);
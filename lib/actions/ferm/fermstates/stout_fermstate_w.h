@@ -89,7 +89,13 @@ namespace Chroma
       
       for(int level=params.n_smear; level > 0; level--) {
 	
-	Stouting::deriv_recurse(F_thin, params.smear_in_this_dirP, params.rho, smeared_links[level-1]);
+	if( params.cache_force ) {
+	  Stouting::deriv_recurse(F_thin, params.smear_in_this_dirP, params.rho, smeared_links[level-1],
+				  level_cache[level-1]);
+	}
+	else {
+	  Stouting::deriv_recurse(F_thin, params.smear_in_this_dirP, params.rho, smeared_links[level-1]);
+	}
 	
 	fbc->zero(F_thin);
 	
@@ -150,6 +156,10 @@ namespace Chroma
       }
       
       
+      // Smearing quantities reused by the force, one entry per smeared level.
+      // The state is rebuilt for every new thin field, so they can never go stale
+      level_cache.resize(params.cache_force ? params.n_smear : 0);
+      
       // Copy thin links into smeared_links[0]
       for(int mu=0; mu < Nd; mu++) { 
 	(smeared_links[0])[mu] = u_[mu];
@@ -162,7 +172,13 @@ namespace Chroma
       // Iterate up the smearings
       for(int i=1; i <= params.n_smear; i++) {
 	
-	Stouting::smear_links(smeared_links[i-1], smeared_links[i], params.smear_in_this_dirP, params.rho);
+	if( params.cache_force ) {
+	  Stouting::smear_links(smeared_links[i-1], smeared_links[i], params.smear_in_this_dirP, params.rho,
+				level_cache[i-1]);
+	}
+	else {
+	  Stouting::smear_links(smeared_links[i-1], smeared_links[i], params.smear_in_this_dirP, params.rho);
+	}
 	if( fbc->nontrivialP() ) {
 	  fbc->modify( smeared_links[i] );    
 	}
@@ -185,6 +201,9 @@ namespace Chroma
     // smeared_links[0] are the thin links smeared_links[params.n_smear] 
     // are the smeared links.
     multi1d< Q > smeared_links;
+
+    // level_cache[i] holds what smearing level i into level i+1 computed
+    multi1d< Stouting::StoutLevelCache > level_cache;
     Q fat_links_with_bc;
     
     
@@ -0,0 +1,525 @@
+/*! \file
+ *  \brief Fused BLAS-1 kernels for the Krylov solvers
+ *
+ *  Site loop versions on LatticeFermionF/D. The instruction set the
+ *  loops are compiled for is chosen with
+ *
+ *    --enable-fused-blas1-kernels=generic|sse|avx2|avx512
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/blas1_kernels.h"
+
+#if defined(BUILD_FUSED_BLAS1) && !defined(QDP_IS_QDPJIT)
+
+#include <vector>
+
+#if defined(BUILD_FUSED_BLAS1_AVX512)
+#define CHROMA_BLAS1_TARGET __attribute__((target("avx512f,avx2,fma")))
+#elif defined(BUILD_FUSED_BLAS1_AVX2)
+#define CHROMA_BLAS1_TARGET __attribute__((target("avx2,fma")))
+#elif defined(BUILD_FUSED_BLAS1_SSE)
+#define CHROMA_BLAS1_TARGET __attribute__((target("sse3")))
+#else
+#define CHROMA_BLAS1_TARGET
+#endif
+
+namespace Chroma
+{
+  namespace Blas1Kernels
+  {
+    namespace Fused
+    {
+      namespace
+      {
+	//! Complex numbers in one site of a fermion
+	const int ncomplex = Ns*Nc;
+
+	//! Start of the (contiguous) spin-colour data of a site
+	template<typename T>
+	inline typename WordType<T>::Type_t* sitePtr(T& x, int site)
+	{
+	  return &(x.elem(site).elem(0).elem(0).real());
+	}
+
+	template<typename T>
+	inline const typename WordType<T>::Type_t* sitePtr(const T& x, int site)
+	{
+	  return &(x.elem(site).elem(0).elem(0).real());
+	}
+
+	//! Sum the per thread partial reductions, then globally
+	void reduce(std::vector<REAL64>& sums, int n, REAL64* g)
+	{
+	  for(int k=0; k < n; ++k)
+	    g[k] = 0;
+
+	  for(int i=0; i < qdpNumThreads(); ++i)
+	    for(int k=0; k < n; ++k)
+	      g[k] += sums[n*i+k];
+
+	  QDPInternal::globalSumArray(g, n);
+	}
+
+
+	//----------------------------------------------------------------
+	// y += a x ;  |y|^2
+	template<typename T>
+	struct AxpyNorm2Args
+	{
+	  T& y;
+	  const T& x;
+	  Coeff a;
+	  const int* tab;
+	  REAL64* sums;
+	};
+
+	template<typename T>
+	CHROMA_BLAS1_TARGET
+	void axpyNorm2SiteLoop(int lo, int hi, int myId, AxpyNorm2Args<T>* arg)
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+	  const REALT ar = arg->a.re;
+	  const REALT ai = arg->a.im;
+	  REAL64 nrm = 0;
+
+	  for(int j=lo; j < hi; ++j)
+	  {
+	    int site = arg->tab[j];
+	    REALT* y = sitePtr(arg->y, site);
+	    const REALT* x = sitePtr(arg->x, site);
+
+	    for(int k=0; k < ncomplex; ++k)
+	    {
+	      REALT yr = y[2*k]   + ar*x[2*k]   - ai*x[2*k+1];
+	      REALT yi = y[2*k+1] + ar*x[2*k+1] + ai*x[2*k];
+	      y[2*k]   = yr;
+	      y[2*k+1] = yi;
+	      nrm += REAL64(yr)*REAL64(yr) + REAL64(yi)*REAL64(yi);
+	    }
+	  }
+
+	  arg->sums[myId] = nrm;
+	}
+
+	template<typename T>
+	Double axpyNorm2T(T& y, const Coeff& a, const T& x, const Subset& s)
+	{
+	  std::vector<REAL64> sums(qdpNumThreads(), REAL64(0));
+	  AxpyNorm2Args<T> arg = {y, x, a, s.siteTable().slice(), &sums[0]};
+	  dispatch_to_threads(s.numSiteTable(), arg, axpyNorm2SiteLoop<T>);
+
+	  REAL64 g;
+	  reduce(sums, 1, &g);
+	  return Double(g);
+	}
+
+
+	//----------------------------------------------------------------
+	// y = a x + b y ;  optionally |y|^2
+	template<typename T>
+	struct AxpbyArgs
+	{
+	  T& y;
+	  const T& x;
+	  Coeff a;
+	  Coeff b;
+	  const int* tab;
+	  REAL64* sums;
+	};
+
+	template<typename T>
+	CHROMA_BLAS1_TARGET
+	void axpbySiteLoop(int lo, int hi, int myId, AxpbyArgs<T>* arg)
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+	  const REALT ar = arg->a.re;
+	  const REALT ai = arg->a.im;
+	  const REALT br = arg->b.re;
+	  const REALT bi = arg->b.im;
+	  REAL64 nrm = 0;
+
+	  for(int j=lo; j < hi; ++j)
+	  {
+	    int site = arg->tab[j];
+	    REALT* y = sitePtr(arg->y, site);
+	    const REALT* x = sitePtr(arg->x, site);
+
+	    for(int k=0; k < ncomplex; ++k)
+	    {
+	      REALT yr = ar*x[2*k]   - ai*x[2*k+1] + br*y[2*k]   - bi*y[2*k+1];
+	      REALT yi = ar*x[2*k+1] + ai*x[2*k]   + br*y[2*k+1] + bi*y[2*k];
+	      y[2*k]   = yr;
+	      y[2*k+1] = yi;
+	      nrm += REAL64(yr)*REAL64(yr) + REAL64(yi)*REAL64(yi);
+	    }
+	  }
+
+	  arg->sums[myId] = nrm;
+	}
+
+	template<typename T>
+	Double axpbyT(T& y, const Coeff& a, const T& x, const Coeff& b, bool do_norm, const Subset& s)
+	{
+	  std::vector<REAL64> sums(qdpNumThreads(), REAL64(0));
+	  AxpbyArgs<T> arg = {y, x, a, b, s.siteTable().slice(), &sums[0]};
+	  dispatch_to_threads(s.numSiteTable(), arg, axpbySiteLoop<T>);
+
+	  // No reduction (and no global sum) unless asked for
+	  REAL64 g = 0;
+	  if (do_norm)
+	    reduce(sums, 1, &g);
+	  return Double(g);
+	}
+
+
+	//----------------------------------------------------------------
+	// x += a p ;  r += b q ;  |r|^2
+	template<typename T>
+	struct AxpyAxpyNorm2Args
+	{
+	  T& x;
+	  const T& p;
+	  T& r;
+	  const T& q;
+	  Coeff a;
+	  Coeff b;
+	  const int* tab;
+	  REAL64* sums;
+	};
+
+	template<typename T>
+	CHROMA_BLAS1_TARGET
+	void axpyAxpyNorm2SiteLoop(int lo, int hi, int myId, AxpyAxpyNorm2Args<T>* arg)
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+	  const REALT ar = arg->a.re;
+	  const REALT ai = arg->a.im;
+	  const REALT br = arg->b.re;
+	  const REALT bi = arg->b.im;
+	  REAL64 nrm = 0;
+
+	  for(int j=lo; j < hi; ++j)
+	  {
+	    int site = arg->tab[j];
+	    REALT* x = sitePtr(arg->x, site);
+	    REALT* r = sitePtr(arg->r, site);
+	    const REALT* p = sitePtr(arg->p, site);
+	    const REALT* q = sitePtr(arg->q, site);
+
+	    for(int k=0; k < ncomplex; ++k)
+	    {
+	      x[2*k]   += ar*p[2*k]   - ai*p[2*k+1];
+	      x[2*k+1] += ar*p[2*k+1] + ai*p[2*k];
+
+	      REALT rr = r[2*k]   + br*q[2*k]   - bi*q[2*k+1];
+	      REALT ri = r[2*k+1] + br*q[2*k+1] + bi*q[2*k];
+	      r[2*k]   = rr;
+	      r[2*k+1] = ri;
+	      nrm += REAL64(rr)*REAL64(rr) + REAL64(ri)*REAL64(ri);
+	    }
+	  }
+
+	  arg->sums[myId] = nrm;
+	}
+
+	template<typename T>
+	Double axpyAxpyNorm2T(T& x, const Coeff& a, const T& p,
+			      T& r, const Coeff& b, const T& q,
+			      const Subset& s)
+	{
+	  std::vector<REAL64> sums(qdpNumThreads(), REAL64(0));
+	  AxpyAxpyNorm2Args<T> arg = {x, p, r, q, a, b, s.siteTable().slice(), &sums[0]};
+	  dispatch_to_threads(s.numSiteTable(), arg, axpyAxpyNorm2SiteLoop<T>);
+
+	  REAL64 g;
+	  reduce(sums, 1, &g);
+	  return Double(g);
+	}
+
+
+	//----------------------------------------------------------------
+	// |x|^2 ,  <x,y>
+	template<typename T>
+	struct Norm2DotArgs
+	{
+	  const T& x;
+	  const T& y;
+	  const int* tab;
+	  REAL64* sums;       /*!< 3 per thread */
+	};
+
+	template<typename T>
+	CHROMA_BLAS1_TARGET
+	void norm2DotSiteLoop(int lo, int hi, int myId, Norm2DotArgs<T>* arg)
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+	  REAL64 xx = 0;
+	  REAL64 dr = 0;
+	  REAL64 di = 0;
+
+	  for(int j=lo; j < hi; ++j)
+	  {
+	    int site = arg->tab[j];
+	    const REALT* x = sitePtr(arg->x, site);
+	    const REALT* y = sitePtr(arg->y, site);
+
+	    for(int k=0; k < ncomplex; ++k)
+	    {
+	      REAL64 xr = x[2*k];
+	      REAL64 xi = x[2*k+1];
+	      REAL64 yr = y[2*k];
+	      REAL64 yi = y[2*k+1];
+	      xx += xr*xr + xi*xi;
+	      dr += xr*yr + xi*yi;
+	      di += xr*yi - xi*yr;
+	    }
+	  }
+
+	  arg->sums[3*myId]   = xx;
+	  arg->sums[3*myId+1] = dr;
+	  arg->sums[3*myId+2] = di;
+	}
+
+	template<typename T>
+	void norm2DotT(const T& x, const T& y, Double& xx, DComplex& xy, const Subset& s)
+	{
+	  std::vector<REAL64> sums(3*qdpNumThreads(), REAL64(0));
+	  Norm2DotArgs<T> arg = {x, y, s.siteTable().slice(), &sums[0]};
+	  dispatch_to_threads(s.numSiteTable(), arg, norm2DotSiteLoop<T>);
+
+	  REAL64 g[3];
+	  reduce(sums, 3, g);
+	  xx = Double(g[0]);
+	  xy = cmplx(Double(g[1]), Double(g[2]));
+	}
+
+
+	//----------------------------------------------------------------
+	// y[i] = a[i] x + b[i] y[i]
+	template<typename T>
+	struct MultiAxpbyArgs
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+
+	  std::vector<REALT*> y;
+	  std::vector<Coeff> a;
+	  std::vector<Coeff> b;
+	  const T& x;
+	  const int* tab;
+	};
+
+	template<typename T>
+	CHROMA_BLAS1_TARGET
+	void multiAxpbySiteLoop(int lo, int hi, int myId, MultiAxpbyArgs<T>* arg)
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+	  const int n = arg->y.size();
+
+	  for(int j=lo; j < hi; ++j)
+	  {
+	    int site = arg->tab[j];
+	    const REALT* x = sitePtr(arg->x, site);
+	    const int off = site * 2 * ncomplex;
+
+	    // x stays in cache while all the shifts are updated
+	    for(int i=0; i < n; ++i)
+	    {
+	      const REALT ar = arg->a[i].re;
+	      const REALT ai = arg->a[i].im;
+	      const REALT br = arg->b[i].re;
+	      const REALT bi = arg->b[i].im;
+	      REALT* y = arg->y[i] + off;
+
+	      for(int k=0; k < ncomplex; ++k)
+	      {
+		REALT yr = ar*x[2*k]   - ai*x[2*k+1] + br*y[2*k]   - bi*y[2*k+1];
+		REALT yi = ar*x[2*k+1] + ai*x[2*k]   + br*y[2*k+1] + bi*y[2*k];
+		y[2*k]   = yr;
+		y[2*k+1] = yi;
+	      }
+	    }
+	  }
+	}
+
+	template<typename T>
+	void multiAxpbyT(multi1d<T>& y, const multi1d<Coeff>& a, const T& x,
+			 const multi1d<Coeff>& b, const multi1d<bool>& active, const Subset& s)
+	{
+	  MultiAxpbyArgs<T> arg = {std::vector<typename WordType<T>::Type_t*>(),
+				   std::vector<Coeff>(), std::vector<Coeff>(),
+				   x, s.siteTable().slice()};
+	  for(int i=0; i < active.size(); ++i)
+	  {
+	    if (! active[i])
+	      continue;
+
+	    arg.y.push_back(sitePtr(y[i], 0));
+	    arg.a.push_back(a[i]);
+	    arg.b.push_back(b[i]);
+	  }
+
+	  if (arg.y.size() > 0)
+	    dispatch_to_threads(s.numSiteTable(), arg, multiAxpbySiteLoop<T>);
+	}
+
+
+	//----------------------------------------------------------------
+	// y[i] += a[i] x[i]
+	template<typename T>
+	struct MultiAxpyArgs
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+
+	  std::vector<REALT*> y;
+	  std::vector<const REALT*> x;
+	  std::vector<Coeff> a;
+	  const int* tab;
+	};
+
+	template<typename T>
+	CHROMA_BLAS1_TARGET
+	void multiAxpySiteLoop(int lo, int hi, int myId, MultiAxpyArgs<T>* arg)
+	{
+	  typedef typename WordType<T>::Type_t REALT;
+	  const int n = arg->y.size();
+
+	  for(int j=lo; j < hi; ++j)
+	  {
+	    const int off = arg->tab[j] * 2 * ncomplex;
+
+	    for(int i=0; i < n; ++i)
+	    {
+	      const REALT ar = arg->a[i].re;
+	      const REALT ai = arg->a[i].im;
+	      REALT* y = arg->y[i] + off;
+	      const REALT* x = arg->x[i] + off;
+
+	      for(int k=0; k < ncomplex; ++k)
+	      {
+		REALT yr = y[2*k]   + ar*x[2*k]   - ai*x[2*k+1];
+		REALT yi = y[2*k+1] + ar*x[2*k+1] + ai*x[2*k];
+		y[2*k]   = yr;
+		y[2*k+1] = yi;
+	      }
+	    }
+	  }
+	}
+
+	template<typename T>
+	void multiAxpyT(multi1d<T>& y, const multi1d<Coeff>& a, const multi1d<T>& x,
+			const multi1d<bool>& active, const Subset& s)
+	{
+	  MultiAxpyArgs<T> arg;
+	  arg.tab = s.siteTable().slice();
+	  for(int i=0; i < active.size(); ++i)
+	  {
+	    if (! active[i])
+	      continue;
+
+	    arg.y.push_back(sitePtr(y[i], 0));
+	    arg.x.push_back(sitePtr(x[i], 0));
+	    arg.a.push_back(a[i]);
+	  }
+
+	  if (arg.y.size() > 0)
+	    dispatch_to_threads(s.numSiteTable(), arg, multiAxpySiteLoop<T>);
+	}
+
+      } // anonymous namespace
+
+
+      //
+      // Explicit versions
+      //
+      Double axpyNorm2(LatticeFermionF& y, const Coeff& a, const LatticeFermionF& x, const Subset& s)
+      {
+	return axpyNorm2T(y, a, x, s);
+      }
+
+      Double axpyNorm2(LatticeFermionD& y, const Coeff& a, const LatticeFermionD& x, const Subset& s)
+      {
+	return axpyNorm2T(y, a, x, s);
+      }
+
+      void xpay(LatticeFermionF& y, const LatticeFermionF& x, const Coeff& a, const Subset& s)
+      {
+	const Coeff one = {1, 0};
+	axpbyT(y, one, x, a, false, s);
+      }
+
+      void xpay(LatticeFermionD& y, const LatticeFermionD& x, const Coeff& a, const Subset& s)
+      {
+	const Coeff one = {1, 0};
+	axpbyT(y, one, x, a, false, s);
+      }
+
+      Double axpby(LatticeFermionF& y, const Coeff& a, const LatticeFermionF& x, const Coeff& b,
+		   bool do_norm, const Subset& s)
+      {
+	return axpbyT(y, a, x, b, do_norm, s);
+      }
+
+      Double axpby(LatticeFermionD& y, const Coeff& a, const LatticeFermionD& x, const Coeff& b,
+		   bool do_norm, const Subset& s)
+      {
+	return axpbyT(y, a, x, b, do_norm, s);
+      }
+
+      Double axpyAxpyNorm2(LatticeFermionF& x, const Coeff& a, const LatticeFermionF& p,
+			   LatticeFermionF& r, const Coeff& b, const LatticeFermionF& q,
+			   const Subset& s)
+      {
+	return axpyAxpyNorm2T(x, a, p, r, b, q, s);
+      }
+
+      Double axpyAxpyNorm2(LatticeFermionD& x, const Coeff& a, const LatticeFermionD& p,
+			   LatticeFermionD& r, const Coeff& b, const LatticeFermionD& q,
+			   const Subset& s)
+      {
+	return axpyAxpyNorm2T(x, a, p, r, b, q, s);
+      }
+
+      void norm2Dot(const LatticeFermionF& x, const LatticeFermionF& y, Double& xx, DComplex& xy,
+		    const Subset& s)
+      {
+	norm2DotT(x, y, xx, xy, s);
+      }
+
+      void norm2Dot(const LatticeFermionD& x, const LatticeFermionD& y, Double& xx, DComplex& xy,
+		    const Subset& s)
+      {
+	norm2DotT(x, y, xx, xy, s);
+      }
+
+      void multiAxpby(multi1d<LatticeFermionF>& y, const multi1d<Coeff>& a, const LatticeFermionF& x,
+		      const multi1d<Coeff>& b, const multi1d<bool>& active, const Subset& s)
+      {
+	multiAxpbyT(y, a, x, b, active, s);
+      }
+
+      void multiAxpby(multi1d<LatticeFermionD>& y, const multi1d<Coeff>& a, const LatticeFermionD& x,
+		      const multi1d<Coeff>& b, const multi1d<bool>& active, const Subset& s)
+      {
+	multiAxpbyT(y, a, x, b, active, s);
+      }
+
+      void multiAxpy(multi1d<LatticeFermionF>& y, const multi1d<Coeff>& a, const multi1d<LatticeFermionF>& x,
+		     const multi1d<bool>& active, const Subset& s)
+      {
+	multiAxpyT(y, a, x, active, s);
+      }
+
+      void multiAxpy(multi1d<LatticeFermionD>& y, const multi1d<Coeff>& a, const multi1d<LatticeFermionD>& x,
+		     const multi1d<bool>& active, const Subset& s)
+      {
+	multiAxpyT(y, a, x, active, s);
+      }
+
+    } // namespace Fused
+
+  } // namespace Blas1Kernels
+
+} // namespace Chroma
+
+#endif
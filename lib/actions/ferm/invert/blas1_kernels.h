@@ -0,0 +1,242 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Fused BLAS-1 kernels for the Krylov solvers
+ *
+ *  The generic versions are plain QDP expressions and work for any
+ *  vector type. If configured with --enable-fused-blas1-kernels the
+ *  LatticeFermionF/D versions run as a single threaded site loop, so that
+ *  every vector is read (and written) once per kernel and the reductions
+ *  are accumulated on the fly.
+ */
+
+#ifndef __blas1_kernels_h__
+#define __blas1_kernels_h__
+
+#include "chroma_config.h"
+#include "chromabase.h"
+
+namespace Chroma
+{
+
+  //! Fused BLAS-1 kernels
+  /*! \ingroup invert
+   *
+   * Coefficients may be real or complex. Reductions are returned in
+   * double precision and are global sums.
+   */
+  namespace Blas1Kernels
+  {
+    //! y += a x ;  return |y|^2
+    template<typename T, typename C>
+    inline
+    Double axpyNorm2(T& y, const C& a, const T& x, const Subset& s)
+    {
+      y[s] += a*x;
+      return norm2(y, s);
+    }
+
+    //! y = x + a y
+    template<typename T, typename C>
+    inline
+    void xpay(T& y, const T& x, const C& a, const Subset& s)
+    {
+      y[s] = x + a*y;
+    }
+
+    //! y = a x + b y
+    template<typename T, typename C>
+    inline
+    void axpby(T& y, const C& a, const T& x, const C& b, const Subset& s)
+    {
+      y[s] = a*x + b*y;
+    }
+
+    //! y = a x + b y ;  return |y|^2
+    template<typename T, typename C>
+    inline
+    Double axpbyNorm2(T& y, const C& a, const T& x, const C& b, const Subset& s)
+    {
+      y[s] = a*x + b*y;
+      return norm2(y, s);
+    }
+
+    //! x += a p ;  r += b q ;  return |r|^2
+    template<typename T, typename C>
+    inline
+    Double axpyAxpyNorm2(T& x, const C& a, const T& p,
+			 T& r, const C& b, const T& q,
+			 const Subset& s)
+    {
+      x[s] += a*p;
+      r[s] += b*q;
+      return norm2(r, s);
+    }
+
+    //! |x|^2  and  <x,y>  in one pass
+    template<typename T>
+    inline
+    void norm2Dot(const T& x, const T& y, Double& xx, DComplex& xy, const Subset& s)
+    {
+      xx = norm2(x, s);
+      xy = innerProduct(x, y, s);
+    }
+
+    //! y[i] = a[i] x + b[i] y[i]  for all active i, reading x once
+    /*!
+     * Only the first active.size() entries of y are touched
+     */
+    template<typename T, typename C>
+    inline
+    void multiAxpby(multi1d<T>& y, const multi1d<C>& a, const T& x, const multi1d<C>& b,
+		    const multi1d<bool>& active, const Subset& s)
+    {
+      for(int i=0; i < active.size(); ++i)
+	if (active[i])
+	  y[i][s] = a[i]*x + b[i]*y[i];
+    }
+
+    //! y[i] += a[i] x[i]  for all active i
+    template<typename T, typename C>
+    inline
+    void multiAxpy(multi1d<T>& y, const multi1d<C>& a, const multi1d<T>& x,
+		   const multi1d<bool>& active, const Subset& s)
+    {
+      for(int i=0; i < active.size(); ++i)
+	if (active[i])
+	  y[i][s] += a[i]*x[i];
+    }
+
+
+#if defined(BUILD_FUSED_BLAS1) && !defined(QDP_IS_QDPJIT)
+    //! Site loop versions on LatticeFermionF/D
+    namespace Fused
+    {
+      //! A (possibly complex) coefficient
+      struct Coeff
+      {
+	REAL64 re;
+	REAL64 im;
+      };
+
+      template<typename W>
+      inline Coeff coeff(const OScalar< PScalar< PScalar< RScalar<W> > > >& a)
+      {
+	Coeff c = {REAL64(a.elem().elem().elem().elem()), 0};
+	return c;
+      }
+
+      template<typename W>
+      inline Coeff coeff(const OScalar< PScalar< PScalar< RComplex<W> > > >& a)
+      {
+	Coeff c = {REAL64(a.elem().elem().elem().real()), REAL64(a.elem().elem().elem().imag())};
+	return c;
+      }
+
+      template<typename C>
+      inline multi1d<Coeff> coeff(const multi1d<C>& a)
+      {
+	multi1d<Coeff> c(a.size());
+	for(int i=0; i < a.size(); ++i)
+	  c[i] = coeff(a[i]);
+	return c;
+      }
+
+      Double axpyNorm2(LatticeFermionF& y, const Coeff& a, const LatticeFermionF& x, const Subset& s);
+      Double axpyNorm2(LatticeFermionD& y, const Coeff& a, const LatticeFermionD& x, const Subset& s);
+
+      void xpay(LatticeFermionF& y, const LatticeFermionF& x, const Coeff& a, const Subset& s);
+      void xpay(LatticeFermionD& y, const LatticeFermionD& x, const Coeff& a, const Subset& s);
+
+      Double axpby(LatticeFermionF& y, const Coeff& a, const LatticeFermionF& x, const Coeff& b,
+		   bool do_norm, const Subset& s);
+      Double axpby(LatticeFermionD& y, const Coeff& a, const LatticeFermionD& x, const Coeff& b,
+		   bool do_norm, const Subset& s);
+
+      Double axpyAxpyNorm2(LatticeFermionF& x, const Coeff& a, const LatticeFermionF& p,
+			   LatticeFermionF& r, const Coeff& b, const LatticeFermionF& q,
+			   const Subset& s);
+      Double axpyAxpyNorm2(LatticeFermionD& x, const Coeff& a, const LatticeFermionD& p,
+			   LatticeFermionD& r, const Coeff& b, const LatticeFermionD& q,
+			   const Subset& s);
+
+      void norm2Dot(const LatticeFermionF& x, const LatticeFermionF& y, Double& xx, DComplex& xy,
+		    const Subset& s);
+      void norm2Dot(const LatticeFermionD& x, const LatticeFermionD& y, Double& xx, DComplex& xy,
+		    const Subset& s);
+
+      void multiAxpby(multi1d<LatticeFermionF>& y, const multi1d<Coeff>& a, const LatticeFermionF& x,
+		      const multi1d<Coeff>& b, const multi1d<bool>& active, const Subset& s);
+      void multiAxpby(multi1d<LatticeFermionD>& y, const multi1d<Coeff>& a, const LatticeFermionD& x,
+		      const multi1d<Coeff>& b, const multi1d<bool>& active, const Subset& s);
+
+      void multiAxpy(multi1d<LatticeFermionF>& y, const multi1d<Coeff>& a, const multi1d<LatticeFermionF>& x,
+		     const multi1d<bool>& active, const Subset& s);
+      void multiAxpy(multi1d<LatticeFermionD>& y, const multi1d<Coeff>& a, const multi1d<LatticeFermionD>& x,
+		     const multi1d<bool>& active, const Subset& s);
+    }
+
+    // The fermion overloads. These are more specialized than the
+    // generic templates above, so are picked for LatticeFermionF/D
+#define CHROMA_BLAS1_FUSED_OVERLOADS(T)					\
+    template<typename C>						\
+    inline Double axpyNorm2(T& y, const C& a, const T& x, const Subset& s) \
+    {									\
+      return Fused::axpyNorm2(y, Fused::coeff(a), x, s);		\
+    }									\
+									\
+    template<typename C>						\
+    inline void xpay(T& y, const T& x, const C& a, const Subset& s)	\
+    {									\
+      Fused::xpay(y, x, Fused::coeff(a), s);				\
+    }									\
+									\
+    template<typename C>						\
+    inline void axpby(T& y, const C& a, const T& x, const C& b, const Subset& s) \
+    {									\
+      Fused::axpby(y, Fused::coeff(a), x, Fused::coeff(b), false, s);	\
+    }									\
+									\
+    template<typename C>						\
+    inline Double axpbyNorm2(T& y, const C& a, const T& x, const C& b, const Subset& s) \
+    {									\
+      return Fused::axpby(y, Fused::coeff(a), x, Fused::coeff(b), true, s); \
+    }									\
+									\
+    template<typename C>						\
+    inline Double axpyAxpyNorm2(T& x, const C& a, const T& p,		\
+				T& r, const C& b, const T& q,		\
+				const Subset& s)			\
+    {									\
+      return Fused::axpyAxpyNorm2(x, Fused::coeff(a), p, r, Fused::coeff(b), q, s); \
+    }									\
+									\
+    inline void norm2Dot(const T& x, const T& y, Double& xx, DComplex& xy, const Subset& s) \
+    {									\
+      Fused::norm2Dot(x, y, xx, xy, s);					\
+    }									\
+									\
+    template<typename C>						\
+    inline void multiAxpby(multi1d<T>& y, const multi1d<C>& a, const T& x, const multi1d<C>& b, \
+			   const multi1d<bool>& active, const Subset& s) \
+    {									\
+      Fused::multiAxpby(y, Fused::coeff(a), x, Fused::coeff(b), active, s); \
+    }									\
+									\
+    template<typename C>						\
+    inline void multiAxpy(multi1d<T>& y, const multi1d<C>& a, const multi1d<T>& x, \
+			  const multi1d<bool>& active, const Subset& s)	\
+    {									\
+      Fused::multiAxpy(y, Fused::coeff(a), x, active, s);		\
+    }
+
+    CHROMA_BLAS1_FUSED_OVERLOADS(LatticeFermionF)
+    CHROMA_BLAS1_FUSED_OVERLOADS(LatticeFermionD)
+
+#undef CHROMA_BLAS1_FUSED_OVERLOADS
+#endif
+
+  } // namespace Blas1Kernels
+
+} // namespace Chroma
+
+#endif
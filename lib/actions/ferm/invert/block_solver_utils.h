@@ -0,0 +1,62 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Bookkeeping helpers for multiple right hand side solvers
+ */
+
+#ifndef __block_solver_utils_h__
+#define __block_solver_utils_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+  namespace BlockSolverUtils
+  {
+    //! Keep only the selected entries of a block
+    /*!
+     * \ingroup invert
+     *
+     * After the call  v[j] = v_old[keep[j]]  and  v.size() == keep.size().
+     * Used to drop converged systems out of the active block so the
+     * block operator is not applied to them any more.
+     *
+     * \param v      block of vectors or scalars ( Modify )
+     * \param keep   indices (into v) of the entries to keep, in order ( Read )
+     */
+    template<typename T>
+    inline
+    void compact(multi1d<T>& v, const multi1d<int>& keep)
+    {
+      multi1d<T> tmp(keep.size());
+      for(int j=0; j < keep.size(); ++j)
+	tmp[j] = v[keep[j]];
+
+      v.resize(keep.size());
+      for(int j=0; j < keep.size(); ++j)
+	v[j] = tmp[j];
+    }
+
+
+    //! Shorten a block, keeping its leading entries
+    /*!
+     * \ingroup invert
+     *
+     * \param v      block ( Modify )
+     * \param n      new length, n <= v.size() ( Read )
+     */
+    template<typename T>
+    inline
+    void truncate(multi1d<T>& v, int n)
+    {
+      multi1d<int> keep(n);
+      for(int j=0; j < n; ++j)
+	keep[j] = j;
+
+      compact(v, keep);
+    }
+
+  } // namespace BlockSolverUtils
+
+} // namespace Chroma
+
+#endif
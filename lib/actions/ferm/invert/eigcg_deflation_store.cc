@@ -0,0 +1,107 @@
+/*! \file
+ *  \brief Disk backed store of EigCG deflation vectors
+ */
+
+#include <qdp-lapack.h>
+#include "actions/ferm/invert/eigcg_deflation_store.h"
+#include "actions/ferm/invert/inv_eigcg2.h"
+
+namespace Chroma
+{
+  //----------------------------------------------------------------------------
+  // KeyEigCGDeflation read
+  void read(BinaryReader& bin, KeyEigCGDeflation_t& param)
+  {
+    read(bin, param.space_id, 256);
+    read(bin, param.config_id, 256);
+    read(bin, param.index);
+  }
+
+  // KeyEigCGDeflation write
+  void write(BinaryWriter& bin, const KeyEigCGDeflation_t& param)
+  {
+    write(bin, param.space_id);
+    write(bin, param.config_id);
+    write(bin, param.index);
+  }
+
+  // KeyEigCGDeflation reader
+  void read(XMLReader& xml, const std::string& path, KeyEigCGDeflation_t& param)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "space_id", param.space_id);
+    read(paramtop, "config_id", param.config_id);
+    read(paramtop, "index", param.index);
+  }
+
+  // KeyEigCGDeflation writer
+  void write(XMLWriter& xml, const std::string& path, const KeyEigCGDeflation_t& param)
+  {
+    push(xml, path);
+
+    write(xml, "space_id", param.space_id);
+    write(xml, "config_id", param.config_id);
+    write(xml, "index", param.index);
+
+    pop(xml);
+  }
+
+
+  namespace
+  {
+    //! Rotate the pairs into Ritz pairs
+    template<typename T>
+    void rayleighRitz(LinAlg::RitzPairs<T>& rp, const LinearOperator<T>& MdagM)
+    {
+      START_CODE();
+
+      const int n = rp.Neig;
+      if (n == 0)
+      {
+	END_CODE();
+	return;
+      }
+
+      const Subset& s = MdagM.subset();
+
+      // Same refinement as after an EigCG solve, on the whole basis
+      LinAlg::Matrix<DComplex> Htmp(n);
+      InvEigCG2Env::SubSpaceMatrix(Htmp, MdagM, rp.evec.vec, n);
+
+      multi1d<Double> lambda;
+      char V = 'V' ; char U = 'U' ;
+      QDPLapack::zheev(V, U, Htmp.mat, lambda);
+
+      multi1d<T> evec(n);
+      for(int k=0; k < n; ++k)
+      {
+	rp.eval[k] = lambda[k];
+	evec[k][s] = zero;
+	for(int j=0; j < n; ++j)
+	  evec[k][s] += conj(Htmp(k,j))*rp.evec[j];
+      }
+
+      for(int k=0; k < n; ++k)
+	rp.evec[k][s] = evec[k];
+
+      END_CODE();
+    }
+  }
+
+
+  // Rotate the pairs into Ritz pairs
+  void eigCGRayleighRitz(LinAlg::RitzPairs<LatticeFermionF>& rp, 
+			 const LinearOperator<LatticeFermionF>& MdagM)
+  {
+    rayleighRitz(rp, MdagM);
+  }
+
+  // Rotate the pairs into Ritz pairs
+  void eigCGRayleighRitz(LinAlg::RitzPairs<LatticeFermionD>& rp, 
+			 const LinearOperator<LatticeFermionD>& MdagM)
+  {
+    rayleighRitz(rp, MdagM);
+  }
+
+} // namespace Chroma
@@ -0,0 +1,245 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Disk backed store of EigCG deflation vectors
+ */
+
+#ifndef __eigcg_deflation_store_h__
+#define __eigcg_deflation_store_h__
+
+#include "chromabase.h"
+#include "linearop.h"
+#include "qdp_map_obj_disk.h"
+#include "actions/ferm/invert/containers.h"
+
+namespace Chroma
+{
+
+  //----------------------------------------------------------------------------
+  //! Key of one stored Ritz pair
+  /*! \ingroup invert */
+  struct KeyEigCGDeflation_t
+  {
+    std::string  space_id;     /*!< User label of the operator, e.g. action and mass */
+    std::string  config_id;    /*!< Fingerprint of the gauge configuration */
+    int          index;        /*!< Index of the Ritz pair */
+  };
+
+  //! Value of one stored basis vector
+  /*! \ingroup invert
+   *
+   * The eigenvalue is the estimate when the vector was written. The
+   * stored vectors are an orthonormal basis of the deflation space,
+   * not its current Ritz vectors.
+   */
+  template<typename T>
+  struct EigCGRitzPair_t
+  {
+    Double  eval;
+    T       evec;
+  };
+
+
+  /*!
+   * \ingroup invert
+   * @{
+   */
+  //! KeyEigCGDeflation read
+  void read(BinaryReader& bin, KeyEigCGDeflation_t& param);
+
+  //! KeyEigCGDeflation write
+  void write(BinaryWriter& bin, const KeyEigCGDeflation_t& param);
+
+  //! KeyEigCGDeflation reader
+  void read(XMLReader& xml, const std::string& path, KeyEigCGDeflation_t& param);
+
+  //! KeyEigCGDeflation writer
+  void write(XMLWriter& xml, const std::string& path, const KeyEigCGDeflation_t& param);
+
+  //! EigCGRitzPair read
+  template<typename T>
+  void read(BinaryReader& bin, EigCGRitzPair_t<T>& param)
+  {
+    read(bin, param.eval);
+    read(bin, param.evec);
+  }
+
+  //! EigCGRitzPair write
+  template<typename T>
+  void write(BinaryWriter& bin, const EigCGRitzPair_t<T>& param)
+  {
+    write(bin, param.eval);
+    write(bin, param.evec);
+  }
+
+  //! Rotate the pairs of rp into the Ritz pairs of MdagM on their span
+  void eigCGRayleighRitz(LinAlg::RitzPairs<LatticeFermionF>& rp, 
+			 const LinearOperator<LatticeFermionF>& MdagM);
+
+  //! Rotate the pairs of rp into the Ritz pairs of MdagM on their span
+  void eigCGRayleighRitz(LinAlg::RitzPairs<LatticeFermionD>& rp, 
+			 const LinearOperator<LatticeFermionD>& MdagM);
+  /*! @} */  // end of group invert
+
+
+  //----------------------------------------------------------------------------
+  //! Disk backed store of EigCG Ritz pairs
+  /*! \ingroup invert
+   *
+   * The basis of one deflation space (one operator on one gauge
+   * configuration) is kept in a MapObjectDisk file under the key
+   * (space_id, config_id, index). The file may hold several spaces; it is
+   * opened once and appended to as the space grows, and flushed after each
+   * write, so that a restarted job or a later measurement can load the
+   * vectors and skip the EigCG warm-up solves.
+   *
+   * The refinement of EigCG rotates the whole basis each time it grows,
+   * but not its span. So only the new, orthonormalised vectors are
+   * written, before the rotation, and after a load the Ritz pairs are
+   * recovered with eigCGRayleighRitz.
+   */
+  template<typename T>
+  class EigCGDeflationStore
+  {
+  public:
+    //! Open (or create) the store
+    /*!
+     * \param file_name   the MapObjectDisk file ( Read )
+     * \param space_id    label of the operator ( Read )
+     * \param config_id   fingerprint of the gauge configuration ( Read )
+     */
+    EigCGDeflationStore(const std::string& file_name,
+			const std::string& space_id,
+			const std::string& config_id);
+
+    //! Number of Ritz pairs of this space on disk
+    int size() const {return n_stored;}
+
+    //! Add the stored Ritz pairs to rp, as many as fit. Returns the number added
+    int load(LinAlg::RitzPairs<T>& rp, const Subset& s);
+
+    //! Append the new basis vectors first .. rp.Neig-1 of rp
+    /*!
+     * Call after the new vectors are orthonormalised against the old ones,
+     * before the basis is rotated. If the vectors before first are not
+     * the ones on disk (the space was not loaded from this store) all
+     * rp.Neig vectors are written instead.
+     */
+    void append(const LinAlg::RitzPairs<T>& rp, int first);
+
+  private:
+    KeyEigCGDeflation_t key(int i) const
+    {
+      KeyEigCGDeflation_t k;
+      k.space_id  = space_id;
+      k.config_id = config_id;
+      k.index     = i;
+      return k;
+    }
+
+    std::string space_id;
+    std::string config_id;
+    int n_stored;
+    QDP::MapObjectDisk< KeyEigCGDeflation_t, EigCGRitzPair_t<T> > db;
+  };
+
+
+  // Open the store
+  template<typename T>
+  EigCGDeflationStore<T>::EigCGDeflationStore(const std::string& file_name,
+					       const std::string& space_id_,
+					       const std::string& config_id_)
+    : space_id(space_id_), config_id(config_id_), n_stored(0)
+  {
+    START_CODE();
+
+    db.setDebug(0);
+
+    if (! db.fileExists(file_name))
+    {
+      XMLBufferWriter file_xml;
+
+      push(file_xml, "MODMetaData");
+      write(file_xml, "id", std::string("eigCGDeflation"));
+      write(file_xml, "lattSize", QDP::Layout::lattSize());
+      proginfo(file_xml);    // Print out basic program info
+      pop(file_xml);
+
+      db.insertUserdata(file_xml.str());
+      db.open(file_name, std::ios_base::in | std::ios_base::out | std::ios_base::trunc);
+    }
+    else
+    {
+      db.open(file_name);
+    }
+
+    // Count the pairs of this space
+    while (db.exist(key(n_stored)))
+      ++n_stored;
+
+    QDPIO::cout << "EigCGDeflationStore: " << file_name
+		<< "  space_id= " << space_id << "  config_id= " << config_id
+		<< "  stored pairs= " << n_stored << std::endl;
+
+    END_CODE();
+  }
+
+
+  // Read the stored pairs
+  template<typename T>
+  int EigCGDeflationStore<T>::load(LinAlg::RitzPairs<T>& rp, const Subset& s)
+  {
+    START_CODE();
+
+    int n = 0;
+    for(int i=0; i < n_stored && rp.Neig < rp.evec.vec.size(); ++i)
+    {
+      EigCGRitzPair_t<T> pair;
+      db.get(key(i), pair);
+      rp.AddVector(pair.eval, pair.evec, s);
+      ++n;
+    }
+
+    QDPIO::cout << "EigCGDeflationStore: loaded " << n << " Ritz pairs" << std::endl;
+
+    END_CODE();
+    return n;
+  }
+
+
+  // Write the new vectors
+  template<typename T>
+  void EigCGDeflationStore<T>::append(const LinAlg::RitzPairs<T>& rp, int first)
+  {
+    START_CODE();
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    if (first != n_stored)
+    {
+      QDPIO::cout << "EigCGDeflationStore: space does not extend the stored one, rewriting it" << std::endl;
+      first = 0;
+    }
+
+    for(int i=first; i < rp.Neig; ++i)
+    {
+      EigCGRitzPair_t<T> pair;
+      pair.eval = rp.eval[i];
+      pair.evec = rp.evec[i];
+      db.insert(key(i), pair);
+    }
+    db.flush();
+
+    n_stored = std::max(n_stored, rp.Neig);
+
+    swatch.stop();
+    QDPIO::cout << "EigCGDeflationStore: wrote " << rp.Neig - first << " vectors: time = "
+		<< swatch.getTimeInSeconds() << " secs" << std::endl;
+
+    END_CODE();
+  }
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,230 @@
+/*! \file
+ *  \brief 16 bit fixed point storage of single precision fermions
+ */
+
+#include "actions/ferm/invert/fixed16_fermion.h"
+
+namespace Chroma 
+{
+
+  namespace 
+  {
+#ifndef QDP_IS_QDPJIT
+    //! Site of a fermion into a flat array
+    inline void loadSite(REAL32* v, const LatticeFermionF& x, int site)
+    {
+      int i = 0;
+      for(int s=0; s < Ns; ++s)
+	for(int c=0; c < Nc; ++c)
+	{
+	  v[i++] = x.elem(site).elem(s).elem(c).real();
+	  v[i++] = x.elem(site).elem(s).elem(c).imag();
+	}
+    }
+
+    //! Flat array into a site of a fermion
+    inline void storeSite(LatticeFermionF& x, int site, const REAL32* v)
+    {
+      int i = 0;
+      for(int s=0; s < Ns; ++s)
+	for(int c=0; c < Nc; ++c)
+	{
+	  x.elem(site).elem(s).elem(c).real() = v[i++];
+	  x.elem(site).elem(s).elem(c).imag() = v[i++];
+	}
+    }
+
+
+    struct PackArgs
+    {
+      Fixed16Fermion& f;
+      const LatticeFermionF& x;
+      const int* tab;
+    };
+
+    void packSiteLoop(int lo, int hi, int myId, PackArgs* a)
+    {
+      REAL32 v[Fixed16Fermion::NReal];
+      for(int j=lo; j < hi; ++j)
+      {
+	int site = a->tab[j];
+	loadSite(v, a->x, site);
+	a->f.setSite(site, v);
+      }
+    }
+
+
+    struct UnpackArgs
+    {
+      const Fixed16Fermion& f;
+      LatticeFermionF& x;
+      const int* tab;
+    };
+
+    void unpackSiteLoop(int lo, int hi, int myId, UnpackArgs* a)
+    {
+      REAL32 v[Fixed16Fermion::NReal];
+      for(int j=lo; j < hi; ++j)
+      {
+	int site = a->tab[j];
+	a->f.getSite(v, site);
+	storeSite(a->x, site, v);
+      }
+    }
+
+
+    struct XpayArgs
+    {
+      LatticeFermionF& p;
+      const Fixed16Fermion& r;
+      REAL32 b;
+      const int* tab;
+    };
+
+    void xpaySiteLoop(int lo, int hi, int myId, XpayArgs* a)
+    {
+      REAL32 vr[Fixed16Fermion::NReal];
+      REAL32 vp[Fixed16Fermion::NReal];
+      for(int j=lo; j < hi; ++j)
+      {
+	int site = a->tab[j];
+	a->r.getSite(vr, site);
+	loadSite(vp, a->p, site);
+	for(int i=0; i < Fixed16Fermion::NReal; ++i)
+	  vp[i] = vr[i] + a->b * vp[i];
+	storeSite(a->p, site, vp);
+      }
+    }
+
+
+    struct CGUpdateArgs
+    {
+      LatticeFermionF& x;
+      Fixed16Fermion& r;
+      const LatticeFermionF& p;
+      const LatticeFermionF& mmp;
+      REAL32 a;
+      const int* tab;
+      REAL64* norms;    /*!< one per thread */
+    };
+
+    void cgUpdateSiteLoop(int lo, int hi, int myId, CGUpdateArgs* a)
+    {
+      REAL32 vx[Fixed16Fermion::NReal];
+      REAL32 vr[Fixed16Fermion::NReal];
+      REAL32 vp[Fixed16Fermion::NReal];
+      REAL32 vm[Fixed16Fermion::NReal];
+      REAL64 nrm = 0;
+
+      for(int j=lo; j < hi; ++j)
+      {
+	int site = a->tab[j];
+	loadSite(vx, a->x, site);
+	a->r.getSite(vr, site);
+	loadSite(vp, a->p, site);
+	loadSite(vm, a->mmp, site);
+
+	for(int i=0; i < Fixed16Fermion::NReal; ++i)
+	{
+	  vx[i] += a->a * vp[i];
+	  vr[i] -= a->a * vm[i];
+	}
+
+	storeSite(a->x, site, vx);
+	a->r.setSite(site, vr);
+
+	// Norm of the stored (rounded) residual
+	a->r.getSite(vr, site);
+	for(int i=0; i < Fixed16Fermion::NReal; ++i)
+	  nrm += REAL64(vr[i])*REAL64(vr[i]);
+      }
+
+      a->norms[myId] = nrm;
+    }
+#endif
+
+    //! Stop if the storage can not be used
+    inline void checkAvailable()
+    {
+#ifdef QDP_IS_QDPJIT
+      QDPIO::cerr << "Fixed16Fermion: not available with QDPJIT" << std::endl;
+      QDP_abort(1);
+#endif
+    }
+  }
+
+
+  // Storage for the node
+  Fixed16Fermion::Fixed16Fermion() :
+    data(Layout::sitesOnNode()*NReal, short(0)), norm(Layout::sitesOnNode(), REAL32(0))
+  {
+    checkAvailable();
+  }
+
+
+  // x = 0
+  void Fixed16Fermion::zero(const Subset& s)
+  {
+    const int* tab = s.siteTable().slice();
+    for(int j=0; j < s.numSiteTable(); ++j)
+    {
+      int site = tab[j];
+      norm[site] = 0;
+      for(int i=0; i < NReal; ++i)
+	data[site*NReal + i] = 0;
+    }
+  }
+
+
+  // Store x
+  void Fixed16Fermion::pack(const LatticeFermionF& x, const Subset& s)
+  {
+#ifndef QDP_IS_QDPJIT
+    PackArgs a = {*this, x, s.siteTable().slice()};
+    dispatch_to_threads(s.numSiteTable(), a, packSiteLoop);
+#endif
+  }
+
+
+  // Retrieve x
+  void Fixed16Fermion::unpack(LatticeFermionF& x, const Subset& s) const
+  {
+#ifndef QDP_IS_QDPJIT
+    UnpackArgs a = {*this, x, s.siteTable().slice()};
+    dispatch_to_threads(s.numSiteTable(), a, unpackSiteLoop);
+#endif
+  }
+
+
+  namespace Fixed16Kernels
+  {
+    // p = r + b * p
+    void xpay(LatticeFermionF& p, const Fixed16Fermion& r, const RealF& b, const Subset& s)
+    {
+#ifndef QDP_IS_QDPJIT
+      XpayArgs a = {p, r, toFloat(b), s.siteTable().slice()};
+      dispatch_to_threads(s.numSiteTable(), a, xpaySiteLoop);
+#endif
+    }
+
+    // x += a p ;  r -= a mmp ;  r_sq = | r |^2
+    void cgUpdate(LatticeFermionF& x, Fixed16Fermion& r,
+		  const LatticeFermionF& p, const LatticeFermionF& mmp,
+		  const RealF& a, Double& r_sq, const Subset& s)
+    {
+#ifndef QDP_IS_QDPJIT
+      std::vector<REAL64> norms(qdpNumThreads(), REAL64(0));
+      CGUpdateArgs arg = {x, r, p, mmp, toFloat(a), s.siteTable().slice(), &norms[0]};
+      dispatch_to_threads(s.numSiteTable(), arg, cgUpdateSiteLoop);
+
+      REAL64 nrm = 0;
+      for(int i=0; i < norms.size(); ++i)
+	nrm += norms[i];
+
+      QDPInternal::globalSum(nrm);
+      r_sq = Double(nrm);
+#endif
+    }
+  }
+
+}
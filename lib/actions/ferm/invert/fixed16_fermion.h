@@ -0,0 +1,98 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief 16 bit fixed point storage of single precision fermions
+ */
+
+#ifndef __fixed16_fermion_h__
+#define __fixed16_fermion_h__
+
+#include "chromabase.h"
+#include <vector>
+#include <cmath>
+
+namespace Chroma 
+{
+
+  //! 16 bit fixed point storage of a LatticeFermionF
+  /*! \ingroup invert
+   *
+   * Each site holds one float norm (the largest modulus of its real
+   * components) and the Ns*Nc*2 components as int16 relative to it,
+   * so a site costs 4 + 2*Ns*Nc*2 bytes instead of 4*Ns*Nc*2.
+   * The relative precision per site is about 3e-5, enough for the
+   * inner iterations of a solver with reliable updates.
+   *
+   * Not available with QDPJIT.
+   */
+  class Fixed16Fermion
+  {
+  public:
+    //! Number of reals per site
+    static const int NReal = Ns*Nc*2;
+
+    //! Storage for all the sites on the node, set to zero
+    Fixed16Fermion();
+
+    //! x = 0 on subset s
+    void zero(const Subset& s);
+
+    //! Store x on subset s
+    void pack(const LatticeFermionF& x, const Subset& s);
+
+    //! x = stored vector on subset s
+    void unpack(LatticeFermionF& x, const Subset& s) const;
+
+    //! Bytes used
+    size_t bytes() const {return data.size()*sizeof(short) + norm.size()*sizeof(REAL32);}
+
+    //! Read site: v[0 .. NReal-1]
+    inline void getSite(REAL32* v, int site) const
+    {
+      const short* d = &data[site*NReal];
+      const REAL32 sc = norm[site] * (REAL32(1)/REAL32(32767));
+      for(int i=0; i < NReal; ++i)
+	v[i] = sc * REAL32(d[i]);
+    }
+
+    //! Write site: v[0 .. NReal-1]
+    inline void setSite(int site, const REAL32* v)
+    {
+      REAL32 m = 0;
+      for(int i=0; i < NReal; ++i)
+      {
+	REAL32 a = fabs(v[i]);
+	if (a > m) m = a;
+      }
+
+      norm[site] = m;
+      short* d = &data[site*NReal];
+      const REAL32 isc = (m > 0) ? REAL32(32767)/m : REAL32(0);
+      for(int i=0; i < NReal; ++i)
+	d[i] = short(lrintf(isc * v[i]));
+    }
+
+  private:
+    std::vector<short>  data;   /*!< NReal int16 per site */
+    std::vector<REAL32> norm;   /*!< one norm per site */
+  };
+
+
+  //! Fused kernels of the fixed point CG
+  /*! \ingroup invert */
+  namespace Fixed16Kernels
+  {
+    //! p = r + b * p
+    void xpay(LatticeFermionF& p, const Fixed16Fermion& r, const RealF& b, const Subset& s);
+
+    //! x += a p ;  r -= a mmp ;  r_sq = | r |^2
+    /*! Only r is held in 16 bit. The partial solution x stays in single
+     *  precision: it accumulates every step, and rounding it to 16 bit
+     *  each time would cap the accuracy of the whole solve */
+    void cgUpdate(LatticeFermionF& x, Fixed16Fermion& r,
+		  const LatticeFermionF& p, const LatticeFermionF& mmp,
+		  const RealF& a, Double& r_sq, const Subset& s);
+  }
+
+}
+
+#endif
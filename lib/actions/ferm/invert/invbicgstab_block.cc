@@ -0,0 +1,251 @@
+/*! \file
+ *  \brief Multiple right hand side BiCGStab for a generic Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invbicgstab_block.h"
+#include "actions/ferm/invert/block_solver_utils.h"
+
+namespace Chroma 
+{
+
+  template<typename T, typename CR>
+  multi1d<SystemSolverResults_t>
+  InvBiCGStabBlock_a(const LinearOperator<T>& A,
+		     const multi1d<T>& chi,
+		     multi1d<T>& psi,
+		     const Real& RsdBiCGStab,
+		     int MaxBiCGStab, 
+		     enum PlusMinus isign)
+  {
+    START_CODE();
+
+    const Subset& s = A.subset();
+    const int N = chi.size();
+
+    multi1d<SystemSolverResults_t> ret(N);
+
+    if (psi.size() != N)
+    {
+      QDPIO::cerr << "InvBiCGStabBlock: number of solutions = " << psi.size()
+		  << " does not match number of sources = " << N << std::endl;
+      QDP_abort(1);
+    }
+
+    StopWatch swatch;
+    FlopCounter flopcount;
+    flopcount.reset();
+    swatch.reset();
+    swatch.start();
+
+    // Work vectors. Slot j of the active block solves source idx[j]
+    multi1d<int> idx(N);
+    multi1d<T> x(N);
+    multi1d<T> r(N);
+    multi1d<T> r0(N);
+    multi1d<T> p(N);
+    multi1d<T> v(N);
+    multi1d<T> t;
+    multi1d<Double> rsd_sq(N);
+    multi1d<Double> r_norm(N);
+    multi1d<ComplexD> rho_prev(N);
+    multi1d<ComplexD> alpha(N);
+    multi1d<ComplexD> omega(N);
+
+    for(int i=0; i < N; ++i)
+    {
+      idx[i] = i;
+      x[i][s] = psi[i];
+    }
+
+    // r = r0 = chi - A psi. Use r0 as a temporary for A psi
+    A.applyBlock(r0, x, isign);
+    flopcount.addFlops(N*A.nFlops());
+
+    for(int i=0; i < N; ++i)
+    {
+      Double chi_sq = norm2(chi[i],s);
+      rsd_sq[i] = RsdBiCGStab*RsdBiCGStab*chi_sq;
+
+      r[i][s] = chi[i] - r0[i];
+      r0[i][s] = r[i];
+      r_norm[i] = norm2(r[i],s);
+
+      // v = p = 0
+      p[i][s] = zero;
+      v[i][s] = zero;
+
+      // rho_0 := alpha := omega = 1
+      rho_prev[i] = Double(1);
+      alpha[i] = Double(1);
+      omega[i] = Double(1);
+
+      ret[i].n_count = 0;
+      ret[i].resid = sqrt(r_norm[i]);
+    }
+    flopcount.addSiteFlops(N*10*Nc*Ns,s);
+
+    int k = 0;
+    for(;;)
+    {
+      // Retire the systems which have converged
+      {
+	int n_keep = 0;
+	multi1d<int> keep(idx.size());
+	for(int j=0; j < idx.size(); ++j)
+	{
+	  if ( toBool(r_norm[j] < rsd_sq[j]) || k == MaxBiCGStab )
+	  {
+	    psi[idx[j]][s] = x[j];
+	    ret[idx[j]].n_count = k;
+	    ret[idx[j]].resid   = sqrt(r_norm[j]);
+	  }
+	  else
+	  {
+	    keep[n_keep++] = j;
+	  }
+	}
+
+	if (n_keep == 0)
+	  break;
+
+	if (n_keep < idx.size())
+	{
+	  BlockSolverUtils::truncate(keep, n_keep);
+
+	  BlockSolverUtils::compact(idx, keep);
+	  BlockSolverUtils::compact(x, keep);
+	  BlockSolverUtils::compact(r, keep);
+	  BlockSolverUtils::compact(r0, keep);
+	  BlockSolverUtils::compact(p, keep);
+	  BlockSolverUtils::compact(v, keep);
+	  BlockSolverUtils::compact(rsd_sq, keep);
+	  BlockSolverUtils::compact(r_norm, keep);
+	  BlockSolverUtils::compact(rho_prev, keep);
+	  BlockSolverUtils::compact(alpha, keep);
+	  BlockSolverUtils::compact(omega, keep);
+	}
+      }
+
+      ++k;
+      const int n_act = idx.size();
+
+      multi1d<ComplexD> rho(n_act);
+      for(int j=0; j < n_act; ++j)
+      {
+	// rho_{k+1} = < r_0 | r >
+	rho[j] = innerProduct(r0[j],r[j],s);
+
+	if( toBool( real(rho[j]) == 0 ) && toBool( imag(rho[j]) == 0 ) ) {
+	  QDPIO::cout << "BiCGStabBlock breakdown: rho = 0 in rhs = " << idx[j] << std::endl;
+	  QDP_abort(1);
+	}
+
+	// beta = ( rho_{k+1}/rho_{k})(alpha/omega)
+	ComplexD beta;
+	beta = ( rho[j] / rho_prev[j] ) * (alpha[j]/omega[j]);
+
+	// p = r + beta(p - omega v)
+	CR omega_r = omega[j];
+	CR beta_r = beta;
+	T tmp;
+	tmp[s] = p[j] - omega_r*v[j];
+	p[j][s] = r[j] + beta_r*tmp;
+      }
+
+      // v = Ap
+      A.applyBlock(v, p, isign);
+
+      for(int j=0; j < n_act; ++j)
+      {
+	// alpha = rho_{k+1} / < r_0 | v >
+	DComplex ctmp = innerProduct(r0[j],v[j],s);
+
+	if( toBool( real(ctmp) == 0 ) && toBool( imag(ctmp) == 0 ) ) {
+	  QDPIO::cout << "BiCGStabBlock breakdown: <r_0|v> = 0 in rhs = " << idx[j] << std::endl;
+	  QDP_abort(1);
+	}
+
+	alpha[j] = rho[j] / ctmp;
+	rho_prev[j] = rho[j];
+
+	// s = r - alpha v, overlapping s with r
+	CR alpha_r = alpha[j];
+	r[j][s]  -=  alpha_r*v[j];
+      }
+
+      // t = As = Ar
+      A.applyBlock(t, r, isign);
+
+      for(int j=0; j < n_act; ++j)
+      {
+	// omega = < t | s > / < t | t > = < t | r > / norm2(t);
+	Double t_norm = norm2(t[j],s);
+
+	if( toBool(t_norm == 0) ) { 
+	  QDPIO::cerr << "Breakdown || Ms || = || t || = 0 in rhs = " << idx[j] << std::endl;
+	  QDP_abort(1);
+	}
+
+	omega[j] = innerProduct(t[j],r[j],s);
+	omega[j] /= t_norm;
+
+	// psi = psi + omega s + alpha p = psi + omega r + alpha p
+	CR omega_r = omega[j];
+	CR alpha_r = alpha[j];
+	T tmp;
+	tmp[s] = x[j] + omega_r*r[j];
+	x[j][s] = tmp + alpha_r*p[j];
+
+	// r = s - omega t
+	r[j][s] -= omega_r*t[j];
+
+	r_norm[j] = norm2(r[j],s);
+      }
+
+      // Same count as InvBiCGStab: 80*Nc*Ns cbsite flops + 2*A per system
+      flopcount.addSiteFlops(n_act*80*Nc*Ns,s);
+      flopcount.addFlops(2*n_act*A.nFlops());
+    }
+  
+    swatch.stop();
+
+    for(int i=0; i < N; ++i)
+    {
+      QDPIO::cout << "InvBiCGStabBlock: rhs = " << i << " k = " << ret[i].n_count << " resid = " << ret[i].resid << std::endl;
+      if ( ret[i].n_count == MaxBiCGStab ) { 
+	QDPIO::cerr << "Nonconvergence of BiCGStabBlock in rhs = " << i << ". MaxIters reached " << std::endl;
+      }
+    }
+    flopcount.report("invbicgstab_block", swatch.getTimeInSeconds());
+
+    END_CODE();
+    return ret;
+  }
+
+
+  template<>
+  multi1d<SystemSolverResults_t>
+  InvBiCGStabBlock(const LinearOperator<LatticeFermionF>& A,
+		   const multi1d<LatticeFermionF>& chi,
+		   multi1d<LatticeFermionF>& psi,
+		   const Real& RsdBiCGStab, 
+		   int MaxBiCGStab, 
+		   enum PlusMinus isign)
+  {
+    return InvBiCGStabBlock_a<LatticeFermionF, ComplexF>(A, chi, psi, RsdBiCGStab, MaxBiCGStab, isign);
+  }
+
+  template<>
+  multi1d<SystemSolverResults_t>
+  InvBiCGStabBlock(const LinearOperator<LatticeFermionD>& A,
+		   const multi1d<LatticeFermionD>& chi,
+		   multi1d<LatticeFermionD>& psi,
+		   const Real& RsdBiCGStab, 
+		   int MaxBiCGStab, 
+		   enum PlusMinus isign)
+  {
+    return InvBiCGStabBlock_a<LatticeFermionD, ComplexD>(A, chi, psi, RsdBiCGStab, MaxBiCGStab, isign);
+  }
+
+}  // end namespace Chroma
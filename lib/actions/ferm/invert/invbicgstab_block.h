@@ -0,0 +1,42 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Multiple right hand side BiCGStab for a generic Linear Operator
+ */
+
+#ifndef __invbicgstab_block__
+#define __invbicgstab_block__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma 
+{
+
+  //! Multiple right hand side Bi-CG stabilized
+  /*! \ingroup invert
+   *
+   * Solves  A . Psi[i] = Chi[i]  for i = 0 .. N-1.
+   *
+   * Each right hand side carries its own BiCGStab recurrence exactly as in
+   * InvBiCGStab, but both operator applications of an iteration are done
+   * for all unconverged systems in one call of the block operator, so an 
+   * operator with a fused multi-vector apply streams its gauge field
+   * (and clover term) once per application instead of once per source.
+   * Systems drop out of the block as they converge.
+   *
+   * @{
+   */
+  template<typename T>
+  multi1d<SystemSolverResults_t>
+  InvBiCGStabBlock(const LinearOperator<T>& A,
+		   const multi1d<T>& chi,
+		   multi1d<T>& psi,
+		   const Real& RsdBiCGStab,
+		   int MaxBiCGStab,
+		   enum PlusMinus isign);
+
+  /*! @} */  // end of group invert
+	    
+}  // end namespace Chroma
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/invcg2.h"
+#include "actions/ferm/invert/blas1_kernels.h"
 
 using namespace QDP::Hints;
 #undef PAT
@@ -174,15 +175,11 @@ namespace Chroma
       a = c/d;
 
       RT ar = a;
+      RT mar = -ar;
 
-      r[s] -= ar * mmp;
-      flopcount.addSiteFlops(4*Nc*Ns, s);
-
-      //  cp  =  | r[k] |**2
-      cp = norm2(r, s);    flopcount.addSiteFlops(4*Nc*Ns,s);
-
-      //  Psi[k] += a[k] p[k]
-      psi[s] += ar * p;    flopcount.addSiteFlops(4*Nc*Ns,s);
+      //  r[k] -= a[k] A . p[k] ;  Psi[k] += a[k] p[k] ;  cp  =  | r[k] |**2
+      cp = Blas1Kernels::axpyAxpyNorm2(psi, ar, p, r, mar, mmp, s);
+      flopcount.addSiteFlops(12*Nc*Ns,s);
 
 
 
@@ -217,7 +214,7 @@ namespace Chroma
       RT br = b;
 
       //  p[k+1] := r[k] + b[k+1] p[k]
-      p[s] = r + br*p;    flopcount.addSiteFlops(4*Nc*Ns,s);
+      Blas1Kernels::xpay(p, r, br, s);    flopcount.addSiteFlops(4*Nc*Ns,s);
     }
     res.n_count = MaxCG;
     res.resid   = sqrt(cp);
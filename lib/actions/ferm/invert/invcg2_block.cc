@@ -0,0 +1,221 @@
+/*! \file
+ *  \brief Multiple right hand side Conjugate-Gradient for a generic Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invcg2_block.h"
+#include "actions/ferm/invert/block_solver_utils.h"
+
+namespace Chroma
+{
+
+  //! Multiple right hand side CGNE for a generic Linear Operator
+  /*! \ingroup invert
+   *
+   * The algorithm for each right hand side is that of InvCG2. The
+   * systems are advanced in lock-step and all the operator applications
+   * of one iteration go through a single call of the block operator.
+   *
+   * Local Variables (per active system j, belonging to source idx[j]):
+   *
+   *  x[j]   	 Solution std::vector
+   *  p[j]   	 Direction std::vector
+   *  r[j]   	 Residual std::vector
+   *  cp[j]  	 | r[k] |**2
+   *  mp, mmp    Temporaries for  M.p  and  M^dag.M.p
+   */
+  template<typename T, typename RT>
+  multi1d<SystemSolverResults_t>
+  InvCG2Block_a(const LinearOperator<T>& M,
+		const multi1d<T>& chi,
+		multi1d<T>& psi,
+		const Real& RsdCG,
+		int MaxCG)
+  {
+    START_CODE();
+
+    const Subset& s = M.subset();
+    const int N = chi.size();
+
+    multi1d<SystemSolverResults_t> res(N);
+
+    if (psi.size() != N)
+    {
+      QDPIO::cerr << "InvCG2Block: number of solutions = " << psi.size()
+		  << " does not match number of sources = " << N << std::endl;
+      QDP_abort(1);
+    }
+
+    QDPIO::cout << "InvCG2Block: starting with " << N << " right hand sides" << std::endl;
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    // Work vectors. Slot j of the active block solves source idx[j]
+    multi1d<int> idx(N);
+    multi1d<T> x(N);
+    multi1d<T> r(N);
+    multi1d<T> p(N);
+    multi1d<T> mp;
+    multi1d<T> mmp;
+    multi1d<Double> rsd_sq(N);
+    multi1d<Double> cp(N);
+
+    for(int i=0; i < N; ++i)
+    {
+      idx[i] = i;
+      x[i][s] = psi[i];
+    }
+
+    //  r[0]  :=  Chi - M^dag . M . Psi[0]
+    M.applyBlock(mp, x, PLUS);
+    M.applyBlock(mmp, mp, MINUS);
+    flopcount.addFlops(2*N*M.nFlops());
+
+    for(int i=0; i < N; ++i)
+    {
+      Double chi_sq = norm2(chi[i],s);
+      rsd_sq[i] = (RsdCG * RsdCG) * chi_sq;
+
+      r[i][s] = chi[i] - mmp[i];
+      cp[i] = norm2(r[i], s);
+
+      //  p[1]  :=  r[0]
+      p[i][s] = r[i];
+
+      res[i].n_count = 0;
+      res[i].resid   = sqrt(cp[i]);
+    }
+    flopcount.addSiteFlops(N*10*Nc*Ns,s);
+
+    int k = 0;
+    for(;;)
+    {
+      // Retire the systems which have converged
+      {
+	int n_keep = 0;
+	multi1d<int> keep(idx.size());
+	for(int j=0; j < idx.size(); ++j)
+	{
+	  if ( toBool(cp[j] <= rsd_sq[j]) || k == MaxCG )
+	  {
+	    psi[idx[j]][s] = x[j];
+	    res[idx[j]].n_count = k;
+	    res[idx[j]].resid   = sqrt(cp[j]);
+	  }
+	  else
+	  {
+	    keep[n_keep++] = j;
+	  }
+	}
+
+	if (n_keep == 0)
+	  break;
+
+	if (n_keep < idx.size())
+	{
+	  BlockSolverUtils::truncate(keep, n_keep);
+
+	  BlockSolverUtils::compact(idx, keep);
+	  BlockSolverUtils::compact(x, keep);
+	  BlockSolverUtils::compact(r, keep);
+	  BlockSolverUtils::compact(p, keep);
+	  BlockSolverUtils::compact(rsd_sq, keep);
+	  BlockSolverUtils::compact(cp, keep);
+	}
+      }
+
+      ++k;
+      const int n_act = idx.size();
+
+      //  Mp = M(u) * p  and  M^dag . M . p  for the whole block
+      M.applyBlock(mp, p, PLUS);
+      M.applyBlock(mmp, mp, MINUS);
+      flopcount.addFlops(2*n_act*M.nFlops());
+
+      for(int j=0; j < n_act; ++j)
+      {
+	//  c  =  | r[k-1] |**2
+	Double c = cp[j];
+
+	//  d = | mp | ** 2
+	Double d = norm2(mp[j], s);
+
+	//  a[k] := | r[k-1] |**2 / < Mp[k], Mp[k] > ;
+	Double a = c/d;
+	RT ar = a;
+
+	//  r[k] -= a[k] A . p[k] ;
+	r[j][s] -= ar * mmp[j];
+
+	//  cp  =  | r[k] |**2
+	cp[j] = norm2(r[j], s);
+
+	//  Psi[k] += a[k] p[k]
+	x[j][s] += ar * p[j];
+
+	//  b[k+1] := |r[k]|**2 / |r[k-1]|**2
+	//  p[k+1] := r[k] + b[k+1] p[k]
+	Double b = cp[j] / c;
+	RT br = b;
+	p[j][s] = r[j] + br*p[j];
+      }
+      flopcount.addSiteFlops(n_act*20*Nc*Ns,s);
+    }
+
+    swatch.stop();
+    flopcount.report("invcg2_block", swatch.getTimeInSeconds());
+
+    // Compute the actual residuals
+    {
+      multi1d<T> tmp1;
+      multi1d<T> tmp2;
+      M.applyBlock(tmp1, psi, PLUS);
+      M.applyBlock(tmp2, tmp1, MINUS);
+
+      for(int i=0; i < N; ++i)
+      {
+	res[i].resid = sqrt(norm2(chi[i] - tmp2[i], s));
+
+	if (res[i].n_count == MaxCG)
+	{
+	  QDPIO::cerr << "Nonconvergence Warning" << std::endl;
+	  QDPIO::cerr << "too many CG iterations in rhs = " << i
+		      << ": count =" << res[i].n_count << " rsd = " << res[i].resid << std::endl;
+	}
+      }
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  InvCG2Block(const LinearOperator<LatticeFermionF>& M,
+	      const multi1d<LatticeFermionF>& chi,
+	      multi1d<LatticeFermionF>& psi,
+	      const Real& RsdCG,
+	      int MaxCG)
+  {
+    return InvCG2Block_a<LatticeFermionF,RealF>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  InvCG2Block(const LinearOperator<LatticeFermionD>& M,
+	      const multi1d<LatticeFermionD>& chi,
+	      multi1d<LatticeFermionD>& psi,
+	      const Real& RsdCG,
+	      int MaxCG)
+  {
+    return InvCG2Block_a<LatticeFermionD,RealD>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+}  // end namespace Chroma
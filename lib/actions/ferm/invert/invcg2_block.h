@@ -0,0 +1,63 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Multiple right hand side Conjugate-Gradient for a generic Linear Operator
+ */
+
+#ifndef __invcg2_block__
+#define __invcg2_block__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma
+{
+
+  //! Multiple right hand side CGNE for a generic Linear Operator
+  /*! \ingroup invert
+   * Solves the set of linear equations
+   *
+   *   	    Chi[i]  =  M^dag . M . Psi[i]      i = 0 .. N-1
+   *
+   * Each right hand side carries its own CG recurrence exactly as in InvCG2,
+   * but the operator is applied to all the search directions of the still
+   * unconverged systems in one call of the block operator
+   *
+   *     M.applyBlock(multi1d<T>& chi, const multi1d<T>& psi, isign)
+   *
+   * so that an operator providing a fused multi-vector apply reads the
+   * gauge field (and clover term) once per iteration, rather than once
+   * per right hand side. Systems drop out of the block as they converge.
+   *
+   * Arguments:
+   *
+   *  \param M       Linear Operator    	       (Read)
+   *  \param chi     Sources	               (Read)
+   *  \param psi     Solutions    	    	       (Modify)
+   *  \param RsdCG   CG residual accuracy        (Read)
+   *  \param MaxCG   Maximum CG iterations       (Read)
+   *  \return res    System solver results, one per right hand side
+   *
+   * @{
+   */
+
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  InvCG2Block(const LinearOperator<LatticeFermionF>& M,
+	      const multi1d<LatticeFermionF>& chi,
+	      multi1d<LatticeFermionF>& psi,
+	      const Real& RsdCG,
+	      int MaxCG);
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  InvCG2Block(const LinearOperator<LatticeFermionD>& M,
+	      const multi1d<LatticeFermionD>& chi,
+	      multi1d<LatticeFermionD>& psi,
+	      const Real& RsdCG,
+	      int MaxCG);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
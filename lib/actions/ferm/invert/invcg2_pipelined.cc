@@ -0,0 +1,264 @@
+/*! \file
+ *  \brief Pipelined Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invcg2_pipelined.h"
+
+namespace Chroma 
+{
+
+  namespace 
+  {
+#ifndef QDP_IS_QDPJIT
+    //! Vectors and coefficients of one pipelined CG update
+    template<typename T>
+    struct PipeUpdateArgs
+    {
+      T& x;  T& r;  T& w;  T& p;  T& s;  T& z;
+      const T& n;
+      typename WordType<T>::Type_t a;
+      typename WordType<T>::Type_t b;
+      const int* tab;
+      REAL64* sums;       /*!< 2 per thread */
+    };
+
+    //! The six updates and the local parts of <r,r> and <w,r>
+    template<typename T>
+    void pipeUpdateSiteLoop(int lo, int hi, int myId, PipeUpdateArgs<T>* arg)
+    {
+      typedef typename WordType<T>::Type_t REALT;
+      const REALT a = arg->a;
+      const REALT b = arg->b;
+      REAL64 rr = 0;
+      REAL64 wr = 0;
+
+      for(int j=lo; j < hi; ++j)
+      {
+	int site = arg->tab[j];
+	for(int sp=0; sp < Ns; ++sp)
+	  for(int c=0; c < Nc; ++c)
+	  {
+	    REALT* x = &(arg->x.elem(site).elem(sp).elem(c).real());
+	    REALT* r = &(arg->r.elem(site).elem(sp).elem(c).real());
+	    REALT* w = &(arg->w.elem(site).elem(sp).elem(c).real());
+	    REALT* p = &(arg->p.elem(site).elem(sp).elem(c).real());
+	    REALT* s = &(arg->s.elem(site).elem(sp).elem(c).real());
+	    REALT* z = &(arg->z.elem(site).elem(sp).elem(c).real());
+	    const REALT* n = &(arg->n.elem(site).elem(sp).elem(c).real());
+
+	    // real and imaginary parts are adjacent
+	    for(int k=0; k < 2; ++k)
+	    {
+	      z[k] = n[k] + b*z[k];
+	      s[k] = w[k] + b*s[k];
+	      p[k] = r[k] + b*p[k];
+	      x[k] += a*p[k];
+	      r[k] -= a*s[k];
+	      w[k] -= a*z[k];
+
+	      rr += REAL64(r[k])*REAL64(r[k]);
+	      wr += REAL64(w[k])*REAL64(r[k]);
+	    }
+	  }
+      }
+
+      arg->sums[2*myId]   = rr;
+      arg->sums[2*myId+1] = wr;
+    }
+#endif
+
+
+    //! One pipelined CG update, returning  gamma = <r,r>  and  delta = Re <w,r>
+    template<typename T, typename RT>
+    void pipeUpdate(T& x, T& r, T& w, T& p, T& s, T& z, const T& n,
+		    const Double& a, const Double& b,
+		    Double& gamma, Double& delta, const Subset& sub)
+    {
+#ifndef QDP_IS_QDPJIT
+      std::vector<REAL64> sums(2*qdpNumThreads(), REAL64(0));
+      PipeUpdateArgs<T> arg = {x, r, w, p, s, z, n, toDouble(a), toDouble(b), 
+			       sub.siteTable().slice(), &sums[0]};
+      dispatch_to_threads(sub.numSiteTable(), arg, pipeUpdateSiteLoop<T>);
+
+      REAL64 g[2] = {0, 0};
+      for(int i=0; i < qdpNumThreads(); ++i)
+      {
+	g[0] += sums[2*i];
+	g[1] += sums[2*i+1];
+      }
+
+      // The single global reduction of the iteration
+      QDPInternal::globalSumArray(g, 2);
+      gamma = Double(g[0]);
+      delta = Double(g[1]);
+#else
+      RT ar = a;
+      RT br = b;
+      z[sub] = n + br*z;
+      s[sub] = w + br*s;
+      p[sub] = r + br*p;
+      x[sub] += ar*p;
+      r[sub] -= ar*s;
+      w[sub] -= ar*z;
+      gamma = norm2(r, sub);
+      delta = innerProductReal(w, r, sub);
+#endif
+    }
+  }
+
+
+  //! Pipelined CGNE
+  template<typename T, typename RT>
+  SystemSolverResults_t 
+  InvCG2Pipelined_a(const LinearOperator<T>& M,
+		    const T& chi,
+		    T& psi,
+		    const Real& RsdCG, 
+		    int MaxCG)
+  {
+    START_CODE();
+
+    const Subset& sub = M.subset();
+    SystemSolverResults_t res;
+
+    QDPIO::cout << "InvCG2Pipelined: starting" << std::endl;
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    T r, w, p, s, z, n, tmp;
+
+    Double chi_sq = norm2(chi, sub);
+    Double rsd_sq = (RsdCG * RsdCG) * chi_sq;
+
+    Double gamma, delta, gamma_old, a, a_old, b;
+    int restarts = 0;
+    int k = 0;
+    bool restart = true;
+
+    for(;;)
+    {
+      if (restart)
+      {
+	//  r := Chi - A Psi ;  w := A r 
+	M(tmp, psi, PLUS);
+	M(n, tmp, MINUS);
+	r[sub] = chi - n;
+
+	M(tmp, r, PLUS);
+	M(w, tmp, MINUS);
+	flopcount.addFlops(4*M.nFlops());
+	flopcount.addSiteFlops(2*Nc*Ns, sub);
+
+	p[sub] = zero;
+	s[sub] = zero;
+	z[sub] = zero;
+
+	gamma = norm2(r, sub);
+	delta = innerProductReal(w, r, sub);
+	flopcount.addSiteFlops(8*Nc*Ns, sub);
+
+	restart = false;
+
+	if ( toBool(gamma <= rsd_sq) )
+	  break;
+      }
+
+      if (k >= MaxCG)
+	break;
+
+      ++k;
+
+      //  n := A w
+      M(tmp, w, PLUS);
+      M(n, tmp, MINUS);
+      flopcount.addFlops(2*M.nFlops());
+
+      if (k == 1 || toBool(a_old == Double(0)))
+      {
+	b = 0;
+	a = gamma / delta;
+      }
+      else
+      {
+	b = gamma / gamma_old;
+	a = gamma / (delta - b * gamma / a_old);
+      }
+
+      gamma_old = gamma;
+      a_old = a;
+
+      pipeUpdate<T,RT>(psi, r, w, p, s, z, n, a, b, gamma, delta, sub);
+      flopcount.addSiteFlops(32*Nc*Ns, sub);
+
+      if ( toBool(gamma <= rsd_sq) )
+      {
+	// Check the true residual
+	M(tmp, psi, PLUS);
+	M(n, tmp, MINUS);
+	flopcount.addFlops(2*M.nFlops());
+
+	Double true_sq = norm2(chi - n, sub);
+	if ( toBool(true_sq <= rsd_sq) )
+	{
+	  gamma = true_sq;
+	  break;
+	}
+
+	// Restart from the true residual
+	QDPIO::cout << "InvCG2Pipelined: restart at iter " << k 
+		    << "  |r|^2 recurrence = " << gamma << "  true = " << true_sq << std::endl;
+	++restarts;
+	restart = true;
+	a_old = 0;
+      }
+    }
+
+    res.n_count = k;
+    res.resid   = sqrt(gamma);
+
+    swatch.stop();
+    QDPIO::cout << "InvCG2Pipelined: k = " << k << "  restarts = " << restarts
+		<< "  |r|/|chi| = " << sqrt(gamma/chi_sq) << std::endl;
+    flopcount.report("invcg2_pipelined", swatch.getTimeInSeconds());
+
+    if ( k >= MaxCG && toBool(gamma > rsd_sq) )
+    {
+      QDPIO::cerr << "Nonconvergence Warning" << std::endl;
+      QDPIO::cerr << "too many CG iterations: count =" << res.n_count << " rsd = " << res.resid << std::endl;
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  SystemSolverResults_t 
+  InvCG2Pipelined(const LinearOperator<LatticeFermionF>& M,
+		  const LatticeFermionF& chi,
+		  LatticeFermionF& psi,
+		  const Real& RsdCG, 
+		  int MaxCG)
+  {
+    return InvCG2Pipelined_a<LatticeFermionF, RealF>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  SystemSolverResults_t 
+  InvCG2Pipelined(const LinearOperator<LatticeFermionD>& M,
+		  const LatticeFermionD& chi,
+		  LatticeFermionD& psi,
+		  const Real& RsdCG, 
+		  int MaxCG)
+  {
+    return InvCG2Pipelined_a<LatticeFermionD, RealD>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+}  // end namespace Chroma
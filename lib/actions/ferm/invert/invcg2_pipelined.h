@@ -0,0 +1,76 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Pipelined Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#ifndef __invcg2_pipelined__
+#define __invcg2_pipelined__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma 
+{
+
+  //! Pipelined CGNE for a generic Linear Operator
+  /*! \ingroup invert
+   * Solves  Chi  =  M^dag . M . Psi  with the pipelined CG of
+   * Ghysels and Vanroose. The recurrences carry  w = A r  and
+   * z = A s, with  A = M^dag M, so the two inner products of an
+   * iteration,
+   *
+   *      gamma = < r, r >     and     delta = < w, r >
+   *
+   * are known before the operator is applied. They are accumulated in
+   * the same sweep over the sites as the six std::vector updates, and
+   * reduced with a single global sum per iteration (instead of the two
+   * blocking reductions of InvCG2).
+   *
+   * Algorithm (A = M^dag M):
+   *
+   *  r := Chi - A Psi ;  w := A r
+   *  gamma := <r,r> ;  delta := <w,r>
+   *  FOR k FROM 0 TO MaxCG DO
+   *      n := A w
+   *      b := gamma / gamma_old             (b = 0 at k=0)
+   *      a := gamma / (delta - b gamma / a_old)
+   *      z := n + b z ;  s := w + b s ;  p := r + b p
+   *      Psi += a p ;  r -= a s ;  w -= a z
+   *      gamma := <r,r> ;  delta := <w,r>       (one global sum)
+   *      IF gamma <= RsdCG^2 |Chi|^2  check the true residual;
+   *         restart the recurrence from it if it is not converged
+   *
+   * The recurrence for r drifts further from Chi - A Psi than in
+   * InvCG2, hence the check of the true residual at convergence.
+   *
+   *  \param M       Linear Operator    	       (Read)
+   *  \param chi     Source	               (Read)
+   *  \param psi     Solution    	    	       (Modify)
+   *  \param RsdCG   CG residual accuracy        (Read)
+   *  \param MaxCG   Maximum CG iterations       (Read)
+   *  \return res    System solver results
+   *
+   * @{
+   */
+
+  // Single precision
+  SystemSolverResults_t 
+  InvCG2Pipelined(const LinearOperator<LatticeFermionF>& M,
+		  const LatticeFermionF& chi,
+		  LatticeFermionF& psi,
+		  const Real& RsdCG, 
+		  int MaxCG);
+
+  // Double precision
+  SystemSolverResults_t 
+  InvCG2Pipelined(const LinearOperator<LatticeFermionD>& M,
+		  const LatticeFermionD& chi,
+		  LatticeFermionD& psi,
+		  const Real& RsdCG, 
+		  int MaxCG);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/invmr.h"
+#include "actions/ferm/invert/blas1_kernels.h"
 
 using namespace QDP::Hints;
 
@@ -134,11 +135,8 @@ namespace Chroma
       /*  Mr = M * r  */
       M(Mr, r, isign);  flopcount.addFlops(M.nFlops());
 
-      /*  c = < M.r, r > */
-      c = innerProduct(Mr, r, s);  flopcount.addSiteFlops(4*Nc*Ns,s);
-    
-      /*  d = | M.r | ** 2  */
-      d = norm2(Mr, s);  flopcount.addSiteFlops(4*Nc*Ns,s);
+      /*  c = < M.r, r > ,  d = | M.r | ** 2  */
+      Blas1Kernels::norm2Dot(Mr, r, d, c, s);  flopcount.addSiteFlops(8*Nc*Ns,s);
 
       /*  a = c / d */
       a = c / d;
@@ -147,13 +145,11 @@ namespace Chroma
       a = a * MRovpar;
 
       /*  Psi[k] += a[k-1] r[k-1] ; */
-      psi[s] += r * a;    flopcount.addSiteFlops(4*Nc*Ns,s);
-
       /*  r[k] -= a[k-1] M . r[k-1] ; */
-      r[s] -= Mr * a;    flopcount.addSiteFlops(4*Nc*Ns,s);
-
       /*  cp  =  | r[k] |**2 */
-      cp = norm2(r, s);    flopcount.addSiteFlops(4*Nc*Ns,s);
+      Complex ma = -a;
+      cp = Blas1Kernels::axpyAxpyNorm2(psi, a, r, r, ma, Mr, s);
+      flopcount.addSiteFlops(12*Nc*Ns,s);
 
 //    QDPIO::cout << "InvMR: k = " << k << "  cp = " << cp << std::endl;
     }
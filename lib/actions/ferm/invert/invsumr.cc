@@ -1,5 +1,6 @@
 #include "chromabase.h"
 #include "actions/ferm/invert/invsumr.h"
+#include "actions/ferm/invert/blas1_kernels.h"
 
 namespace Chroma {
 
@@ -156,21 +157,15 @@ void InvSUMR_a(const LinearOperator<T>& U,
     // p_{m-1} := p_{m-2} - ( w_{m-2} - v_{m-1} )*lambda_{m-1}
     //
     // NB: I precompute v_{m-2} - v_{m-1} into w_minus_v
+    // and overwrite w_old with w_{m-1} which is kept for the next iteration
     LatticeFermion w_minus_v;
     w_minus_v = w_old - v_old;
 
-    LatticeFermion w = alpha*p - kappa*w_minus_v;
-    p = p - lambda*w_minus_v;
+    w_old = alpha*p - kappa*w_minus_v;
+    p -= lambda*w_minus_v;
 
     // x_{m-1} := x_{m-1} - ( w_{m-1} - v_m ) eta
-    //
-    // NB I compute w_{m-1} - v_m into w_minus_v
-
-    w_minus_v = w-v;
-    x = x - eta*w_minus_v;
-
-    // I need to keep w as w_old for the next iteration
-    w_old = w;
+    x -= eta*(w_old - v);
 
     // At this point the paper writes:
     // 
@@ -195,18 +190,18 @@ void InvSUMR_a(const LinearOperator<T>& U,
       v_old = v;
 
       // v_{m+1} := (1/sigma)( u + gamma_m vtilde_m );
-      v = u + gamma*vtilde;
       Real ftmp2 = Real(1)/sigma;
-      v *= ftmp2;
+      v = ftmp2*(u + gamma*vtilde);
 
       // vtilde_{m+1} := sigma_m vtilde_m + conj(gamma_m)*v_{m+1} 
+      // with its norm in the same pass
       Complex gconj = conj(gamma);
       Complex csigma=cmplx(sigma,0);
-      vtilde = csigma*vtilde + gconj*v;
+      Double vtilde_sq = Blas1Kernels::axpbyNorm2(vtilde, gconj, v, csigma, all);
 
       // Normalise vtilde -- I found this in the Wuppertal MATLAB code
       // It is not prescribed by the Reichel/Jagels paper
-      Real ftmp3 = Real(1)/sqrt(norm2(vtilde));
+      Real ftmp3 = Real(1)/sqrt(vtilde_sq);
       vtilde *= ftmp3;
 
       // Check whether we have converged or not:
@@ -0,0 +1,481 @@
+/*! \file
+ *  \brief Coarse levels of the native aggregation multigrid
+ */
+
+#include "actions/ferm/invert/mg_native/mg_native_coarse.h"
+
+namespace Chroma
+{
+  namespace MGNative
+  {
+    //----------------------------------------------------------------------------
+    // Block the lattice
+    CoarseGeometry::CoarseGeometry(const multi1d<int>& scale_) : scale(scale_)
+    {
+      START_CODE();
+
+      const multi1d<int>& latt_size = Layout::lattSize();
+      const multi1d<int>& sub_size  = Layout::subgridLattSize();
+
+      if (scale.size() != Nd)
+      {
+	QDPIO::cerr << "MGNative: blocking needs " << Nd << " entries" << std::endl;
+	QDP_abort(1);
+      }
+
+      dims.resize(Nd);
+      nsites = 1;
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	if (scale[mu] < 1 || sub_size[mu] % scale[mu] != 0)
+	{
+	  QDPIO::cerr << "MGNative: block size " << scale[mu] << " in direction " << mu
+		      << " does not divide the node sub-lattice size " << sub_size[mu] << std::endl;
+	  QDP_abort(1);
+	}
+	dims[mu] = latt_size[mu] / scale[mu];
+	nsites *= dims[mu];
+      }
+
+      neigh.resize(num_stencil*nsites);
+      local_index.assign(nsites, -1);
+      local.clear();
+
+      for(int site=0; site < nsites; ++site)
+      {
+	multi1d<int> c = coords(site);
+
+	neigh[num_stencil*site] = site;
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  multi1d<int> cf = c;
+	  cf[mu] = (c[mu] + 1) % dims[mu];
+	  neigh[num_stencil*site + fwdDir(mu)] = index(cf);
+
+	  multi1d<int> cb = c;
+	  cb[mu] = (c[mu] + dims[mu] - 1) % dims[mu];
+	  neigh[num_stencil*site + bwdDir(mu)] = index(cb);
+	}
+
+	// The block is held by the node holding its first site
+	multi1d<int> x(Nd);
+	for(int mu=0; mu < Nd; ++mu)
+	  x[mu] = c[mu] * scale[mu];
+
+	if (Layout::nodeNumber(x) == Layout::nodeNumber())
+	{
+	  local_index[site] = local.size();
+	  local.push_back(site);
+	}
+      }
+
+      END_CODE();
+    }
+
+
+    // Lexicographic index
+    int CoarseGeometry::index(const multi1d<int>& c) const
+    {
+      int site = 0;
+      for(int mu=Nd-1; mu >= 0; --mu)
+	site = site*dims[mu] + c[mu];
+      return site;
+    }
+
+
+    // Coordinates
+    multi1d<int> CoarseGeometry::coords(int site) const
+    {
+      multi1d<int> c(Nd);
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	c[mu] = site % dims[mu];
+	site /= dims[mu];
+      }
+      return c;
+    }
+
+
+    //----------------------------------------------------------------------------
+    // Vector helpers
+    void gatherHalo(std::vector<Cmplx>& full, const CoarseVector& v)
+    {
+      full = v.data;
+      if (Layout::numNodes() > 1)
+	QDPInternal::globalSumArray(reinterpret_cast<REAL64*>(&full[0]), 2*full.size());
+    }
+
+
+    void zeroLike(CoarseVector& x, const CoarseVector& like)
+    {
+      x.resize(like.geometry(), like.numDof());
+    }
+
+
+    DComplex innerProduct(const CoarseVector& x, const CoarseVector& y, const Subset& s)
+    {
+      const std::vector<int>& local = x.geometry().localSites();
+      const int ndof = x.numDof();
+
+      REAL64 d[2] = {0, 0};
+      for(int l=0; l < local.size(); ++l)
+      {
+	const Cmplx* xs = x.site(local[l]);
+	const Cmplx* ys = y.site(local[l]);
+	for(int k=0; k < ndof; ++k)
+	{
+	  Cmplx p = std::conj(xs[k]) * ys[k];
+	  d[0] += p.real();
+	  d[1] += p.imag();
+	}
+      }
+
+      QDPInternal::globalSumArray(d, 2);
+      return cmplx(Double(d[0]), Double(d[1]));
+    }
+
+
+    Double norm2(const CoarseVector& x, const Subset& s)
+    {
+      const std::vector<int>& local = x.geometry().localSites();
+      const int ndof = x.numDof();
+
+      REAL64 d = 0;
+      for(int l=0; l < local.size(); ++l)
+      {
+	const Cmplx* xs = x.site(local[l]);
+	for(int k=0; k < ndof; ++k)
+	  d += std::norm(xs[k]);
+      }
+
+      QDPInternal::globalSum(d);
+      return Double(d);
+    }
+
+
+    void axpy(CoarseVector& y, const DComplex& a, const CoarseVector& x, const Subset& s)
+    {
+      const std::vector<int>& local = x.geometry().localSites();
+      const int ndof = x.numDof();
+      const Cmplx ac(toDouble(real(a)), toDouble(imag(a)));
+
+      for(int l=0; l < local.size(); ++l)
+      {
+	const Cmplx* xs = x.site(local[l]);
+	Cmplx* ys = y.site(local[l]);
+	for(int k=0; k < ndof; ++k)
+	  ys[k] += ac * xs[k];
+      }
+    }
+
+
+    void copy(CoarseVector& y, const CoarseVector& x, const Subset& s)
+    {
+      y = x;
+    }
+
+
+    void xmy(CoarseVector& y, const CoarseVector& x, const Subset& s)
+    {
+      const std::vector<int>& local = x.geometry().localSites();
+      const int ndof = x.numDof();
+
+      for(int l=0; l < local.size(); ++l)
+      {
+	const Cmplx* xs = x.site(local[l]);
+	Cmplx* ys = y.site(local[l]);
+	for(int k=0; k < ndof; ++k)
+	  ys[k] = xs[k] - ys[k];
+      }
+    }
+
+
+    //----------------------------------------------------------------------------
+    // Coarse operator
+    CoarseLinOp::CoarseLinOp(const CoarseGeometry& g, int ndof_) : geom(g), ndof(ndof_)
+    {
+      stencil.assign(num_stencil*g.localSites().size()*ndof*ndof, Cmplx(0));
+    }
+
+
+    namespace
+    {
+      struct CoarseApplyArgs
+      {
+	const CoarseLinOp& A;
+	const std::vector<Cmplx>& in;
+	CoarseVector& out;
+	bool dagger;
+      };
+
+      void coarseApplySiteLoop(int lo, int hi, int myId, CoarseApplyArgs* arg)
+      {
+	const CoarseGeometry& geom = arg->A.geometry();
+	const int ndof = arg->A.numDof();
+	const int nhalf = ndof / 2;
+
+	for(int l=lo; l < hi; ++l)
+	{
+	  const int site = geom.localSites()[l];
+	  Cmplx* out = arg->out.site(site);
+
+	  for(int i=0; i < ndof; ++i)
+	    out[i] = 0;
+
+	  for(int dir=0; dir < num_stencil; ++dir)
+	  {
+	    const Cmplx* in = &arg->in[geom.neighbour(site, dir)*ndof];
+	    const Cmplx* m = arg->A.link(l, dir);
+
+	    if (! arg->dagger)
+	    {
+	      for(int i=0; i < ndof; ++i)
+		for(int j=0; j < ndof; ++j)
+		  out[i] += m[i*ndof + j] * in[j];
+	    }
+	    else
+	    {
+	      // A^dag = G5 A G5 : flip the sign of the blocks mixing chiralities
+	      for(int i=0; i < ndof; ++i)
+		for(int j=0; j < ndof; ++j)
+		{
+		  const Cmplx t = m[i*ndof + j] * in[j];
+		  out[i] += ((i < nhalf) == (j < nhalf)) ? t : -t;
+		}
+	    }
+	  }
+	}
+      }
+    }
+
+
+    void CoarseLinOp::operator()(CoarseVector& chi, const CoarseVector& psi, enum PlusMinus isign) const
+    {
+      std::vector<Cmplx> full;
+      gatherHalo(full, psi);
+
+      zeroLike(chi, psi);
+
+      CoarseApplyArgs arg = {*this, full, chi, isign == MINUS};
+      dispatch_to_threads(geom.localSites().size(), arg, coarseApplySiteLoop);
+    }
+
+
+    //----------------------------------------------------------------------------
+    // Aggregation between coarse levels
+    CoarseAggregation::CoarseAggregation(const CoarseGeometry& fine_, const multi1d<int>& block)
+      : fine(fine_), fine_dof(0), nvec(0)
+    {
+      START_CODE();
+
+      multi1d<int> scale(Nd);
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	if (block[mu] < 1 || fine.size()[mu] % block[mu] != 0)
+	{
+	  QDPIO::cerr << "MGNative: block size " << block[mu] << " in direction " << mu
+		      << " does not divide the coarse lattice size " << fine.size()[mu] << std::endl;
+	  QDP_abort(1);
+	}
+	scale[mu] = fine.scaleFactor()[mu] * block[mu];
+      }
+
+      coarse = CoarseGeometry(scale);
+
+      block_of.resize(fine.numSites());
+      for(int site=0; site < fine.numSites(); ++site)
+      {
+	multi1d<int> c = fine.coords(site);
+	for(int mu=0; mu < Nd; ++mu)
+	  c[mu] /= block[mu];
+	block_of[site] = coarse.index(c);
+      }
+
+      members.resize(coarse.localSites().size());
+      for(int l=0; l < fine.localSites().size(); ++l)
+      {
+	const int site = fine.localSites()[l];
+	const int lc = coarse.localIndex(block_of[site]);
+	if (lc < 0)
+	{
+	  QDPIO::cerr << "MGNative: aggregate straddles a node" << std::endl;
+	  QDP_abort(1);
+	}
+	members[lc].push_back(site);
+      }
+
+      END_CODE();
+    }
+
+
+    // Project on chirality and orthonormalise per aggregate
+    void CoarseAggregation::setNullVectors(const multi1d<CoarseVector>& nv)
+    {
+      START_CODE();
+
+      nvec = nv.size();
+      fine_dof = nv[0].numDof();
+      const int nhalf = fine_dof / 2;
+
+      vecs.resize(2*nvec);
+      for(int s=0; s < 2; ++s)
+	for(int i=0; i < nvec; ++i)
+	{
+	  CoarseVector& v = vecs[s*nvec + i];
+	  v = nv[i];
+	  for(int site=0; site < fine.numSites(); ++site)
+	    for(int k=0; k < fine_dof; ++k)
+	      if ((k < nhalf) != (s == 0))
+		v.site(site)[k] = 0;
+	}
+
+      // Modified Gram-Schmidt within each aggregate and chirality
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	const std::vector<int>& mem = members[lc];
+	for(int s=0; s < 2; ++s)
+	  for(int i=0; i < nvec; ++i)
+	  {
+	    CoarseVector& vi = vecs[s*nvec + i];
+	    for(int j=0; j < i; ++j)
+	    {
+	      const CoarseVector& vj = vecs[s*nvec + j];
+	      Cmplx d = 0;
+	      for(int m=0; m < mem.size(); ++m)
+		for(int k=0; k < fine_dof; ++k)
+		  d += std::conj(vj.site(mem[m])[k]) * vi.site(mem[m])[k];
+	      for(int m=0; m < mem.size(); ++m)
+		for(int k=0; k < fine_dof; ++k)
+		  vi.site(mem[m])[k] -= d * vj.site(mem[m])[k];
+	    }
+
+	    REAL64 n = 0;
+	    for(int m=0; m < mem.size(); ++m)
+	      for(int k=0; k < fine_dof; ++k)
+		n += std::norm(vi.site(mem[m])[k]);
+	    const REAL64 in = (n > 0) ? 1.0/std::sqrt(n) : 0.0;
+	    for(int m=0; m < mem.size(); ++m)
+	      for(int k=0; k < fine_dof; ++k)
+		vi.site(mem[m])[k] *= in;
+	  }
+      }
+
+      END_CODE();
+    }
+
+
+    // fine = P coarse
+    void CoarseAggregation::prolongate(CoarseVector& fine_v, const CoarseVector& coarse_v) const
+    {
+      fine_v.resize(fine, fine_dof);
+
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	const Cmplx* c = coarse_v.site(coarse.localSites()[lc]);
+	const std::vector<int>& mem = members[lc];
+
+	for(int m=0; m < mem.size(); ++m)
+	{
+	  Cmplx* f = fine_v.site(mem[m]);
+	  for(int v=0; v < 2*nvec; ++v)
+	  {
+	    const Cmplx* nv = vecs[v].site(mem[m]);
+	    for(int k=0; k < fine_dof; ++k)
+	      f[k] += nv[k] * c[v];
+	  }
+	}
+      }
+    }
+
+
+    // coarse = P^dag fine
+    void CoarseAggregation::restrictTo(CoarseVector& coarse_v, const CoarseVector& fine_v) const
+    {
+      coarse_v.resize(coarse, 2*nvec);
+
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	Cmplx* c = coarse_v.site(coarse.localSites()[lc]);
+	const std::vector<int>& mem = members[lc];
+
+	for(int m=0; m < mem.size(); ++m)
+	{
+	  const Cmplx* f = fine_v.site(mem[m]);
+	  for(int v=0; v < 2*nvec; ++v)
+	  {
+	    const Cmplx* nv = vecs[v].site(mem[m]);
+	    for(int k=0; k < fine_dof; ++k)
+	      c[v] += std::conj(nv[k]) * f[k];
+	  }
+	}
+      }
+    }
+
+
+    // Galerkin operator
+    Handle<CoarseLinOp> CoarseAggregation::coarsen(const CoarseLinOp& A) const
+    {
+      START_CODE();
+
+      const int cdof = 2*nvec;
+      Handle<CoarseLinOp> Ac(new CoarseLinOp(coarse, cdof));
+
+      // The null vectors on the neighbouring sites of other nodes
+      std::vector< std::vector<Cmplx> > full(cdof);
+      for(int v=0; v < cdof; ++v)
+	gatherHalo(full[v], vecs[v]);
+
+      std::vector<Cmplx> an(fine_dof*cdof);
+
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	const int csite = coarse.localSites()[lc];
+	const std::vector<int>& mem = members[lc];
+
+	for(int m=0; m < mem.size(); ++m)
+	{
+	  const int x = mem[m];
+	  const int lx = fine.localIndex(x);
+
+	  for(int dir=0; dir < num_stencil; ++dir)
+	  {
+	    const int y = fine.neighbour(x, dir);
+
+	    // The entry of the coarser stencil: the aggregate itself or its neighbour
+	    const int cdir = (block_of[y] == csite) ? 0 : dir;
+
+	    // an = A(x,dir) P_y
+	    const Cmplx* a = A.link(lx, dir);
+	    for(int k=0; k < fine_dof; ++k)
+	      for(int v=0; v < cdof; ++v)
+	      {
+		Cmplx t = 0;
+		for(int j=0; j < fine_dof; ++j)
+		  t += a[k*fine_dof + j] * full[v][y*fine_dof + j];
+		an[k*cdof + v] = t;
+	      }
+
+	    // Ac += P_x^dag an
+	    Cmplx* ac = Ac->link(lc, cdir);
+	    for(int u=0; u < cdof; ++u)
+	    {
+	      const Cmplx* px = vecs[u].site(x);
+	      for(int v=0; v < cdof; ++v)
+	      {
+		Cmplx t = 0;
+		for(int k=0; k < fine_dof; ++k)
+		  t += std::conj(px[k]) * an[k*cdof + v];
+		ac[u*cdof + v] += t;
+	      }
+	    }
+	  }
+	}
+      }
+
+      END_CODE();
+      return Ac;
+    }
+
+  } // namespace MGNative
+
+} // namespace Chroma
@@ -0,0 +1,233 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Coarse levels of the native aggregation multigrid
+ */
+
+#ifndef __mg_native_coarse_h__
+#define __mg_native_coarse_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "linearop.h"
+#include <complex>
+#include <vector>
+
+namespace Chroma
+{
+  //! Native aggregation multigrid
+  /*! \ingroup invert */
+  namespace MGNative
+  {
+    typedef std::complex<REAL64> Cmplx;
+
+    //! Number of stencil entries of a coarse operator: the site and its 2*Nd neighbours
+    const int num_stencil = 2*Nd + 1;
+
+    //! Stencil entry of the forward (backward) neighbour in direction mu
+    inline int fwdDir(int mu) {return 1 + 2*mu;}
+    inline int bwdDir(int mu) {return 2 + 2*mu;}
+
+
+    //----------------------------------------------------------------------------
+    //! Geometry of a coarse lattice
+    /*!
+     * Coarse sites are blocks of sites of the original lattice. A block
+     * never straddles a node, and is owned by the node holding its sites.
+     * Coarse site indices are global and lexicographic.
+     */
+    class CoarseGeometry
+    {
+    public:
+      CoarseGeometry() : nsites(0) {}
+
+      //! Block the original lattice
+      /*!
+       * \param scale   original lattice sites per coarse site, per direction ( Read )
+       */
+      CoarseGeometry(const multi1d<int>& scale);
+
+      //! Global coarse lattice size
+      const multi1d<int>& size() const {return dims;}
+
+      //! Original lattice sites per coarse site, per direction
+      const multi1d<int>& scaleFactor() const {return scale;}
+
+      //! Number of global coarse sites
+      int numSites() const {return nsites;}
+
+      //! Coarse sites held by this node
+      const std::vector<int>& localSites() const {return local;}
+
+      //! Position of a site in localSites(), or -1 if not held here
+      int localIndex(int site) const {return local_index[site];}
+
+      //! Site of a stencil entry of a site
+      int neighbour(int site, int dir) const {return neigh[num_stencil*site + dir];}
+
+      //! Lexicographic index of coordinates
+      int index(const multi1d<int>& c) const;
+
+      //! Coordinates of an index
+      multi1d<int> coords(int site) const;
+
+    private:
+      multi1d<int> dims;
+      multi1d<int> scale;
+      int nsites;
+      std::vector<int> neigh;
+      std::vector<int> local;
+      std::vector<int> local_index;
+    };
+
+
+    //----------------------------------------------------------------------------
+    //! Vector on a coarse lattice
+    /*!
+     * Holds ndof complex numbers on every global coarse site, of which
+     * only the sites held by this node are used; all others are zero.
+     * The first ndof/2 components have chirality +1, the rest -1.
+     *
+     * The coarse levels are not distributed: storage is replicated on
+     * every node and gatherHalo is a global sum of the whole vector.
+     * That is meant for a single node and for testing; the solver stops
+     * on more than one node unless ReplicatedCoarse is set.
+     */
+    class CoarseVector
+    {
+    public:
+      CoarseVector() : geom(0), ndof(0) {}
+      CoarseVector(const CoarseGeometry& g, int ndof_) {resize(g, ndof_);}
+
+      //! Size and zero
+      void resize(const CoarseGeometry& g, int ndof_)
+      {
+	geom = &g;
+	ndof = ndof_;
+	data.assign(g.numSites()*ndof, Cmplx(0));
+      }
+
+      const CoarseGeometry& geometry() const {return *geom;}
+      int numDof() const {return ndof;}
+
+      Cmplx* site(int s) {return &data[s*ndof];}
+      const Cmplx* site(int s) const {return &data[s*ndof];}
+
+      std::vector<Cmplx> data;
+
+    private:
+      const CoarseGeometry* geom;
+      int ndof;
+    };
+
+
+    //----------------------------------------------------------------------------
+    //! Coarse operator
+    /*!
+     * A nearest neighbour stencil with a dense ndof x ndof matrix per
+     * stencil entry, as produced by Galerkin projection of a nearest
+     * neighbour operator onto aggregates. Only the sites of this node are
+     * stored. The operator is gamma_5 hermitian with the chirality of the
+     * coarse components, which gives the MINUS application.
+     *
+     * The neighbours are gathered by a global sum of the full vector,
+     * so its cost grows with the global coarse lattice (see CoarseVector).
+     */
+    class CoarseLinOp : public LinearOperator<CoarseVector>
+    {
+    public:
+      //! Zero operator
+      CoarseLinOp(const CoarseGeometry& g, int ndof_);
+
+      //! Apply
+      void operator()(CoarseVector& chi, const CoarseVector& psi, enum PlusMinus isign) const;
+
+      //! Coarse operators act on all sites
+      const Subset& subset() const {return all;}
+
+      const CoarseGeometry& geometry() const {return geom;}
+      int numDof() const {return ndof;}
+
+      //! Matrix of a stencil entry of a local site. Row major
+      Cmplx* link(int lsite, int dir) {return &stencil[(num_stencil*lsite + dir)*ndof*ndof];}
+      const Cmplx* link(int lsite, int dir) const {return &stencil[(num_stencil*lsite + dir)*ndof*ndof];}
+
+    private:
+      const CoarseGeometry& geom;
+      int ndof;
+      std::vector<Cmplx> stencil;
+    };
+
+
+    //----------------------------------------------------------------------------
+    //! Make the neighbours of all local sites available
+    void gatherHalo(std::vector<Cmplx>& full, const CoarseVector& v);
+
+    //! Zero a vector, giving it the shape of another
+    void zeroLike(CoarseVector& x, const CoarseVector& like);
+
+    //! Global <x,y>
+    DComplex innerProduct(const CoarseVector& x, const CoarseVector& y, const Subset& s);
+
+    //! Global |x|^2
+    Double norm2(const CoarseVector& x, const Subset& s);
+
+    //! y += a x
+    void axpy(CoarseVector& y, const DComplex& a, const CoarseVector& x, const Subset& s);
+
+    //! y = x
+    void copy(CoarseVector& y, const CoarseVector& x, const Subset& s);
+
+    //! y = x - y
+    void xmy(CoarseVector& y, const CoarseVector& x, const Subset& s);
+
+
+    //----------------------------------------------------------------------------
+    //! Aggregation of a coarse level onto a coarser one
+    /*!
+     * The prolongator maps the coarser component (s,i) on an aggregate to
+     * the chirality s part of null vector i on the sites of the aggregate,
+     * orthonormalised per aggregate and chirality.
+     */
+    class CoarseAggregation
+    {
+    public:
+      //! Set up the blocking
+      /*!
+       * \param fine    geometry of the level to be coarsened ( Read )
+       * \param block   level sites per aggregate, per direction ( Read )
+       */
+      CoarseAggregation(const CoarseGeometry& fine, const multi1d<int>& block);
+
+      //! Geometry of the coarser level
+      const CoarseGeometry& coarseGeometry() const {return coarse;}
+
+      //! Components per coarser site
+      int numCoarseDof() const {return 2*nvec;}
+
+      //! Install the null vectors. They are orthonormalised per aggregate
+      void setNullVectors(const multi1d<CoarseVector>& nv);
+
+      //! fine = P coarse
+      void prolongate(CoarseVector& fine_v, const CoarseVector& coarse_v) const;
+
+      //! coarse = P^dag fine
+      void restrictTo(CoarseVector& coarse_v, const CoarseVector& fine_v) const;
+
+      //! Galerkin operator  P^dag A P  on the coarser level
+      Handle<CoarseLinOp> coarsen(const CoarseLinOp& A) const;
+
+    private:
+      const CoarseGeometry& fine;
+      CoarseGeometry coarse;
+      int fine_dof;
+      int nvec;
+      std::vector<int> block_of;                  /*!< coarser site of each fine site */
+      std::vector< std::vector<int> > members;    /*!< local fine sites of each local coarser site */
+      multi1d<CoarseVector> vecs;                 /*!< 2*nvec chirally projected null vectors */
+    };
+
+  } // namespace MGNative
+
+} // namespace Chroma
+
+#endif
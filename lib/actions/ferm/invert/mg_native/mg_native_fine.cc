@@ -0,0 +1,254 @@
+/*! \file
+ *  \brief Aggregation of the fermion lattice for the native multigrid
+ */
+
+#include "actions/ferm/invert/mg_native/mg_native_fine.h"
+
+namespace Chroma
+{
+  namespace MGNative
+  {
+    namespace
+    {
+      //! <x,y> over the spin and colour components of a site
+      inline Cmplx siteInner(const LatticeFermion& x, const LatticeFermion& y, int site)
+      {
+	Cmplx d = 0;
+	for(int s=0; s < Ns; ++s)
+	  for(int c=0; c < Nc; ++c)
+	  {
+	    const Cmplx xc(x.elem(site).elem(s).elem(c).real(), x.elem(site).elem(s).elem(c).imag());
+	    const Cmplx yc(y.elem(site).elem(s).elem(c).real(), y.elem(site).elem(s).elem(c).imag());
+	    d += std::conj(xc) * yc;
+	  }
+	return d;
+      }
+
+      //! y += a x on a site
+      inline void siteAxpy(LatticeFermion& y, const Cmplx& a, const LatticeFermion& x, int site)
+      {
+	for(int s=0; s < Ns; ++s)
+	  for(int c=0; c < Nc; ++c)
+	  {
+	    const Cmplx xc(x.elem(site).elem(s).elem(c).real(), x.elem(site).elem(s).elem(c).imag());
+	    const Cmplx t = a * xc;
+	    y.elem(site).elem(s).elem(c).real() += t.real();
+	    y.elem(site).elem(s).elem(c).imag() += t.imag();
+	  }
+      }
+    }
+
+
+    // Set up the blocking
+    FineAggregation::FineAggregation(const multi1d<int>& block_) : block(block_), coarse(block_), nvec(0)
+    {
+      START_CODE();
+
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	const int nb = coarse.size()[mu];
+	if (nb > 1 && (nb % 2 != 0 || block[mu] < 2))
+	{
+	  QDPIO::cerr << "MGNative: in direction " << mu << " the number of aggregates (" << nb
+		      << ") must be even and the block size (" << block[mu] << ") at least 2" << std::endl;
+	  QDP_abort(1);
+	}
+      }
+
+      const int nodeSites = Layout::sitesOnNode();
+      block_of.resize(nodeSites);
+      in_block.resize(Nd*nodeSites);
+      members.resize(coarse.localSites().size());
+
+      for(int site=0; site < nodeSites; ++site)
+      {
+	multi1d<int> x = Layout::siteCoords(Layout::nodeNumber(), site);
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  in_block[Nd*site + mu] = x[mu] % block[mu];
+	  x[mu] /= block[mu];
+	}
+
+	block_of[site] = coarse.index(x);
+	members[coarse.localIndex(block_of[site])].push_back(site);
+      }
+
+      END_CODE();
+    }
+
+
+    // Parity colour
+    int FineAggregation::colour(int csite) const
+    {
+      multi1d<int> c = coarse.coords(csite);
+      int col = 0;
+      for(int mu=0; mu < Nd; ++mu)
+	col |= (c[mu] & 1) << mu;
+      return col;
+    }
+
+
+    // Project on chirality and orthonormalise per block
+    void FineAggregation::setNullVectors(const multi1d<LatticeFermion>& nv)
+    {
+      START_CODE();
+
+      nvec = nv.size();
+      vecs.resize(2*nvec);
+
+      for(int i=0; i < nvec; ++i)
+      {
+	LatticeFermion g5v = Gamma(Ns*Ns-1) * nv[i];
+	vecs[i]        = Real(0.5) * (nv[i] + g5v);
+	vecs[nvec + i] = Real(0.5) * (nv[i] - g5v);
+      }
+
+      // Modified Gram-Schmidt within each block and chirality
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	const std::vector<int>& mem = members[lc];
+	for(int s=0; s < 2; ++s)
+	  for(int i=0; i < nvec; ++i)
+	  {
+	    LatticeFermion& vi = vecs[s*nvec + i];
+	    for(int j=0; j < i; ++j)
+	    {
+	      const LatticeFermion& vj = vecs[s*nvec + j];
+	      Cmplx d = 0;
+	      for(int m=0; m < mem.size(); ++m)
+		d += siteInner(vj, vi, mem[m]);
+	      for(int m=0; m < mem.size(); ++m)
+		siteAxpy(vi, -d, vj, mem[m]);
+	    }
+
+	    REAL64 n = 0;
+	    for(int m=0; m < mem.size(); ++m)
+	      n += siteInner(vi, vi, mem[m]).real();
+	    const Cmplx in((n > 0) ? 1.0/std::sqrt(n) - 1.0 : -1.0, 0);
+	    for(int m=0; m < mem.size(); ++m)
+	      siteAxpy(vi, in, vi, mem[m]);
+	  }
+      }
+
+      END_CODE();
+    }
+
+
+    // fine = P coarse
+    void FineAggregation::prolongate(LatticeFermion& fine_v, const CoarseVector& coarse_v) const
+    {
+      fine_v = zero;
+
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	const Cmplx* c = coarse_v.site(coarse.localSites()[lc]);
+	const std::vector<int>& mem = members[lc];
+
+	for(int m=0; m < mem.size(); ++m)
+	  for(int v=0; v < 2*nvec; ++v)
+	    siteAxpy(fine_v, c[v], vecs[v], mem[m]);
+      }
+    }
+
+
+    // coarse = P^dag fine
+    void FineAggregation::restrictTo(CoarseVector& coarse_v, const LatticeFermion& fine_v) const
+    {
+      coarse_v.resize(coarse, 2*nvec);
+
+      for(int lc=0; lc < members.size(); ++lc)
+      {
+	Cmplx* c = coarse_v.site(coarse.localSites()[lc]);
+	const std::vector<int>& mem = members[lc];
+
+	for(int m=0; m < mem.size(); ++m)
+	  for(int v=0; v < 2*nvec; ++v)
+	    c[v] += siteInner(vecs[v], fine_v, mem[m]);
+      }
+    }
+
+
+    // Galerkin operator by probing
+    Handle<CoarseLinOp> FineAggregation::coarsen(const LinearOperator<LatticeFermion>& M) const
+    {
+      START_CODE();
+
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      const int cdof = 2*nvec;
+      Handle<CoarseLinOp> Ac(new CoarseLinOp(coarse, cdof));
+
+      const int ncol = 1 << Nd;
+      LatticeFermion v, w;
+
+      for(int col=0; col < ncol; ++col)
+      {
+	for(int k=0; k < cdof; ++k)
+	{
+	  // Null vector k on the aggregates of this colour
+	  v = zero;
+	  for(int lc=0; lc < members.size(); ++lc)
+	  {
+	    if (colour(coarse.localSites()[lc]) != col)
+	      continue;
+
+	    const std::vector<int>& mem = members[lc];
+	    for(int m=0; m < mem.size(); ++m)
+	      v.elem(mem[m]) = vecs[k].elem(mem[m]);
+	  }
+
+	  M(w, v, PLUS);
+
+	  // Sort the result by the aggregate it came from. An aggregate only
+	  // sees itself (same colour) and, on its faces, its neighbours in the
+	  // one direction in which the colours differ
+	  for(int lc=0; lc < members.size(); ++lc)
+	  {
+	    const int diff = colour(coarse.localSites()[lc]) ^ col;
+	    int mu = -1;
+	    if (diff != 0)
+	    {
+	      for(int nu=0; nu < Nd; ++nu)
+		if (diff == (1 << nu))
+		  mu = nu;
+	      if (mu < 0)
+		continue;
+	    }
+
+	    const std::vector<int>& mem = members[lc];
+	    for(int m=0; m < mem.size(); ++m)
+	    {
+	      const int site = mem[m];
+	      int dir = 0;
+	      if (mu >= 0)
+	      {
+		const int xm = in_block[Nd*site + mu];
+		if (xm == block[mu]-1)
+		  dir = fwdDir(mu);
+		else if (xm == 0)
+		  dir = bwdDir(mu);
+		else
+		  continue;
+	      }
+
+	      Cmplx* ac = Ac->link(lc, dir);
+	      for(int u=0; u < cdof; ++u)
+		ac[u*cdof + k] += siteInner(vecs[u], w, site);
+	    }
+	  }
+	}
+      }
+
+      swatch.stop();
+      QDPIO::cout << "MGNative: coarse operator with " << cdof << " components per site, "
+		  << ncol*cdof << " probes, time = " << swatch.getTimeInSeconds() << " secs" << std::endl;
+
+      END_CODE();
+      return Ac;
+    }
+
+  } // namespace MGNative
+
+} // namespace Chroma
@@ -0,0 +1,100 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Aggregation of the fermion lattice for the native multigrid
+ */
+
+#ifndef __mg_native_fine_h__
+#define __mg_native_fine_h__
+
+#include "actions/ferm/invert/mg_native/mg_native_coarse.h"
+
+namespace Chroma
+{
+  namespace MGNative
+  {
+    //----------------------------------------------------------------------------
+    //! Vector helpers on the fermion lattice
+    /*! \ingroup invert */
+    inline void zeroLike(LatticeFermion& x, const LatticeFermion& like)
+    {
+      x = zero;
+    }
+
+    inline void axpy(LatticeFermion& y, const DComplex& a, const LatticeFermion& x, const Subset& s)
+    {
+      Complex ac = a;
+      y[s] += ac * x;
+    }
+
+    inline void copy(LatticeFermion& y, const LatticeFermion& x, const Subset& s)
+    {
+      y[s] = x;
+    }
+
+    inline void xmy(LatticeFermion& y, const LatticeFermion& x, const Subset& s)
+    {
+      y[s] = x - y;
+    }
+
+
+    //----------------------------------------------------------------------------
+    //! Aggregation of the fermion lattice onto the first coarse level
+    /*! \ingroup invert
+     *
+     * Aggregates are blocks of sites, split by chirality. The prolongator
+     * maps the coarse component (s,i) on an aggregate to the chirality s
+     * part of null vector i on the block, orthonormalised per block and
+     * chirality. Since the prolongator commutes with gamma_5, the coarse
+     * operator inherits gamma_5 hermiticity.
+     */
+    class FineAggregation
+    {
+    public:
+      //! Set up the blocking
+      /*!
+       * \param block   lattice sites per aggregate, per direction ( Read )
+       */
+      FineAggregation(const multi1d<int>& block);
+
+      //! Geometry of the coarse level
+      const CoarseGeometry& coarseGeometry() const {return coarse;}
+
+      //! Components per coarse site
+      int numCoarseDof() const {return 2*nvec;}
+
+      //! Install the null vectors. They are orthonormalised per aggregate
+      void setNullVectors(const multi1d<LatticeFermion>& nv);
+
+      //! fine = P coarse
+      void prolongate(LatticeFermion& fine_v, const CoarseVector& coarse_v) const;
+
+      //! coarse = P^dag fine
+      void restrictTo(CoarseVector& coarse_v, const LatticeFermion& fine_v) const;
+
+      //! Galerkin operator  P^dag M P
+      /*!
+       * M must be a nearest neighbour operator on the full lattice (e.g.
+       * unpreconditioned Wilson or clover). The stencil is probed with one
+       * application of M per chirality, null vector and each of the 2^Nd
+       * colours of a parity colouring of the aggregates.
+       */
+      Handle<CoarseLinOp> coarsen(const LinearOperator<LatticeFermion>& M) const;
+
+    private:
+      //! Parity colour of a coarse site
+      int colour(int csite) const;
+
+      multi1d<int> block;
+      CoarseGeometry coarse;
+      int nvec;
+      std::vector<int> block_of;                  /*!< coarse site of each node site */
+      std::vector<int> in_block;                  /*!< coordinates of each node site within its block */
+      std::vector< std::vector<int> > members;    /*!< node sites of each local coarse site */
+      multi1d<LatticeFermion> vecs;               /*!< 2*nvec chirally projected null vectors */
+    };
+
+  } // namespace MGNative
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,270 @@
+/*! \file
+ *  \brief Level hierarchy and V-cycle of the native aggregation multigrid
+ */
+
+#include "actions/ferm/invert/mg_native/mg_native_hierarchy.h"
+#include "actions/ferm/invert/mg_native/mg_native_solvers.h"
+#include "actions/ferm/invert/invmr.h"
+
+namespace Chroma
+{
+  namespace MGNative
+  {
+    // Build the hierarchy
+    Hierarchy::Hierarchy(Handle< LinearOperator<LatticeFermion> > M_,
+			 const SysSolverMGNativeParams& param_,
+			 const std::string& config_id_) : 
+      M(M_), param(param_), config_id(config_id_), pending(Keep)
+    {
+      START_CODE();
+
+      work.setups = work.refreshes = work.coarsenings = 0;
+      work.setup_time = work.refresh_time = work.coarsen_time = 0;
+
+      const int ncoarse = param.Blocking.size();
+      aggs.resize(ncoarse-1);
+      ops.resize(ncoarse);
+      coarse_nv.resize(ncoarse-1);
+
+      fine = new FineAggregation(param.Blocking[0]);
+      for(int l=1; l < ncoarse; ++l)
+      {
+	const CoarseGeometry& g = (l == 1) ? fine->coarseGeometry() : aggs[l-2]->coarseGeometry();
+	aggs[l-1] = new CoarseAggregation(g, param.Blocking[l]);
+      }
+
+      levels(Generate);
+
+      END_CODE();
+    }
+
+
+    // Adopt a new fine operator
+    void Hierarchy::update(Handle< LinearOperator<LatticeFermion> > M_,
+			   const std::string& config_id_)
+    {
+      START_CODE();
+
+      M = M_;
+
+      if (pending != Keep || config_id_ != config_id)
+      {
+	config_id = config_id_;
+	levels(pending);
+	pending = Keep;
+      }
+
+      END_CODE();
+    }
+
+
+    // (Re)build the levels
+    void Hierarchy::levels(SetupMode mode)
+    {
+      START_CODE();
+
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      double tcoarsen = 0;
+
+      fineNullVectors(mode);
+      if (mode != Keep)
+	fine->setNullVectors(fine_nv);
+
+      {
+	StopWatch sw;
+	sw.reset();
+	sw.start();
+	ops[0] = fine->coarsen(*M);
+	sw.stop();
+	tcoarsen += sw.getTimeInSeconds();
+      }
+
+      for(int l=1; l < ops.size(); ++l)
+      {
+	coarseNullVectors(l-1, mode);
+	if (mode != Keep)
+	  aggs[l-1]->setNullVectors(coarse_nv[l-1]);
+
+	StopWatch sw;
+	sw.reset();
+	sw.start();
+	ops[l] = aggs[l-1]->coarsen(*ops[l-1]);
+	sw.stop();
+	tcoarsen += sw.getTimeInSeconds();
+      }
+
+      swatch.stop();
+      const double t = swatch.getTimeInSeconds();
+
+      ++work.coarsenings;
+      work.coarsen_time += tcoarsen;
+      switch (mode)
+      {
+      case Generate:
+	++work.setups;
+	work.setup_time += t - tcoarsen;
+	break;
+      case Relax:
+	++work.refreshes;
+	work.refresh_time += t - tcoarsen;
+	break;
+      default:
+	break;
+      }
+
+      const char* what[] = {"coarse operators", "refresh", "setup"};
+      QDPIO::cout << "MG_NATIVE: " << what[mode] << " of " << ops.size() << " coarse levels, time = "
+		  << t << " secs" << std::endl;
+
+      END_CODE();
+    }
+
+
+    // Near null vectors by MR relaxation of  M v = 0
+    void Hierarchy::fineNullVectors(SetupMode mode)
+    {
+      if (mode == Keep)
+	return;
+
+      int niter = param.RefreshIter;
+      if (mode == Generate)
+      {
+	niter = param.NullSolverMaxIter[0];
+	fine_nv.resize(param.NullVecs[0]);
+	for(int i=0; i < fine_nv.size(); ++i)
+	  gaussian(fine_nv[i]);
+      }
+
+      LatticeFermion chi = zero;
+      for(int i=0; i < fine_nv.size(); ++i)
+      {
+	InvMR(*M, chi, fine_nv[i], Real(1), Real(1.0e-10), niter, PLUS);
+	fine_nv[i] *= Real(1) / sqrt(norm2(fine_nv[i]));
+      }
+    }
+
+
+    // Near null vectors of a coarse level, starting from restricted random vectors
+    void Hierarchy::coarseNullVectors(int l, SetupMode mode)
+    {
+      if (mode == Keep)
+	return;
+
+      multi1d<CoarseVector>& nv = coarse_nv[l];
+
+      int niter = param.RefreshIter;
+      if (mode == Generate)
+      {
+	niter = param.NullSolverMaxIter[l+1];
+	nv.resize(param.NullVecs[l+1]);
+
+	LatticeFermion g;
+	for(int i=0; i < nv.size(); ++i)
+	{
+	  gaussian(g);
+	  fine->restrictTo(nv[i], g);
+	  for(int k=0; k < l; ++k)
+	  {
+	    CoarseVector t = nv[i];
+	    aggs[k]->restrictTo(nv[i], t);
+	  }
+	}
+      }
+
+      CoarseVector b;
+      for(int i=0; i < nv.size(); ++i)
+      {
+	zeroLike(b, nv[i]);
+	mrIterate(*ops[l], nv[i], b, niter);
+
+	const Double n = norm2(nv[i], all);
+	axpy(nv[i], cmplx(Double(1)/sqrt(n) - Double(1), Double(0)), nv[i], all);
+      }
+    }
+
+
+    // V-cycle on the fermion lattice
+    void Hierarchy::cycle(LatticeFermion& x, const LatticeFermion& b) const
+    {
+      x = zero;
+      mrIterate(*M, x, b, param.PreSmooth);
+
+      LatticeFermion r;
+      (*M)(r, x, PLUS);
+      r = b - r;
+
+      CoarseVector rc, ec;
+      fine->restrictTo(rc, r);
+      cycle(0, ec, rc);
+
+      LatticeFermion e;
+      fine->prolongate(e, ec);
+      x += e;
+
+      mrIterate(*M, x, b, param.PostSmooth);
+    }
+
+
+    // V-cycle on a coarse level
+    void Hierarchy::cycle(int l, CoarseVector& x, const CoarseVector& b) const
+    {
+      const CoarseLinOp& A = *ops[l];
+      zeroLike(x, b);
+
+      if (l == ops.size()-1)
+      {
+	fgcr(A, (const LinearOperator<CoarseVector>*)0, x, b,
+	     param.NKrylov, param.CoarseMaxIter, param.CoarseRsdTarget, std::string());
+	return;
+      }
+
+      mrIterate(A, x, b, param.PreSmooth);
+
+      CoarseVector r;
+      A(r, x, PLUS);
+      xmy(r, b, all);
+
+      CoarseVector rc, ec;
+      aggs[l]->restrictTo(rc, r);
+      cycle(l+1, ec, rc);
+
+      CoarseVector e;
+      aggs[l]->prolongate(e, ec);
+      axpy(x, cmplx(Double(1), Double(0)), e, all);
+
+      mrIterate(A, x, b, param.PostSmooth);
+    }
+
+
+    //----------------------------------------------------------------------------
+    // Apply the cycle on a subset
+    void Preconditioner::operator()(LatticeFermion& chi, const LatticeFermion& psi, enum PlusMinus isign) const
+    {
+      if (isign != PLUS)
+      {
+	QDPIO::cerr << "MG_NATIVE: preconditioner only implemented for PLUS" << std::endl;
+	QDP_abort(1);
+      }
+
+      if (s.numSiteTable() == Layout::sitesOnNode())
+      {
+	mg->cycle(chi, psi);
+	return;
+      }
+
+      LatticeFermion b = zero;
+      b[s] = psi;
+
+      LatticeFermion x;
+      mg->cycle(x, b);
+
+      chi = zero;
+      chi[s] = x;
+    }
+
+  } // namespace MGNative
+
+} // namespace Chroma
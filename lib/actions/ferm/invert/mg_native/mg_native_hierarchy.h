@@ -0,0 +1,135 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Level hierarchy and V-cycle of the native aggregation multigrid
+ */
+
+#ifndef __mg_native_hierarchy_h__
+#define __mg_native_hierarchy_h__
+
+#include "actions/ferm/invert/mg_native/mg_native_fine.h"
+#include "actions/ferm/invert/mg_native/mg_native_params.h"
+
+namespace Chroma
+{
+  namespace MGNative
+  {
+    //! Multigrid hierarchy
+    /*!
+     * \ingroup invert
+     *
+     * The fermion lattice with operator M, followed by one or two coarse
+     * levels. Level 0 is the first coarse level; aggs[l] maps level l onto
+     * level l+1 and ops[l] is the Galerkin operator of level l.
+     */
+    class Hierarchy
+    {
+    public:
+      //! Build the hierarchy: null vectors, prolongators and coarse operators
+      /*!
+       * \param M_          full lattice operator ( Read )
+       * \param param_      multigrid parameters ( Read )
+       * \param config_id_  fingerprint of M: its gauge field and params ( Read )
+       */
+      Hierarchy(Handle< LinearOperator<LatticeFermion> > M_,
+		const SysSolverMGNativeParams& param_,
+		const std::string& config_id_);
+
+      //! Adopt a new fine operator
+      /*!
+       * The coarse operators are rebuilt if the fingerprint of M (gauge
+       * field, mass, clover coefficients) changed. The null vectors are
+       * kept, unless a refresh or a rebuild was requested since the last
+       * update.
+       */
+      void update(Handle< LinearOperator<LatticeFermion> > M_,
+		  const std::string& config_id_);
+
+      //! Relax the present null vectors with a few smoothing steps at the next update
+      void requestRefresh() {pending = (pending == Generate) ? Generate : Relax;}
+
+      //! Regenerate the null vectors from scratch at the next update
+      void requestRebuild() {pending = Generate;}
+
+      //! Work done on the hierarchy
+      struct Stats_t
+      {
+	int     setups;          /*!< null vectors generated from scratch */
+	int     refreshes;       /*!< null vectors relaxed incrementally */
+	int     coarsenings;     /*!< coarse operators rebuilt */
+	double  setup_time;      /*!< seconds spent in setups */
+	double  refresh_time;    /*!< seconds spent in refreshes */
+	double  coarsen_time;    /*!< seconds spent in coarsening alone */
+      };
+
+      const Stats_t& stats() const {return work;}
+
+      //! Fine operator
+      const LinearOperator<LatticeFermion>& fineOp() const {return *M;}
+
+      //! One V-cycle on  M x = b  from a zero guess
+      void cycle(LatticeFermion& x, const LatticeFermion& b) const;
+
+    private:
+      //! What happens to the null vectors when the levels are rebuilt
+      enum SetupMode {Keep, Relax, Generate};
+
+      //! (Re)build the levels
+      void levels(SetupMode mode);
+
+      //! V-cycle on coarse level l
+      void cycle(int l, CoarseVector& x, const CoarseVector& b) const;
+
+      //! Near null vectors of the fermion lattice
+      void fineNullVectors(SetupMode mode);
+
+      //! Near null vectors of coarse level l
+      void coarseNullVectors(int l, SetupMode mode);
+
+      Handle< LinearOperator<LatticeFermion> > M;
+      SysSolverMGNativeParams param;
+      std::string config_id;
+      SetupMode pending;
+      Stats_t work;
+
+      Handle<FineAggregation> fine;
+      multi1d< Handle<CoarseAggregation> > aggs;
+      multi1d< Handle<CoarseLinOp> > ops;
+
+      multi1d<LatticeFermion> fine_nv;             /*!< relaxed null vectors of the fermion lattice */
+      multi1d< multi1d<CoarseVector> > coarse_nv;  /*!< relaxed null vectors of the coarse levels */
+    };
+
+
+    //----------------------------------------------------------------------------
+    //! The V-cycle as a preconditioner for an operator on a subset
+    /*!
+     * \ingroup invert
+     *
+     * For a full lattice operator this is the V-cycle. For an even-odd
+     * preconditioned operator, the cycle is applied to the source embedded
+     * on the full lattice and restricted back: the solution of  M x = (0, b)
+     * on the odd sites solves the Schur complement system. Normalisation
+     * differences between the two operators are absorbed by the flexible
+     * outer solver.
+     */
+    class Preconditioner : public LinearOperator<LatticeFermion>
+    {
+    public:
+      Preconditioner(Handle<Hierarchy> mg_, const Subset& s_) : mg(mg_), s(s_) {}
+
+      //! Apply
+      void operator()(LatticeFermion& chi, const LatticeFermion& psi, enum PlusMinus isign) const;
+
+      //! Subset of the outer operator
+      const Subset& subset() const {return s;}
+
+    private:
+      Handle<Hierarchy> mg;
+      const Subset& s;
+    };
+
+  } // namespace MGNative
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,125 @@
+/*! \file
+ *  \brief Parameters of the native aggregation multigrid
+ */
+
+#include "actions/ferm/invert/mg_native/mg_native_params.h"
+
+namespace Chroma
+{
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, SysSolverMGNativeParams& param)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "RsdTarget", param.RsdTarget);
+    read(paramtop, "MaxIter", param.MaxIter);
+
+    if (paramtop.count("NKrylov") > 0)
+      read(paramtop, "NKrylov", param.NKrylov);
+    else
+      param.NKrylov = 8;
+
+    read(paramtop, "Blocking", param.Blocking);
+    read(paramtop, "NullVecs", param.NullVecs);
+    read(paramtop, "NullSolverMaxIter", param.NullSolverMaxIter);
+
+    const int ncoarse = param.Blocking.size();
+    if (ncoarse < 1 || ncoarse > 2)
+    {
+      QDPIO::cerr << "MG_NATIVE: supports one or two coarsenings, found " << ncoarse << std::endl;
+      QDP_abort(1);
+    }
+
+    if (param.NullVecs.size() != ncoarse || param.NullSolverMaxIter.size() != ncoarse)
+    {
+      QDPIO::cerr << "MG_NATIVE: there are " << ncoarse << " blockings but "
+		  << param.NullVecs.size() << " NullVecs and "
+		  << param.NullSolverMaxIter.size() << " NullSolverMaxIter" << std::endl;
+      QDP_abort(1);
+    }
+
+    for(int l=0; l < ncoarse; ++l)
+    {
+      if (param.Blocking[l].size() != Nd)
+      {
+	QDPIO::cerr << "MG_NATIVE: Blocking of level " << l << " must have " << Nd << " entries" << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    read(paramtop, "PreSmooth", param.PreSmooth);
+    read(paramtop, "PostSmooth", param.PostSmooth);
+    read(paramtop, "CoarseMaxIter", param.CoarseMaxIter);
+    read(paramtop, "CoarseRsdTarget", param.CoarseRsdTarget);
+
+    if (paramtop.count("SubspaceId") > 0)
+      read(paramtop, "SubspaceId", param.SubspaceId);
+    else
+      param.SubspaceId = "";
+
+    if (paramtop.count("RefreshIter") > 0)
+      read(paramtop, "RefreshIter", param.RefreshIter);
+    else
+      param.RefreshIter = 5;
+
+    if (paramtop.count("ReplicatedCoarse") > 0)
+      read(paramtop, "ReplicatedCoarse", param.ReplicatedCoarse);
+    else
+      param.ReplicatedCoarse = false;
+
+    param.cloverP = false;
+    if (paramtop.count("CloverParams") > 0)
+    {
+      read(paramtop, "CloverParams", param.clovParams);
+      param.cloverP = true;
+    }
+  }
+
+  // Writer parameters
+  void write(XMLWriter& xml, const std::string& path, const SysSolverMGNativeParams& param)
+  {
+    push(xml, path);
+
+    write(xml, "invType", "MG_NATIVE");
+    write(xml, "RsdTarget", param.RsdTarget);
+    write(xml, "MaxIter", param.MaxIter);
+    write(xml, "NKrylov", param.NKrylov);
+    write(xml, "Blocking", param.Blocking);
+    write(xml, "NullVecs", param.NullVecs);
+    write(xml, "NullSolverMaxIter", param.NullSolverMaxIter);
+    write(xml, "PreSmooth", param.PreSmooth);
+    write(xml, "PostSmooth", param.PostSmooth);
+    write(xml, "CoarseMaxIter", param.CoarseMaxIter);
+    write(xml, "CoarseRsdTarget", param.CoarseRsdTarget);
+    write(xml, "SubspaceId", param.SubspaceId);
+    write(xml, "RefreshIter", param.RefreshIter);
+    write(xml, "ReplicatedCoarse", param.ReplicatedCoarse);
+    if (param.cloverP)
+      write(xml, "CloverParams", param.clovParams);
+
+    pop(xml);
+  }
+
+  //! Default constructor
+  SysSolverMGNativeParams::SysSolverMGNativeParams()
+  {
+    RsdTarget = zero;
+    MaxIter = 0;
+    NKrylov = 8;
+    PreSmooth = 0;
+    PostSmooth = 4;
+    CoarseMaxIter = 0;
+    CoarseRsdTarget = zero;
+    RefreshIter = 5;
+    ReplicatedCoarse = false;
+    cloverP = false;
+  }
+
+  //! Read parameters
+  SysSolverMGNativeParams::SysSolverMGNativeParams(XMLReader& xml, const std::string& path)
+  {
+    read(xml, path, *this);
+  }
+
+}
@@ -0,0 +1,57 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Parameters of the native aggregation multigrid
+ */
+
+#ifndef __mg_native_params_h__
+#define __mg_native_params_h__
+
+#include "chromabase.h"
+#include "actions/ferm/fermacts/clover_fermact_params_w.h"
+
+namespace Chroma
+{
+
+  //! Params of the native aggregation multigrid
+  /*! \ingroup invert */
+  struct SysSolverMGNativeParams
+  {
+    SysSolverMGNativeParams();
+    SysSolverMGNativeParams(XMLReader& in, const std::string& path);
+
+    Real          RsdTarget;           /*!< Target relative residual of the outer solver */
+    int           MaxIter;             /*!< Maximum outer iterations */
+    int           NKrylov;             /*!< Restart length of the outer flexible GCR */
+
+    multi1d< multi1d<int> > Blocking;  /*!< Sites per aggregate of each coarsening */
+    multi1d<int>  NullVecs;            /*!< Null vectors of each coarsening */
+    multi1d<int>  NullSolverMaxIter;   /*!< Relaxation steps on each null vector */
+
+    int           PreSmooth;           /*!< MR steps before the coarse correction */
+    int           PostSmooth;          /*!< MR steps after the coarse correction */
+    int           CoarseMaxIter;       /*!< Maximum GCR iterations on the coarsest level */
+    Real          CoarseRsdTarget;     /*!< Relative residual on the coarsest level */
+
+    std::string   SubspaceId;          /*!< Keep the hierarchy in the named object store under this id, if not empty */
+    int           RefreshIter;         /*!< Relaxation steps on each null vector when the hierarchy is refreshed */
+
+    bool          ReplicatedCoarse;    /*!< Run on more than one node anyway (testing only). The coarse
+					    levels are replicated on every node and each coarse apply
+					    is a global sum of a whole coarse vector, so they do not
+					    scale with the number of nodes */
+
+    bool          cloverP;             /*!< Build the fine operator from CloverParams */
+    CloverFermActParams clovParams;    /*!< Unpreconditioned clover operator to coarsen */
+  };
+
+
+  // Reader/writers
+  /*! \ingroup invert */
+  void read(XMLReader& xml, const std::string& path, SysSolverMGNativeParams& param);
+
+  /*! \ingroup invert */
+  void write(XMLWriter& xml, const std::string& path, const SysSolverMGNativeParams& param);
+
+} // End namespace
+
+#endif
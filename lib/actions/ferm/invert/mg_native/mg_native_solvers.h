@@ -0,0 +1,156 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Smoother and Krylov solver used on all levels of the native multigrid
+ *
+ *  The routines only need zeroLike, innerProduct, norm2, axpy, copy and
+ *  xmy on the vector type, so they serve both the fermion lattice and
+ *  the coarse levels.
+ */
+
+#ifndef __mg_native_solvers_h__
+#define __mg_native_solvers_h__
+
+#include "actions/ferm/invert/mg_native/mg_native_fine.h"
+#include "syssolver.h"
+
+namespace Chroma
+{
+  namespace MGNative
+  {
+    //! Minimal residual iterations
+    /*!
+     * \ingroup invert
+     *
+     * A fixed number of MR steps on  A x = b  starting from the given x.
+     * Used as the multigrid smoother and to relax the null vectors.
+     *
+     * \param A       linear operator ( Read )
+     * \param x       solution ( Modify )
+     * \param b       source ( Read )
+     * \param niter   number of steps ( Read )
+     */
+    template<typename V>
+    void mrIterate(const LinearOperator<V>& A, V& x, const V& b, int niter)
+    {
+      const Subset& s = A.subset();
+
+      V r, Ar;
+      A(r, x, PLUS);
+      xmy(r, b, s);                      // r = b - A x
+
+      for(int k=0; k < niter; ++k)
+      {
+	A(Ar, r, PLUS);
+
+	const Double nAr = norm2(Ar, s);
+	if (toBool(nAr == zero))
+	  break;
+
+	const DComplex a = innerProduct(Ar, r, s) / nAr;
+	axpy(x, a, r, s);
+	axpy(r, -a, Ar, s);
+      }
+    }
+
+
+    //! Flexible GCR
+    /*!
+     * \ingroup invert
+     *
+     * Solves  A x = b  by GCR restarted every nkrylov steps, with an
+     * optional preconditioner K that may change from one application to
+     * the next (e.g. a multigrid cycle). The residual is recomputed at
+     * every restart.
+     *
+     * \param A          linear operator ( Read )
+     * \param K          preconditioner, or 0 ( Read )
+     * \param x          guess on input, solution on output ( Modify )
+     * \param b          source ( Read )
+     * \param nkrylov    restart length ( Read )
+     * \param max_iter   maximum number of iterations ( Read )
+     * \param rsd        target relative residual ( Read )
+     * \param tag        prefix of the log output, or empty for none ( Read )
+     */
+    template<typename V>
+    SystemSolverResults_t fgcr(const LinearOperator<V>& A, const LinearOperator<V>* K,
+			       V& x, const V& b,
+			       int nkrylov, int max_iter, const Real& rsd,
+			       const std::string& tag)
+    {
+      const Subset& s = A.subset();
+      SystemSolverResults_t res;
+
+      const Double bnorm = norm2(b, s);
+      const Double target = Double(rsd) * Double(rsd) * bnorm;
+
+      multi1d<V> z(nkrylov);
+      multi1d<V> Az(nkrylov);
+
+      V r;
+      A(r, x, PLUS);
+      xmy(r, b, s);
+      Double rnorm = norm2(r, s);
+
+      int iter = 0;
+      bool stalled = false;
+      while (iter < max_iter && toBool(rnorm > target))
+      {
+	for(int j=0; j < nkrylov && iter < max_iter && toBool(rnorm > target); ++j)
+	{
+	  if (K)
+	    (*K)(z[j], r, PLUS);
+	  else
+	    copy(z[j], r, s);
+
+	  A(Az[j], z[j], PLUS);
+
+	  // Orthogonalise A z against the previous directions
+	  for(int i=0; i < j; ++i)
+	  {
+	    const DComplex beta = innerProduct(Az[i], Az[j], s);
+	    axpy(Az[j], -beta, Az[i], s);
+	    axpy(z[j], -beta, z[i], s);
+	  }
+
+	  const Double nAz = norm2(Az[j], s);
+	  if (toBool(nAz == zero))
+	  {
+	    stalled = true;
+	    break;
+	  }
+
+	  const DComplex sc = cmplx(Double(1) / sqrt(nAz) - Double(1), Double(0));
+	  axpy(Az[j], sc, Az[j], s);
+	  axpy(z[j], sc, z[j], s);
+
+	  const DComplex a = innerProduct(Az[j], r, s);
+	  axpy(x, a, z[j], s);
+	  axpy(r, -a, Az[j], s);
+
+	  rnorm = norm2(r, s);
+	  ++iter;
+
+	  if (tag.size() > 0)
+	    QDPIO::cout << tag << ": iter = " << iter
+			<< "  |r|/|b| = " << sqrt(rnorm / bnorm) << std::endl;
+	}
+
+	// True residual at the restart
+	A(r, x, PLUS);
+	xmy(r, b, s);
+	rnorm = norm2(r, s);
+
+	if (stalled)
+	  break;
+      }
+
+      res.n_count = iter;
+      res.resid   = sqrt(rnorm);
+      return res;
+    }
+
+  } // namespace MGNative
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,206 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by the native aggregation multigrid
+ */
+
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/mg_native/syssolver_linop_mg_native.h"
+#include "actions/ferm/invert/mg_native/mg_native_solvers.h"
+#include "util/gauge/gauge_fingerprint.h"
+#include "actions/ferm/linop/unprec_clover_linop_w.h"
+#include "meas/inline/io/named_objmap.h"
+#include <sstream>
+#include <iomanip>
+
+namespace Chroma
+{
+
+  //! Native multigrid system solver namespace
+  namespace LinOpSysSolverMGNativeEnv
+  {
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverMGNative(A, state, SysSolverMGNativeParams(xml_in, path));
+    }
+
+    //! Name to be used
+    const std::string name("MG_NATIVE");
+
+    //! Local registration flag
+    static bool registered = false;
+
+    //! Fingerprint of the operator the hierarchy is built from
+    /*!
+     * The gauge field checksum, the clover parameters if given, and the
+     * matrix element <eta|M|eta> of a fixed gaussian vector, which moves
+     * with the mass, the clover coefficients and anything else in M
+     */
+    std::string operatorId(const LinearOperator<LatticeFermion>& M,
+			   const SysSolverMGNativeParams& invParam,
+			   const multi1d<LatticeColorMatrix>& u)
+    {
+      std::ostringstream os;
+      os << gaugeFingerprint(u);
+
+      if (invParam.cloverP)
+      {
+	XMLBufferWriter xml;
+	write(xml, "CloverParams", invParam.clovParams);
+	os << ";" << xml.str();
+      }
+
+      // A fixed vector, without disturbing the random number stream
+      LatticeFermion eta, Meta;
+      {
+	QDP::Seed ran_seed;
+	QDP::RNG::savern(ran_seed);
+
+	QDP::Seed probe_seed;
+	probe_seed = 20090;
+	QDP::RNG::setrn(probe_seed);
+	gaussian(eta);
+
+	QDP::RNG::setrn(ran_seed);
+      }
+
+      M(Meta, eta, PLUS);
+      DComplex p = innerProduct(eta, Meta);
+
+      os << ";" << std::setprecision(15) << toDouble(real(p)) << ":" << toDouble(imag(p));
+      return os.str();
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  // Build the hierarchy
+  LinOpSysSolverMGNative::LinOpSysSolverMGNative(Handle< LinearOperator<T> > A_,
+						 Handle< FermState<T,P,Q> > state_,
+						 const SysSolverMGNativeParams& invParam_) :
+    A(A_), invParam(invParam_)
+  {
+    START_CODE();
+
+    // The coarse levels are replicated on every node, see MGNative::CoarseVector
+    if (Layout::numNodes() > 1)
+    {
+      if (! invParam.ReplicatedCoarse)
+      {
+	QDPIO::cerr << LinOpSysSolverMGNativeEnv::name 
+		    << ": the coarse levels are not distributed, every node holds the whole coarse lattice"
+		    << " and each coarse apply is a global sum of it. Set ReplicatedCoarse to run on "
+		    << Layout::numNodes() << " nodes anyway (testing only)" << std::endl;
+	QDP_abort(1);
+      }
+
+      QDPIO::cout << LinOpSysSolverMGNativeEnv::name 
+		  << ": WARNING: replicated coarse levels on " << Layout::numNodes() << " nodes" << std::endl;
+    }
+
+    Handle< LinearOperator<T> > M;
+    if (invParam.cloverP)
+    {
+      M = new UnprecCloverLinOp(state_, invParam.clovParams);
+    }
+    else if (A->subset().numSiteTable() == Layout::sitesOnNode())
+    {
+      M = A;
+    }
+    else
+    {
+      QDPIO::cerr << LinOpSysSolverMGNativeEnv::name 
+		  << ": the operator is preconditioned, so CloverParams are needed to build the hierarchy" << std::endl;
+      QDP_abort(1);
+    }
+
+    // Rebuild the coarse operators when the gauge field or the operator params change
+    const std::string config_id = LinOpSysSolverMGNativeEnv::operatorId(*M, invParam, state_->getLinks());
+
+    if (invParam.SubspaceId.empty())
+    {
+      mg = new MGNative::Hierarchy(M, invParam, config_id);
+    }
+    else if (TheNamedObjMap::Instance().check(invParam.SubspaceId))
+    {
+      QDPIO::cout << LinOpSysSolverMGNativeEnv::name << ": reusing subspace " << invParam.SubspaceId << std::endl;
+      mg = TheNamedObjMap::Instance().getData< Handle<MGNative::Hierarchy> >(invParam.SubspaceId);
+      mg->update(M, config_id);
+    }
+    else
+    {
+      mg = new MGNative::Hierarchy(M, invParam, config_id);
+
+      XMLBufferWriter file_xml;
+      push(file_xml, "FileXML");
+      pop(file_xml);
+
+      XMLBufferWriter record_xml;
+      push(record_xml, "RecordXML");
+      write(record_xml, "InvertParam", invParam);
+      pop(record_xml);
+
+      TheNamedObjMap::Instance().create< Handle<MGNative::Hierarchy> >(invParam.SubspaceId);
+      TheNamedObjMap::Instance().get(invParam.SubspaceId).setFileXML(file_xml);
+      TheNamedObjMap::Instance().get(invParam.SubspaceId).setRecordXML(record_xml);
+      TheNamedObjMap::Instance().getData< Handle<MGNative::Hierarchy> >(invParam.SubspaceId) = mg;
+    }
+
+    END_CODE();
+  }
+
+
+  // Outer flexible GCR preconditioned by the V-cycle
+  SystemSolverResults_t LinOpSysSolverMGNative::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    MGNative::Preconditioner K(mg, A->subset());
+
+    SystemSolverResults_t res = MGNative::fgcr(*A, &K, psi, chi,
+					       invParam.NKrylov, invParam.MaxIter, invParam.RsdTarget,
+					       LinOpSysSolverMGNativeEnv::name);
+
+    swatch.stop();
+
+    {
+      T r;
+      (*A)(r, psi, PLUS);
+      r[A->subset()] -= chi;
+      res.resid = sqrt(norm2(r, A->subset()));
+    }
+
+    QDPIO::cout << LinOpSysSolverMGNativeEnv::name << ": " << res.n_count << " iterations. Rsd = " << res.resid
+		<< " Relative Rsd = " << res.resid / sqrt(norm2(chi, A->subset())) << std::endl;
+    QDPIO::cout << LinOpSysSolverMGNativeEnv::name << ": time = " << swatch.getTimeInSeconds() << " secs" << std::endl;
+
+    if (res.n_count >= invParam.MaxIter && toBool(res.resid > invParam.RsdTarget * sqrt(norm2(chi, A->subset()))))
+    {
+      QDPIO::cerr << LinOpSysSolverMGNativeEnv::name << ": no convergence in " << invParam.MaxIter << " iterations" << std::endl;
+    }
+
+    END_CODE();
+
+    return res;
+  }
+
+}
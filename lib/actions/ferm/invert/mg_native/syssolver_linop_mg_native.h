@@ -0,0 +1,90 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by the native aggregation multigrid
+ */
+
+#ifndef __syssolver_linop_mg_native_h__
+#define __syssolver_linop_mg_native_h__
+
+#include "chroma_config.h"
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "state.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/mg_native/mg_native_params.h"
+#include "actions/ferm/invert/mg_native/mg_native_hierarchy.h"
+
+namespace Chroma
+{
+
+  //! Native multigrid system solver namespace
+  namespace LinOpSysSolverMGNativeEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a M*psi=chi linear system by the native aggregation multigrid
+  /*! \ingroup invert
+   *
+   * Flexible GCR on A, preconditioned by a V-cycle of a two or three level
+   * aggregation multigrid for Wilson-like fermions. The hierarchy is built
+   * from the unpreconditioned clover operator given by the CloverParams,
+   * or from A itself if A acts on the full lattice.
+   *
+   * With a SubspaceId the hierarchy lives in the named object store. A
+   * new solver then only rebuilds the coarse operators for its gauge
+   * field, and the null vectors are relaxed incrementally when the
+   * MG_4D_PREDICTOR of the same subspace asks for a refresh.
+   *
+   * Limitation: the coarse levels are not distributed. Every node holds
+   * every coarse vector on the whole coarse lattice, and each coarse
+   * apply is a global sum of it, so the coarse work and communication do
+   * not shrink with the number of nodes. The solver is meant for a single
+   * node; it stops on more than one unless ReplicatedCoarse is set.
+   */
+  class LinOpSysSolverMGNative : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    typedef LatticeFermion               T;
+    typedef multi1d<LatticeColorMatrix>  P;
+    typedef multi1d<LatticeColorMatrix>  Q;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param state_    Fermion state ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverMGNative(Handle< LinearOperator<T> > A_,
+			   Handle< FermState<T,P,Q> > state_,
+			   const SysSolverMGNativeParams& invParam_);
+
+    //! Destructor is automatic
+    ~LinOpSysSolverMGNative() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverMGNative() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverMGNativeParams invParam;
+    Handle<MGNative::Hierarchy> mg;
+  };
+
+} // End namespace
+
+#endif 
@@ -5,6 +5,7 @@
 
 #include "linearop.h"
 #include "actions/ferm/invert/minvcg2.h"
+#include "actions/ferm/invert/blas1_kernels.h"
 #undef PAT
 #ifdef PAT
 #include <pat_api.h>
@@ -247,6 +248,12 @@ namespace Chroma
     Double as;
     Double  bp;
     int k;
+
+    // Coefficients of the fused shifted updates
+    multi1d<bool> active(n_shift);
+    multi1d<R> zs_r(n_shift);
+    multi1d<R> as_r(n_shift);
+    multi1d<R> mbs_r(n_shift);
   
     for(k = 1; k <= MaxCG && !convP ; ++k)
     {
@@ -255,22 +262,26 @@ namespace Chroma
 
       // Update p
       R a_r = a;
-      p_0[sub] = r + a_r*p_0;                        flopcount.addSiteFlops(4*Nc*Ns,sub);
+      Blas1Kernels::xpay(p_0, r, a_r, sub);          flopcount.addSiteFlops(4*Nc*Ns,sub);
       //  p[k+1] := r[k+1] + a[k+1] p[k]; 
       //  Compute the shifted as */
       //  ps[k+1] := zs[k+1] r[k+1] + a[k+1] ps[k];
       for(s = 0; s < n_shift; ++s) {
 
-	  // Don't update other p-s if converged.
-	if( ! convsP[s] ) {
+	// Don't update other p-s if converged.
+	active[s] = ! convsP[s];
+	if( active[s] ) {
 
 	  as = a * z[iz][s]*bs[s] / (z[1-iz][s]*b);
-	  R zizs= z[iz][s];
-	  R as_r = as;
-	  p[s][sub] = zizs*r + as_r*p[s];  flopcount.addSiteFlops(6*Nc*Ns,sub);
+	  zs_r[s] = z[iz][s];
+	  as_r[s] = as;
+	  flopcount.addSiteFlops(6*Nc*Ns,sub);
 	}
       }
 
+      // All the shifted p in one pass over r
+      Blas1Kernels::multiAxpby(p, zs_r, r, as_r, active, sub);
+
       //  cp  =  | r[k] |**2 
       cp = c;
 
@@ -287,10 +298,9 @@ namespace Chroma
       bp = b;
       b = -cp/d;
       //  r[k+1] += b[k] A . p[k] ; 
-      b_r = b;
-      r[sub] += b_r*MMp;                                flopcount.addSiteFlops(4*Nc*Ns,sub);
       //  c  =  | r[k] |**2 
-      c = norm2(r,sub);	                                   flopcount.addSiteFlops(4*Nc*Ns,sub);
+      b_r = b;
+      c = Blas1Kernels::axpyNorm2(r, b_r, MMp, sub);      flopcount.addSiteFlops(8*Nc*Ns,sub);
 
       // Compute the shifted bs and z 
       iz = 1 - iz;
@@ -309,13 +319,13 @@ namespace Chroma
       //  Psi[k+1] -= b[k] p[k] ; 
       for(s = 0; s < n_shift; ++s) 
       {
-	if (! convsP[s] ) 
+	if (active[s]) 
 	{
-	  R bs_r = bs[s];
-
-	  psi[s][sub] -= bs_r*p[s];                 flopcount.addSiteFlops(2*Nc*Ns,sub);
+	  mbs_r[s] = -bs[s];
+	  flopcount.addSiteFlops(2*Nc*Ns,sub);
 	}
       }
+      Blas1Kernels::multiAxpy(psi, mbs_r, p, active, sub);
 
 
       //    IF |psi[k+1] - psi[k]| <= RsdCG |psi[k+1]| THEN RETURN;
@@ -0,0 +1,347 @@
+/*! \file
+ *  \brief Multiple right hand side multishift Conjugate-Gradient for a Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/minvcg2_block.h"
+#include "actions/ferm/invert/block_solver_utils.h"
+#include "actions/ferm/invert/blas1_kernels.h"
+
+namespace Chroma
+{
+
+  //! Multiple right hand side multishift CGNE for a Linear Operator
+  /*! \ingroup invert
+   *
+   * The algorithm for each right hand side is that of MInvCG2. The
+   * systems are advanced in lock-step and all the operator applications
+   * of one iteration go through a single call of the block operator.
+   *
+   * Local Variables (per active system j, belonging to source idx[j]):
+   *
+   *  x[j][s]    Solutions of the shifted systems
+   *  p_0[j]     Direction std::vector of the unshifted system
+   *  p[j][s]    Directions of the shifted systems
+   *  r[j]       Residual std::vector
+   *  c[j]       | r[k] |**2
+   *  b[j]       b[k]
+   *  zc[j][s]   Shifted residual factors of this iteration
+   *  zp[j][s]   ... and of the previous one
+   *  bs[j][s]   Shifted b
+   */
+  template<typename T, typename R>
+  multi1d<SystemSolverResults_t>
+  MInvCG2Block_a(const LinearOperator<T>& M,
+		 const multi1d<T>& chi,
+		 multi1d< multi1d<T> >& psi,
+		 const multi1d<R>& shifts,
+		 const multi1d<R>& RsdCG,
+		 int MaxCG)
+  {
+    START_CODE();
+
+    const Subset& sub = M.subset();
+    const int N = chi.size();
+    const int n_shift = shifts.size();
+
+    if (n_shift == 0 || RsdCG.size() != n_shift)
+    {
+      QDPIO::cerr << "MInvCG2Block: need at least one shift and one residual per shift" << std::endl;
+      QDP_abort(1);
+    }
+
+    multi1d<SystemSolverResults_t> res(N);
+
+    // All the psi have to be 0 to start, so the initial residual is chi
+    if (psi.size() != N)
+      psi.resize(N);
+
+    for(int i=0; i < N; ++i)
+    {
+      if (psi[i].size() < n_shift)
+	psi[i].resize(n_shift);
+
+      for(int s=0; s < n_shift; ++s)
+	psi[i][s][sub] = zero;
+    }
+
+    // The smallest shift decides the first convergence check
+    int isz = 0;
+    for(int s=1; s < n_shift; ++s)
+      if ( toBool( shifts[s] < shifts[isz] ) )
+	isz = s;
+
+    QDPIO::cout << "MInvCG2Block: starting with " << N << " right hand sides and "
+		<< n_shift << " shifts" << std::endl;
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    // Sources with zero norm have zero solutions
+    multi1d<int> idx(N);
+    multi1d<Double> chi_sq(N);
+    int n_act = 0;
+    for(int i=0; i < N; ++i)
+    {
+      chi_sq[i] = norm2(chi[i], sub);
+      res[i].n_count = 0;
+      res[i].resid   = sqrt(chi_sq[i]);
+
+      if ( toBool( sqrt(chi_sq[i]) >= fuzz ) )
+	idx[n_act++] = i;
+    }
+    flopcount.addSiteFlops(N*4*Nc*Ns,sub);
+    BlockSolverUtils::truncate(idx, n_act);
+
+    // State of the active systems
+    multi1d<T> r(n_act);
+    multi1d<T> p_0(n_act);
+    multi1d< multi1d<T> > p(n_act);
+    multi1d< multi1d<T> > x(n_act);
+    multi1d<T> Mp;
+    multi1d<T> MMp;
+
+    multi1d<Double> c(n_act);
+    multi1d<Double> b(n_act);
+    multi1d< multi1d<Double> > rsd_sq(n_act);
+    multi1d< multi1d<Double> > zc(n_act);
+    multi1d< multi1d<Double> > zp(n_act);
+    multi1d< multi1d<Double> > bs(n_act);
+    multi1d< multi1d<bool> > convsP(n_act);
+    multi1d<bool> convP(n_act);
+
+    // r[0] := p[0] := Chi
+    for(int j=0; j < n_act; ++j)
+    {
+      const T& chi_j = chi[idx[j]];
+
+      r[j][sub]   = chi_j;
+      p_0[j][sub] = chi_j;
+
+      p[j].resize(n_shift);
+      x[j].resize(n_shift);
+      rsd_sq[j].resize(n_shift);
+      zc[j].resize(n_shift);
+      zp[j].resize(n_shift);
+      bs[j].resize(n_shift);
+      convsP[j].resize(n_shift);
+
+      for(int s=0; s < n_shift; ++s)
+      {
+	p[j][s][sub] = chi_j;
+	rsd_sq[j][s] = chi_sq[idx[j]] * Double(RsdCG[s]) * Double(RsdCG[s]);
+	convsP[j][s] = false;
+      }
+    }
+
+    //  b[0] := - | r[0] |**2 / < p[0], Ap[0] >
+    M.applyBlock(Mp, p_0, PLUS);
+    M.applyBlock(MMp, Mp, MINUS);
+    flopcount.addFlops(2*n_act*M.nFlops());
+
+    for(int j=0; j < n_act; ++j)
+    {
+      const T& chi_j = chi[idx[j]];
+
+      Double d = norm2(Mp[j], sub);
+      b[j] = -chi_sq[idx[j]] / d;
+
+      //  r[1] += b[0] A . p[0];
+      R b_r = b[j];
+      c[j] = Blas1Kernels::axpyNorm2(r[j], b_r, MMp[j], sub);
+
+      //  The shifted bs and z, and  Psi[1] -= b[0] p[0] = - b[0] chi
+      for(int s=0; s < n_shift; ++s)
+      {
+	zp[j][s] = Double(1);
+	zc[j][s] = Double(1) / (Double(1) - Double(shifts[s])*b[j]);
+	bs[j][s] = b[j] * zc[j][s];
+
+	R bs_r = bs[j][s];
+	x[j][s][sub] = - bs_r*chi_j;
+      }
+
+      convP[j] = toBool( c[j] < rsd_sq[j][isz] );
+    }
+    flopcount.addSiteFlops(n_act*(12 + 2*n_shift)*Nc*Ns,sub);
+
+    // Coefficients of the fused shifted updates
+    multi1d<bool> active(n_shift);
+    multi1d<R> zs_r(n_shift);
+    multi1d<R> as_r(n_shift);
+    multi1d<R> mbs_r(n_shift);
+
+    multi1d<Double> a(n_act);
+    multi1d<Double> cp(n_act);
+
+    int k = 0;
+    for(;;)
+    {
+      // Retire the systems which have converged
+      {
+	int n_keep = 0;
+	multi1d<int> keep(idx.size());
+	for(int j=0; j < idx.size(); ++j)
+	{
+	  if ( convP[j] || k == MaxCG )
+	  {
+	    for(int s=0; s < n_shift; ++s)
+	      psi[idx[j]][s][sub] = x[j][s];
+
+	    res[idx[j]].n_count = k;
+	    res[idx[j]].resid   = sqrt(c[j]);
+	  }
+	  else
+	  {
+	    keep[n_keep++] = j;
+	  }
+	}
+
+	if (n_keep == 0)
+	  break;
+
+	if (n_keep < idx.size())
+	{
+	  BlockSolverUtils::truncate(keep, n_keep);
+
+	  BlockSolverUtils::compact(idx, keep);
+	  BlockSolverUtils::compact(r, keep);
+	  BlockSolverUtils::compact(p_0, keep);
+	  BlockSolverUtils::compact(p, keep);
+	  BlockSolverUtils::compact(x, keep);
+	  BlockSolverUtils::compact(c, keep);
+	  BlockSolverUtils::compact(cp, keep);
+	  BlockSolverUtils::compact(a, keep);
+	  BlockSolverUtils::compact(b, keep);
+	  BlockSolverUtils::compact(rsd_sq, keep);
+	  BlockSolverUtils::compact(zc, keep);
+	  BlockSolverUtils::compact(zp, keep);
+	  BlockSolverUtils::compact(bs, keep);
+	  BlockSolverUtils::compact(convsP, keep);
+	  BlockSolverUtils::compact(convP, keep);
+	}
+      }
+
+      ++k;
+      n_act = idx.size();
+
+      for(int j=0; j < n_act; ++j)
+      {
+	//  a[k+1] := |r[k]|**2 / |r[k-1]|**2
+	//  p[k+1] := r[k+1] + a[k+1] p[k]
+	a[j] = (k == 1) ? c[j] / chi_sq[idx[j]] : c[j] / cp[j];
+	R a_r = a[j];
+	Blas1Kernels::xpay(p_0[j], r[j], a_r, sub);
+
+	//  ps[k+1] := zs[k+1] r[k+1] + as[k+1] ps[k]
+	for(int s=0; s < n_shift; ++s)
+	{
+	  active[s] = ! convsP[j][s];
+	  if (active[s])
+	  {
+	    zs_r[s] = zc[j][s];
+	    as_r[s] = a[j] * zc[j][s]*bs[j][s] / (zp[j][s]*b[j]);
+	  }
+	}
+	Blas1Kernels::multiAxpby(p[j], zs_r, r[j], as_r, active, sub);
+
+	cp[j] = c[j];
+      }
+      flopcount.addSiteFlops(n_act*(4 + 6*n_shift)*Nc*Ns,sub);
+
+      //  Ap = A . p  for the whole block
+      M.applyBlock(Mp, p_0, PLUS);
+      M.applyBlock(MMp, Mp, MINUS);
+      flopcount.addFlops(2*n_act*M.nFlops());
+
+      for(int j=0; j < n_act; ++j)
+      {
+	//  b[k] := - | r[k] |**2 / < p[k], Ap[k] >
+	Double d = norm2(Mp[j], sub);
+	Double bp = b[j];
+	b[j] = -cp[j] / d;
+
+	//  r[k+1] += b[k] A . p[k] ;  c = | r[k+1] |**2
+	R b_r = b[j];
+	c[j] = Blas1Kernels::axpyNorm2(r[j], b_r, MMp[j], sub);
+
+	// The shifted bs and z
+	for(int s=0; s < n_shift; ++s)
+	{
+	  active[s] = ! convsP[j][s];
+	  if (active[s])
+	  {
+	    Double z0 = zc[j][s];
+	    Double z1 = zp[j][s];
+	    Double zn = z0*z1*bp;
+	    zn /= b[j]*a[j]*(z1-z0) + z1*bp*(Double(1) - Double(shifts[s])*b[j]);
+
+	    bs[j][s] = b[j]*zn/z0;
+	    zp[j][s] = z0;
+	    zc[j][s] = zn;
+	    mbs_r[s] = -bs[j][s];
+	  }
+	}
+
+	//  Psi[k+1] -= b[k] p[k]
+	Blas1Kernels::multiAxpy(x[j], mbs_r, p[j], active, sub);
+
+	// Converged when all the shifted residuals are small enough
+	convP[j] = true;
+	for(int s=0; s < n_shift; ++s)
+	{
+	  if (! convsP[j][s])
+	    convsP[j][s] = toBool( c[j] * zc[j][s]*zc[j][s] < rsd_sq[j][s] );
+
+	  convP[j] = convP[j] && convsP[j][s];
+	}
+      }
+      flopcount.addSiteFlops(n_act*(12 + 2*n_shift)*Nc*Ns,sub);
+    }
+
+    swatch.stop();
+    flopcount.report("minvcg2_block", swatch.getTimeInSeconds());
+
+    for(int i=0; i < N; ++i)
+    {
+      QDPIO::cout << "MInvCG2Block: rhs = " << i << "  " << res[i].n_count << " iterations" << std::endl;
+
+      if (res[i].n_count == MaxCG)
+	QDP_error_exit("too many CG iterationns: %d\n", res[i].n_count);
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  MInvCG2Block(const LinearOperator<LatticeFermionF>& M,
+	       const multi1d<LatticeFermionF>& chi,
+	       multi1d< multi1d<LatticeFermionF> >& psi,
+	       const multi1d<RealF>& shifts,
+	       const multi1d<RealF>& RsdCG,
+	       int MaxCG)
+  {
+    return MInvCG2Block_a(M, chi, psi, shifts, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  MInvCG2Block(const LinearOperator<LatticeFermionD>& M,
+	       const multi1d<LatticeFermionD>& chi,
+	       multi1d< multi1d<LatticeFermionD> >& psi,
+	       const multi1d<RealD>& shifts,
+	       const multi1d<RealD>& RsdCG,
+	       int MaxCG)
+  {
+    return MInvCG2Block_a(M, chi, psi, shifts, RsdCG, MaxCG);
+  }
+
+}  // end namespace Chroma
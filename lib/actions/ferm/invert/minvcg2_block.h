@@ -0,0 +1,65 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Multiple right hand side multishift Conjugate-Gradient for a Linear Operator
+ */
+
+#ifndef __minvcg2_block_h__
+#define __minvcg2_block_h__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma 
+{
+
+  //! Multiple right hand side multishift CGNE for a Linear Operator
+  /*! \ingroup invert
+   * Solves the set of linear equations
+   *
+   *   	    Chi[i]  =  ( M^dag . M + shift[s] ) . Psi[i][s]
+   *
+   * for all right hand sides i and shifts s. Each right hand side carries
+   * its own multishift recurrence exactly as in MInvCG2, but the operator
+   * is applied to the search directions of all the still unconverged
+   * systems in one call of the block operator
+   *
+   *     M.applyBlock(multi1d<T>& chi, const multi1d<T>& psi, isign)
+   *
+   * so that an operator with a fused multi-vector apply reads the gauge
+   * field once per iteration for all right hand sides. Right hand sides
+   * drop out of the block as all their shifts converge.
+   *
+   *  \param M       Linear Operator    	                (Read)
+   *  \param chi     Sources	                        (Read)
+   *  \param psi     Solutions, psi[i][s]                 (Write)
+   *  \param shifts  shifts of form  M^dag M + shift        (Read)
+   *  \param RsdCG   residual accuracy, one per shift       (Read)
+   *  \param MaxCG   Maximum CG iterations                  (Read)
+   *  \return res    System solver results, one per right hand side
+   *
+   * @{
+   */
+
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  MInvCG2Block(const LinearOperator<LatticeFermionF>& M,
+	       const multi1d<LatticeFermionF>& chi,
+	       multi1d< multi1d<LatticeFermionF> >& psi,
+	       const multi1d<RealF>& shifts,
+	       const multi1d<RealF>& RsdCG,
+	       int MaxCG);
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  MInvCG2Block(const LinearOperator<LatticeFermionD>& M,
+	       const multi1d<LatticeFermionD>& chi,
+	       multi1d< multi1d<LatticeFermionD> >& psi,
+	       const multi1d<RealD>& shifts,
+	       const multi1d<RealD>& RsdCG,
+	       int MaxCG);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
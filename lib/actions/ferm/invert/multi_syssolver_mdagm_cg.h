@@ -13,6 +13,7 @@
 #include "actions/ferm/invert/multi_syssolver_cg_params.h"
 #include "actions/ferm/invert/minvcg.h"
 #include "actions/ferm/invert/minvcg2.h"
+#include "actions/ferm/invert/minvcg2_block.h"
 #include "init/chroma_init.h"
 
 namespace Chroma
@@ -59,20 +60,7 @@ namespace Chroma
       {
 	START_CODE();
 
-	multi1d<Real> RsdCG(shifts.size());
-	if (invParam.RsdCG.size() == 1)
-	{
-	  RsdCG = invParam.RsdCG[0];
-	}
-	else if (invParam.RsdCG.size() == RsdCG.size())
-	{
-	  RsdCG = invParam.RsdCG;
-	}
-	else
-	{
-	  QDPIO::cerr << "MdagMMultiSysSolverCG: shifts incompatible" << std::endl;
-	  QDP_abort(1);
-	}
+	multi1d<Real> RsdCG = rsdCG(shifts);
 
 	SystemSolverResults_t res;
   	MInvCG2(*A, chi, psi, shifts, RsdCG, invParam.MaxCG, res.n_count);
@@ -102,11 +90,55 @@ namespace Chroma
 	return res;
       }
 
+    //! Solve the linear systems for a block of right hand sides
+    /*!
+     * All the right hand sides share the operator applications of one
+     * block multishift CG.
+     *
+     * \param psi      solutions psi[i][s] ( Modify )
+     * \param shifts   shifts ( Read )
+     * \param chi      sources ( Read )
+     * \return syssolver results, one per source
+     */
+    multi1d<SystemSolverResults_t> solveBlock (multi1d< multi1d<T> >& psi, 
+					       const multi1d<Real>& shifts, 
+					       const multi1d<T>& chi) const
+      {
+	START_CODE();
+
+	multi1d<Real> RsdCG = rsdCG(shifts);
+	multi1d<SystemSolverResults_t> res = MInvCG2Block(*A, chi, psi, shifts, RsdCG, invParam.MaxCG);
+
+	END_CODE();
+
+	return res;
+      }
+
 
   private:
     // Hide default constructor
     MdagMMultiSysSolverCG() {}
 
+    //! One residual per shift
+    multi1d<Real> rsdCG(const multi1d<Real>& shifts) const
+      {
+	multi1d<Real> RsdCG(shifts.size());
+	if (invParam.RsdCG.size() == 1)
+	{
+	  RsdCG = invParam.RsdCG[0];
+	}
+	else if (invParam.RsdCG.size() == RsdCG.size())
+	{
+	  RsdCG = invParam.RsdCG;
+	}
+	else
+	{
+	  QDPIO::cerr << "MdagMMultiSysSolverCG: shifts incompatible" << std::endl;
+	  QDP_abort(1);
+	}
+	return RsdCG;
+      }
+
     Handle< LinearOperator<T> > A;
     MultiSysSolverCGParams invParam;
   };
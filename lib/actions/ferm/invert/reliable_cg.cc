@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/reliable_cg.h"
+#include "actions/ferm/invert/fixed16_fermion.h"
 
 namespace Chroma {
 
@@ -189,6 +190,185 @@ RelInvCG_a(const LinearOperator<T>& A,
 
 
 
+  //! Reliable CG with the inner vectors in 16 bit fixed point
+  /*!
+   * Same iteration as RelInvCG_a. The residual r lives in Fixed16Fermion
+   * storage, the search direction p (the operator's input) and the
+   * partial solution x in single precision. x, r and the norm of r are
+   * updated in one pass over the sites. x is not compressed: its
+   * rounding errors would add up over the iterations between reliable
+   * updates, while those of r are corrected at each of them.
+   */
+SystemSolverResults_t
+RelInvCGFixed16_a(const LinearOperator<LatticeFermionD>& A,
+		  const LinearOperator<LatticeFermionF>& AF,
+		  const LatticeFermionD& chi,
+		  LatticeFermionD& psi,
+		  const Real& RsdCG,
+		  const Real& Delta,
+		  int MaxCG)
+  {
+    START_CODE();
+    typedef LatticeFermionD T;
+    typedef LatticeFermionF TF;
+    typedef RealF RF;
+
+    SystemSolverResults_t ret;
+
+    const Subset& s = A.subset();
+    
+    bool convP = false;
+
+    Fixed16Fermion r;
+    TF x;
+    T b; 
+    T r_dble;
+    T x_dble;
+    TF tmp_f;
+    int k;
+    int rupdates = 0;
+
+    StopWatch swatch;
+    FlopCounter flopcount;
+    flopcount.reset();
+    swatch.reset();
+    swatch.start();
+
+    b[s] = chi;
+    Double chi_norm = norm2(chi,s);
+    Double rsd_sq=RsdCG*RsdCG*chi_norm;
+
+    {
+      T tmp1, tmp2;
+      A(tmp1, psi, PLUS);
+      A(tmp2, tmp1, MINUS);
+      b[s] -= tmp2;
+      flopcount.addFlops(2*A.nFlops());
+      flopcount.addSiteFlops(2*Nc*Ns,s);
+    }
+
+    x[s] = zero;
+ 
+    // r = chi - A psi
+    tmp_f[s] = b;
+    r.pack(tmp_f, s);
+
+    Double r_sq = norm2(b,s);
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    QDPIO::cout << "Reliable CG (fixed16): || r0 ||/|| b ||=" << sqrt(r_sq/chi_norm) << std::endl;
+
+    Double rNorm = sqrt(r_sq);
+    Double r0Norm = rNorm;
+    Double maxrx = rNorm;
+    Double maxrr = rNorm;
+    bool updateR = false;
+    bool updateX = false;
+
+    TF p, mp, mmp;
+    Double a, c, d;
+
+    // The iterations 
+    for(k = 0; k < MaxCG && !convP; k++) { 
+      if( k == 0 ) { 
+	r.unpack(p, s);
+      }
+      else { 
+	Double beta = r_sq / c;
+	RF br = beta;
+	Fixed16Kernels::xpay(p, r, br, s);  flopcount.addSiteFlops(4*Nc*Ns,s);
+      }
+
+      c = r_sq;
+
+      AF(mp, p, PLUS); 
+      d = norm2(mp,s); 
+      AF(mmp,mp,MINUS); 
+
+      a = c/d;
+      RF ar = a;
+
+      // x += a p ; r -= a mmp ; r_sq = |r|^2
+      Fixed16Kernels::cgUpdate(x, r, p, mmp, ar, r_sq, s);
+
+      flopcount.addSiteFlops(16*Nc*Ns,s);
+      flopcount.addFlops(2*A.nFlops());
+
+      // Reliable update part...
+      rNorm = sqrt(r_sq);
+      if( toBool( rNorm > maxrx) ) maxrx = rNorm;
+      if( toBool( rNorm > maxrr) ) maxrr = rNorm;
+      
+      updateX = toBool ( rNorm < Delta*r0Norm && r0Norm <= maxrx );
+      updateR = toBool ( rNorm < Delta*maxrr && r0Norm <= maxrr ) || updateX;
+
+      // Do the R update with real DP residual
+      if( updateR ) { 
+	rupdates++;
+
+	{
+	  T tmp1,tmp2;
+	  x_dble[s] = x;
+	  
+	  A(tmp1, x_dble, PLUS); // Use full solution so far
+	  A(tmp2, tmp1, MINUS); 
+
+	  r_dble[s] = b - tmp2;
+	}
+
+	tmp_f[s] = r_dble;     // new R = b - Ax
+	r.pack(tmp_f, s);
+	r_sq = norm2(r_dble,s);
+
+	flopcount.addSiteFlops(6*Nc*Ns,s);
+	flopcount.addFlops(2*A.nFlops());
+
+	rNorm = sqrt(r_sq);
+	maxrr = rNorm;
+	
+	// Group wise x update
+	if( updateX ) { 
+	  psi[s] += x_dble; // x_dble is set above since updateR is true
+	  flopcount.addSiteFlops(2*Nc*Ns,s);
+
+	  x[s] = zero;
+	  b[s] = r_dble;
+	  r0Norm = rNorm;
+	  maxrx = rNorm;
+	}
+      }
+
+      // Convergence check
+      if( toBool(r_sq < rsd_sq ) ) {
+	x_dble[s] = x;
+	psi[s] += x_dble;
+	flopcount.addSiteFlops(2*Nc*Ns,s);
+	ret.resid = rNorm;
+	ret.n_count = k;
+	convP = true;
+      }
+      else { 
+	convP = false;
+      }
+    }
+
+    // Loop is finished. Report FLOP Count...
+    swatch.stop();
+    QDPIO::cout << "reliable_invcg2_fixed16: n_count " << k << " r-updates: " << rupdates << std::endl;
+    flopcount.report("reliable_invcg2_fixed16", swatch.getTimeInSeconds());
+
+    // Check for nonconvergence
+    if( k >= MaxCG && !convP ) { 
+      QDPIO::cout << "Nonconvergence: Reliable CG (fixed16) Failed to converge in " << MaxCG << " iterations " << std::endl;
+      QDP_abort(1);
+    }
+
+    END_CODE();
+    return ret;
+  }
+
+
+
 SystemSolverResults_t
 InvCGReliable(const LinearOperator<LatticeFermionF>& A,
 	      const LatticeFermionF& chi,
@@ -226,5 +406,18 @@ InvCGReliable(const LinearOperator<LatticeFermionD>& A,
   return RelInvCG_a<LatticeFermionD, LatticeFermionF, RealF>(A,AF, chi, psi, RsdCG, Delta, MaxCG);
 }
 
+  // single double, fixed point inner vectors
+SystemSolverResults_t
+InvCGReliableFixed16(const LinearOperator<LatticeFermionD>& A,
+		     const LinearOperator<LatticeFermionF>& AF,
+		     const LatticeFermionD& chi,
+		     LatticeFermionD& psi,
+		     const Real& RsdCG, 
+		     const Real& Delta,
+		     int MaxCG)
+{
+  return RelInvCGFixed16_a(A, AF, chi, psi, RsdCG, Delta, MaxCG);
+}
+
 
 }  // end namespace Chroma
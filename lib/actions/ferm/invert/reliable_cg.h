@@ -46,6 +46,22 @@ namespace Chroma
 		int MaxCG);
   
 
+  // single double, with the inner vectors in 16 bit fixed point
+  /*!
+   * The inner iterations keep the residual as Fixed16Fermion; the
+   * search direction handed to AF and the accumulated solution are
+   * LatticeFermionF. Reliable updates are in double.
+   */
+  SystemSolverResults_t
+  InvCGReliableFixed16(const LinearOperator<LatticeFermionD>& A,
+		       const LinearOperator<LatticeFermionF>& AF,
+		       const LatticeFermionD& chi,
+		       LatticeFermionD& psi,
+		       const Real& RsdCG, 
+		       const Real& Delta,
+		       int MaxCG);
+
+
   /*! @} */  // end of group invert
 	    
 }  // end namespace Chroma
@@ -32,6 +32,27 @@ namespace Chroma
   }
 
 
+  //! Deflation store output
+  void write(XMLWriter& xml, const std::string& path, const SysSolverEigCGParams::DeflationStore_t& input){
+    push(xml, path);
+
+    write(xml, "file_name", input.file_name);
+    write(xml, "space_id", input.space_id);
+
+    pop(xml);
+  }
+
+
+  //! Deflation store input
+  void read(XMLReader& xml, const std::string& path, SysSolverEigCGParams::DeflationStore_t& input){
+    XMLReader inputtop(xml, path);
+
+    input.enabled = true;
+    read(inputtop, "file_name", input.file_name);
+    read(inputtop, "space_id", input.space_id);
+  }
+
+
   // Read parameters
   void read(XMLReader& xml, const std::string& path, SysSolverEigCGParams& param)
   {
@@ -82,6 +103,10 @@ namespace Chroma
       read(paramtop, "FileIO", param.file);
     }
 
+    if(paramtop.count("DeflationStore")!=0){
+      read(paramtop, "DeflationStore", param.store);
+    }
+
   }
 
   // Writer parameters
@@ -108,6 +133,9 @@ namespace Chroma
 
     write(xml, "FileIO",param.file);
 
+    if (param.store.enabled)
+      write(xml, "DeflationStore", param.store);
+
     pop(xml);
   }
 
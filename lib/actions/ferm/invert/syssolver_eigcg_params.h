@@ -61,6 +61,13 @@ namespace Chroma
       QDP_volfmt_t  file_volfmt;
     } file;
 
+    struct DeflationStore_t
+    {
+      bool          enabled ;     /*!< keep the Ritz pairs in a disk store */
+      std::string   file_name;    /*!< MapObjectDisk file */
+      std::string   space_id;     /*!< label of the operator, e.g. action and mass */
+    } store;
+
     void defaults(){
       RsdCG = 1.0e-8;
       MaxCG = 1000;
@@ -82,6 +89,8 @@ namespace Chroma
       file.read   = false;
       file.write  = false;
 
+      store.enabled = false;
+
       //These work only with old version of EigCG where the vPrecCG exists
       vPrecCGvecs = 0;
       vPrecCGvecStart =0;
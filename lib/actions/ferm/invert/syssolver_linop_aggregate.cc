@@ -14,10 +14,14 @@
 #include "actions/ferm/invert/syssolver_linop_eigcg.h"
 #include "actions/ferm/invert/syssolver_linop_eigbicg.h"
 #include "actions/ferm/invert/syssolver_linop_richardson_multiprec_clover.h"
+#include "actions/ferm/invert/syssolver_linop_mixed_prec_richardson.h"
 #include "actions/ferm/invert/syssolver_linop_rel_bicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_linop_rel_ibicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_linop_rel_cg_clover.h"
 #include "actions/ferm/invert/syssolver_linop_fgmres_dr.h"
+#include "actions/ferm/invert/syssolver_linop_block_cg.h"
+#include "actions/ferm/invert/syssolver_linop_block_bicgstab.h"
+#include "actions/ferm/invert/mg_native/syssolver_linop_mg_native.h"
 
 
 #include "chroma_config.h"
@@ -70,10 +74,14 @@ namespace Chroma
 	success &= LinOpSysSolverEigCGEnv::registerAll();
 	success &= LinOpSysSolverEigBiCGEnv::registerAll();
 	success &= LinOpSysSolverRichardsonCloverEnv::registerAll();
+	success &= LinOpSysSolverMixedPrecRichardsonEnv::registerAll();
 	success &= LinOpSysSolverReliableBiCGStabCloverEnv::registerAll();
 	success &= LinOpSysSolverReliableIBiCGStabCloverEnv::registerAll();
 	success &= LinOpSysSolverReliableCGCloverEnv::registerAll();
 	success &= LinOpSysSolverFGMRESDREnv::registerAll();
+	success &= LinOpSysSolverBlockCGEnv::registerAll();
+	success &= LinOpSysSolverBlockBiCGStabEnv::registerAll();
+	success &= LinOpSysSolverMGNativeEnv::registerAll();
 
 #ifdef BUILD_QUDA
 	success &= LinOpSysSolverQUDACloverEnv::registerAll();
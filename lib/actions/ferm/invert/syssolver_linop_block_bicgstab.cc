@@ -0,0 +1,58 @@
+/*! \file
+ *  \brief Solve M*psi=chi linear systems for several right hand sides by BICGSTAB
+ */
+#include "state.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_linop_block_bicgstab.h"
+
+namespace Chroma
+{
+
+  //! Block BICGSTAB system solver namespace
+  namespace LinOpSysSolverBlockBiCGStabEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Name to be used
+      const std::string name("BLOCK_BICGSTAB_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverBlockBiCGStab<LatticeFermion>(A, SysSolverBiCGStabParams(xml_in, path));
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermionF>* createFermF(XMLReader& xml_in,
+						    const std::string& path,
+						    Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+						    Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new LinOpSysSolverBlockBiCGStab<LatticeFermionF>(A, SysSolverBiCGStabParams(xml_in, path));
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	success &= Chroma::TheLinOpFFermSystemSolverFactory::Instance().registerObject(name, createFermF);
+	registered = true;
+      }
+      return success;
+    }
+  }
+}
@@ -0,0 +1,138 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve M*psi=chi linear systems for several right hand sides by BICGSTAB
+ */
+
+#ifndef __syssolver_linop_block_bicgstab_h__
+#define __syssolver_linop_block_bicgstab_h__
+#include "chroma_config.h"
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_bicgstab_params.h"
+#include "actions/ferm/invert/invbicgstab_block.h"
+
+
+namespace Chroma
+{
+
+  //! Block BICGSTAB system solver namespace
+  namespace LinOpSysSolverBlockBiCGStabEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve M*psi=chi linear systems for several right hand sides by BICGSTAB
+  /*! \ingroup invert
+   *
+   * The right hand sides are solved together, applying the operator
+   * to all of them in one sweep. A single right hand side is solved
+   * as a block of length one.
+   */
+  template<typename T>
+  class LinOpSysSolverBlockBiCGStab : public LinOpSystemSolver<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverBlockBiCGStab(Handle< LinearOperator<T> > A_,
+			  const SysSolverBiCGStabParams& invParam_) : 
+      A(A_), invParam(invParam_) 
+      {}
+
+    //! Destructor is automatic
+    ~LinOpSysSolverBlockBiCGStab() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solve the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	multi1d<T> psi_b(1);
+	multi1d<T> chi_b(1);
+	psi_b[0] = psi;
+	chi_b[0] = chi;
+
+	multi1d<SystemSolverResults_t> res = solveBlock(psi_b, chi_b);
+	psi = psi_b[0];
+
+	return res[0];
+      }
+
+    //! Solve the linear systems
+    /*!
+     * \param psi      solutions ( Modify )
+     * \param chi      sources ( Read )
+     * \return syssolver results, one per source
+     */
+    multi1d<SystemSolverResults_t> solveBlock (multi1d<T>& psi, const multi1d<T>& chi) const
+      {
+	START_CODE();
+	StopWatch swatch;
+	swatch.reset();
+	swatch.start();
+
+	const Subset& s = A->subset();
+
+	if (psi.size() != chi.size())
+	{
+	  psi.resize(chi.size());
+	  for(int i=0; i < psi.size(); ++i)
+	    psi[i] = zero;
+	}
+
+	// For now solve with PLUS until we add a way to explicitly
+	// ask for MINUS
+	multi1d<SystemSolverResults_t> res = InvBiCGStabBlock(*A, chi, psi, 
+							      invParam.RsdBiCGStab, 
+							      invParam.MaxBiCGStab, 
+							      PLUS);
+
+	swatch.stop();
+	double time = swatch.getTimeInSeconds();
+
+	{
+	  multi1d<T> tmp;
+	  A->applyBlock(tmp, psi, PLUS);
+
+	  for(int i=0; i < chi.size(); ++i)
+	  {
+	    T r;
+	    r[s] = chi[i] - tmp[i];
+	    res[i].resid = sqrt(norm2(r, s));
+
+	    QDPIO::cout << "BLOCK_BICGSTAB_SOLVER: rhs = " << i << " : " << res[i].n_count << " iterations. Rsd = " << res[i].resid << " Relative Rsd = " << res[i].resid/sqrt(norm2(chi[i],s)) << std::endl;
+	  }
+	}
+	QDPIO::cout << "BLOCK_BICGSTAB_SOLVER_TIME: "<<time<< " sec for " << chi.size() << " rhs" << std::endl;
+
+	END_CODE();
+
+	return res;
+      }
+
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverBlockBiCGStab() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverBiCGStabParams invParam;
+  };
+
+} // End namespace
+
+#endif 
+
@@ -0,0 +1,218 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by mixed precision Richardson iteration
+ */
+
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+#include "actions/ferm/invert/syssolver_linop_mixed_prec_richardson.h"
+
+namespace Chroma
+{
+  namespace LinOpSysSolverMixedPrecRichardsonEnv
+  {
+
+    //! Anonymous namespace
+    namespace
+    {
+      //! Name to be used
+      const std::string name("MIXED_PRECISION_RICHARDSON");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverMixedPrecRichardson(A, state, SysSolverMixedPrecRichardsonParams(xml_in, path));
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  // Constructor
+  LinOpSysSolverMixedPrecRichardson::LinOpSysSolverMixedPrecRichardson(Handle< LinearOperator<T> > A_,
+								       Handle< FermState<T,Q,Q> > state_,
+								       const SysSolverMixedPrecRichardsonParams& invParam_) : 
+    A(A_), invParam(invParam_) 
+  {
+    START_CODE();
+
+    // The links already carry the boundary conditions, so the copy is periodic
+    QF links_single(Nd);
+    const Q& links = state_->getLinks();
+    for(int mu=0; mu < Nd; mu++)
+      links_single[mu] = links[mu];
+
+    Handle< FermState<TF,QF,QF> > fstate_single(new PeriodicFermState<TF,QF,QF>(links_single));
+
+    if (! invParam.cloverP)
+    {
+      QDPIO::cerr << "MIXED_PRECISION_RICHARDSON: no single precision operator for this action."
+		  << " CloverParams are required" << std::endl;
+      QDP_abort(1);
+    }
+
+    A_single = new EvenOddPrecDumbCloverFLinOp(fstate_single, invParam.clovParams);
+    checkSinglePrec();
+
+    std::istringstream is(invParam.innerSolverParams.xml);
+    XMLReader paramtop(is);
+
+    DInv = TheLinOpFFermSystemSolverFactory::Instance().createObject(invParam.innerSolverParams.id,
+								     paramtop, 
+								     invParam.innerSolverParams.path,
+								     fstate_single, 
+								     A_single);
+
+    END_CODE();
+  }
+
+
+  // Compare the two operators
+  void
+  LinOpSysSolverMixedPrecRichardson::checkSinglePrec() const
+  {
+    START_CODE();
+
+    const Subset& s = A->subset();
+    if (&(A_single->subset()) != &s)
+    {
+      QDPIO::cerr << "MIXED_PRECISION_RICHARDSON: the single precision clover operator"
+		  << " and the operator to invert act on different subsets" << std::endl;
+      QDP_abort(1);
+    }
+
+    // Leave the random number stream as it was
+    QDP::Seed ran_seed;
+    QDP::RNG::savern(ran_seed);
+
+    T psi, chi;
+    psi = zero;
+    gaussian(psi, s);
+    QDP::RNG::setrn(ran_seed);
+
+    TF psi_single, chi_single;
+    psi_single[s] = psi;
+
+    Double rel_diff = zero;
+    for(int i=0; i < 2; ++i)
+    {
+      enum PlusMinus isign = (i == 0) ? PLUS : MINUS;
+
+      (*A)(chi, psi, isign);
+      (*A_single)(chi_single, psi_single, isign);
+
+      T diff;
+      diff[s] = chi_single;
+      diff[s] -= chi;
+      Double d = sqrt(norm2(diff, s) / norm2(chi, s));
+      if (toBool(d > rel_diff))
+	rel_diff = d;
+    }
+
+    QDPIO::cout << "MIXED_PRECISION_RICHARDSON: |A_single - A| / |A| on a random vector = " 
+		<< rel_diff << std::endl;
+
+    // Single precision rounding is of order 1e-7
+    if (toBool(rel_diff > Double(1.0e-4)))
+    {
+      QDPIO::cerr << "MIXED_PRECISION_RICHARDSON: the CloverParams do not describe the operator to invert."
+		  << " Relative difference = " << rel_diff << std::endl;
+      QDP_abort(1);
+    }
+
+    END_CODE();
+  }
+
+
+  // Solve
+  SystemSolverResults_t
+  LinOpSysSolverMixedPrecRichardson::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+
+    SystemSolverResults_t res;
+    res.n_count = 0;
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    const Subset& s = A->subset();
+
+    // Target residue
+    Double chi_sq = norm2(chi, s);
+    Double rsd_t  = Double(invParam.RsdTarget)*Double(invParam.RsdTarget)*chi_sq;
+
+    // r = chi - A psi
+    T r, tmp;
+    (*A)(tmp, psi, PLUS);
+    r[s] = chi - tmp;
+
+    Double rnorm = norm2(r, s);
+    int k = 0;
+    int n_inner = 0;
+
+    while( toBool(rnorm > rsd_t) && k < invParam.MaxIter )
+    {
+      ++k;
+
+      // Solve  A dx = r  in single precision
+      TF r_single, dx_single;
+      r_single[s]  = r;
+      dx_single[s] = zero;
+
+      SystemSolverResults_t res_inner = (*DInv)(dx_single, r_single);
+      n_inner += res_inner.n_count;
+
+      // Correct in full precision
+      T dx;
+      dx[s] = dx_single;
+      psi[s] += dx;
+
+      // Recompute the true residue, so the single precision errors do not accumulate
+      (*A)(tmp, psi, PLUS);
+      r[s] = chi - tmp;
+      rnorm = norm2(r, s);
+
+      QDPIO::cout << "MIXED_PRECISION_RICHARDSON: outer iter " << k 
+		  << "  inner iters = " << res_inner.n_count
+		  << "  || r || / || chi || = " << sqrt(rnorm/chi_sq) << std::endl;
+    }
+
+    swatch.stop();
+
+    res.n_count = n_inner;
+    res.resid   = sqrt(rnorm);
+
+    if (toBool(rnorm > rsd_t))
+    {
+      QDPIO::cout << "MIXED_PRECISION_RICHARDSON: NONCONVERGENCE after " << k << " outer iterations" << std::endl;
+    }
+
+    QDPIO::cout << "MIXED_PRECISION_RICHARDSON_SOLVER: " << k << " outer, " << n_inner 
+		<< " inner iterations. Rsd = " << res.resid 
+		<< " Relative Rsd = " << sqrt(rnorm/chi_sq) << std::endl;
+    QDPIO::cout << "MIXED_PRECISION_RICHARDSON_SOLVER_TIME: " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+    return res;
+  }
+
+}
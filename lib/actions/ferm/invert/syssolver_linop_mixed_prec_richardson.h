@@ -0,0 +1,102 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by mixed precision Richardson iteration
+ */
+
+#ifndef __syssolver_linop_mixed_prec_richardson_h__
+#define __syssolver_linop_mixed_prec_richardson_h__
+#include "chroma_config.h"
+
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/fermstates/periodic_fermstate.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_mixed_prec_richardson_params.h"
+#include "actions/ferm/linop/eoprec_clover_dumb_linop_w.h"
+
+#include <string>
+
+namespace Chroma
+{
+
+  //! Mixed precision Richardson system solver namespace
+  namespace LinOpSysSolverMixedPrecRichardsonEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a system by mixed precision Richardson iteration
+  /*! \ingroup invert
+   *
+   * Defect correction: the residual  r = chi - A psi  is kept in the full
+   * precision of the operator, while the correction  A dx = r  is solved
+   * by any registered single precision LinOp solver, given in the
+   * InnerSolverParams group.
+   *
+   * The inner solver gets a single precision copy of the fermion state
+   * (the links with the boundary conditions already applied) and a real
+   * single precision operator built on it. The fermion action factory
+   * only makes full precision actions, so the operator is the single
+   * precision even-odd clover operator of RICHARDSON_MP_CLOVER, given by
+   * the CloverParams, and A must be the matching even-odd clover (or,
+   * with clovCoeff 0, Wilson) operator. At construction both operators
+   * are applied to a random vector and the solver stops if they
+   * disagree. Without CloverParams, or for array (e.g. DWF) operators,
+   * there is no single precision operator and the solver is not usable.
+   */
+  class LinOpSysSolverMixedPrecRichardson : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    typedef LatticeFermion T;
+    typedef multi1d<LatticeColorMatrix> Q;
+ 
+    typedef LatticeFermionF TF;
+    typedef multi1d<LatticeColorMatrixF> QF;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param state_    Fermion state ( Read )
+     * \param invParam_ inverter parameters ( Read )
+     */
+    LinOpSysSolverMixedPrecRichardson(Handle< LinearOperator<T> > A_,
+				      Handle< FermState<T,Q,Q> > state_,
+				      const SysSolverMixedPrecRichardsonParams& invParam_);
+
+    //! Destructor is automatic
+    ~LinOpSysSolverMixedPrecRichardson() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solve the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverMixedPrecRichardson() {}
+
+    //! Stop unless A_single agrees with A on a random vector
+    void checkSinglePrec() const;
+
+    Handle< LinearOperator<T> > A;
+    SysSolverMixedPrecRichardsonParams invParam;
+
+    // Created and initialized here.
+    Handle< LinearOperator<TF> > A_single;
+    Handle< LinOpSystemSolver<TF> > DInv;
+  };
+
+} // End namespace
+
+#endif 
@@ -13,6 +13,8 @@
 #include "linearop.h"
 #include "lmdagm.h"
 #include "actions/ferm/fermstates/periodic_fermstate.h"
+#include "actions/ferm/fermstates/simple_fermstate.h"
+#include "actions/ferm/fermbcs/periodic_fermbc.h"
 #include "actions/ferm/invert/reliable_cg.h"
 #include "actions/ferm/invert/syssolver_linop_factory.h"
 #include "actions/ferm/invert/syssolver_rel_bicgstab_clover_params.h"
@@ -78,7 +80,20 @@ namespace Chroma
       // Links single hold the possibly stouted links
       // with gaugeBCs applied... 
       // Now I need to create a single prec state...
-      fstate_single = new PeriodicFermState<TF,QF,QF>(links_single);
+      // With Fixed16Inner the single prec. dslash holds its links in 16 bit.
+      // Only the QDP dslash decodes them, so stop if this build uses another
+      if( invParam.Fixed16Inner ) { 
+#if defined(BUILD_CPP_WILSON_DSLASH) || (defined(BUILD_SSE_WILSON_DSLASH) && BASE_PRECISION == 32) || defined(QDP_IS_QDPJIT)
+	QDPIO::cerr << "RELIABLE_CG_MP_CLOVER: Fixed16Inner needs the QDP single precision WilsonDslashF,"
+		    << " the one of this build can not use FIXED16 links" << std::endl;
+	QDP_abort(1);
+#endif
+	Handle< FermBC<TF,QF,QF> > fbc_single(new PeriodicFermBC<TF,QF,QF>());
+	fstate_single = new SimpleFermState<TF,QF,QF>(fbc_single, links_single, LINK_COMPRESS_FIXED16);
+      }
+      else { 
+	fstate_single = new PeriodicFermState<TF,QF,QF>(links_single);
+      }
       fstate_double = new PeriodicFermState<TD,QD,QD>(links_double);
 
       // Make single precision M
@@ -124,13 +139,24 @@ namespace Chroma
       // Then convert to double
       TD chi_d = M_dag_chi;
 
-      res=InvCGReliable(*M_double,
-			*M_single,
-			chi_d,
-			psi_d,
-			invParam.RsdTarget,
-			invParam.Delta,
-			invParam.MaxIter);
+      if( invParam.Fixed16Inner ) { 
+	res=InvCGReliableFixed16(*M_double,
+				 *M_single,
+				 chi_d,
+				 psi_d,
+				 invParam.RsdTarget,
+				 invParam.Delta,
+				 invParam.MaxIter);
+      }
+      else { 
+	res=InvCGReliable(*M_double,
+			  *M_single,
+			  chi_d,
+			  psi_d,
+			  invParam.RsdTarget,
+			  invParam.Delta,
+			  invParam.MaxIter);
+      }
       
       psi = psi_d;
 
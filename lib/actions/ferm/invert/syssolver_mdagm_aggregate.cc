@@ -6,6 +6,7 @@
 
 
 #include "actions/ferm/invert/syssolver_mdagm_cg.h"
+#include "actions/ferm/invert/syssolver_mdagm_cg_pipelined.h"
 #include "actions/ferm/invert/syssolver_mdagm_bicgstab.h"
 #include "actions/ferm/invert/syssolver_mdagm_ibicgstab.h"
 #include "actions/ferm/invert/syssolver_mdagm_cg_timing.h"
@@ -48,6 +49,7 @@ namespace Chroma
       {
 	// Sources
 	success &= MdagMSysSolverCGEnv::registerAll();
+	success &= MdagMSysSolverCGPipelinedEnv::registerAll();
 	success &= MdagMSysSolverCGTimingsEnv::registerAll();
 	success &= MdagMSysSolverBiCGStabEnv::registerAll();
 	success &= MdagMSysSolverIBiCGStabEnv::registerAll();
@@ -11,6 +11,7 @@
 #include "actions/ferm/invert/inv_eigcg2.h"
 #include "actions/ferm/invert/norm_gram_schm.h"
 #include "actions/ferm/invert/invcg2.h"
+#include "util/gauge/gauge_fingerprint.h"
 
 //for debugging
 //#include "octave.h"
@@ -28,7 +29,12 @@ namespace Chroma
 
 						  Handle< LinearOperator<LatticeFermion> > A)
     {
-      return new MdagMSysSolverQDPEigCG<LatticeFermion>(A, SysSolverEigCGParams(xml_in, path));
+      SysSolverEigCGParams invParam(xml_in, path);
+      std::string config_id;
+      if (invParam.store.enabled)
+	config_id = gaugeFingerprint(state->getLinks());
+
+      return new MdagMSysSolverQDPEigCG<LatticeFermion>(A, invParam, config_id);
     }
 
 #if 0
@@ -76,7 +82,8 @@ namespace Chroma
     SystemSolverResults_t sysSolver(T& psi, const T& chi, 
 				    const LinearOperator<T>& A,
 				    const LinearOperator<T>& MdagM, 
-				    const SysSolverEigCGParams& invParam)
+				    const SysSolverEigCGParams& invParam,
+				    const Handle< EigCGDeflationStore<T> >& store)
     {
       START_CODE();
 
@@ -128,6 +135,11 @@ namespace Chroma
 	    normGramSchmidt(GoodEvecs.evec.vec,GoodEvecs.Neig-invParam.Neig,GoodEvecs.Neig,MdagM.subset());
 	    snoop.stop();
 	    Time += snoop.getTimeInSeconds() ;
+
+	    // Keep the grown space on disk. The new vectors now extend the
+	    // orthonormal basis, the rotation below only mixes it
+	    if (invParam.store.enabled)
+	      store->append(GoodEvecs, GoodEvecs.Neig-invParam.Neig);
 	  
 	    snoop.start();
 	    LinAlg::Matrix<DComplex> Htmp(GoodEvecs.Neig) ;
@@ -177,6 +189,7 @@ namespace Chroma
 		QDPIO::cout<<"--- norm = "<<tt<<std::endl  ;
 	      } 
 	    }
+
 	  }// if there is space
 	else // call CG but ask it not to compute vectors
 	  {
@@ -241,7 +254,7 @@ namespace Chroma
   SystemSolverResults_t
   MdagMSysSolverQDPEigCG<LatticeFermionF>::operator()(LatticeFermionF& psi, const LatticeFermionF& chi) const
   {
-    return sysSolver(psi, chi, *A, *MdagM, invParam);
+    return sysSolver(psi, chi, *A, *MdagM, invParam, store);
   }
 
   // LatticeFermionD
@@ -249,7 +262,7 @@ namespace Chroma
   SystemSolverResults_t
   MdagMSysSolverQDPEigCG<LatticeFermionD>::operator()(LatticeFermionD& psi, const LatticeFermionD& chi) const
   {
-    return sysSolver(psi, chi, *A, *MdagM, invParam);
+    return sysSolver(psi, chi, *A, *MdagM, invParam, store);
   }
 
 #if 0
@@ -259,7 +272,7 @@ namespace Chroma
   SystemSolverResults_t
   MdagMSysSolverQDPEigCG<LatticeStaggeredFermionF>::operator()(LatticeStaggeredFermionF& psi, const LatticeStaggeredFermionF& chi) const
   {
-    return sysSolver(psi, chi, *A, *MdagM, invParam);
+    return sysSolver(psi, chi, *A, *MdagM, invParam, store);
   }
 
   // LatticeStaggeredFermionD
@@ -267,7 +280,7 @@ namespace Chroma
   SystemSolverResults_t
   MdagMSysSolverQDPEigCG<LatticeStaggeredFermionD>::operator()(LatticeStaggeredFermionD& psi, const LatticeStaggeredFermionD& chi) const
   {
-    return sysSolver(psi, chi, *A, *MdagM, invParam);
+    return sysSolver(psi, chi, *A, *MdagM, invParam, store);
   }
 #endif
 
@@ -16,6 +16,7 @@
 #include "actions/ferm/invert/syssolver_mdagm.h"
 #include "actions/ferm/invert/syssolver_eigcg_params.h"
 #include "actions/ferm/invert/containers.h"
+#include "actions/ferm/invert/eigcg_deflation_store.h"
 
 namespace Chroma
 {
@@ -39,11 +40,20 @@ namespace Chroma
     /*!
      * \param M_         Linear operator ( Read )
      * \param invParam_  inverter parameters ( Read )
+     * \param config_id  fingerprint of the gauge field, used to key the deflation store ( Read )
      */
     MdagMSysSolverQDPEigCG(Handle< LinearOperator<T> > A_,
-			   const SysSolverEigCGParams& invParam_) : 
+			   const SysSolverEigCGParams& invParam_,
+			   const std::string& config_id = "") : 
       MdagM(new MdagMLinOp<T>(A_)), A(A_), invParam(invParam_) 
       {
+	if (invParam.store.enabled)
+	{
+	  store = new EigCGDeflationStore<T>(invParam.store.file_name,
+					     invParam.store.space_id,
+					     config_id);
+	}
+
 	// NEED to grab the eignvectors from the named buffer here
 	if (! TheNamedObjMap::Instance().check(invParam.eigen_id))
 	{
@@ -57,6 +67,14 @@ namespace Chroma
 	  else{
 	    GoodEvecs.init(invParam.Neig);
 	  }
+
+	  // Start from the vectors of an earlier job, if there are any.
+	  // The store holds a basis, so recover the Ritz pairs
+	  if (invParam.store.enabled)
+	  {
+	    if (store->load(GoodEvecs, A->subset()) > 0)
+	      eigCGRayleighRitz(GoodEvecs, *MdagM);
+	  }
 	}
       }
 
@@ -119,6 +137,7 @@ namespace Chroma
     Handle< LinearOperator<T> > MdagM;
     Handle< LinearOperator<T> > A;
     SysSolverEigCGParams invParam;
+    Handle< EigCGDeflationStore<T> > store;
   };
 
 } // End namespace
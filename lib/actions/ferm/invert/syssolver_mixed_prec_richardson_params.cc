@@ -0,0 +1,46 @@
+/*! \file
+ *  \brief Params of the generic mixed precision Richardson solver
+ */
+
+#include "actions/ferm/invert/syssolver_mixed_prec_richardson_params.h"
+
+namespace Chroma 
+{
+  
+  SysSolverMixedPrecRichardsonParams::SysSolverMixedPrecRichardsonParams(XMLReader& xml, 
+									 const std::string& path)
+  {
+    XMLReader paramtop(xml, path);
+    read(paramtop, "MaxIter", MaxIter);
+    read(paramtop, "RsdTarget", RsdTarget);
+    innerSolverParams = readXMLGroup(paramtop, "InnerSolverParams", "invType");
+
+    // Optional single precision clover operator for the inner solves
+    cloverP = false;
+    if (paramtop.count("CloverParams") != 0)
+    {
+      read(paramtop, "CloverParams", clovParams);
+      cloverP = true;
+    }
+  }
+
+  void read(XMLReader& xml, const std::string& path, 
+	    SysSolverMixedPrecRichardsonParams& p)
+  {
+    SysSolverMixedPrecRichardsonParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverMixedPrecRichardsonParams& p) 
+  {
+    push(xml, path);
+    write(xml, "MaxIter", p.MaxIter);
+    write(xml, "RsdTarget", p.RsdTarget);
+    if (p.cloverP)
+      write(xml, "CloverParams", p.clovParams);
+    xml << p.innerSolverParams.xml;
+    pop(xml);
+  }
+
+}
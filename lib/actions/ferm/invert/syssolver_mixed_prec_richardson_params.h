@@ -0,0 +1,39 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the generic mixed precision Richardson solver
+ */
+
+#ifndef __syssolver_mixed_prec_richardson_params_h__
+#define __syssolver_mixed_prec_richardson_params_h__
+
+#include "chromabase.h"
+#include "io/xml_group_reader.h"
+#include "actions/ferm/fermacts/clover_fermact_params_w.h"
+
+namespace Chroma 
+{
+  //! Params of the generic mixed precision Richardson solver
+  /*! \ingroup invert */
+  struct SysSolverMixedPrecRichardsonParams 
+  { 
+    SysSolverMixedPrecRichardsonParams(XMLReader& xml, const std::string& path);
+    SysSolverMixedPrecRichardsonParams() : cloverP(false) {}
+
+    int MaxIter;                    /*!< Maximum number of outer corrections */
+    Real RsdTarget;                 /*!< Relative residual of the outer solve */
+    GroupXML_t innerSolverParams;   /*!< Any single precision LinOp system solver */
+
+    bool cloverP;                   /*!< Inner operator is a real single precision clover operator */
+    CloverFermActParams clovParams; /*!< Its params, if cloverP */
+  };
+
+  //! Read params
+  void read(XMLReader& xml, const std::string& path, SysSolverMixedPrecRichardsonParams& p);
+
+  //! Write params
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverMixedPrecRichardsonParams& param);
+
+}
+
+#endif
@@ -16,6 +16,11 @@ namespace Chroma {
     read(paramtop, "RsdTarget", RsdTarget);
     read(paramtop, "CloverParams", clovParams);
     read(paramtop, "Delta", Delta);
+
+    Fixed16Inner = false;
+    if( paramtop.count("Fixed16Inner") > 0 ) { 
+      read(paramtop, "Fixed16Inner", Fixed16Inner);
+    }
   }
 
   void read(XMLReader& xml, const std::string& path, 
@@ -32,6 +37,7 @@ namespace Chroma {
     write(xml, "RsdTarget", p.RsdTarget);
     write(xml, "CloverParams", p.clovParams);
     write(xml, "Delta", p.Delta);
+    write(xml, "Fixed16Inner", p.Fixed16Inner);
     pop(xml);
 
   }
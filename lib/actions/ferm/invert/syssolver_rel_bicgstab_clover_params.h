@@ -15,11 +15,13 @@ namespace Chroma
       MaxIter = p.MaxIter;
       RsdTarget = p.RsdTarget;
       Delta = p.Delta;
+      Fixed16Inner = p.Fixed16Inner;
     }
     CloverFermActParams clovParams;
     int MaxIter;
     Real RsdTarget;
     Real Delta;
+    bool Fixed16Inner;   /*!< 16 bit fixed point links and residual in the inner solve (CG with the QDP dslash only; p and the clover term stay float) */
   };
 
   typedef SysSolverReliableBiCGStabCloverParams SysSolverReliableCGCloverParams;
@@ -11,6 +11,23 @@
 
 namespace Chroma 
 { 
+  //! Spin-colour matrix type of the outer product of two fermions
+  template<typename T>
+  class CloverOuterProdType {};
+
+  template<>
+  class CloverOuterProdType<LatticeFermionF>  { 
+  public:
+    typedef LatticePropagatorF Type_t;
+  };
+
+  template<>
+  class CloverOuterProdType<LatticeFermionD>  { 
+  public:
+    typedef LatticePropagatorD Type_t;
+  };
+
+
   //! Clover term
   /*!
    * \ingroup linop
@@ -159,6 +176,13 @@ namespace Chroma
     END_CODE();
   }
 
+  //! Take deriv of D summed over several pairs of vectors
+  /*!
+   * The outer products  psi_i chi_i^dag  of all the pairs are summed into
+   * one spin-colour matrix in a single sweep, and each sigma_{mu,nu}
+   * insertion is then a trace against that sum. The sum is shared by
+   * the two checkerboards.
+   */
   template<typename T, typename U>
   void CloverTermBase<T,U>::derivMultipole(multi1d<U>& ds_u, 
 			     const multi1d<T>& chi, const multi1d<T>& psi, 
@@ -166,16 +190,44 @@ namespace Chroma
   {
     START_CODE();
 
-    // base deriv resizes.
-    // Even even checkerboard
-    derivMultipole(ds_u, chi, psi, isign,0);
-    
-    // Odd Odd checkerboard
-    multi1d<U> ds_tmp;
-    derivMultipole(ds_tmp, chi, psi, isign,1);
-    
-    ds_u += ds_tmp;
-    
+    if( ds_u.size() != Nd ) { 
+      ds_u.resize(Nd);
+    }
+
+    ds_u = zero;
+
+    // Sum of the outer products of all the pairs
+    typename CloverOuterProdType<T>::Type_t q = zero;
+    for(int i=0; i < chi.size(); i++) { 
+      q += outerProduct(psi[i], chi[i]);
+    }
+
+    for(int mu=0; mu < Nd; mu++) {
+      for(int nu = mu+1; nu < Nd; nu++) {
+
+	// The weight for the terms
+	Real factor = (Real(-1)/Real(8))*getCloverCoeff(mu,nu);
+
+	int mu_nu_index = (1 << mu) + (1 << nu); // 2^{mu} 2^{nu}
+	U s_xy_dag = traceSpin(Gamma(mu_nu_index)*q);
+	s_xy_dag *= Real(factor);
+
+	for(int cb=0; cb < 2; cb++) { 
+	  U ds_tmp_mu; 
+	  U ds_tmp_nu;
+
+	  // Compute contributions
+	  deriv_loops(mu, nu, cb, ds_tmp_mu, ds_tmp_nu, s_xy_dag);
+
+	  // Accumulate them
+	  ds_u[mu] += ds_tmp_mu;
+	  ds_u[nu] -= ds_tmp_nu;
+	}
+      }
+    }
+
+    // Clear out the deriv on any fixed links
+    (*this).getFermBC().zero(ds_u);
     END_CODE();
   }
 
@@ -618,9 +670,12 @@ namespace Chroma
 
     ds_u = zero;
 
-    // Get the links
-    //const multi1d<U>& u = getU();
-
+    // Sum of the outer products of all the pairs, on the sites the
+    // insertions are taken from
+    typename CloverOuterProdType<T>::Type_t q = zero;
+    for(int i=0; i < chi.size(); i++) { 
+      q[rb[cb]] += outerProduct(psi[i], chi[i]);
+    }
 
     // Now compute the insertions
     for(int mu=0; mu < Nd; mu++) {
@@ -637,18 +692,9 @@ namespace Chroma
 	// The weight for the terms
 	Real factor = (Real(-1)/Real(8))*getCloverCoeff(mu,nu);
 
-	// Get gamma_mu gamma_nu psi -- no saving here, from storing shifts because
-	// I now only do every mu, nu pair only once.
-
 	int mu_nu_index = (1 << mu) + (1 << nu); // 2^{mu} 2^{nu}
 
-	// Accumulate all the trace spin outer products 
-	U s_xy_dag = zero;
-	for(int i=0; i < chi.size(); i++) { 
-	  T ferm_tmp = Gamma(mu_nu_index)*psi[i];
-	  s_xy_dag += traceSpin( outerProduct(ferm_tmp,chi[i]));
-	}
-
+	U s_xy_dag = traceSpin(Gamma(mu_nu_index)*q);
 	s_xy_dag *= Real(factor);
 
 	// Compute contributions
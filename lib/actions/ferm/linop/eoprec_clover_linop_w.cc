@@ -187,6 +187,71 @@ namespace Chroma
   }
 
 
+  //! Apply even-odd preconditioned Clover fermion linear operator to a block of vectors
+  /*!
+   * The two hopping terms go through the fused dslash; the clover
+   * terms are site local and applied one vector at a time.
+   *
+   * \param chi 	  Pseudofermion fields     	       (Write)
+   * \param psi 	  Pseudofermion fields     	       (Read)
+   * \param isign   Flag ( PLUS | MINUS )   	       (Read)
+   */
+  void EvenOddPrecCloverLinOp::applyBlock(multi1d<LatticeFermion>& chi, 
+					  const multi1d<LatticeFermion>& psi, 
+					  enum PlusMinus isign) const
+  {
+    START_CODE();
+
+    const int num = psi.size();
+    if (chi.size() != num)
+      chi.resize(num);
+
+    multi1d<LatticeFermion> tmp1(num), tmp2(num);
+    LatticeFermion tmp3; moveToFastMemoryHint(tmp3);
+    Real mquarter = -0.25;
+
+    //  tmp1_e  =  D_eo  psi_o
+    D.applyBlock(tmp1, psi, isign, 0);
+
+    //  tmp2_e  =  A^(-1)_ee  tmp1_e
+    swatch.reset(); swatch.start();
+    for(int i=0; i < num; ++i)
+      invclov.apply(tmp2[i], tmp1[i], isign, 0);
+    swatch.stop();
+    clov_apply_time += swatch.getTimeInSeconds();
+
+    //  tmp1_o  =  D_oe  tmp2_e
+    D.applyBlock(tmp1, tmp2, isign, 1);
+
+    //  chi_o  =  A_oo  psi_o  -  tmp1_o
+    swatch.reset(); swatch.start();
+    for(int i=0; i < num; ++i)
+      clov.apply(chi[i], psi[i], isign, 1);
+    swatch.stop();
+    clov_apply_time += swatch.getTimeInSeconds();
+
+    for(int i=0; i < num; ++i)
+    {
+      chi[i][rb[1]] += mquarter*tmp1[i];
+
+      // Twisted Term?
+      if( param.twisted_m_usedP ){ 
+	// tmp3 = i mu gamma_5 psi
+	tmp3[rb[1]] = (GammaConst<Ns,Ns*Ns-1>() * timesI(psi[i]));
+      
+	if( isign == PLUS ) {
+	  chi[i][rb[1]] += param.twisted_m * tmp3;
+	}
+	else {
+	  chi[i][rb[1]] -= param.twisted_m * tmp3;
+	}
+      }
+    }
+
+    END_CODE();
+  }
+
+
   //! Apply the even-even block onto a source std::vector
   void 
   EvenOddPrecCloverLinOp::derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
@@ -263,6 +328,36 @@ namespace Chroma
     END_CODE();
   }
 
+  //! The even-odd block summed over several pairs of vectors
+  void 
+  EvenOddPrecCloverLinOp::derivEvenOddLinOpMP(multi1d<LatticeColorMatrix>& ds_u, 
+					      const multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+					      enum PlusMinus isign) const
+  {
+    START_CODE();
+    ds_u.resize(Nd);
+    D.derivMultipole(ds_u, chi, psi, isign, 0);
+    for(int mu=0; mu < Nd; mu++) { 
+      ds_u[mu]  *= Real(-0.5);
+    }
+    END_CODE();
+  }
+
+  //! The odd-even block summed over several pairs of vectors
+  void 
+  EvenOddPrecCloverLinOp::derivOddEvenLinOpMP(multi1d<LatticeColorMatrix>& ds_u, 
+					      const multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+					      enum PlusMinus isign) const
+  {
+    START_CODE();
+    ds_u.resize(Nd);
+    D.derivMultipole(ds_u, chi, psi, isign, 1);
+    for(int mu=0; mu < Nd; mu++) { 
+      ds_u[mu]  *= Real(-0.5);
+    }
+    END_CODE();
+  }
+
   // Inherit this
   //! Apply the the odd-odd block onto a source std::vector
   void 
@@ -167,6 +167,42 @@ namespace Chroma
   }
 
 
+  //! Apply the operator to a block of vectors
+  /*!
+   * Same as the single std::vector operator, but the dslash is applied
+   * to the whole block at once so the links are read once per block.
+   */
+  void EvenOddPrecWilsonLinOp::applyBlock(multi1d<LatticeFermion>& chi, 
+					  const multi1d<LatticeFermion>& psi, 
+					  enum PlusMinus isign) const
+  {
+    START_CODE();
+
+    const int num = psi.size();
+    if (chi.size() != num)
+      chi.resize(num);
+
+    multi1d<LatticeFermion> tmp1(num), tmp2(num);
+
+    Real mquarterinvfact = -0.25*invfact;
+
+    // tmp1[0] = D_eo psi[1]
+    D.applyBlock(tmp1, psi, isign, 0);
+
+    // tmp2[1] = D_oe tmp1[0]
+    D.applyBlock(tmp2, tmp1, isign, 1);
+
+    // chi[1] = (Nd + m) - (1/4)*(1/(Nd + m)) D_oe D_eo psi[1]
+    for(int i=0; i < num; ++i)
+    {
+      chi[i][rb[1]] = fact*psi[i] + mquarterinvfact*tmp2[i];
+      getFermBC().modifyF(chi[i], rb[1]);
+    }
+    
+    END_CODE();
+  }
+
+
   //! Derivative of even-odd linop component
   void 
   EvenOddPrecWilsonLinOp::derivEvenOddLinOp(multi1d<LatticeColorMatrix>& ds_u,
@@ -205,19 +241,18 @@ namespace Chroma
     END_CODE();
   }
 
-#if 0
- //! Derivative of even-odd linop component
+  //! Derivative of even-odd linop component summed over several pairs of vectors
   void 
   EvenOddPrecWilsonLinOp::derivEvenOddLinOpMP(multi1d<LatticeColorMatrix>& ds_u,
-					      const LatticeFermion& chi, 
-					      const LatticeFermion& psi, 
+					      const multi1d<LatticeFermion>& chi, 
+					      const multi1d<LatticeFermion>& psi, 
 					      enum PlusMinus isign) const
   {
     START_CODE();
 
     ds_u.resize(Nd);
 
-    D.deriv(ds_u, chi, psi, isign, 0);
+    D.derivMultipole(ds_u, chi, psi, isign, 0);
     for(int mu=0; mu < Nd; mu++) {
       ds_u[mu] *=  Real(-0.5);
     }
@@ -226,24 +261,23 @@ namespace Chroma
   }
 
 
-  //! Derivative of odd-even linop component
+  //! Derivative of odd-even linop component summed over several pairs of vectors
   void 
   EvenOddPrecWilsonLinOp::derivOddEvenLinOpMP(multi1d<LatticeColorMatrix>& ds_u,
-					      const LatticeFermion& chi, 
-					      const LatticeFermion& psi, 
+					      const multi1d<LatticeFermion>& chi, 
+					      const multi1d<LatticeFermion>& psi, 
 					      enum PlusMinus isign) const
   {
     START_CODE();
 
     ds_u.resize(Nd);
 
-    D.deriv(ds_u, chi, psi, isign, 1);
+    D.derivMultipole(ds_u, chi, psi, isign, 1);
     for(int mu=0; mu < Nd; mu++) { 
       ds_u[mu]  *= Real(-0.5);
     }
     END_CODE();
   }
-#endif
 
   //! Return flops performed by the operator()
   unsigned long EvenOddPrecWilsonLinOp::nFlops() const
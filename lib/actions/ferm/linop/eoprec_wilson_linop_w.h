@@ -109,6 +109,10 @@ namespace Chroma
     void operator()(LatticeFermion& chi, const LatticeFermion& psi, 
 		    enum PlusMinus isign) const;
 
+    //! Apply the operator to a block of vectors, sharing the dslash link loads
+    void applyBlock(multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+		    enum PlusMinus isign) const;
+
 
     //! Apply the even-even block onto a source std::vector
     void derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
@@ -131,6 +135,16 @@ namespace Chroma
 			   const LatticeFermion& chi, const LatticeFermion& psi, 
 			   enum PlusMinus isign) const;
 
+    //! The even-odd block summed over several pairs of vectors, in one dslash sweep
+    void derivEvenOddLinOpMP(multi1d<LatticeColorMatrix>& ds_u, 
+			     const multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+			     enum PlusMinus isign) const;
+
+    //! The odd-even block summed over several pairs of vectors, in one dslash sweep
+    void derivOddEvenLinOpMP(multi1d<LatticeColorMatrix>& ds_u, 
+			     const multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+			     enum PlusMinus isign) const;
+
     //! Apply the the odd-odd block onto a source std::vector
     void derivOddOddLinOp(multi1d<LatticeColorMatrix>& ds_u, 
 			  const LatticeFermion& chi, const LatticeFermion& psi, 
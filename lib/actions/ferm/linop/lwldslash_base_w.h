@@ -76,12 +76,44 @@ namespace Chroma
 		       const T& chi, const T& psi, 
 		       enum PlusMinus isign, int cb) const ;
 
+    //! Take deriv of D summed over several pairs of vectors
+    /*!
+     * \param chi     left vectors                                (Read)
+     * \param psi     right vectors                               (Read)
+     * \param isign   D'^dag or D'  ( MINUS | PLUS ) resp.        (Read)
+     *
+     * \return Computes   \f$\sum_i \chi_i^\dag * \dot(D} * \psi_i\f$
+     */
+    virtual void derivMultipole(P& ds_u, 
+				const multi1d<T>& chi, const multi1d<T>& psi, 
+				enum PlusMinus isign) const;
+
+    //! Take deriv of D summed over several pairs of vectors
+    /*!
+     * \param chi     left vectors on cb                          (Read)
+     * \param psi     right vectors on 1-cb                       (Read)
+     * \param isign   D'^dag or D'  ( MINUS | PLUS ) resp.        (Read)
+     * \param cb      Checkerboard of the chi vectors             (Read)
+     *
+     * \return Computes   \f$\sum_i \chi_i^\dag * \dot(D} * \psi_i\f$
+     */
+    virtual void derivMultipole(P& ds_u, 
+				const multi1d<T>& chi, const multi1d<T>& psi, 
+				enum PlusMinus isign, int cb) const;
+
     //! Return flops performed by the operator()
     unsigned long nFlops() const;
 
   protected:
     //! Get the anisotropy parameters
     virtual const multi1d<Real>& getCoeffs() const = 0;
+
+  private:
+    //! Sum of the multipole insertions with chi on "to" and psi on "from"
+    void derivMultipoleSubset(P& ds_u, 
+			      const multi1d<T>& chi, const multi1d<T>& psi, 
+			      enum PlusMinus isign, 
+			      const Subset& from, const Subset& to) const;
   };
 
   template<typename T>
@@ -227,6 +259,150 @@ namespace Chroma
   }
 
 
+  namespace WilsonDslashBaseEnv
+  {
+    //! Spin project psi on the "from" sites and shift the half spinor to the "to" sites
+    /*!
+     * Only the half spinor goes through the shift, so that the
+     * communications are half those of the full spinor.
+     */
+    template<typename T>
+    void projectShift(typename HalfFermionType<T>::Type_t& h_shift, const T& psi, 
+		      int mu, enum PlusMinus isign, const Subset& from, const Subset& to)
+    {
+      typename HalfFermionType<T>::Type_t h;
+
+      if (isign == PLUS)
+      {
+	// Undaggered: Minus Projectors
+	switch(mu) 
+	{ 
+	case 0: h[from] = spinProjectDir0Minus(psi); break;
+	case 1: h[from] = spinProjectDir1Minus(psi); break;
+	case 2: h[from] = spinProjectDir2Minus(psi); break;
+	case 3: h[from] = spinProjectDir3Minus(psi); break;
+	default: QDP_error_exit("unknown direction");
+	}
+      }
+      else
+      {
+	// Daggered: Plus Projectors
+	switch(mu) 
+	{ 
+	case 0: h[from] = spinProjectDir0Plus(psi); break;
+	case 1: h[from] = spinProjectDir1Plus(psi); break;
+	case 2: h[from] = spinProjectDir2Plus(psi); break;
+	case 3: h[from] = spinProjectDir3Plus(psi); break;
+	default: QDP_error_exit("unknown direction");
+	}
+      }
+
+      h_shift[to] = shift(h, FORWARD, mu);
+    }
+
+    //! ds += Tr_spin [ recon(h) chi^dag ] on the sites s
+    template<typename T, typename U>
+    void reconOuterAdd(U& ds, const typename HalfFermionType<T>::Type_t& h, const T& chi,
+		       int mu, enum PlusMinus isign, const Subset& s)
+    {
+      if (isign == PLUS)
+      {
+	switch(mu) 
+	{ 
+	case 0: ds[s] += traceSpin(outerProduct(spinReconstructDir0Minus(h), chi)); break;
+	case 1: ds[s] += traceSpin(outerProduct(spinReconstructDir1Minus(h), chi)); break;
+	case 2: ds[s] += traceSpin(outerProduct(spinReconstructDir2Minus(h), chi)); break;
+	case 3: ds[s] += traceSpin(outerProduct(spinReconstructDir3Minus(h), chi)); break;
+	default: QDP_error_exit("unknown direction");
+	}
+      }
+      else
+      {
+	switch(mu) 
+	{ 
+	case 0: ds[s] += traceSpin(outerProduct(spinReconstructDir0Plus(h), chi)); break;
+	case 1: ds[s] += traceSpin(outerProduct(spinReconstructDir1Plus(h), chi)); break;
+	case 2: ds[s] += traceSpin(outerProduct(spinReconstructDir2Plus(h), chi)); break;
+	case 3: ds[s] += traceSpin(outerProduct(spinReconstructDir3Plus(h), chi)); break;
+	default: QDP_error_exit("unknown direction");
+	}
+      }
+    }
+  }
+
+
+  //! Take deriv of D summed over several pairs of vectors
+  /*!
+   * Unlike calling deriv() once per pair, each psi is projected and
+   * shifted once per direction for both checkerboards together, the
+   * outer products of all the pairs are accumulated straight into the
+   * force, and the anisotropy weights and boundary conditions are
+   * applied once at the end.
+   */
+  template<typename T, typename P, typename Q>
+  void
+  WilsonDslashBase<T,P,Q>::derivMultipole(P& ds_u,
+					  const multi1d<T>& chi, const multi1d<T>& psi, 
+					  enum PlusMinus isign) const
+  {
+    START_CODE();
+
+    derivMultipoleSubset(ds_u, chi, psi, isign, all, all);
+
+    END_CODE();
+  }
+
+
+  //! Take deriv of D summed over several pairs of vectors
+  template<typename T, typename P, typename Q>
+  void
+  WilsonDslashBase<T,P,Q>::derivMultipole(P& ds_u,
+					  const multi1d<T>& chi, const multi1d<T>& psi, 
+					  enum PlusMinus isign, int cb) const
+  {
+    START_CODE();
+
+    derivMultipoleSubset(ds_u, chi, psi, isign, rb[1-cb], rb[cb]);
+
+    END_CODE();
+  }
+
+
+  //! Sum of the multipole insertions with chi on "to" and psi on "from"
+  template<typename T, typename P, typename Q>
+  void
+  WilsonDslashBase<T,P,Q>::derivMultipoleSubset(P& ds_u,
+						const multi1d<T>& chi, const multi1d<T>& psi, 
+						enum PlusMinus isign,
+						const Subset& from, const Subset& to) const
+  {
+    if (chi.size() != psi.size())
+    {
+      QDPIO::cerr << "WilsonDslashBase::derivMultipole: chi and psi differ in size" << std::endl;
+      QDP_abort(1);
+    }
+
+    ds_u.resize(Nd);
+
+    const multi1d<Real>& anisoWeights = getCoeffs();
+    typename HalfFermionType<T>::Type_t h_shift;
+
+    for(int mu = 0; mu < Nd; ++mu) 
+    {
+      ds_u[mu] = zero;
+
+      for(int i=0; i < psi.size(); ++i)
+      {
+	WilsonDslashBaseEnv::projectShift(h_shift, psi[i], mu, isign, from, to);
+	WilsonDslashBaseEnv::reconOuterAdd(ds_u[mu], h_shift, chi[i], mu, isign, to);
+      }
+
+      ds_u[mu][to] *= anisoWeights[mu];
+    }
+    (*this).getFermBC().zero(ds_u);
+  }
+
+
   //! Return flops performed by the operator()
   template<typename T, typename P, typename Q>
   unsigned long 
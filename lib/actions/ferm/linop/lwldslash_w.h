@@ -9,10 +9,159 @@
 #include "state.h"
 #include "io/aniso_io.h"
 #include "actions/ferm/linop/lwldslash_base_w.h"
+#include "util/gauge/compressed_links.h"
 
 
 namespace Chroma 
 { 
+  //! Helpers for the multi-vector QDP Wilson dslash
+  namespace QDPWilsonDslashEnv
+  {
+    //! Spin project in direction mu and shift forward, on a subset
+    /*!
+     * \param h       half fermion, h(x) = P psi(x+mu)       (Write)
+     * \param psi     fermion                               (Read)
+     * \param mu      direction                             (Read)
+     * \param plus    use (1 + gamma_mu) if true, else (1 - gamma_mu)  (Read)
+     * \param s       subset                                (Read)
+     */
+    template<typename HT, typename T>
+    inline
+    void shiftSpinProjectDir(HT& h, const T& psi, int mu, bool plus, const Subset& s)
+    {
+      switch(mu)
+      {
+      case 0:
+	if (plus) h[s] = shift(spinProjectDir0Plus(psi), FORWARD, 0);
+	else      h[s] = shift(spinProjectDir0Minus(psi), FORWARD, 0);
+	break;
+      case 1:
+	if (plus) h[s] = shift(spinProjectDir1Plus(psi), FORWARD, 1);
+	else      h[s] = shift(spinProjectDir1Minus(psi), FORWARD, 1);
+	break;
+      case 2:
+	if (plus) h[s] = shift(spinProjectDir2Plus(psi), FORWARD, 2);
+	else      h[s] = shift(spinProjectDir2Minus(psi), FORWARD, 2);
+	break;
+      case 3:
+	if (plus) h[s] = shift(spinProjectDir3Plus(psi), FORWARD, 3);
+	else      h[s] = shift(spinProjectDir3Minus(psi), FORWARD, 3);
+	break;
+      default:
+	QDPIO::cerr << __func__ << ": unsupported direction " << mu << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+#ifndef QDP_IS_QDPJIT
+    //! Spin project a single site in direction mu
+    template<typename HS, typename S>
+    inline
+    void spinProjectSite(HS& h, const S& psi, int mu, bool plus)
+    {
+      switch(mu)
+      {
+      case 0:  if (plus) h = spinProjectDir0Plus(psi); else h = spinProjectDir0Minus(psi); break;
+      case 1:  if (plus) h = spinProjectDir1Plus(psi); else h = spinProjectDir1Minus(psi); break;
+      case 2:  if (plus) h = spinProjectDir2Plus(psi); else h = spinProjectDir2Minus(psi); break;
+      default: if (plus) h = spinProjectDir3Plus(psi); else h = spinProjectDir3Minus(psi); break;
+      }
+    }
+
+    //! Spin reconstruct a single site in direction mu and accumulate
+    template<typename S, typename HS>
+    inline
+    void spinReconstructSiteAdd(S& chi, const HS& h, int mu, bool plus)
+    {
+      switch(mu)
+      {
+      case 0:  if (plus) chi += spinReconstructDir0Plus(h); else chi += spinReconstructDir0Minus(h); break;
+      case 1:  if (plus) chi += spinReconstructDir1Plus(h); else chi += spinReconstructDir1Minus(h); break;
+      case 2:  if (plus) chi += spinReconstructDir2Plus(h); else chi += spinReconstructDir2Minus(h); break;
+      default: if (plus) chi += spinReconstructDir3Plus(h); else chi += spinReconstructDir3Minus(h); break;
+      }
+    }
+
+    //! The link on one site, rebuilt if held compressed
+    template<typename U>
+    inline
+    void siteLink(typename CompressedLinksT<U>::SiteMatrix_t& m,
+		  const U* u, const CompressedLinksT<U>* cu, int site)
+    {
+      if (cu)
+	cu->reconstructSite(m, site);
+      else
+	m = u->elem(site);
+    }
+
+    //! Arguments for the threaded site loops of one direction
+    template<typename T, typename HT, typename U>
+    struct FusedHopArgs
+    {
+      T* const* chi;                   /*!< N results */
+      const T* const* psi;             /*!< N sources */
+      HT* h;                           /*!< N half fermions, see applyFused */
+      const HT* hs;                    /*!< N backward shifted half fermions */
+      const U* u;                      /*!< the link, or null if compressed */
+      const CompressedLinksT<U>* cu;   /*!< the compressed link, or null */
+      int mu;                          /*!< direction */
+      bool fwd_plus;                   /*!< projector of the forward hop */
+      bool first;                      /*!< first direction: overwrite chi */
+      int cb;                          /*!< checkerboard of the sites */
+    };
+
+    //! Backward hop source: h[n](y) = adj(u(y)) P psi[n](y), projected and multiplied per site
+    template<typename T, typename HT, typename U, int N>
+    inline
+    void backHopSiteLoop(int lo, int hi, int myId, FusedHopArgs<T,HT,U>* a)
+    {
+      const int* tab = rb[a->cb].siteTable().slice();
+      typename CompressedLinksT<U>::SiteMatrix_t m;
+      typename HT::Subtype_t ph;
+
+      for(int ssite=lo; ssite < hi; ++ssite)
+      {
+	int site = tab[ssite];
+	siteLink(m, a->u, a->cu, site);
+
+	for(int n=0; n < N; ++n)
+	{
+	  spinProjectSite(ph, a->psi[n]->elem(site), a->mu, ! a->fwd_plus);
+	  a->h[n].elem(site) = adj(m) * ph;
+	}
+      }
+    }
+
+    //! Both hops into chi: chi[n](x) += R u(x) h[n](x) + R hs[n](x), per site
+    template<typename T, typename HT, typename U, int N>
+    inline
+    void accumHopSiteLoop(int lo, int hi, int myId, FusedHopArgs<T,HT,U>* a)
+    {
+      const int* tab = rb[a->cb].siteTable().slice();
+      typename CompressedLinksT<U>::SiteMatrix_t m;
+      typename HT::Subtype_t uh;
+
+      for(int ssite=lo; ssite < hi; ++ssite)
+      {
+	int site = tab[ssite];
+	siteLink(m, a->u, a->cu, site);
+
+	for(int n=0; n < N; ++n)
+	{
+	  typename T::Subtype_t& c = a->chi[n]->elem(site);
+	  if (a->first)
+	    zero_rep(c);
+
+	  uh = m * a->h[n].elem(site);
+	  spinReconstructSiteAdd(c, uh, a->mu, a->fwd_plus);
+	  spinReconstructSiteAdd(c, a->hs[n].elem(site), a->mu, ! a->fwd_plus);
+	}
+      }
+    }
+#endif
+  }
+
+
   //! General Wilson-Dirac dslash
   /*!
    * \ingroup linop
@@ -88,6 +237,28 @@ namespace Chroma
      */
     void apply (T& chi, const T& psi, enum PlusMinus isign, int cb) const;
 
+    /**
+     * Apply a dslash to N vectors at once
+     *
+     * Each gauge link is read once per site and applied to all N 
+     * (half) spinors, so the gauge field is streamed once per call 
+     * instead of N times.
+     *
+     * \param chi     results, chi[offset] .. chi[offset+N-1]     (Write)
+     * \param psi     sources, psi[offset] .. psi[offset+N-1]     (Read)
+     * \param isign   D'^dag or D'  ( MINUS | PLUS ) resp.        (Read)
+     * \param cb      Checkerboard of OUTPUT std::vector               (Read) 
+     * \param offset  first vector of the block                   (Read) 
+     */
+    template<int N>
+    void applyN (multi1d<T>& chi, const multi1d<T>& psi, enum PlusMinus isign, int cb, int offset) const;
+
+    //! Apply a dslash to a block of vectors, in chunks of the fused kernel
+    void applyBlock (multi1d<T>& chi, const multi1d<T>& psi, enum PlusMinus isign, int cb) const;
+
+    //! Keep the both-checkerboard block apply visible
+    using WilsonDslashBase<T,P,Q>::applyBlock;
+
     //! Return the fermion BC object for this linear operator
     const FermBC<T,P,Q>& getFermBC() const {return *fbc;}
 
@@ -96,9 +267,17 @@ namespace Chroma
     const multi1d<Real>& getCoeffs() const {return coeffs;}
 
   private:
+    //! The fused kernel on N vectors given by pointers
+    template<int N>
+    void applyFused (T* const* chi, const T* const* psi, enum PlusMinus isign, int cb) const;
+
+    typedef CompressedLinksT<typename LinkFieldType<Q>::Type_t> CompLinks_t;
+
     multi1d<Real> coeffs;  /*!< Nd array of coefficients of terms in the action */
     Handle< FermBC<T,P,Q> >  fbc;
-    Q  u;
+    Q  u;                  /*!< links, empty when they are held compressed */
+    LinkCompressType link_compress;
+    multi1d<CompLinks_t> cu;  /*!< compressed links */
   };
 
   //! General Wilson-Dirac dslash
@@ -131,11 +310,12 @@ namespace Chroma
 
   //! Empty constructor
   template<typename T, typename P, typename Q>
-  QDPWilsonDslashT<T,P,Q>::QDPWilsonDslashT() {}
+  QDPWilsonDslashT<T,P,Q>::QDPWilsonDslashT() : link_compress(LINK_COMPRESS_NONE) {}
   
   //! Full constructor
   template<typename T, typename P, typename Q>
-  QDPWilsonDslashT<T,P,Q>::QDPWilsonDslashT(Handle< FermState<T,P,Q> > state)
+  QDPWilsonDslashT<T,P,Q>::QDPWilsonDslashT(Handle< FermState<T,P,Q> > state) :
+    link_compress(LINK_COMPRESS_NONE)
   {
     create(state);
   }
@@ -143,7 +323,8 @@ namespace Chroma
   //! Full constructor with anisotropy
   template<typename T, typename P, typename Q>
   QDPWilsonDslashT<T,P,Q>::QDPWilsonDslashT(Handle< FermState<T,P,Q> > state,
-				   const AnisoParam_t& aniso_) 
+				   const AnisoParam_t& aniso_) :
+    link_compress(LINK_COMPRESS_NONE)
   {
     create(state, aniso_);
   }
@@ -151,7 +332,8 @@ namespace Chroma
   //! Full constructor with general coefficients
   template<typename T, typename P, typename Q>
   QDPWilsonDslashT<T,P,Q>::QDPWilsonDslashT(Handle< FermState<T,P,Q> > state,
-				   const multi1d<Real>& coeffs_)
+				   const multi1d<Real>& coeffs_) :
+    link_compress(LINK_COMPRESS_NONE)
   {
     create(state, coeffs_);
   }
@@ -209,6 +391,38 @@ namespace Chroma
     {
       u[mu] *= coeffs[mu];
     }
+
+    // Optionally hold the links compressed. The scale of each link carries
+    // the anisotropy coefficient and the boundary sign or phase.
+    link_compress = state->getLinkCompression();
+#if defined(QDP_IS_QDPJIT)
+    if (link_compress != LINK_COMPRESS_NONE)
+    {
+      QDPIO::cout << "QDPWilsonDslash: link compression not available with QDPJIT, using NONE" << std::endl;
+      link_compress = LINK_COMPRESS_NONE;
+    }
+#endif
+
+    if (link_compress != LINK_COMPRESS_NONE)
+    {
+      cu.resize(Nd);
+      for(int mu=0; mu < Nd; ++mu)
+	cu[mu].create(u[mu], link_compress);
+
+      u.resize(0);
+      QDPIO::cout << "QDPWilsonDslash: links held with " << cu[0].numReals() << " reals per link";
+      if (link_compress != LINK_COMPRESS_FIXED16)
+      {
+	QDPIO::cout << ", scales per direction on node 0:";
+	for(int mu=0; mu < Nd; ++mu)
+	  QDPIO::cout << " " << cu[mu].numScales();
+      }
+      QDPIO::cout << std::endl;
+    }
+    else
+    {
+      cu.resize(0);
+    }
   }
 
 
@@ -229,6 +443,18 @@ namespace Chroma
 			  enum PlusMinus isign, int cb) const
   {
     START_CODE();
+
+    // Compressed links only go through the fused kernel
+    if (link_compress != LINK_COMPRESS_NONE)
+    {
+      T* c[1] = { &chi };
+      const T* p[1] = { &psi };
+      applyFused<1>(c, p, isign, cb);
+
+      END_CODE();
+      return;
+    }
+
 #if (QDP_NC == 2) || (QDP_NC == 3)
     /*     F 
      *   a2  (x)  :=  U  (x) (1 - isign gamma  ) psi(x)
@@ -302,6 +528,139 @@ namespace Chroma
     END_CODE();
   }
 
+  //! Fused multi-vector Wilson-Dirac dslash
+  /*! \ingroup linop
+   *
+   * Same operator as apply, for N vectors. Per direction there are two
+   * threaded site loops, each reading the link once per site for all N
+   * vectors:
+   *
+   *  - on 1-cb the backward hop source adj(u(y)) P psi(y) is projected
+   *    and multiplied in one go;
+   *  - on cb the forward hop is multiplied by u(x) and both hops are
+   *    reconstructed and accumulated into chi.
+   *
+   * In between QDP++ does the shifts, and hence the communications.
+   * The only lattice temporaries are the shifted half spinors, two per
+   * vector: h[n] holds the backward source on 1-cb and the forward
+   * projected psi(x+mu) on cb, hs[n] the backward source shifted onto cb.
+   *
+   * With compressed links each link is rebuilt once per site in the
+   * site loops and used for all N vectors.
+   */
+  template<typename T, typename P, typename Q>
+  template<int N>
+  void 
+  QDPWilsonDslashT<T,P,Q>::applyFused (T* const* chi, const T* const* psi, 
+				       enum PlusMinus isign, int cb) const
+  {
+    START_CODE();
+#if ((QDP_NC == 2) || (QDP_NC == 3)) && ! defined(QDP_IS_QDPJIT)
+    typedef typename HalfFermionType<T>::Type_t HT;
+    typedef typename LinkFieldType<Q>::Type_t U;
+
+    // PLUS:  forward hop uses (1 - gamma_mu), backward hop (1 + gamma_mu)
+    // MINUS: the other way round
+    const bool compressed = (link_compress != LINK_COMPRESS_NONE);
+
+    HT h[N];
+    HT hs[N];
+
+    QDPWilsonDslashEnv::FusedHopArgs<T,HT,U> a;
+    a.chi = chi;
+    a.psi = psi;
+    a.h = h;
+    a.hs = hs;
+    a.fwd_plus = (isign == MINUS);
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      a.u  = compressed ? 0 : &u[mu];
+      a.cu = compressed ? &cu[mu] : 0;
+      a.mu = mu;
+      a.first = (mu == 0);
+
+      // adj(u(y)) P psi(y) on 1-cb
+      a.cb = 1-cb;
+      dispatch_to_threads(rb[1-cb].numSiteTable(), a, 
+			  QDPWilsonDslashEnv::backHopSiteLoop<T,HT,U,N>);
+
+      // The shifts. The backward source is read on 1-cb before h is
+      // overwritten on cb
+      for(int n=0; n < N; ++n)
+      {
+	hs[n][rb[cb]] = shift(h[n], BACKWARD, mu);
+	QDPWilsonDslashEnv::shiftSpinProjectDir(h[n], *psi[n], mu, a.fwd_plus, rb[cb]);
+      }
+
+      // u(x) P psi(x+mu) and both reconstructs on cb
+      a.cb = cb;
+      dispatch_to_threads(rb[cb].numSiteTable(), a, 
+			  QDPWilsonDslashEnv::accumHopSiteLoop<T,HT,U,N>);
+    }
+
+    for(int n=0; n < N; ++n)
+      QDPWilsonDslashT<T,P,Q>::getFermBC().modifyF(*chi[n], QDP::rb[cb]);
+#else
+    // Compression is never enabled here
+    for(int n=0; n < N; ++n)
+      apply(*chi[n], *psi[n], isign, cb);
+#endif
+    END_CODE();
+  }
+
+
+  //! Fused multi-vector Wilson-Dirac dslash
+  /*! \ingroup linop */
+  template<typename T, typename P, typename Q>
+  template<int N>
+  void 
+  QDPWilsonDslashT<T,P,Q>::applyN (multi1d<T>& chi, const multi1d<T>& psi, 
+				   enum PlusMinus isign, int cb, int offset) const
+  {
+    T* c[N];
+    const T* p[N];
+    for(int n=0; n < N; ++n)
+    {
+      c[n] = &chi[offset+n];
+      p[n] = &psi[offset+n];
+    }
+
+    applyFused<N>(c, p, isign, cb);
+  }
+
+
+  //! Wilson-Dirac dslash on a block of vectors
+  /*! \ingroup linop
+   *
+   * The block is processed in chunks of 12 (a full spin-color propagator)
+   * and 4, with any remainder done one std::vector at a time.
+   */
+  template<typename T, typename P, typename Q>
+  void 
+  QDPWilsonDslashT<T,P,Q>::applyBlock (multi1d<T>& chi, const multi1d<T>& psi, 
+				       enum PlusMinus isign, int cb) const
+  {
+    START_CODE();
+
+    const int num = psi.size();
+    if (chi.size() != num)
+      chi.resize(num);
+
+    int i = 0;
+    for(; i+12 <= num; i += 12)
+      applyN<12>(chi, psi, isign, cb, i);
+
+    for(; i+4 <= num; i += 4)
+      applyN<4>(chi, psi, isign, cb, i);
+
+    for(; i < num; ++i)
+      apply(chi[i], psi[i], isign, cb);
+
+    END_CODE();
+  }
+
+
   typedef QDPWilsonDslashT<LatticeFermion,
 			   multi1d<LatticeColorMatrix>,
 			   multi1d<LatticeColorMatrix> > QDPWilsonDslash;
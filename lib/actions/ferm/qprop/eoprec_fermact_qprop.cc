@@ -79,6 +79,63 @@ namespace Chroma
       return res;
     }
 
+    //! Solve the linear system for a block of sources
+    /*!
+     * The odd checkerboard systems are handed to the inverter as one block
+     *
+     * \param psi      quark propagators ( Modify )
+     * \param chi      sources ( Read )
+     * \return results, one per source
+     */
+    multi1d<SystemSolverResults_t> solveBlock (multi1d<T>& psi, const multi1d<T>& chi) const
+    {
+      START_CODE();
+
+      const int N = chi.size();
+      if (psi.size() != N)
+	psi.resize(N);
+
+      /* Step (i) */
+      /* chi_tmp =  chi_o - D_oe * A_ee^-1 * chi_e */
+      multi1d<T> chi_tmp(N);
+      for(int i=0; i < N; ++i)
+      {
+	T tmp1, tmp2;
+
+	A->evenEvenInvLinOp(tmp1, chi[i], PLUS);
+	A->oddEvenLinOp(tmp2, tmp1, PLUS);
+	chi_tmp[i][rb[1]] = chi[i] - tmp2;
+      }
+
+      // Call inverter
+      multi1d<SystemSolverResults_t> res = invA->solveBlock(psi, chi_tmp);
+
+      for(int i=0; i < N; ++i)
+      {
+	/* Step (ii) */
+	/* psi_e = A_ee^-1 * [chi_e  -  D_eo * psi_o] */
+	{
+	  T tmp1, tmp2;
+
+	  A->evenOddLinOp(tmp1, psi[i], PLUS);
+	  tmp2[rb[0]] = chi[i] - tmp1;
+	  A->evenEvenInvLinOp(psi[i], tmp2, PLUS);
+	}
+  
+	// Compute residual
+	{
+	  T  r;
+	  A->unprecLinOp(r, psi[i], PLUS);
+	  r -= chi[i];
+	  res[i].resid = sqrt(norm2(r));
+	}
+      }
+
+      END_CODE();
+
+      return res;
+    }
+
   private:
     // Hide default constructor
     PrecFermActQprop() {}
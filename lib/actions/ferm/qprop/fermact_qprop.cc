@@ -65,6 +65,35 @@ namespace Chroma
       return res;
     }
 
+    //! Solve the linear system for a block of sources
+    /*!
+     * \param psi      quark propagators ( Modify )
+     * \param chi      sources ( Read )
+     * \return results, one per source
+     */
+    multi1d<SystemSolverResults_t> solveBlock (multi1d<T>& psi, const multi1d<T>& chi) const
+    {
+      START_CODE();
+
+      // Call inverter
+      multi1d<SystemSolverResults_t> res = invA->solveBlock(psi, chi);
+  
+      // Compute residuals
+      {
+	multi1d<T>  r;
+	A->applyBlock(r, psi, PLUS);
+	for(int i=0; i < chi.size(); ++i)
+	{
+	  r[i] -= chi[i];
+	  res[i].resid = sqrt(norm2(r[i]));
+	}
+      }
+
+      END_CODE();
+
+      return res;
+    }
+
   private:
     // Hide default constructor
     FermActQprop() {}
@@ -64,55 +64,68 @@ namespace Chroma
       break;
     }
 
-//  LatticeFermion psi = zero;  // note this is ``zero'' and not 0
+    // All the color and spin sources are handed to the solver as one block.
+    // Solvers with a block implementation apply the operator to all of 
+    // them in one sweep, the rest solve them one after another.
+    const int num_spin = end_spin - start_spin;
+    const int num_src  = Nc*num_spin;
+
+    multi1d<LatticeFermion> psi(num_src);
+    multi1d<LatticeFermion> chi(num_src);
+    multi1d<Real> fact(num_src);
 
-    // This version loops over all color and spin indices
     for(int color_source = 0; color_source < Nc; ++color_source)
     {
       for(int spin_source = start_spin; spin_source < end_spin; ++spin_source)
       {
-	LatticeFermion psi = zero;  // note this is ``zero'' and not 0
-	LatticeFermion chi;
+	int n = spin_source - start_spin + num_spin*color_source;
 
-	// Extract a fermion source
-	PropToFerm(q_src, chi, color_source, spin_source);
+	psi[n] = zero;  // note this is ``zero'' and not 0
 
-	// Use the last initial guess as the current initial guess
+	// Extract a fermion source
+	PropToFerm(q_src, chi[n], color_source, spin_source);
 
 	/* 
 	 * Normalize the source in case it is really huge or small - 
 	 * a trick to avoid overflows or underflows
 	 */
-	Real fact = 1.0;
-	Real nrm = sqrt(norm2(chi));
+	fact[n] = 1.0;
+	Real nrm = sqrt(norm2(chi[n]));
 	if (toFloat(nrm) != 0.0)
-	  fact /= nrm;
+	  fact[n] /= nrm;
 
 	// Rescale
-	chi *= fact;
-
-	// Compute the propagator for given source color/spin.
-	{
-	  SystemSolverResults_t result = (*qprop)(psi,chi);
-	  ncg_had += result.n_count;
-
-	  push(xml_out,"Qprop");
-	  write(xml_out, "color_source", color_source);
-	  write(xml_out, "spin_source", spin_source);
-	  write(xml_out, "n_count", result.n_count);
-	  write(xml_out, "resid", result.resid);
-	  pop(xml_out);
-	}
+	chi[n] *= fact[n];
+      }
+    }
+
+    // Compute the propagator for all source colors/spins.
+    multi1d<SystemSolverResults_t> result = qprop->solveBlock(psi,chi);
+
+    for(int color_source = 0; color_source < Nc; ++color_source)
+    {
+      for(int spin_source = start_spin; spin_source < end_spin; ++spin_source)
+      {
+	int n = spin_source - start_spin + num_spin*color_source;
+
+	ncg_had += result[n].n_count;
+
+	push(xml_out,"Qprop");
+	write(xml_out, "color_source", color_source);
+	write(xml_out, "spin_source", spin_source);
+	write(xml_out, "n_count", result[n].n_count);
+	write(xml_out, "resid", result[n].resid);
+	pop(xml_out);
 
 	// Unnormalize the source following the inverse of the normalization above
-	fact = Real(1) / fact;
-	psi *= fact;
+	Real ifact = Real(1) / fact[n];
+	psi[n] *= ifact;
 
 	/*
 	 * Move the solution to the appropriate components
 	 * of quark propagator.
 	 */
-	FermToProp(psi, q_sol, color_source, spin_source);
+	FermToProp(psi[n], q_sol, color_source, spin_source);
       }	/* end loop over spin_source */
     } /* end loop over color_source */
 
@@ -77,7 +77,13 @@ namespace Chroma
       
       for(int level=params.n_smear; level > 0; level--) {
 	QDPIO::cout << "Recursing level " << level << " to level " << level -1 << std::endl;
-	Stouting::deriv_recurse(F_thin, params.smear_in_this_dirP, params.rho, smeared_links[level-1]);
+	if( params.cache_force ) {
+	  Stouting::deriv_recurse(F_thin, params.smear_in_this_dirP, params.rho, smeared_links[level-1],
+				  level_cache[level-1]);
+	}
+	else {
+	  Stouting::deriv_recurse(F_thin, params.smear_in_this_dirP, params.rho, smeared_links[level-1]);
+	}
 	
 	// gbc->zero(F_thin);
 	
@@ -131,6 +137,10 @@ namespace Chroma
       }
       
       
+      // Smearing quantities reused by the force, one entry per smeared level.
+      // The state is rebuilt for every new thin field, so they can never go stale
+      level_cache.resize(params.cache_force ? params.n_smear : 0);
+      
       // Copy thin links into smeared_links[0]
       for(int mu=0; mu < Nd; mu++) { 
 	(smeared_links[0])[mu] = u_[mu];
@@ -143,7 +153,13 @@ namespace Chroma
       
       // Iterate up the smearings
       for(int i=1; i <= params.n_smear; i++) {
-	Stouting::smear_links(smeared_links[i-1], smeared_links[i], params.smear_in_this_dirP, params.rho);
+	if( params.cache_force ) {
+	  Stouting::smear_links(smeared_links[i-1], smeared_links[i], params.smear_in_this_dirP, params.rho,
+				level_cache[i-1]);
+	}
+	else {
+	  Stouting::smear_links(smeared_links[i-1], smeared_links[i], params.smear_in_this_dirP, params.rho);
+	}
 
 	// If the gauge BC's are nontrivial 
 	// apply at every level - eg SF BC's
@@ -163,6 +179,7 @@ namespace Chroma
   private:
     Handle< GaugeBC<P,Q> >  gbc;
     multi1d<Q> smeared_links;
+    multi1d< Stouting::StoutLevelCache > level_cache;
     StoutFermStateParams params;
   };
 
@@ -31,5 +31,6 @@
 #include "enum_md_integrator_type_io.h"
 #include "enum_inner_solver_type_io.h"
 #include "enum_quarkspintype_io.h"
+#include "enum_linkcompresstype_io.h"
 
 #endif
@@ -0,0 +1,37 @@
+/*! \file
+ * \brief Enum for the storage format of gauge links in fermion operators
+ */
+
+#include "enum_linkcompresstype_io.h"
+
+namespace Chroma 
+{ 
+  namespace LinkCompressTypeEnv 
+  { 
+    bool registerAll(void) 
+    {
+      bool success = true; 
+      success &= theLinkCompressTypeMap::Instance().registerPair(std::string("NONE"), LINK_COMPRESS_NONE );
+      success &= theLinkCompressTypeMap::Instance().registerPair(std::string("RECONSTRUCT_12"), LINK_COMPRESS_12);
+      success &= theLinkCompressTypeMap::Instance().registerPair(std::string("RECONSTRUCT_8"), LINK_COMPRESS_8);
+      success &= theLinkCompressTypeMap::Instance().registerPair(std::string("FIXED_16"), LINK_COMPRESS_FIXED16);
+      return success;
+    }
+
+    bool registered = registerAll();
+    const std::string typeIDString = "LinkCompressType";
+  };
+  using namespace LinkCompressTypeEnv;
+
+  //! Read a link compression type enum
+  void read(XMLReader& xml_in,  const std::string& path, LinkCompressType& t) 
+  {
+    theLinkCompressTypeMap::Instance().read(typeIDString, xml_in, path,t);
+  }
+  
+  //! Write a link compression type enum
+  void write(XMLWriter& xml_out, const std::string& path, const LinkCompressType& t) 
+  {
+    theLinkCompressTypeMap::Instance().write(typeIDString, xml_out, path, t);
+  }
+}
@@ -0,0 +1,64 @@
+// -*- C++ -*-
+
+/*! \file
+ * \brief Enum for the storage format of gauge links in fermion operators
+ *
+ */
+
+#ifndef enum_linkcompresstype_io_h
+#define enum_linkcompresstype_io_h
+
+#include "chromabase.h"
+#include <string>
+#include "singleton.h"
+#include "io/enum_io/enum_type_map.h"
+
+
+namespace Chroma 
+{
+  // LinkCompressType --------------------------------------
+  /*!
+   * Types and structures
+   *
+   * \ingroup io
+   *
+   * @{
+   */
+ 
+  //! Link compression type
+  /*! \ingroup io */
+  enum LinkCompressType 
+  {
+    LINK_COMPRESS_NONE,         /*!< full 18 real links */
+    LINK_COMPRESS_12,           /*!< two rows, third reconstructed */
+    LINK_COMPRESS_8,            /*!< 8 parameters, SU(3) reconstructed */
+    LINK_COMPRESS_FIXED16       /*!< 18 int16 relative to a per link norm */
+  };
+
+
+  //! Link compression type env
+  /*! \ingroup io */
+  namespace LinkCompressTypeEnv 
+  { 
+    extern const std::string typeIDString;
+    extern bool registered; 
+    bool registerAll(void);   // Forward declaration
+  }
+
+  //! A singleton to hold the typemap
+  /*! \ingroup io */
+  typedef SingletonHolder<EnumTypeMap<LinkCompressType> > theLinkCompressTypeMap;
+
+  // Reader and writer
+  //! Read a link compression type enum
+  /*! \ingroup io */
+  void read(XMLReader& r, const std::string& path, LinkCompressType& t);
+
+  //! Write a link compression type enum
+  /*! \ingroup io */
+  void write(XMLWriter& w, const std::string& path, const LinkCompressType& t);
+
+  /*! @} */   // end of group io
+
+}
+#endif
@@ -39,6 +39,24 @@ namespace Chroma
       (*this)(chi,psi,isign);
     }
 
+    //! Apply the operator onto a block of source vectors
+    /*! 
+     * Default implementation applies the operator one std::vector at a time.
+     * Operators that can reuse their gauge (and clover) data for several
+     * right hand sides in one sweep should override this.
+     *
+     * Named apart from operator() so overriding one does not hide the other.
+     */
+    virtual void applyBlock (multi1d<T>& chi, const multi1d<T>& psi, 
+			     enum PlusMinus isign) const
+    {
+      if (chi.size() != psi.size())
+	chi.resize(psi.size());
+
+      for(int i=0; i < psi.size(); ++i)
+	(*this)(chi[i], psi[i], isign);
+    }
+
     //! Return the subset on which the operator acts
     virtual const Subset& subset() const = 0;
 
@@ -234,6 +252,13 @@ namespace Chroma
       apply(d, psi, isign, 1);
     }
 
+    //! Apply operator on both checkerboards to a block of vectors
+    virtual void applyBlock (multi1d<T>& d, const multi1d<T>& psi, enum PlusMinus isign) const
+    {
+      applyBlock(d, psi, isign, 0);
+      applyBlock(d, psi, isign, 1);
+    }
+
     //! Apply checkerboarded linear operator
     /*! 
      * To avoid confusion (especially of the compilers!), call the checkerboarded
@@ -241,6 +266,20 @@ namespace Chroma
      */
     virtual void apply (T& chi, const T& psi, enum PlusMinus isign, int cb) const = 0;
 
+    //! Apply checkerboarded linear operator to a block of vectors
+    /*! 
+     * Default implementation calls apply one std::vector at a time.
+     * Kernels that can reuse each link for several vectors override this.
+     */
+    virtual void applyBlock (multi1d<T>& chi, const multi1d<T>& psi, enum PlusMinus isign, int cb) const
+    {
+      if (chi.size() != psi.size())
+	chi.resize(psi.size());
+
+      for(int i=0; i < psi.size(); ++i)
+	apply(chi[i], psi[i], isign, cb);
+    }
+
 
     //! Take deriv of D
     /*!
@@ -44,6 +44,16 @@ namespace Chroma
 	(*A)(chi, tmp, MINUS);
       }
 
+    //! Apply the operator onto a block of source vectors
+    /*! For this operator, the sign is ignored */
+    inline void applyBlock (multi1d<T>& chi, const multi1d<T>& psi, enum PlusMinus isign) const
+      {
+	multi1d<T>  tmp(psi.size());
+
+	A->applyBlock(tmp, psi, PLUS);
+	A->applyBlock(chi, tmp, MINUS);
+      }
+
     unsigned long nFlops(void) const {
       unsigned long nflops=2*A->nFlops();
       return nflops;
@@ -87,6 +87,10 @@ namespace Chroma
       read(paramtop, "site_orthog_basis", param.site_orthog_basis);
 
       param.link_smearing  = readXMLGroup(paramtop, "LinkSmearing", "LinkSmearingType");
+
+      param.disp_cache_max_mb = 1024;
+      if (paramtop.count("disp_cache_max_mb") != 0)
+	read(paramtop, "disp_cache_max_mb", param.disp_cache_max_mb);
     }
 
 
@@ -106,6 +110,7 @@ namespace Chroma
       write(xml, "decay_dir", param.decay_dir);
       write(xml, "site_orthog_basis", param.site_orthog_basis);
       xml << param.link_smearing.xml;
+      write(xml, "disp_cache_max_mb", param.disp_cache_max_mb);
 
       pop(xml);
     }
@@ -118,6 +123,10 @@ namespace Chroma
       read(inputtop, "gauge_id", input.gauge_id);
       read(inputtop, "colorvec_id", input.colorvec_id);
       read(inputtop, "baryon_op_file", input.baryon_op_file);
+
+      input.disp_cache_id = "";
+      if (inputtop.count("disp_cache_id") != 0)
+	read(inputtop, "disp_cache_id", input.disp_cache_id);
     }
 
     //! Write named objects
@@ -128,6 +137,8 @@ namespace Chroma
       write(xml, "gauge_id", input.gauge_id);
       write(xml, "colorvec_id", input.colorvec_id);
       write(xml, "baryon_op_file", input.baryon_op_file);
+      if (input.disp_cache_id != "")
+	write(xml, "disp_cache_id", input.disp_cache_id);
 
       pop(xml);
     }
@@ -569,11 +580,33 @@ namespace Chroma
 
       //
       // The object holding the displaced color std::vector std::maps  
+      // If a cache is named, the displaced vectors are shared with other measurements
       //
-      DispColorVectorMap smrd_disp_vecs(params.param.use_derivP,
-					params.param.displacement_length,
-					u_smr,
-					eigen_source);
+      Handle<DispColorVectorMap> disp_vecs;
+
+      if (params.named_obj.disp_cache_id != "")
+      {
+	DispColorVectorCache& cache = namedDispColorVectorCache(params.named_obj.disp_cache_id,
+								 params.param.disp_cache_max_mb);
+
+	disp_vecs = new DispColorVectorMap(params.param.use_derivP,
+					   params.param.displacement_length,
+					   u_smr,
+					   eigen_source,
+					   cache,
+					   dispColorVectorGaugeKey(params.named_obj.gauge_id,
+								   params.param.link_smearing.xml, u_smr),
+					   params.named_obj.colorvec_id);
+      }
+      else
+      {
+	disp_vecs = new DispColorVectorMap(params.param.use_derivP,
+					   params.param.displacement_length,
+					   u_smr,
+					   eigen_source);
+      }
+
+      DispColorVectorMap& smrd_disp_vecs = *disp_vecs;
 
       //
       // DB storage
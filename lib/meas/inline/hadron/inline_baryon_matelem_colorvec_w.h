@@ -44,6 +44,7 @@ namespace Chroma
 	int                     decay_dir;              /*!< Decay direction */
 	multi1d<Displacement_t> displacement_list;      /*!< Array of displacements list to generate */
 	GroupXML_t              link_smearing;          /*!< link smearing xml */
+	int                     disp_cache_max_mb;      /*!< Memory of the displacement cache on each node */
 
 	// This all may need some work
 	bool                    site_orthog_basis;      /*!< Whether all the basis vectors are site level orthog */
@@ -54,6 +55,7 @@ namespace Chroma
 	std::string         gauge_id;               /*!< Gauge field */
 	std::string         colorvec_id;            /*!< LatticeColorVector EigenInfo */
 	std::string         baryon_op_file;          /*!< File name for creation operators */
+	std::string         disp_cache_id;          /*!< Shared displacement cache, optional */
       };
 
       Param_t        param;      /*!< Parameters */    
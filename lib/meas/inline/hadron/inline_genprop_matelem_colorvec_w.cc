@@ -14,6 +14,7 @@
 #include "qdp_map_obj.h"
 #include "util/ferm/key_val_db.h"
 #include "util/ferm/key_prop_colorvec.h"
+#include "util/ferm/timeslice_contract.h"
 #include "util/ft/sftmom.h"
 #include "util/info/proginfo.h"
 #include "meas/inline/make_xml_file.h"
@@ -611,18 +612,51 @@ namespace Chroma
 	swiss.reset();
 	swiss.start();
 
-	// Big loop over the momentum projection
-	for(int mom_num = 0 ; mom_num < phases.numMom() ; ++mom_num) 
+	// Loop over spins
+	for(int spin_r=0; spin_r < Ns; ++spin_r)
 	{
-	  // Loop over spins
-	  for(int spin_r=0; spin_r < Ns; ++spin_r)
+	  QDPIO::cout << "spin_r = " << spin_r << std::endl; 
+
+	  // Displace the right vectors once for all the spin_l and momenta,
+	  // and block them by time slice for the contractions
+	  TimeSliceBlock right(phases.getSet(), num_vecs);
+
+	  for(int j = 0; j < num_vecs; ++j)
+	  {
+	    KeyPropColorVec_t key_r;
+	    key_r.t_source     = t_source;
+	    key_r.colorvec_src = j;
+	    key_r.spin_src     = spin_r;
+		  
+	    LatticeFermion tmpvec; source_ferm_map.get(key_r, tmpvec);
+
+	    LatticeFermion shift_ferm = Gamma(gamma_tmp) * displace(u_smr, 
+								    tmpvec,
+								    params.param.displacement_length, 
+								    disp);
+	    right.set(j, shift_ferm);
+	  }
+
+	  for(int spin_l=0; spin_l < Ns; ++spin_l)
 	  {
-	    QDPIO::cout << "spin_r = " << spin_r << std::endl; 
+	    QDPIO::cout << "spin_l = " << spin_l << std::endl; 
+
+	    TimeSliceBlock left(phases.getSet(), num_vecs);
 
-	    for(int spin_l=0; spin_l < Ns; ++spin_l)
+	    for(int i = 0; i < num_vecs; ++i)
 	    {
-	      QDPIO::cout << "spin_l = " << spin_l << std::endl; 
+	      KeyPropColorVec_t key_l;
+	      key_l.t_source     = t_sink;
+	      key_l.colorvec_src = i;
+	      key_l.spin_src     = spin_l;
+
+	      LatticeFermion tmpvec_sink; sink_ferm_map.get(key_l, tmpvec_sink);
+	      left.set(i, tmpvec_sink);
+	    }
 
+	    // Big loop over the momentum projection
+	    for(int mom_num = 0 ; mom_num < phases.numMom() ; ++mom_num) 
+	    {
 	      // The keys for the spin and displacements for this particular elemental operator
 	      // No displacement for left colorstd::vector, only displace right colorstd::vector
 	      // Invert the time - make it an independent key
@@ -640,75 +674,41 @@ namespace Chroma
 		buf[t].key.key().mom           = phases.numToMom(mom_num);
 		buf[t].key.key().gamma         = gamma;
 		buf[t].key.key().displacement  = disp; // only right colorstd::vector
-
-		buf[t].val.data().op.resize(num_vecs, num_vecs);
 	      }
 
-	      for(int j = 0; j < params.param.num_vecs; ++j)
-	      {
-		KeyPropColorVec_t key_r;
-		key_r.t_source     = t_source;
-		key_r.colorvec_src = j;
-		key_r.spin_src     = spin_r;
-		  
-		// Displace the right std::vector and multiply by the momentum phase
-
-		LatticeFermion shift_ferm;
-		{
-		  LatticeFermion tmpvec; source_ferm_map.get(key_r, tmpvec);
-
-		  shift_ferm = Gamma(gamma_tmp) * displace(u_smr, 
-							   tmpvec,
-							   params.param.displacement_length, 
-							   disp);
-		}
-
-		for(int i = 0; i < params.param.num_vecs; ++i)
-		{
-		  KeyPropColorVec_t key_l;
-		  key_l.t_source     = t_sink;
-		  key_l.colorvec_src = i;
-		  key_l.spin_src     = spin_l;
-		  
-		  watch.reset();
-		  watch.start();
-
-		  // Contract over color indices
-		  // Do the relevant quark contraction
-		  LatticeFermion tmpvec_sink; sink_ferm_map.get(key_l, tmpvec_sink);
-
-		  LatticeComplex lop = localInnerProduct(tmpvec_sink, shift_ferm);
+	      // Reweight the phase in case there was momentum averaging
+	      Real reweight;
+	      if (phases.multiplicity(mom_num) > 0)
+		reweight = Real(phases.multiplicity(mom_num));
+	      else
+		reweight = 1.0;
 
-		  // Reweight the phase in case there was momentum averaging
-		  Real reweight;
-		  if (phases.multiplicity(mom_num) > 0)
-		    reweight = Real(phases.multiplicity(mom_num));
-		  else
-		    reweight = 1.0;
+	      watch.reset();
+	      watch.start();
 
-		  // Slow fourier-transform
-		  multi1d<ComplexD> op_sum = sumMulti(reweight * phases[mom_num] * lop, phases.getSet());
+	      // Contract over color and spin indices: all (i,j) pairs and time slices at once
+	      multi1d< multi2d<ComplexD> > op_sum;
+	      timeSliceInnerProducts(op_sum, left, right, reweight * phases[mom_num]);
 
-		  watch.stop();
+	      watch.stop();
 
-		  for(int tt=t_start; tt <= t_end; ++tt)
-		  {
-		    int t = tt % phases.numSubsets(); // mod back into a normal interval
-		    buf[t].val.data().op(i,j) = op_sum[t];
-		  }
-		} // end for i
-	      } // end for j
+	      for(int tt=t_start; tt <= t_end; ++tt)
+	      {
+		int t = tt % phases.numSubsets(); // mod back into a normal interval
+		buf[t].val.data().op = op_sum[t];
+	      }
 
-	      QDPIO::cout << "insert: mom= " << phases.numToMom(mom_num) << " displacement= " << disp << std::endl; 
+	      QDPIO::cout << "insert: mom= " << phases.numToMom(mom_num) << " displacement= " << disp 
+			  << "  contraction time= " << watch.getTimeInSeconds() << " secs" << std::endl; 
 	      for(int tt=t_start; tt <= t_end; ++tt)
 	      {
 		int t = tt % phases.numSubsets(); // mod back into a normal interval
 		qdp_db.insert(buf[t].key, buf[t].val);
 	      }
 
-	    } // end for spin_l
-	  } // end for spin_r
-	} // mom_num
+	    } // mom_num
+	  } // end for spin_l
+	} // end for spin_r
 
 	swiss.stop();
 
@@ -1,5 +1,6 @@
 /*! \file
- * \brief Use the IRL method to solve for eigenvalues and eigenvectors 
+ * \brief Use the IRL method, or a block Chebyshev filtered subspace
+ * iteration, to solve for eigenvalues and eigenvectors 
  * of the gauge-covariant laplacian.  
  */
 
@@ -11,6 +12,7 @@
 #include "meas/smear/gaus_smear.h"
 #include "meas/glue/mesplq.h"
 #include "util/ferm/subset_vectors.h"
+#include "util/ferm/timeslice_contract.h"
 #include "util/ferm/map_obj/map_obj_aggregate_w.h"
 #include "util/ferm/map_obj/map_obj_factory_w.h"
 #include "util/ft/sftmom.h"
@@ -18,6 +20,7 @@
 #include "meas/inline/make_xml_file.h"
 #include "actions/boson/operator/klein_gord.h"
 #include <qdp-lapack.h>
+#include <algorithm>
 
 #include "meas/inline/io/named_objmap.h"
 
@@ -59,6 +62,33 @@ namespace Chroma
       read(inputtop, "decay_dir", input.decay_dir);
       read(inputtop, "max_iter", input.max_iter);
       read(inputtop, "tol", input.tol);
+
+      input.method = "LANCZOS";
+      if (inputtop.count("method") == 1)
+	read(inputtop, "method", input.method);
+
+      input.filter_order = 20;
+      if (inputtop.count("filter_order") == 1)
+	read(inputtop, "filter_order", input.filter_order);
+
+      input.filter_lower = zero;
+      if (inputtop.count("filter_lower") == 1)
+	read(inputtop, "filter_lower", input.filter_lower);
+
+      input.filter_upper = Real(4*(Nd-1));
+      if (inputtop.count("filter_upper") == 1)
+	read(inputtop, "filter_upper", input.filter_upper);
+
+      input.num_guard = std::max(8, input.num_vecs/10);
+      if (inputtop.count("num_guard") == 1)
+	read(inputtop, "num_guard", input.num_guard);
+
+      if (input.method != "LANCZOS" && input.method != "BLOCK_CHEBYSHEV")
+      {
+	QDPIO::cerr << "LaplaceEigs: unknown method " << input.method << std::endl;
+	QDP_abort(1);
+      }
+
       input.link_smear = readXMLGroup(inputtop, "LinkSmearing", "LinkSmearingType");
     }
 
@@ -71,6 +101,11 @@ namespace Chroma
       write(xml, "decay_dir", out.decay_dir);
       write(xml, "max_iter", out.max_iter);
       write(xml, "tol", out.tol);
+      write(xml, "method", out.method);
+      write(xml, "filter_order", out.filter_order);
+      write(xml, "filter_lower", out.filter_lower);
+      write(xml, "filter_upper", out.filter_upper);
+      write(xml, "num_guard", out.num_guard);
       xml << out.link_smear.xml;
 
       pop(xml);
@@ -242,146 +277,18 @@ namespace Chroma
     }
     
     
-    // Real work done here
-    void 
-    InlineMeas::func(unsigned long update_no,
-		     XMLWriter& xml_out) 
+    //! Lanczos with the 12th order Chebyshev preconditioner, all time slices at once
+    void lanczosEigs(const multi1d<LatticeColorMatrix>& u_smr,
+		     const SftMom& phases,
+		     const Params::Param_t& param,
+		     multi1d<EVPair<LatticeColorVector> >& ev_pairs)
     {
-      START_CODE();
-      
-      StopWatch snoop;
-      snoop.reset();
-      snoop.start();
-      
-      // Test and grab a reference to the gauge field
-      multi1d<LatticeColorMatrix> u;
-      XMLBufferWriter gauge_xml;
-      try
-      {
-	u = TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >(params.named_obj.gauge_id);
-	TheNamedObjMap::Instance().get(params.named_obj.gauge_id).getRecordXML(gauge_xml);
-      }
-      catch( std::bad_cast )  {
-	QDPIO::cerr << name << ": caught dynamic cast error" << std::endl;
-	QDP_abort(1);
-      }
-      catch (const std::string& e) {
-	QDPIO::cerr << name << ": std::map call failed: " << e << std::endl;
-	QDP_abort(1);
-      }
-      
-      push(xml_out, "LaplaceEigs");
-      write(xml_out, "update_no", update_no);
-      
-      QDPIO::cout << name << ": Use the IRL method to solve for laplace eigenpairs" << std::endl;
-      
-      proginfo(xml_out);    // Print out basic program info
-      
-      // Write out the input
-      write(xml_out, "Input", params);
-      
-      // Write out the config header
-      write(xml_out, "Config_info", gauge_xml);
-      
-      push(xml_out, "Output_version");
-      write(xml_out, "out_version", 1);
-      pop(xml_out);
-      
-      // Calculate some gauge invariant observables just for info.
-      MesPlq(xml_out, "Observables", u);
-	  
-      //
-      // Smear the gauge field if needed
-      //
-      multi1d<LatticeColorMatrix> u_smr = u;
-      
-      try  { 
-	std::istringstream  xml_l(params.param.link_smear.xml);
-	XMLReader  linktop(xml_l);
-	QDPIO::cout << "Link smearing type = " 
-		    << params.param.link_smear.id
-		    << std::endl;
-	
-	Handle< LinkSmearing >
-	  linkSmearing(TheLinkSmearingFactory::Instance().createObject(params.param.link_smear.id, 
-								       linktop,params.param.link_smear.path));
-	(*linkSmearing)(u_smr);
-      }
-      catch(const std::string& e){
-	QDPIO::cerr << name << ": Caught Exception link smearing: "<<e<< std::endl;
-	QDP_abort(1);
-      }
-      
-      // Record the smeared observables
-      MesPlq(xml_out, "Smeared_Observables", u_smr);
-      
-      
-      //
-      // Create the output files
-      //
-      try {
-        // Generate a metadata
-	std::string file_str;
-        if (1)
-        {
-          XMLBufferWriter file_xml;
-
-          push(file_xml, "MODMetaData");
-          write(file_xml, "id", std::string("eigenColorVec"));
-          write(file_xml, "lattSize", QDP::Layout::lattSize());
-          write(file_xml, "num_vecs", params.param.num_vecs);
-          write(file_xml, "Config_info", gauge_xml);
-          pop(file_xml);
-
-          file_str = file_xml.str();
-        }
-
-	// Create the object
-	std::istringstream  xml_s(params.named_obj.colorvec_obj.xml);
-	XMLReader MapObjReader(xml_s);
-	
-	// Create the entry
-	TheNamedObjMap::Instance().create< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(params.named_obj.colorvec_id);
-	TheNamedObjMap::Instance().getData< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(params.named_obj.colorvec_id) =
-	  TheMapObjIntKeyColorEigenVecFactory::Instance().createObject(params.named_obj.colorvec_obj.id,
-								       MapObjReader,
-								       params.named_obj.colorvec_obj.path,
-								       file_str);
-      }
-      catch (std::bad_cast) {
-	QDPIO::cerr << name << ": caught dynamic cast error" << std::endl;
-	QDP_abort(1);
-      }
-      catch (const std::string& e) {
-	
-	QDPIO::cerr << name << ": error creating prop: " << e << std::endl;
-	QDP_abort(1);
-      }
-      
-      // Cast should be valid now
-      // Cast should be valid now
-      QDP::MapObject<int,EVPair<LatticeColorVector> >& color_vecs = 
-	*(TheNamedObjMap::Instance().getData< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(params.named_obj.colorvec_id));
-
-      
-      // The code goes here
-      StopWatch swatch;
       StopWatch fossil;
       fossil.reset();
-      swatch.reset();
-      swatch.start();
-	  
-      // Initialize the slow Fourier transform phases
-      SftMom phases(0, true, params.param.decay_dir);
-      
-      int num_vecs = params.param.num_vecs;
-      int nt = phases.numSubsets();
-      multi1d<EVPair<LatticeColorVector> >  ev_pairs(num_vecs);
-      for(int n=0; n < num_vecs; ++n) { 
-	ev_pairs[n].eigenValue.weights.resize(nt);
-      }
-      
-	  
+
+      const int num_vecs = param.num_vecs;
+      const int nt = phases.numSubsets();
+
       // Choose the starting eigenvectors to have identical 
       // components and unit norm. 
       // The norm is evaluated time slice by time slice
@@ -423,8 +330,8 @@ namespace Chroma
 	  
 	  
       //Build Krlov subspace
-      int kdim = 3 * params.param.num_vecs;
-      int j_decay = params.param.decay_dir;
+      int kdim = 3 * param.num_vecs;
+      int j_decay = param.decay_dir;
       
       QDPIO::cout << "Krylov Dim = " << kdim << std::endl; 
       
@@ -675,7 +582,7 @@ namespace Chroma
       //Get Eigenvectors
 
       QDPIO::cout << "Obtaining eigenvectors of the laplacian" << std::endl;
-      for (int k = 0 ; k < params.param.num_vecs ; ++k) {
+      for (int k = 0 ; k < param.num_vecs ; ++k) {
 	LatticeColorVector vec_k = zero;
 	
 	//LatticeColorVector lambda_v = zero;
@@ -765,9 +672,464 @@ namespace Chroma
 	}
 	
       }//k
+    }
+
+    //! -Laplacian on the time slices, spectrum in [0, 4*(Nd-1)]
+    void minusLaplacian(const multi1d<LatticeColorMatrix>& u,
+			const LatticeColorVector& psi,
+			LatticeColorVector& chi,
+			int j_decay)
+    {
+      klein_gord(u, psi, chi, Real(0), j_decay);
+    }
+
+
+#if ! defined(QDP_IS_QDPJIT)
+    //! Orthonormalize the vectors first..m-1 of a block on every time slice
+    /*!
+     * The vectors before first are orthonormal already and are left as
+     * they are. The others are projected on the complement of them and
+     * then V <- V S^{-1/2} with the Gram matrix S of the projected
+     * vectors. Done twice
+     */
+    void orthonormalize(TimeSliceBlock& vecs, TimeSliceBlock& tmp, const LatticeComplex& ones, int first = 0)
+    {
+      typedef std::complex<double> DComplex_t;
+
+      const int nt = vecs.numSubsets();
+      const int m  = vecs.numVecs();
+      const int ma = m - first;
+
+      for(int pass=0; pass < 2; ++pass)
+      {
+	multi1d< multi2d<ComplexD> > s;
+	timeSliceInnerProducts(s, vecs, vecs, ones);
+
+	multi1d< multi2d<ComplexD> > z(nt);
+	for(int t=0; t < nt; ++t)
+	{
+	  std::vector<DComplex_t> sd(m*m);
+	  for(int i=0; i < m; ++i)
+	    for(int j=0; j < m; ++j)
+	      sd[i*m + j] = DComplex_t(toDouble(real(s[t](i,j))), toDouble(imag(s[t](i,j))));
+
+	  // Gram matrix of  w_k = v_k - sum_{l < first} v_l <v_l,v_k>
+	  multi2d<ComplexD> sa(ma, ma);
+	  for(int i=0; i < ma; ++i)
+	    for(int j=0; j < ma; ++j)
+	    {
+	      DComplex_t sum = sd[(first+i)*m + first+j];
+	      for(int l=0; l < first; ++l)
+		sum -= std::conj(sd[l*m + first+i]) * sd[l*m + first+j];
+	      sa(i,j) = cmplx(Double(sum.real()), Double(sum.imag()));
+	    }
+
+	  multi1d<Double> w;
+	  char V = 'V'; char U = 'U';
+	  QDPLapack::zheev(V, U, sa, w);
+
+	  // Eigenvector l of S has components conj(sa(l,n)). Nearly
+	  // dependent vectors are not blown up beyond the precision.
+	  std::vector<DComplex_t> u(ma*ma);
+	  std::vector<DComplex_t> b(ma*ma);
+	  for(int l=0; l < ma; ++l)
+	  {
+	    double w_isqrt = 1.0 / std::sqrt(std::max(toDouble(w[l]), 1.0e-14*toDouble(w[ma-1])));
+	    for(int k=0; k < ma; ++k)
+	    {
+	      u[l*ma + k] = DComplex_t(toDouble(real(sa(l,k))), toDouble(imag(sa(l,k))));
+	      b[l*ma + k] = w_isqrt * u[l*ma + k];
+	    }
+	  }
+
+	  // S^{-1/2}
+	  std::vector<DComplex_t> r(ma*ma);
+	  for(int n=0; n < ma; ++n)
+	    for(int k=0; k < ma; ++k)
+	    {
+	      DComplex_t sum = 0;
+	      for(int l=0; l < ma; ++l)
+		sum += std::conj(u[l*ma + n]) * b[l*ma + k];
+	      r[n*ma + k] = sum;
+	    }
+
+	  // The locked vectors are kept, the others become  sum_j w_j S^{-1/2}(j,k)
+	  z[t].resize(m, m);
+	  for(int n=0; n < m; ++n)
+	    for(int k=0; k < m; ++k)
+	    {
+	      DComplex_t sum = 0;
+	      if (k < first)
+		sum = (n == k) ? 1 : 0;
+	      else if (n >= first)
+		sum = r[(n-first)*ma + k-first];
+	      else
+		for(int j=0; j < ma; ++j)
+		  sum -= sd[n*m + first+j] * r[j*ma + k-first];
+
+	      z[t](n,k) = cmplx(Double(sum.real()), Double(sum.imag()));
+	    }
+	}
+
+	timeSliceRotate(tmp, vecs, z);
+	vecs.swap(tmp);
+      }
+    }
+#endif
+
+
+    //! Chebyshev filtered block subspace iteration, all time slices at once
+    /*!
+     * A block of num_vecs + num_guard vectors is filtered with a scaled
+     * Chebyshev polynomial of -Laplacian that damps [filter_lower, filter_upper]
+     * and is Rayleigh-Ritz projected on every time slice. Leading vectors
+     * that are converged on all time slices are written to color_vecs at
+     * once and are no longer filtered (soft locking).
+     */
+    void blockChebyshevEigs(const multi1d<LatticeColorMatrix>& u_smr,
+			    const SftMom& phases,
+			    const Params::Param_t& param,
+			    QDP::MapObject<int,EVPair<LatticeColorVector> >& color_vecs,
+			    multi1d<EVPair<LatticeColorVector> >& ev_pairs)
+    {
+#if defined(QDP_IS_QDPJIT)
+      QDPIO::cerr << name << ": method BLOCK_CHEBYSHEV is not available with QDP-JIT" << std::endl;
+      QDP_abort(1);
+#else
+      const Set& set       = phases.getSet();
+      const int nt         = phases.numSubsets();
+      const int j_decay    = param.decay_dir;
+      const int num_vecs   = param.num_vecs;
+      const int m          = num_vecs + param.num_guard;
+      const double tol     = toDouble(param.tol);
+      const double upper   = toDouble(param.filter_upper);
+
+      // Zero momentum: the phases are 1
+      const LatticeComplex& ones = phases[0];
+
+      QDPIO::cout << name << ": block Chebyshev filtered subspace iteration, block size = " << m
+		  << "  filter order = " << param.filter_order << std::endl;
+
+      TimeSliceBlock vecs(set, m, Nc);
+      TimeSliceBlock avecs(set, m, Nc);
+      TimeSliceBlock tmp(set, m, Nc);
+
+      for(int k=0; k < m; ++k)
+      {
+	LatticeColorVector v;
+	gaussian(v);
+	vecs.set(k, v);
+      }
+      orthonormalize(vecs, tmp, ones);
+
+      multi1d< multi1d<double> > theta(nt);
+      for(int t=0; t < nt; ++t)
+	theta[t].resize(m);
+
+      int num_conv = 0;
+      int iter = 0;
+
+      for(iter=0; iter < param.max_iter; ++iter)
+      {
+	// Rayleigh-Ritz on every time slice
+	for(int k=0; k < m; ++k)
+	{
+	  LatticeColorVector v, av;
+	  vecs.get(k, v);
+	  minusLaplacian(u_smr, v, av, j_decay);
+	  avecs.set(k, av);
+	}
+
+	multi1d< multi2d<ComplexD> > h;
+	timeSliceInnerProducts(h, vecs, avecs, ones);
 
-      for(int n=0; n < num_vecs; n++) { 
-	color_vecs.insert(n, ev_pairs[n]);
+	multi1d< multi2d<ComplexD> > z(nt);
+	for(int t=0; t < nt; ++t)
+	{
+	  multi1d<Double> w;
+	  char V = 'V'; char U = 'U';
+	  QDPLapack::zheev(V, U, h[t], w);
+
+	  z[t].resize(m, m);
+	  for(int k=0; k < m; ++k)
+	  {
+	    theta[t][k] = toDouble(w[k]);
+	    for(int n=0; n < m; ++n)
+	      z[t](n,k) = conj(h[t](k,n));
+	  }
+	}
+
+	timeSliceRotate(tmp, vecs, z);
+	vecs.swap(tmp);
+	timeSliceRotate(tmp, avecs, z);
+	avecs.swap(tmp);
+
+	// Write out the leading vectors that are converged on all time slices
+	double resid = 0;
+	for(; num_conv < num_vecs; ++num_conv)
+	{
+	  LatticeColorVector v, av;
+	  vecs.get(num_conv, v);
+	  avecs.get(num_conv, av);
+
+	  LatticeReal lambda;
+	  for(int t=0; t < nt; ++t)
+	    lambda[set[t]] = Real(theta[t][num_conv]);
+
+	  LatticeColorVector r = av - lambda*v;
+	  multi1d<Double> r_norm2 = sumMulti(localNorm2(r), set);
+
+	  resid = 0;
+	  for(int t=0; t < nt; ++t)
+	    resid = std::max(resid, sqrt(toDouble(r_norm2[t])));
+
+	  if (resid > tol)
+	    break;
+
+	  ev_pairs[num_conv].eigenVector = v;
+	  for(int t=0; t < nt; ++t)
+	    ev_pairs[num_conv].eigenValue.weights[t] = Real(theta[t][num_conv]);
+
+	  color_vecs.insert(num_conv, ev_pairs[num_conv]);
+
+	  // Keep only the eigenvalues, the vector is in the map
+	  ev_pairs[num_conv].eigenVector = zero;
+	}
+
+	double lower = toDouble(param.filter_lower);
+	double a0 = theta[0][0];
+	for(int t=0; t < nt; ++t)
+	{
+	  if (toDouble(param.filter_lower) <= 0)
+	    lower = std::max(lower, theta[t][m-1]);
+	  a0 = std::min(a0, theta[t][0]);
+	}
+
+	QDPIO::cout << name << ": iter = " << iter
+		    << "  converged = " << num_conv << "/" << num_vecs
+		    << "  resid = " << resid
+		    << "  filter = [" << lower << "," << upper << "]" << std::endl;
+
+	if (num_conv == num_vecs)
+	  break;
+
+	if (lower >= upper || a0 >= lower)
+	{
+	  QDPIO::cerr << name << ": filter interval [" << lower << "," << upper
+		      << "] does not separate the wanted eigenvalues" << std::endl;
+	  QDP_abort(1);
+	}
+
+	// Scaled Chebyshev filter of the vectors not yet converged:
+	// damps [lower,upper], normalized to 1 at a0
+	const double e = (upper - lower) / 2;
+	const double c = (upper + lower) / 2;
+	const double sigma1 = e / (a0 - c);
+
+	for(int k=num_conv; k < m; ++k)
+	{
+	  LatticeColorVector x, y, ay;
+	  vecs.get(k, x);
+
+	  minusLaplacian(u_smr, x, ay, j_decay);
+	  y = Real(sigma1/e) * (ay - Real(c)*x);
+
+	  double sigma = sigma1;
+	  for(int i=2; i <= param.filter_order; ++i)
+	  {
+	    double sigma2 = 1 / (2/sigma1 - sigma);
+
+	    minusLaplacian(u_smr, y, ay, j_decay);
+	    LatticeColorVector ynew = Real(2*sigma2/e) * (ay - Real(c)*y) - Real(sigma*sigma2) * x;
+	    x = y;
+	    y = ynew;
+	    sigma = sigma2;
+	  }
+
+	  vecs.set(k, y);
+	}
+
+	// The converged vectors were written out as they are
+	orthonormalize(vecs, tmp, ones, num_conv);
+      }
+
+      if (num_conv < num_vecs)
+      {
+	QDPIO::cout << name << ": WARNING: only " << num_conv << " of " << num_vecs
+		    << " vectors converged after " << iter << " iterations. Writing the rest as they are" << std::endl;
+
+	for(int k=num_conv; k < num_vecs; ++k)
+	{
+	  vecs.get(k, ev_pairs[k].eigenVector);
+	  for(int t=0; t < nt; ++t)
+	    ev_pairs[k].eigenValue.weights[t] = Real(theta[t][k]);
+
+	  color_vecs.insert(k, ev_pairs[k]);
+	  ev_pairs[k].eigenVector = zero;
+	}
+      }
+
+      for(int k=0; k < num_vecs; ++k)
+	for(int t=0; t < nt; ++t)
+	  QDPIO::cout << "t = " << t << "  lap_evals[" << k << "] = " << ev_pairs[k].eigenValue.weights[t] << std::endl;
+#endif
+    }
+
+
+    // Real work done here
+    void 
+    InlineMeas::func(unsigned long update_no,
+		     XMLWriter& xml_out) 
+    {
+      START_CODE();
+      
+      StopWatch snoop;
+      snoop.reset();
+      snoop.start();
+      
+      // Test and grab a reference to the gauge field
+      multi1d<LatticeColorMatrix> u;
+      XMLBufferWriter gauge_xml;
+      try
+      {
+	u = TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >(params.named_obj.gauge_id);
+	TheNamedObjMap::Instance().get(params.named_obj.gauge_id).getRecordXML(gauge_xml);
+      }
+      catch( std::bad_cast )  {
+	QDPIO::cerr << name << ": caught dynamic cast error" << std::endl;
+	QDP_abort(1);
+      }
+      catch (const std::string& e) {
+	QDPIO::cerr << name << ": std::map call failed: " << e << std::endl;
+	QDP_abort(1);
+      }
+      
+      push(xml_out, "LaplaceEigs");
+      write(xml_out, "update_no", update_no);
+      
+      if (params.param.method == "BLOCK_CHEBYSHEV")
+	QDPIO::cout << name << ": Use a block Chebyshev filtered subspace iteration to solve for laplace eigenpairs" << std::endl;
+      else
+	QDPIO::cout << name << ": Use the IRL method to solve for laplace eigenpairs" << std::endl;
+      
+      proginfo(xml_out);    // Print out basic program info
+      
+      // Write out the input
+      write(xml_out, "Input", params);
+      
+      // Write out the config header
+      write(xml_out, "Config_info", gauge_xml);
+      
+      push(xml_out, "Output_version");
+      write(xml_out, "out_version", 1);
+      pop(xml_out);
+      
+      // Calculate some gauge invariant observables just for info.
+      MesPlq(xml_out, "Observables", u);
+	  
+      //
+      // Smear the gauge field if needed
+      //
+      multi1d<LatticeColorMatrix> u_smr = u;
+      
+      try  { 
+	std::istringstream  xml_l(params.param.link_smear.xml);
+	XMLReader  linktop(xml_l);
+	QDPIO::cout << "Link smearing type = " 
+		    << params.param.link_smear.id
+		    << std::endl;
+	
+	Handle< LinkSmearing >
+	  linkSmearing(TheLinkSmearingFactory::Instance().createObject(params.param.link_smear.id, 
+								       linktop,params.param.link_smear.path));
+	(*linkSmearing)(u_smr);
+      }
+      catch(const std::string& e){
+	QDPIO::cerr << name << ": Caught Exception link smearing: "<<e<< std::endl;
+	QDP_abort(1);
+      }
+      
+      // Record the smeared observables
+      MesPlq(xml_out, "Smeared_Observables", u_smr);
+      
+      
+      //
+      // Create the output files
+      //
+      try {
+        // Generate a metadata
+	std::string file_str;
+        if (1)
+        {
+          XMLBufferWriter file_xml;
+
+          push(file_xml, "MODMetaData");
+          write(file_xml, "id", std::string("eigenColorVec"));
+          write(file_xml, "lattSize", QDP::Layout::lattSize());
+          write(file_xml, "num_vecs", params.param.num_vecs);
+          write(file_xml, "Config_info", gauge_xml);
+          pop(file_xml);
+
+          file_str = file_xml.str();
+        }
+
+	// Create the object
+	std::istringstream  xml_s(params.named_obj.colorvec_obj.xml);
+	XMLReader MapObjReader(xml_s);
+	
+	// Create the entry
+	TheNamedObjMap::Instance().create< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(params.named_obj.colorvec_id);
+	TheNamedObjMap::Instance().getData< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(params.named_obj.colorvec_id) =
+	  TheMapObjIntKeyColorEigenVecFactory::Instance().createObject(params.named_obj.colorvec_obj.id,
+								       MapObjReader,
+								       params.named_obj.colorvec_obj.path,
+								       file_str);
+      }
+      catch (std::bad_cast) {
+	QDPIO::cerr << name << ": caught dynamic cast error" << std::endl;
+	QDP_abort(1);
+      }
+      catch (const std::string& e) {
+	
+	QDPIO::cerr << name << ": error creating prop: " << e << std::endl;
+	QDP_abort(1);
+      }
+      
+      // Cast should be valid now
+      // Cast should be valid now
+      QDP::MapObject<int,EVPair<LatticeColorVector> >& color_vecs = 
+	*(TheNamedObjMap::Instance().getData< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(params.named_obj.colorvec_id));
+
+      
+      // The code goes here
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+	  
+      // Initialize the slow Fourier transform phases
+      SftMom phases(0, true, params.param.decay_dir);
+      
+      int num_vecs = params.param.num_vecs;
+      int nt = phases.numSubsets();
+      multi1d<EVPair<LatticeColorVector> >  ev_pairs(num_vecs);
+      for(int n=0; n < num_vecs; ++n) { 
+	ev_pairs[n].eigenValue.weights.resize(nt);
+      }
+      
+	  
+
+      if (params.param.method == "BLOCK_CHEBYSHEV")
+      {
+	// The vectors are written to color_vecs as they converge
+	blockChebyshevEigs(u_smr, phases, params.param, color_vecs, ev_pairs);
+      }
+      else
+      {
+	lanczosEigs(u_smr, phases, params.param, ev_pairs);
+
+	for(int n=0; n < num_vecs; n++) { 
+	  color_vecs.insert(n, ev_pairs[n]);
+	}
       }
       color_vecs.flush();
       
@@ -35,6 +35,12 @@ namespace Chroma
 	int         max_iter;    /*!< Maximum number of Lanczos iterations */
 	Real 		tol; 		 /*!< Allowed residual upon exit */	
 
+	std::string method;      /*!< LANCZOS (default) or BLOCK_CHEBYSHEV */
+	int         filter_order;  /*!< Degree of the Chebyshev filter of BLOCK_CHEBYSHEV */
+	Real        filter_lower;  /*!< Lower end of the damped interval, <= 0 for the largest Ritz value */
+	Real        filter_upper;  /*!< Upper bound of the spectrum of -Laplacian */
+	int         num_guard;     /*!< Extra vectors in the block of BLOCK_CHEBYSHEV */
+
 	GroupXML_t  link_smear;  /*!< link smearing xml */
       };
 
@@ -10,6 +10,7 @@
 #include "meas/smear/link_smearing_aggregate.h"
 #include "meas/smear/link_smearing_factory.h"
 #include "meas/smear/displace.h"
+#include "meas/smear/disp_colvec_cache.h"
 #include "meas/glue/mesplq.h"
 #include "util/ferm/subset_vectors.h"
 #include "util/ferm/key_val_db.h"
@@ -76,6 +77,10 @@ namespace Chroma
       read(paramtop, "orthog_basis", param.orthog_basis);
 
       param.link_smearing  = readXMLGroup(paramtop, "LinkSmearing", "LinkSmearingType");
+
+      param.disp_cache_max_mb = 1024;
+      if (paramtop.count("disp_cache_max_mb") != 0)
+	read(paramtop, "disp_cache_max_mb", param.disp_cache_max_mb);
     }
 
 
@@ -96,6 +101,7 @@ namespace Chroma
       write(xml, "decay_dir", param.decay_dir);
       write(xml, "orthog_basis", param.orthog_basis);
      xml << param.link_smearing.xml;
+      write(xml, "disp_cache_max_mb", param.disp_cache_max_mb);
 
       pop(xml);
     }
@@ -108,6 +114,10 @@ namespace Chroma
       read(inputtop, "gauge_id", input.gauge_id);
       read(inputtop, "colorvec_id", input.colorvec_id);
       read(inputtop, "meson_op_file", input.meson_op_file);
+
+      input.disp_cache_id = "";
+      if (inputtop.count("disp_cache_id") != 0)
+	read(inputtop, "disp_cache_id", input.disp_cache_id);
     }
 
     //! Write named objects
@@ -118,6 +128,8 @@ namespace Chroma
       write(xml, "gauge_id", input.gauge_id);
       write(xml, "colorvec_id", input.colorvec_id);
       write(xml, "meson_op_file", input.meson_op_file);
+      if (input.disp_cache_id != "")
+	write(xml, "disp_cache_id", input.disp_cache_id);
 
       pop(xml);
     }
@@ -550,6 +562,30 @@ namespace Chroma
       }
 
 
+      //
+      // The displaced vectors, shared with other measurements if a cache is named
+      //
+      Handle<DispColorVectorCache> local_cache;
+      DispColorVectorCache* disp_cache;
+
+      if (params.named_obj.disp_cache_id != "")
+      {
+	disp_cache = &namedDispColorVectorCache(params.named_obj.disp_cache_id,
+						params.param.disp_cache_max_mb);
+      }
+      else
+      {
+	local_cache = new DispColorVectorCache(params.param.disp_cache_max_mb);
+	disp_cache = &(*local_cache);
+      }
+
+      KeyDispColorVectorCache_t disp_key;
+      disp_key.gauge_key           = dispColorVectorGaugeKey(params.named_obj.gauge_id,
+								 params.param.link_smearing.xml, u_smr);
+      disp_key.colorvec_id         = params.named_obj.colorvec_id;
+      disp_key.use_derivP          = false;
+      disp_key.displacement_length = params.param.displacement_length;
+
       // Keep track of no displacements and zero momentum
       multi1d<int> no_displacement;
       multi1d<int> zero_mom(3); zero_mom = 0;
@@ -615,11 +651,12 @@ namespace Chroma
 	  for(int j = 0 ; j < params.param.num_vecs; ++j)
 	  {
 	    // Displace the right std::vector and multiply by the momentum phase
-	    EVPair<LatticeColorVector> tmpvec; eigen_source.get(j,tmpvec);
-	    LatticeColorVector shift_vec = phases[mom_num] * displace(u_smr, 
-								      tmpvec.eigenVector, 
-								      params.param.displacement_length, 
-								      disp);
+	    KeyDispColorVectorCache_t right_key = disp_key;
+	    right_key.colvec = j;
+	    for(int n=0; n < disp.size(); ++n)
+	      right_key.displacement.push_back(disp[n]);
+
+	    LatticeColorVector shift_vec = phases[mom_num] * disp_cache->getDispVector(right_key, u_smr, eigen_source);
 
 	    for(int i = 0 ; i <  params.param.num_vecs; ++i)
 	    {
@@ -628,8 +665,10 @@ namespace Chroma
 
 	      // Contract over color indices
 	      // Do the relevant quark contraction
-	      EVPair<LatticeColorVector> tmpvec; eigen_source.get(i,tmpvec);
-	      LatticeComplex lop = localInnerProduct(tmpvec.eigenVector, shift_vec);
+	      KeyDispColorVectorCache_t left_key = disp_key;
+	      left_key.colvec = i;
+
+	      LatticeComplex lop = localInnerProduct(disp_cache->getDispVector(left_key, u_smr, eigen_source), shift_vec);
 
 	      // Slow fourier-transform
 	      multi1d<ComplexD> op_sum = sumMulti(lop, phases.getSet());
@@ -664,6 +703,10 @@ namespace Chroma
 
       pop(xml_out); // ElementalOps
 
+      QDPIO::cout << name << ": displacement cache hits= " << disp_cache->numHits()
+		  << "  misses= " << disp_cache->numMisses()
+		  << "  evictions= " << disp_cache->numEvictions() << std::endl;
+
       // Close the namelist output file XMLDAT
       pop(xml_out);     // MesonMatElemColorVector
 
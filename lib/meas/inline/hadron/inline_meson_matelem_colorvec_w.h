@@ -37,6 +37,7 @@ namespace Chroma
 	int                     decay_dir;              /*!< Decay direction */
 	multi1d< multi1d<int> > displacement_list;      /*!< Array of displacements list to generate */
 	GroupXML_t              link_smearing;          /*!< link smearing xml */
+	int                     disp_cache_max_mb;      /*!< Memory of the displacement cache on each node */
 
 	// This all may need some work
 	bool                    orthog_basis;           /*!< Whether all the basis vectors are orthog */
@@ -47,6 +48,7 @@ namespace Chroma
 	std::string         gauge_id;               /*!< Gauge field */
 	std::string         colorvec_id;            /*!< LatticeColorVector EigenInfo */
 	std::string         meson_op_file;          /*!< File name for creation operators */
+	std::string         disp_cache_id;          /*!< Shared displacement cache, optional */
       };
 
       Param_t        param;      /*!< Parameters */    
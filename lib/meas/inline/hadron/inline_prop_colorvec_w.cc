@@ -11,6 +11,7 @@
 #include "util/ferm/subset_vectors.h"
 #include "util/ferm/map_obj/map_obj_aggregate_w.h"
 #include "util/ferm/map_obj/map_obj_factory_w.h"
+#include "util/ferm/map_obj/map_obj_timeslice_mmap_w.h"
 #include "util/ferm/key_prop_colorvec.h"
 #include "util/ferm/transf.h"
 #include "util/ft/sftmom.h"
@@ -427,12 +428,21 @@ namespace Chroma
 	SftMom phases(0, true, decay_dir);
 
 
+	// A time slice ordered store can hand out single time slices
+	const MapObjectTimeSliceMmap* slab_source = dynamic_cast<const MapObjectTimeSliceMmap*>(&eigen_source);
+	if (slab_source && slab_source->getDecayDir() != decay_dir)
+	  slab_source = 0;
+
 	// Loop over each operator 
 	for(int tt=0; tt < t_sources.size(); ++tt)
 	{
 	  int t_source = t_sources[tt];
 	  QDPIO::cout << "t_source = " << t_source << std::endl; 
 
+	  // Page in the next source time slice during the inversions of this one
+	  if (slab_source && tt+1 < t_sources.size())
+	    slab_source->prefetch(t_sources[tt+1]);
+
 	  // All the loops
 	  for(int colorvec_source=0; colorvec_source < num_vecs; ++colorvec_source)
 	  {
@@ -440,9 +450,16 @@ namespace Chroma
 
 	    // Pull out a time-slice of the color std::vector source
 	    LatticeColorVector vec_srce = zero;
-	    EVPair<LatticeColorVector> tmpvec;
-	    eigen_source.get(colorvec_source, tmpvec);
-	    vec_srce[phases.getSet()[t_source]] = tmpvec.eigenVector;
+	    if (slab_source)
+	    {
+	      slab_source->getTimeSlice(colorvec_source, t_source, vec_srce);
+	    }
+	    else
+	    {
+	      EVPair<LatticeColorVector> tmpvec;
+	      eigen_source.get(colorvec_source, tmpvec);
+	      vec_srce[phases.getSet()[t_source]] = tmpvec.eigenVector;
+	    }
 	
 	    for(int spin_source=0; spin_source < Ns; ++spin_source)
 	    {
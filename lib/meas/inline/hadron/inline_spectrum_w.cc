@@ -133,6 +133,10 @@ namespace Chroma
     read(paramtop, "mom2_max", param.mom2_max);
     read(paramtop, "avg_equiv_mom", param.avg_equiv_mom);
 
+    param.use_fft = false;
+    if (paramtop.count("use_fft") != 0)
+      read(paramtop, "use_fft", param.use_fft);
+
     read(paramtop, "wvf_kind", param.wvf_kind);
     read(paramtop, "wvf_param", param.wvf_param);
     read(paramtop, "wvfIntPar", param.wvfIntPar);
@@ -173,6 +177,7 @@ namespace Chroma
 
     write(xml, "mom2_max", param.mom2_max);
     write(xml, "avg_equiv_mom", param.avg_equiv_mom);
+    write(xml, "use_fft", param.use_fft);
 
     write(xml, "wvf_kind", param.wvf_kind);
     write(xml, "wvf_param", param.wvf_param);
@@ -421,8 +426,13 @@ namespace Chroma
       int bc_spec = boundary[j_decay];
 
       // Initialize the slow Fourier transform phases
-      SftMom phases(params.param.mom2_max, t_srce, params.param.avg_equiv_mom,
-                    j_decay);
+      SftMomParams_t sft_params;
+      sft_params.mom2_max      = params.param.mom2_max;
+      sft_params.origin_offset = t_srce;
+      sft_params.avg_equiv_mom = params.param.avg_equiv_mom;
+      sft_params.decay_dir     = j_decay;
+      sft_params.use_fft       = params.param.use_fft;
+      SftMom phases(sft_params);
 
       // Keep a copy of the phases with NO momenta
       SftMom phases_nomom(0, true, j_decay);
@@ -51,6 +51,7 @@ namespace Chroma
 
       int mom2_max;            // (mom)^2 <= mom2_max. mom2_max=7 in szin.
       bool avg_equiv_mom;      // average over equivalent momenta
+      bool use_fft;            // separable transform instead of a phase table
       WvfKind       wvf_kind;  // Wave function kind: gauge invariant
       multi1d<Real> wvf_param; // Array of width's or other parameters
       //   for "shell" source/sink wave function
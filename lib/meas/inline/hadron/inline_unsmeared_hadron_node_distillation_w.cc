@@ -18,6 +18,7 @@
 #include "meas/smear/link_smearing_factory.h"
 #include "util/ferm/key_timeslice_colorvec.h"
 #include "util/ferm/disp_soln_cache.h"
+#include "util/ferm/timeslice_contract.h"
 #include "util/ferm/key_val_db.h"
 #include "util/info/proginfo.h"
 #include "util/ft/sftmom.h"
@@ -984,6 +985,15 @@ namespace Chroma
 	swatch.stop(); 
 	QDPIO::cout << " SINK: time to compute all sink solution vectors= " << swatch.getTimeInSeconds() << " secs" <<std::endl;
 
+	// Block the sink solution vectors by time slice for the contractions,
+	// column colorvec*Ns + spin. They are not needed as lattice fields anymore.
+	TimeSliceBlock snk_block(phases.getSet(), sink_num_vecs*Ns);
+	for(int colorvec_snk=0; colorvec_snk < sink_num_vecs; ++colorvec_snk)
+	  for(int spin_snk=0; spin_snk < Ns; ++spin_snk)
+	    snk_block.set(colorvec_snk*Ns + spin_snk, ferm_snk(colorvec_snk, spin_snk));
+
+	ferm_snk.resize(0,0);
+
 
 	//
 	// The source distillation loop
@@ -1061,11 +1071,12 @@ namespace Chroma
 		  // The deriv/disp are cached, so the only cost is a lookup.
 		  // The gamma is really just a rearrangement of spin components, but it does cost
 		  // a traversal of the lattice
-		  // The phases mult is a straight up cost.
+		  // The phases mult is done within the contraction.
 		  //
-		  LatticeFermion tmp = phases[mom_num] * (Gamma(gamma) * disp_soln_cache.getDispVector(params.param.contract.use_derivP,
-												       mom,
-												       disp));
+		  TimeSliceBlock ins_block(phases.getSet(), 1);
+		  ins_block.set(0, Gamma(gamma) * disp_soln_cache.getDispVector(params.param.contract.use_derivP,
+										  mom,
+										  disp));
 	      
 		  // Keys and stuff
 		  SerialDBKey<KeyUnsmearedMesonElementalOperator_t>  key;
@@ -1091,20 +1102,17 @@ namespace Chroma
 		    buf[t].val.data().op.resize(sink_num_vecs,Ns);
 		  }
 
-		  for(int spin_snk=0; spin_snk < Ns; ++spin_snk)
+		  // Fourier-transform of all the sink vectors at once
+		  multi1d< multi2d<ComplexD> > fred;
+		  timeSliceInnerProducts(fred, snk_block, ins_block, phases[mom_num]);
+
+		  for(int t=0; t < phases.numSubsets(); ++t)
 		  {
+		    if (! active_t_slices[t]) {continue;}
+
 		    for(int colorvec_snk=0; colorvec_snk < sink_num_vecs; ++colorvec_snk)
-		    {
-		      // Slow fourier-transform
-		      multi1d<DComplex> fred = sumMulti(localInnerProduct(ferm_snk(colorvec_snk, spin_snk), tmp), phases.getSet());
-	
-		      for(int t=0; t < phases.numSubsets(); ++t)
-		      {
-			if (! active_t_slices[t]) {continue;}
-			
-			buf[t].val.data().op(colorvec_snk,spin_snk) = fred[t];
-		      }
-		    }
+		      for(int spin_snk=0; spin_snk < Ns; ++spin_snk)
+			buf[t].val.data().op(colorvec_snk,spin_snk) = fred[t](colorvec_snk*Ns + spin_snk, 0);
 		  }
 
 		  // Insert these elementals into the db
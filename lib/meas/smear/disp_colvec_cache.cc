@@ -0,0 +1,197 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Memory bounded cache of displaced color vectors shared between measurements
+ */
+
+#include "meas/smear/disp_colvec_cache.h"
+#include "meas/smear/displace.h"
+#include "meas/inline/io/named_objmap.h"
+#include "util/gauge/gauge_fingerprint.h"
+
+namespace Chroma
+{
+  // Support for the keys of cached displaced color vectors
+  bool operator<(const KeyDispColorVectorCache_t& a, const KeyDispColorVectorCache_t& b)
+  {
+    if (a.colvec != b.colvec)
+      return a.colvec < b.colvec;
+    if (a.displacement != b.displacement)
+      return a.displacement < b.displacement;
+    if (a.use_derivP != b.use_derivP)
+      return a.use_derivP < b.use_derivP;
+    if (a.displacement_length != b.displacement_length)
+      return a.displacement_length < b.displacement_length;
+    if (a.colorvec_id != b.colorvec_id)
+      return a.colorvec_id < b.colorvec_id;
+
+    return a.gauge_key < b.gauge_key;
+  }
+
+
+  // Hold at most max_mem_mb megabytes of vectors on each node
+  DispColorVectorCache::DispColorVectorCache(int max_mem_mb) : hits(0), misses(0), evictions(0)
+  {
+    const double vec_bytes = double(Layout::sitesOnNode()) * Nc * 2 * sizeof(REAL);
+
+    max_entries = int(double(max_mem_mb) * 1024.0 * 1024.0 / vec_bytes);
+
+    // A path and its prefix must fit
+    if (max_entries < 2)
+      max_entries = 2;
+
+    QDPIO::cout << "DispColorVectorCache: room for " << max_entries << " vectors" << std::endl;
+  }
+
+
+  // Drop all vectors
+  void DispColorVectorCache::clear()
+  {
+    entries.clear();
+    use_list.clear();
+  }
+
+
+  // The displaced vector
+  LatticeColorVector
+  DispColorVectorCache::getDispVector(const KeyDispColorVectorCache_t& key_in,
+				      const multi1d<LatticeColorMatrix>& u_smr,
+				      const QDP::MapObject<int,EVPair<LatticeColorVector> >& eigen_source)
+  {
+    // Zeros and zero length displacements do nothing, drop them so equal vectors share a key
+    KeyDispColorVectorCache_t key = key_in;
+    key.displacement.clear();
+
+    if (key_in.displacement_length != 0)
+    {
+      for(int i=0; i < key_in.displacement.size(); ++i)
+	if (key_in.displacement[i] != 0)
+	  key.displacement.push_back(key_in.displacement[i]);
+    }
+
+    return displaceObject(key, u_smr, eigen_source);
+  }
+
+
+  // Find or build a displaced vector
+  LatticeColorVector
+  DispColorVectorCache::displaceObject(const KeyDispColorVectorCache_t& key,
+				       const multi1d<LatticeColorMatrix>& u_smr,
+				       const QDP::MapObject<int,EVPair<LatticeColorVector> >& eigen_source)
+  {
+    std::map<KeyDispColorVectorCache_t, Entry>::iterator it = entries.find(key);
+
+    if (it != entries.end())
+    {
+      // Now the most recently used
+      ++hits;
+      use_list.splice(use_list.begin(), use_list, it->second.use);
+      return it->second.vec;
+    }
+
+    ++misses;
+
+    if (key.displacement.size() == 0)
+    {
+      EVPair<LatticeColorVector> tmpvec;
+      eigen_source.get(key.colvec, tmpvec);
+      insert(key, tmpvec.eigenVector);
+      return tmpvec.eigenVector;
+    }
+
+    // Have at least one displacement. Pull that one off the end of the list
+    KeyDispColorVectorCache_t prev_key = key;
+
+    int d = key.displacement.back();
+    prev_key.displacement.pop_back();
+
+    // Recursively get the prefix
+    LatticeColorVector disp_q = displaceObject(prev_key, u_smr, eigen_source);
+
+    LatticeColorVector vec;
+
+    if (d > 0)
+    {
+      int disp_dir = d - 1;
+      int disp_len = key.displacement_length;
+      if (key.use_derivP)
+	vec = rightNabla(disp_q, u_smr, disp_dir, disp_len);
+      else
+	vec = displace(u_smr, disp_q, disp_len, disp_dir);
+    }
+    else
+    {
+      if (key.use_derivP)
+      {
+	QDPIO::cerr << __func__ << ": do not support (rather do not want to support) negative displacements for rightNabla\n";
+	QDP_abort(1);
+      }
+
+      int disp_dir = -d - 1;
+      int disp_len = -key.displacement_length;
+      vec = displace(u_smr, disp_q, disp_len, disp_dir);
+    }
+
+    insert(key, vec);
+    return vec;
+  }
+
+
+  // Insert a new vector, dropping old ones for room
+  void
+  DispColorVectorCache::insert(const KeyDispColorVectorCache_t& key, const LatticeColorVector& vec)
+  {
+    while (int(entries.size()) >= max_entries && ! use_list.empty())
+    {
+      entries.erase(use_list.back());
+      use_list.pop_back();
+      ++evictions;
+    }
+
+    use_list.push_front(key);
+
+    Entry& entry = entries[key];
+    entry.vec = vec;
+    entry.use = use_list.begin();
+  }
+
+
+  // The cache of the named object cache_id
+  DispColorVectorCache& namedDispColorVectorCache(const std::string& cache_id, int max_mem_mb)
+  {
+    try
+    {
+      if (! TheNamedObjMap::Instance().check(cache_id))
+      {
+	QDPIO::cout << __func__ << ": create displacement cache " << cache_id << std::endl;
+
+	TheNamedObjMap::Instance().create< Handle<DispColorVectorCache> >(cache_id);
+	TheNamedObjMap::Instance().getData< Handle<DispColorVectorCache> >(cache_id) =
+	  new DispColorVectorCache(max_mem_mb);
+      }
+
+      return *(TheNamedObjMap::Instance().getData< Handle<DispColorVectorCache> >(cache_id));
+    }
+    catch (std::bad_cast)
+    {
+      QDPIO::cerr << __func__ << ": named object " << cache_id << " is not a displacement cache" << std::endl;
+      QDP_abort(1);
+    }
+    catch (const std::string& e)
+    {
+      QDPIO::cerr << __func__ << ": error with displacement cache " << cache_id << ": " << e << std::endl;
+      QDP_abort(1);
+    }
+
+    // Not reached
+    return *(TheNamedObjMap::Instance().getData< Handle<DispColorVectorCache> >(cache_id));
+  }
+
+
+  // Gauge key of the links u_smr
+  std::string dispColorVectorGaugeKey(const std::string& gauge_id, const std::string& link_smearing_xml,
+				      const multi1d<LatticeColorMatrix>& u_smr)
+  {
+    return gauge_id + link_smearing_xml + gaugeFingerprint(u_smr);
+  }
+
+} // namespace Chroma
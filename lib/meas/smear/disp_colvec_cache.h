@@ -0,0 +1,126 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Memory bounded cache of displaced color vectors shared between measurements
+ */
+
+#ifndef __disp_colvec_cache_h__
+#define __disp_colvec_cache_h__
+
+#include "chromabase.h"
+#include "util/ferm/subset_ev_pair.h"
+#include "qdp_map_obj.h"
+#include <list>
+#include <map>
+#include <vector>
+
+namespace Chroma
+{
+  /*!
+   * \ingroup smear
+   *
+   * @{
+   */
+  //----------------------------------------------------------------------------
+  //! The key for cached displaced color vectors
+  struct KeyDispColorVectorCache_t
+  {
+    std::string        gauge_key;             /*!< Gauge field id, link smearing and fingerprint of the smeared links */
+    std::string        colorvec_id;           /*!< Named object of the color vectors */
+    int                colvec;                /*!< Color vector index */
+    bool               use_derivP;            /*!< Derivatives instead of displacements */
+    int                displacement_length;   /*!< Displacement length */
+    std::vector<int>   displacement;          /*!< Orig plus/minus 1-based directional displacements */
+  };
+
+
+  //! Support for the keys of cached displaced color vectors
+  bool operator<(const KeyDispColorVectorCache_t& a, const KeyDispColorVectorCache_t& b);
+
+
+  //----------------------------------------------------------------------------
+  //! Least recently used cache of displaced color vectors
+  /*!
+   * A path is built from the longest cached prefix, and every prefix on
+   * the way is kept, so paths sharing their first steps are displaced once.
+   * When the memory bound is reached the least recently used vectors are
+   * dropped.
+   *
+   * The cache lives in the named object map so the elemental operator
+   * measurements of a configuration can share it. It knows nothing of the
+   * gauge field or the vectors beyond their keys. The gauge key carries a
+   * fingerprint of the smeared links (see dispColorVectorGaugeKey), so a
+   * new configuration under an old id misses instead of returning stale
+   * vectors. The vectors themselves are only known by their id.
+   *
+   * Vectors are returned by value: an entry may be evicted by any later
+   * lookup, so no reference into the cache is handed out.
+   */
+  class DispColorVectorCache
+  {
+  public:
+    //! Hold at most max_mem_mb megabytes of vectors on each node
+    DispColorVectorCache(int max_mem_mb);
+
+    //! Destructor
+    ~DispColorVectorCache() {}
+
+    //! The displaced vector
+    LatticeColorVector getDispVector(const KeyDispColorVectorCache_t& key,
+					    const multi1d<LatticeColorMatrix>& u_smr,
+					    const QDP::MapObject<int,EVPair<LatticeColorVector> >& eigen_source);
+
+    //! Drop all vectors
+    void clear();
+
+    //! Number of vectors held
+    int size() const {return entries.size();}
+
+    //! Lookups found in the cache
+    unsigned long numHits() const {return hits;}
+
+    //! Vectors built
+    unsigned long numMisses() const {return misses;}
+
+    //! Vectors dropped for room
+    unsigned long numEvictions() const {return evictions;}
+
+  protected:
+    //! Find or build a displaced vector
+    LatticeColorVector displaceObject(const KeyDispColorVectorCache_t& key,
+					     const multi1d<LatticeColorMatrix>& u_smr,
+					     const QDP::MapObject<int,EVPair<LatticeColorVector> >& eigen_source);
+
+    //! Insert a new vector, dropping old ones for room
+    void insert(const KeyDispColorVectorCache_t& key, const LatticeColorVector& vec);
+
+  private:
+    //! A cached vector and its place in the use list
+    struct Entry
+    {
+      LatticeColorVector vec;
+      std::list<KeyDispColorVectorCache_t>::iterator use;
+    };
+
+    int max_entries;
+    std::map<KeyDispColorVectorCache_t, Entry> entries;
+    std::list<KeyDispColorVectorCache_t> use_list;   /*!< most recently used first */
+
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+  };
+
+
+  //! The cache of the named object cache_id, created holding max_mem_mb if not there yet
+  DispColorVectorCache& namedDispColorVectorCache(const std::string& cache_id, int max_mem_mb);
+
+  //! Gauge key of the links u_smr, from the gauge field id and the link smearing xml
+  /*! A checksum of u_smr is appended, so the key changes with the configuration */
+  std::string dispColorVectorGaugeKey(const std::string& gauge_id, const std::string& link_smearing_xml,
+				      const multi1d<LatticeColorMatrix>& u_smr);
+
+  /*! @} */  // end of group smear
+
+} // namespace Chroma
+
+#endif
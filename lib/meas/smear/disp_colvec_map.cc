@@ -29,7 +29,21 @@ namespace Chroma
 					 int disp_length,
 					 const multi1d<LatticeColorMatrix>& u_smr,
 					 const MapObject<int,EVPair<LatticeColorVector> >& eigen_vec)
-    : use_derivP(use_derivP_), displacement_length(disp_length), u(u_smr), eigen_source(eigen_vec)
+    : use_derivP(use_derivP_), displacement_length(disp_length), u(u_smr), eigen_source(eigen_vec), cache(0)
+  {
+  }
+
+
+  // Constructor for displaced std::map kept in a shared cache
+  DispColorVectorMap::DispColorVectorMap(bool use_derivP_,
+					 int disp_length,
+					 const multi1d<LatticeColorMatrix>& u_smr,
+					 const MapObject<int,EVPair<LatticeColorVector> >& eigen_vec,
+					 DispColorVectorCache& cache_,
+					 const std::string& gauge_key_,
+					 const std::string& colorvec_id_)
+    : use_derivP(use_derivP_), displacement_length(disp_length), u(u_smr), eigen_source(eigen_vec),
+      cache(&cache_), gauge_key(gauge_key_), colorvec_id(colorvec_id_)
   {
   }
 
@@ -38,6 +52,20 @@ namespace Chroma
   const LatticeColorVector
   DispColorVectorMap::getDispVector(const KeyDispColorVector_t& key)
   {
+    if (cache)
+    {
+      KeyDispColorVectorCache_t cache_key;
+      cache_key.gauge_key           = gauge_key;
+      cache_key.colorvec_id         = colorvec_id;
+      cache_key.colvec              = key.colvec;
+      cache_key.use_derivP          = use_derivP;
+      cache_key.displacement_length = displacement_length;
+      for(int i=0; i < key.displacement.size(); ++i)
+	cache_key.displacement.push_back(key.displacement[i]);
+
+      return cache->getDispVector(cache_key, u, eigen_source);
+    }
+
     //Check if any displacement is needed
     if (displacement_length == 0) 
     {
@@ -9,6 +9,7 @@
 #include "chromabase.h"
 #include "util/ferm/subset_ev_pair.h"
 #include "qdp_map_obj.h"
+#include "meas/smear/disp_colvec_cache.h"
 #include <map>
 
 namespace Chroma 
@@ -49,6 +50,19 @@ namespace Chroma
 		       const multi1d<LatticeColorMatrix>& u_smr,
 		       const QDP::MapObject<int,EVPair<LatticeColorVector> >& eigen_source);
 
+    //! Constructor for displaced std::map kept in a shared cache
+    /*! 
+     * gauge_key and colorvec_id name the smeared links and the vectors
+     * in the keys of the cache. Make gauge_key with dispColorVectorGaugeKey
+     */
+    DispColorVectorMap(bool use_derivP, 
+		       int disp_length,
+		       const multi1d<LatticeColorMatrix>& u_smr,
+		       const QDP::MapObject<int,EVPair<LatticeColorVector> >& eigen_source,
+		       DispColorVectorCache& cache,
+		       const std::string& gauge_key,
+		       const std::string& colorvec_id);
+
     //! Destructor
     ~DispColorVectorMap() {}
 
@@ -74,6 +88,11 @@ namespace Chroma
 			
     //! Maps of displaced color vectors 
     std::map<KeyDispColorVector_t, ValDispColorVector_t> disp_src_map;
+
+    //! Shared cache used instead of disp_src_map, if any
+    DispColorVectorCache* cache;
+    std::string gauge_key;
+    std::string colorvec_id;
   };
 
   /*! @} */  // end of group smear
@@ -14,6 +14,7 @@
 #include "gaugebc.h"
 #include "fermbc.h"
 #include "handle.h"
+#include "io/enum_io/enum_linkcompresstype_io.h"
 
 namespace Chroma
 {
@@ -103,6 +104,12 @@ namespace Chroma
     //! Return the ferm BC object for this state
     /*! This is to help the optimized linops */
     virtual Handle< FermBC<T,P,Q> > getFermBC() const = 0;
+
+    //! Storage the linops should use for the links of this state
+    /*! Only a hint: an operator without compressed links ignores it.
+     *  At present only the QDP Wilson dslash (QDPWilsonDslashT) honours it,
+     *  not the SSE/CPP/PAB/LLVM dslashes nor the clover term */
+    virtual LinkCompressType getLinkCompression() const {return LINK_COMPRESS_NONE;}
    
   };
 
@@ -45,6 +45,25 @@ namespace Chroma
      */
     virtual SystemSolverResults_t operator() (T& psi, const T& chi) const = 0;
 
+    //! Solve for a block of right hand sides
+    /*! 
+     * Solves   A*psi[i] = chi[i]  for all i. 
+     *
+     * The default is to call the single source solver for each right hand side 
+     * in turn. Block solvers override this to apply the operator to all
+     * the sources in one sweep. The incoming psi are the initial guesses.
+     */
+    virtual multi1d<SystemSolverResults_t> solveBlock (multi1d<T>& psi, const multi1d<T>& chi) const
+    {
+      multi1d<SystemSolverResults_t> res(chi.size());
+      if (psi.size() != chi.size())
+	psi.resize(chi.size());
+      for(int i=0; i < chi.size(); ++i)
+	res[i] = (*this)(psi[i], chi[i]);
+
+      return res;
+    }
+
     //! Return the subset on which the operator acts
     virtual const Subset& subset() const = 0;
   };
@@ -108,6 +127,30 @@ namespace Chroma
 					      const multi1d<Real>& shifts, 
 					      const T& chi) const = 0;
 
+    //! Solve for a block of right hand sides
+    /*! 
+     * Solves   (A + shifts[s])*psi[i][s] = chi[i]  for all i and s.
+     *
+     * The default is to call the single source solver for each right hand side 
+     * in turn. Block solvers override this to apply the operator to all
+     * the sources in one sweep.
+     *
+     * Named apart from operator() so overriding one does not hide the other.
+     */
+    virtual multi1d<SystemSolverResults_t> solveBlock (multi1d< multi1d<T> >& psi, 
+						       const multi1d<Real>& shifts, 
+						       const multi1d<T>& chi) const
+    {
+      multi1d<SystemSolverResults_t> res(chi.size());
+      if (psi.size() != chi.size())
+	psi.resize(chi.size());
+
+      for(int i=0; i < chi.size(); ++i)
+	res[i] = (*this)(psi[i], shifts, chi[i]);
+
+      return res;
+    }
+
     //! Return the subset on which the operator acts
     virtual const Subset& subset() const = 0;
   };
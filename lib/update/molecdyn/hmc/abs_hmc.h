@@ -33,6 +33,20 @@ namespace Chroma
     virtual void operator()(AbsFieldState<P,Q>& s,
 			    const bool WarmUpP, 
 			    const bool CheckRevP)
+    {
+      (*this)(s, WarmUpP, CheckRevP, false);
+    }
+
+    // Do the HMC trajectory, with the single step checks if CheckStepP
+    /*! The single step checks integrate one outermost MD step from the
+     *  start of the trajectory twice and compare the results bit for bit
+     *  (reproducibility), then integrate back from there with flipped
+     *  momenta (reversibility). They cost two or three steps instead of
+     *  a full extra trajectory for each check */
+    virtual void operator()(AbsFieldState<P,Q>& s,
+			    const bool WarmUpP, 
+			    const bool CheckRevP,
+			    const bool CheckStepP)
     {
       START_CODE();
 
@@ -83,7 +97,7 @@ namespace Chroma
       MD.copyFields();
 
       // Integrate MD trajectory
-      MD(s, MD.getTrajLength());
+      MD.primaryTrajectory(s, MD.getTrajLength());
            
 
       // If this is a reverse trajectory
@@ -135,6 +149,11 @@ namespace Chroma
 	
       }
 
+      // Lightweight checks on a single step from the saved start state
+      if( CheckStepP ) { 
+	checkOneStep(*s_old);
+      }
+
       //  Measure the energy of the new state
       Double KE, PE;
 
@@ -169,6 +188,9 @@ namespace Chroma
       QDPIO::cout << "Delta H = " << DeltaH << std::endl;
       QDPIO::cout << "AccProb = " << AccProb << std::endl;
 
+      // Let the integrator see how well it did
+      MD.endTrajectory(DeltaH);
+
       // If we intend to do an accept reject step
       // (ie we are not warming up)
       if( ! WarmUpP ) 
@@ -202,6 +224,85 @@ namespace Chroma
     }
     
   protected:
+    // Reproducibility and reversibility of one outermost MD step of the 
+    // trajectory from s_start. The step is drawn at random; the steps
+    // before it are integrated again to get to its start
+    void checkOneStep(const AbsFieldState<P,Q>& s_start)
+    {
+      START_CODE();
+
+      AbsMDIntegrator<P,Q>& MD = getMDIntegrator();
+
+      XMLWriter& xml_out = TheXMLOutputWriter::Instance();
+      XMLWriter& xml_log = TheXMLLogWriter::Instance();
+
+      // Draw the step. The RNG state is put back so the Markov chain
+      // does not depend on whether the steps are checked
+      const int num_steps = MD.getNumSteps();
+      int k;
+      {
+	QDP::Seed ran_seed;
+	QDP::RNG::savern(ran_seed);
+	Real r;
+	random(r);
+	QDP::RNG::setrn(ran_seed);
+
+	k = int(toDouble(r) * num_steps);
+	if( k >= num_steps ) k = num_steps - 1;
+      }
+
+      QDPIO::cout << "Step checks: integrating step " << k+1 << " of " << num_steps 
+		  << " MD steps of the trajectory" << std::endl;
+
+      Handle< AbsFieldState<P,Q> >  s_k(s_start.clone());
+      for(int i=0; i < k; i++) { 
+	MD.oneStep(*s_k, MD.getTrajLength());
+      }
+
+      // The step twice from the same state
+      Handle< AbsFieldState<P,Q> >  s_step(s_k->clone());
+      MD.oneStep(*s_step, MD.getTrajLength());
+
+      Handle< AbsFieldState<P,Q> >  s_repro(s_k->clone());
+      MD.oneStep(*s_repro, MD.getTrajLength());
+
+      Double dq_repro;
+      Double dp_repro;
+      reverseCheckMetrics(dq_repro, dp_repro, *s_repro, *s_step);
+      bool pass = ( toBool(dq_repro == Double(0)) && toBool(dp_repro == Double(0)) );
+
+      // And back again
+      flipMomenta(*s_step);
+      MD.oneStep(*s_step, MD.getTrajLength());
+      flipMomenta(*s_step);
+
+      Double dq;
+      Double dp;
+      reverseCheckMetrics(dq, dp, *s_step, *s_k);
+
+      push(xml_log, "StepCheckMetrics");
+      write(xml_log, "Step", k);
+      write(xml_log, "ReproCheck", pass);
+      write(xml_log, "DeltaQPerSite", dq);
+      write(xml_log, "DeltaPPerSite", dp);
+      pop(xml_log);
+
+      QDPIO::cout << "Step reversibility: DeltaQ = " << dq << std::endl;
+      QDPIO::cout << "Step reversibility: DeltaP = " << dp << std::endl;
+
+      if( ! pass ) { 
+	QDPIO::cout << "Step reproducibility check failed: DeltaQ = " << dq_repro
+		    << " DeltaP = " << dp_repro << std::endl;
+	QDPIO::cout << "Aborting" << std::endl;
+	write(xml_out, "StepReproCheck", pass);
+	QDP_abort(1);
+      }
+      QDPIO::cout << "Step reproducibility check passed" << std::endl;
+      write(xml_out, "StepReproCheck", pass);
+
+      END_CODE();
+    }
+
     // Get at the Exact Hamiltonian
     virtual AbsHamiltonian<P,Q>& getMCHamiltonian(void) = 0;
     
@@ -36,6 +36,9 @@ namespace Chroma
 
     //! Reset any chronological predictors for the integrator
     virtual void resetPredictors(void) const = 0;
+
+    //! Does the integrator report its outermost steps to the in-flight checkpointer
+    virtual bool checkpointable(void) const {return false;}
   };
 
   //! MD component integrator that has a sub integrator (recursive)
@@ -100,6 +103,14 @@ namespace Chroma
       theIntegrator(s, trajLength);
     }
     
+    //! Do the trajectory that goes to the accept/reject step
+    /*! Integrators with observers of the MD (autotuning, monitoring,
+     *  checkpoints) let them watch this trajectory only, and not the 
+     *  integrations of the reversibility and step checks */
+    virtual void primaryTrajectory(AbsFieldState<P,Q>& s, const Real& trajLength) const {
+      (*this)(s, trajLength);
+    }
+    
     //! Refresh fields in the sub integrators (for R-like algorithms)
     virtual void refreshFields(AbsFieldState<P,Q>&s ) const { 
       getIntegrator().refreshFields(s); // Recursively refresh fields
@@ -113,6 +124,19 @@ namespace Chroma
         fields it needs to copy internally so that this function doesn't
 	need its details exposed */
     virtual void copyFields(void) const = 0;
+
+    //! Called at the end of each trajectory with its energy violation
+    virtual void endTrajectory(const Double& DeltaH) {}
+
+    //! Number of outermost steps in a trajectory
+    virtual int getNumSteps(void) const { return 1; }
+
+    //! Integrate one outermost step of a trajectory of length trajLength
+    /*! The default treats the whole trajectory as the step */
+    virtual void oneStep(AbsFieldState<P,Q>& s, const Real& trajLength) const {
+      (*this)(s, trajLength);
+    }
+
   private:
 
     //! Get the toplevel sub integrator
@@ -20,6 +20,7 @@
 #include "update/molecdyn/integrator/lcm_integrator_leaps.h"
 #include "update/molecdyn/integrator/integrator_shared.h"
 #include "update/molecdyn/integrator/lcm_toplevel_integrator.h"
+#include "update/molecdyn/integrator/lcm_traj_checkpoint.h"
 
 #include "update/molecdyn/integrator/lcm_exp_sdt.h"
 #include "update/molecdyn/integrator/lcm_exp_tdt.h"
@@ -1,7 +1,10 @@
 #include "lcm_integrator_leaps.h"
+#include "update/molecdyn/integrator/lcm_step_autotune.h"
+#include "update/molecdyn/integrator/lcm_shadow_monitor.h"
 #include "util/gauge/taproj.h"
 #include "util/gauge/reunit.h"
 #include "util/gauge/expmat.h"
+#include "util/gauge/eesu3.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 
 namespace Chroma 
@@ -10,6 +13,87 @@ namespace Chroma
   namespace LCMMDIntegratorSteps 
   { 
 
+    namespace
+    {
+      //! Sum of the forces of a list of monomials
+      void monomialForces(const multi1d< IntegratorShared::MonomialPair >& monomials,
+			  multi1d<LatticeColorMatrix>& dsdQ,
+			  const AbsFieldState<multi1d<LatticeColorMatrix>,
+			  multi1d<LatticeColorMatrix> >& s)
+      {
+	StopWatch swatch;
+	XMLWriter& xml_out = TheXMLLogWriter::Instance();
+
+	push(xml_out, "AbsHamiltonianForce"); // Backward compatibility
+	write(xml_out, "num_terms", monomials.size());
+	push(xml_out, "ForcesByMonomial");
+
+	if( monomials.size() > 0 ) { 
+	  // Keep the separate forces for the shadow monitor
+	  ShadowMonitor& shadow = theShadowMonitor::Instance();
+	  multi1d<std::string> ids;
+	  multi1d< multi1d<LatticeColorMatrix> > F;
+	  if( shadow.isActive() ) { 
+	    ids.resize(monomials.size());
+	    F.resize(monomials.size());
+	    for(int i=0; i < monomials.size(); i++) { 
+	      ids[i] = monomials[i].id;
+	    }
+	  }
+
+	  push(xml_out, "elem");
+	  swatch.reset(); swatch.start();
+	  monomials[0].mon->dsdq(dsdQ,s);
+	  swatch.stop();
+	  QDPIO::cout << "FORCE TIME: " << monomials[0].id <<  " : " << swatch.getTimeInSeconds() << std::endl;
+	  theStepAutoTuner::Instance().recordForce(monomials[0].id, dsdQ, swatch.getTimeInSeconds());
+	  if( shadow.isActive() ) { 
+	    F[0] = dsdQ;
+	  }
+	  pop(xml_out); //elem
+	  for(int i=1; i < monomials.size(); i++) { 
+	    push(xml_out, "elem");
+	    multi1d<LatticeColorMatrix> cur_F(Nd);
+	    swatch.reset(); swatch.start();
+	    monomials[i].mon->dsdq(cur_F, s);
+	    swatch.stop();
+	    theStepAutoTuner::Instance().recordForce(monomials[i].id, cur_F, swatch.getTimeInSeconds());
+	    if( shadow.isActive() ) { 
+	      F[i] = cur_F;
+	    }
+	    dsdQ += cur_F;
+
+	    QDPIO::cout << "FORCE TIME: " << monomials[i].id << " : " << swatch.getTimeInSeconds() << "\n";
+ 
+	    pop(xml_out); // elem
+	  }
+
+	  if( shadow.isActive() ) { 
+	    shadow.recordForces(ids, F, s);
+	  }
+	}
+	pop(xml_out); // ForcesByMonomial
+	//monitorForces(xml_out, "TotalForcesThisLevel", dsdQ);
+	pop(xml_out); // AbsHamiltonianForce 
+      }
+    }
+
+
+    // Suspend the observers of the MD
+    SuspendObservers::SuspendObservers()
+    {
+      tuner_on = theStepAutoTuner::Instance().suspend();
+      shadow_on = theShadowMonitor::Instance().suspend();
+    }
+
+    // Let the observers carry on as before
+    SuspendObservers::~SuspendObservers()
+    {
+      theShadowMonitor::Instance().resume(shadow_on);
+      theStepAutoTuner::Instance().resume(tuner_on);
+    }
+
+
     //! LeapP for just a selected list of monomials
     void leapP(const multi1d< IntegratorShared::MonomialPair >& monomials,
 	                                       
@@ -19,8 +103,6 @@ namespace Chroma
 	       multi1d<LatticeColorMatrix> >& s)
     {
       START_CODE();
-      StopWatch swatch;
-
 
       XMLWriter& xml_out = TheXMLLogWriter::Instance();
       // Self Description rule
@@ -37,33 +119,7 @@ namespace Chroma
       
       // Force Term
       multi1d<LatticeColorMatrix> dsdQ(Nd);
-      push(xml_out, "AbsHamiltonianForce"); // Backward compatibility
-      write(xml_out, "num_terms", monomials.size());
-      push(xml_out, "ForcesByMonomial");
-
-      if( monomials.size() > 0 ) { 
-	push(xml_out, "elem");
-	swatch.reset(); swatch.start();
-	monomials[0].mon->dsdq(dsdQ,s);
-	swatch.stop();
-	QDPIO::cout << "FORCE TIME: " << monomials[0].id <<  " : " << swatch.getTimeInSeconds() << std::endl;
-	pop(xml_out); //elem
-	for(int i=1; i < monomials.size(); i++) { 
-	  push(xml_out, "elem");
-	  multi1d<LatticeColorMatrix> cur_F(Nd);
-	  swatch.reset(); swatch.start();
-	  monomials[i].mon->dsdq(cur_F, s);
-	  swatch.stop();
-	  dsdQ += cur_F;
-
-	  QDPIO::cout << "FORCE TIME: " << monomials[i].id << " : " << swatch.getTimeInSeconds() << "\n";
- 
-	  pop(xml_out); // elem
-	}
-      }
-      pop(xml_out); // ForcesByMonomial
-      //monitorForces(xml_out, "TotalForcesThisLevel", dsdQ);
-      pop(xml_out); // AbsHamiltonianForce 
+      monomialForces(monomials, dsdQ, s);
 
 
       for(int mu =0; mu < Nd; mu++) {
@@ -79,6 +135,55 @@ namespace Chroma
       END_CODE();
     }
 
+    //! LeapP with the approximate force gradient term
+    void leapPForceGradient(const multi1d< IntegratorShared::MonomialPair >& monomials,
+			    const Real& dt, 
+			    const Real& fg_dt, 
+			    AbsFieldState<multi1d<LatticeColorMatrix>,
+			    multi1d<LatticeColorMatrix> >& s)
+    {
+      START_CODE();
+
+      if( monomials.size() == 0 ) { 
+	END_CODE();
+	return;
+      }
+
+      XMLWriter& xml_out = TheXMLLogWriter::Instance();
+      // Self Description rule
+      push(xml_out, "leapPForceGradient");
+      write(xml_out, "dt", dt);
+      write(xml_out, "fg_dt", fg_dt);
+
+      // Displace the gauge field along the force:  U' = exp(fg_dt F) U
+      Handle< AbsFieldState<multi1d<LatticeColorMatrix>,
+	                    multi1d<LatticeColorMatrix> > > s_fg(s.clone());
+      {
+	multi1d<LatticeColorMatrix> dsdQ(Nd);
+	monomialForces(monomials, dsdQ, s);
+
+	for(int mu =0; mu < Nd; mu++) {
+	  (s_fg->getP())[mu] = dsdQ[mu];
+	  taproj( (s_fg->getP())[mu] );
+	}
+      }
+      {
+	// The displaced field is not on the trajectory
+	SuspendObservers off;
+
+	leapQ(fg_dt, *s_fg);
+
+	// Kick the original momenta with the force on the displaced field
+	s_fg->getP() = s.getP();
+	leapP(monomials, dt, *s_fg);
+	s.getP() = s_fg->getP();
+      }
+
+      pop(xml_out); // pop("leapPForceGradient");
+
+      END_CODE();
+    }
+
     void leapQ(const Real& dt, 
 	       AbsFieldState<multi1d<LatticeColorMatrix>,
 	       multi1d<LatticeColorMatrix> >& s) 
@@ -101,6 +206,8 @@ namespace Chroma
       }
       write(xml_out, "dt_actual_per_dir", real_step_size);
       
+      theShadowMonitor::Instance().advance(dt);
+
       // Constant
       const multi1d<LatticeColorMatrix>& p_mom = s.getP();
       
@@ -109,22 +216,34 @@ namespace Chroma
       
       for(int mu = 0; mu < Nd; mu++) 
       {
-	//  dt*p[mu]
-	tmp_1 = real_step_size[mu]*(s.getP())[mu];
+	if( Nc == 3 ) { 
+	  // u[mu] = exp(dt*p[mu]) u[mu], exactly and in place
+	  eesu3Update((s.getQ())[mu], (s.getP())[mu], real_step_size[mu]);
+
+#if BASE_PRECISION == 32
+	  // The exponential is unitary to double precision, but the 
+	  // single precision links still drift
+	  int numbad;
+	  reunit((s.getQ())[mu], numbad, REUNITARIZE_ERROR);
+#endif
+	}
+	else { 
+	  //  dt*p[mu]
+	  tmp_1 = real_step_size[mu]*(s.getP())[mu];
 	
-	// tmp_1 = exp(dt*p[mu])  
-	// expmat(tmp_1, EXP_TWELFTH_ORDER);
-	expmat(tmp_1, EXP_EXACT);
+	  // tmp_1 = exp(dt*p[mu])  
+	  expmat(tmp_1, EXP_EXACT);
 	
-	// tmp_2 = exp(dt*p[mu]) u[mu] = tmp_1 * u[mu]
-	tmp_2 = tmp_1*(s.getQ())[mu];
+	  // tmp_2 = exp(dt*p[mu]) u[mu] = tmp_1 * u[mu]
+	  tmp_2 = tmp_1*(s.getQ())[mu];
 	
-	// u[mu] =  tmp_1 * u[mu] =  tmp_2 
-	(s.getQ())[mu] = tmp_2;
+	  // u[mu] =  tmp_1 * u[mu] =  tmp_2 
+	  (s.getQ())[mu] = tmp_2;
 	
-	// Reunitarize u[mu]
-	int numbad;
-	reunit((s.getQ())[mu], numbad, REUNITARIZE_ERROR);
+	  // Reunitarize u[mu]
+	  int numbad;
+	  reunit((s.getQ())[mu], numbad, REUNITARIZE_ERROR);
+	}
       }
 
       pop(xml_out);
@@ -53,6 +53,27 @@ namespace Chroma
 
     typedef SingletonHolder<  AnisoStepSizeArray > theAnisoStepSizeArray;
 
+    //! Suspends the observers of the MD while in scope
+    /*!
+     * The step size autotuner and the shadow monitor are to see only the
+     * trajectory that goes to the accept/reject step. Integrations off
+     * that trajectory, like the step checks or the displaced field of a
+     * force gradient step, are done with one of these in scope.
+     */
+    class SuspendObservers {
+    public:
+      SuspendObservers();
+      ~SuspendObservers();
+
+    private:
+      // Not copyable
+      SuspendObservers(const SuspendObservers&);
+      SuspendObservers& operator=(const SuspendObservers&);
+
+      bool tuner_on;
+      bool shadow_on;
+    };
+
     //! Leap with Q (with all monomials)
     /*! @ingroup integrator */
     void leapQ(const Real& dt, 
@@ -69,6 +90,24 @@ namespace Chroma
 			     multi1d<LatticeColorMatrix> >& s);
 
 
+    //! LeapP with the approximate (Hessian free) force gradient term
+    /*! @ingroup integrator
+     *
+     * Approximates  exp( dt S + xi C ), where C = [S,[T,S]] is the force
+     * gradient term, by a plain momentum step with the force evaluated on
+     * the gauge field displaced along the force by  fg_dt = 2 xi / dt
+     *
+     *     P += dt F(U'),    U' = exp( fg_dt F(U) ) U
+     *
+     * The displacement costs one extra force evaluation of the monomials.
+     */
+    void leapPForceGradient(const multi1d< IntegratorShared::MonomialPair >& monomials,
+			    const Real& dt, 
+			    const Real& fg_dt, 
+			    AbsFieldState<multi1d<LatticeColorMatrix>,
+			                  multi1d<LatticeColorMatrix> >& s);
+
+
 
 
   } // End Namespace MDIntegratorSteps
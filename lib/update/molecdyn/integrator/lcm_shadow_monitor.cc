@@ -0,0 +1,233 @@
+/*! @file
+ * @brief Poisson bracket time series of the monomials along MD trajectories
+ */
+
+#include "update/molecdyn/integrator/lcm_shadow_monitor.h"
+#include <cstring>
+
+namespace Chroma
+{
+  namespace
+  {
+    const char shadow_magic[8] = {'C','H','S','H','A','D','O','W'};
+    const int  shadow_version = 1;
+    const unsigned int shadow_byte_order = 0x01020304;
+    const int  shadow_record_bytes = 4*4 + 2*8;
+  }
+
+  // Monitoring switched off
+  LCMShadowMonitorParams::LCMShadowMonitorParams() :
+    enabled(false), output_file("shadow.bin")
+  {}
+
+  // Read from XML
+  LCMShadowMonitorParams::LCMShadowMonitorParams(XMLReader& xml, const std::string& path)
+  {
+    enabled = true;
+
+    try {
+      XMLReader paramtop(xml, path);
+      read(paramtop, "OutputFile", output_file);
+    }
+    catch(const std::string& e) {
+      QDPIO::cout << "Caught Exception Reading ShadowMonitor XML: " << e << std::endl;
+      QDP_abort(1);
+    }
+  }
+
+  // Read the shadow monitor params
+  void read(XMLReader& xml, const std::string& path, LCMShadowMonitorParams& p)
+  {
+    LCMShadowMonitorParams tmp(xml, path);
+    p = tmp;
+  }
+
+  // Write the shadow monitor params
+  void write(XMLWriter& xml, const std::string& path, const LCMShadowMonitorParams& p)
+  {
+    push(xml, path);
+    write(xml, "OutputFile", p.output_file);
+    pop(xml);
+  }
+
+
+  namespace LCMMDIntegratorSteps
+  {
+
+    // Start writing to the file of p
+    void ShadowMonitor::start(const LCMShadowMonitorParams& p)
+    {
+      params = p;
+      enabled = p.enabled;
+      if (! enabled)
+	return;
+
+      QDPIO::cout << "ShadowMonitor: writing Poisson brackets to " << params.output_file << std::endl;
+
+      if (Layout::primaryNode()) {
+	header();
+
+	out.open(params.output_file.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+	ids_out.open((params.output_file + ".ids").c_str(), std::ios::out | std::ios::app);
+	if (! out || ! ids_out) {
+	  QDPIO::cerr << "ShadowMonitor: cannot open " << params.output_file << std::endl;
+	  QDP_abort(1);
+	}
+      }
+    }
+
+
+    // Write the file header, or check the one there
+    void ShadowMonitor::header()
+    {
+      std::ifstream in(params.output_file.c_str(), std::ios::in | std::ios::binary);
+      if (in && in.peek() != std::ifstream::traits_type::eof())
+      {
+	// Appending: it must be a file of this format written on this kind of machine
+	char magic[8];
+	int version = 0, record_bytes = 0;
+	unsigned int byte_order = 0;
+	in.read(magic, sizeof(magic));
+	in.read(reinterpret_cast<char*>(&version), sizeof(version));
+	in.read(reinterpret_cast<char*>(&byte_order), sizeof(byte_order));
+	in.read(reinterpret_cast<char*>(&record_bytes), sizeof(record_bytes));
+
+	if (! in 
+	    || memcmp(magic, shadow_magic, sizeof(magic)) != 0
+	    || version != shadow_version
+	    || byte_order != shadow_byte_order
+	    || record_bytes != shadow_record_bytes)
+	{
+	  QDPIO::cerr << "ShadowMonitor: " << params.output_file 
+		      << " exists but is not a version " << shadow_version 
+		      << " shadow monitor file in this byte order" << std::endl;
+	  QDP_abort(1);
+	}
+	return;
+      }
+      in.close();
+
+      std::ofstream h(params.output_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      h.write(shadow_magic, sizeof(shadow_magic));
+      h.write(reinterpret_cast<const char*>(&shadow_version), sizeof(shadow_version));
+      h.write(reinterpret_cast<const char*>(&shadow_byte_order), sizeof(shadow_byte_order));
+      h.write(reinterpret_cast<const char*>(&shadow_record_bytes), sizeof(shadow_record_bytes));
+      if (! h) {
+	QDPIO::cerr << "ShadowMonitor: cannot write the header of " << params.output_file << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+
+    // MD of a new trajectory starts
+    void ShadowMonitor::beginTrajectory()
+    {
+      if (! enabled)
+	return;
+
+      active = true;
+      md_time = 0;
+    }
+
+
+    // MD of the trajectory is over
+    void ShadowMonitor::stopTrajectory()
+    {
+      active = false;
+    }
+
+
+    // Trajectory ended with energy violation DeltaH
+    void ShadowMonitor::endTrajectory(const Double& DeltaH)
+    {
+      if (! enabled)
+	return;
+
+      put(DELTA_H, -1, -1, toDouble(DeltaH));
+      if (Layout::primaryNode()) {
+	out.flush();
+	ids_out.flush();
+      }
+      ++traj;
+    }
+
+
+    // The gauge field moved by dt
+    void ShadowMonitor::advance(const Real& dt)
+    {
+      if (active)
+	md_time += toDouble(dt);
+    }
+
+
+    // Index of a monomial id, registering it if new
+    int ShadowMonitor::index(const std::string& id)
+    {
+      std::map<std::string, int>::const_iterator it = indices.find(id);
+      if (it != indices.end())
+	return it->second;
+
+      int k = indices.size();
+      indices[id] = k;
+      if (Layout::primaryNode())
+	ids_out << k << " " << id << "\n";
+
+      return k;
+    }
+
+
+    // Append a record
+    void ShadowMonitor::put(int kind, int i, int j, double value)
+    {
+      if (! Layout::primaryNode())
+	return;
+
+      // Field by field, so there is no padding to depend on the compiler
+      const int ints[4] = {kind, traj, i, j};
+      const double dbls[2] = {md_time, value};
+      out.write(reinterpret_cast<const char*>(ints), sizeof(ints));
+      out.write(reinterpret_cast<const char*>(dbls), sizeof(dbls));
+    }
+
+
+    // The forces of a list of monomials at the state s
+    void ShadowMonitor::recordForces(const multi1d<std::string>& ids,
+				     const multi1d< multi1d<LatticeColorMatrix> >& F,
+				     const AbsFieldState<multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s)
+    {
+      if (! active)
+	return;
+
+      START_CODE();
+
+      const Double vol = Double(Layout::vol());
+      const int n = ids.size();
+
+      multi1d<int> idx(n);
+      for(int k=0; k < n; ++k)
+	idx[k] = index(ids[k]);
+
+      for(int k=0; k < n; ++k)
+      {
+	// {S_k,T} = - Tr(P F_k)
+	Double st = zero;
+	for(int mu=0; mu < Nd; ++mu)
+	  st -= sum(real(trace(s.getP()[mu]*F[k][mu])));
+	put(BRACKET_ST, idx[k], idx[k], toDouble(st/vol));
+
+	// {S_k,{S_l,T}} = - Tr(F_k F_l), symmetric in k,l
+	for(int l=k; l < n; ++l)
+	{
+	  Double sst = zero;
+	  for(int mu=0; mu < Nd; ++mu)
+	    sst -= sum(real(trace(F[k][mu]*F[l][mu])));
+	  put(BRACKET_SST, idx[k], idx[l], toDouble(sst/vol));
+	}
+      }
+
+      END_CODE();
+    }
+
+  } // End Namespace LCMMDIntegratorSteps
+
+} // End Namespace Chroma
@@ -0,0 +1,144 @@
+// -*- C++ -*-
+/*! @file
+ * @brief Poisson bracket time series of the monomials along MD trajectories
+ */
+
+#ifndef LCM_SHADOW_MONITOR_H
+#define LCM_SHADOW_MONITOR_H
+
+#include "chromabase.h"
+#include "singleton.h"
+#include "update/molecdyn/field_state.h"
+#include <map>
+#include <fstream>
+
+namespace Chroma
+{
+
+  //! Parameters of the shadow Hamiltonian monitor
+  /*! @ingroup integrator
+   *
+   * Read from the optional ShadowMonitor group of the toplevel integrator:
+   *
+   *   <ShadowMonitor>
+   *     <OutputFile>shadow.bin</OutputFile>
+   *   </ShadowMonitor>
+   */
+  struct LCMShadowMonitorParams
+  {
+    //! Monitoring switched off
+    LCMShadowMonitorParams();
+
+    //! Read from XML
+    LCMShadowMonitorParams(XMLReader& xml, const std::string& path);
+
+    bool        enabled;          /*!< monitoring switched on */
+    std::string output_file;      /*!< binary time series file */
+  };
+
+  //! Read the shadow monitor params
+  void read(XMLReader& xml, const std::string& path, LCMShadowMonitorParams& p);
+
+  //! Write the shadow monitor params
+  void write(XMLWriter& xml, const std::string& path, const LCMShadowMonitorParams& p);
+
+
+  namespace LCMMDIntegratorSteps
+  {
+    //! Poisson brackets of the monomials from the forces of the MD
+    /*!
+     * Whenever the forces of a list of monomials have been computed, it
+     * uses them, at no extra force cost, for
+     *
+     *   {S_i,{S_j,T}} = - sum_x,mu Tr( F_i F_j )   for the monomials of the list
+     *   {S_i,T}       = - sum_x,mu Tr( P F_i )     (dS_i/dt)
+     *
+     * which are the force parts of the shadow Hamiltonian of the
+     * integrator. The {T,{S,T}} terms need second derivatives of the
+     * actions and are not measured.
+     *
+     * Only the trajectory going to the accept/reject step is recorded,
+     * between beginTrajectory() and stopTrajectory().
+     *
+     * The values are per site and are appended to a binary file. A new
+     * file starts with a header
+     *
+     *   char[8]  "CHSHADOW"
+     *   int32    format version (1)
+     *   uint32   0x01020304, in the byte order of the records
+     *   int32    bytes per record (32)
+     *
+     * and each record is, in that byte order,
+     *
+     *   int32  kind, int32 traj, int32 i, int32 j, float64 md_time, float64 value
+     *
+     * The monomial ids belonging to the indices are in a text file of
+     * the same name with ".ids" appended.
+     */
+    class ShadowMonitor {
+    public:
+      //! Kinds of record
+      enum Kind {
+	BRACKET_SST = 0,      /*!< {S_i,{S_j,T}} */
+	BRACKET_ST  = 1,      /*!< {S_i,T}, j = i */
+	DELTA_H     = 2       /*!< energy violation at the trajectory end, i = j = -1 */
+      };
+
+      ShadowMonitor() : enabled(false), active(false), traj(0), md_time(0) {}
+
+      //! Start writing to the file of p
+      void start(const LCMShadowMonitorParams& p);
+
+      //! Is a trajectory being monitored
+      bool isActive() const {return active;}
+
+      //! MD of a new trajectory starts
+      void beginTrajectory();
+
+      //! MD of the trajectory is over
+      void stopTrajectory();
+
+      //! Trajectory ended with energy violation DeltaH
+      void endTrajectory(const Double& DeltaH);
+
+      //! Stop recording for a while, returns whether it was recording
+      bool suspend() {bool was = active; active = false; return was;}
+
+      //! Carry on after suspend()
+      void resume(bool was_active) {active = was_active;}
+
+      //! The gauge field moved by dt
+      void advance(const Real& dt);
+
+      //! The forces F[k] of the monomials ids[k] at the state s
+      void recordForces(const multi1d<std::string>& ids,
+			const multi1d< multi1d<LatticeColorMatrix> >& F,
+			const AbsFieldState<multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s);
+
+    private:
+      //! Index of a monomial id, registering it if new
+      int index(const std::string& id);
+
+      //! Append a record
+      void put(int kind, int i, int j, double value);
+
+      //! Write the file header, or check the one there
+      void header();
+
+      bool enabled;
+      bool active;
+      int traj;
+      double md_time;
+      LCMShadowMonitorParams params;
+      std::map<std::string, int> indices;
+      std::ofstream out;
+      std::ofstream ids_out;
+    };
+
+    typedef SingletonHolder< ShadowMonitor > theShadowMonitor;
+
+  } // End Namespace LCMMDIntegratorSteps
+
+} // End Namespace Chroma
+
+#endif
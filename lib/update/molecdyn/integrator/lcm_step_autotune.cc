@@ -0,0 +1,407 @@
+/*! @file
+ * @brief Step size autotuning for nested LatticeColorMatrix MD integrators
+ */
+
+#include "update/molecdyn/integrator/lcm_step_autotune.h"
+#include "io/xmllog_io.h"
+#include <cmath>
+
+namespace Chroma
+{
+
+  // Autotuning switched off
+  LCMStepAutoTuneParams::LCMStepAutoTuneParams() :
+    enabled(false), skip_traj(0), tune_traj(20), target_acc(0.8),
+    order(2), max_steps(32), apply(false), output_file("tuned_integrator.xml")
+  {}
+
+  // Read from XML
+  LCMStepAutoTuneParams::LCMStepAutoTuneParams(XMLReader& xml, const std::string& path)
+  {
+    *this = LCMStepAutoTuneParams();
+    enabled = true;
+
+    try {
+      XMLReader paramtop(xml, path);
+
+      read(paramtop, "TuneTrajectories", tune_traj);
+      read(paramtop, "TargetAcceptance", target_acc);
+      read(paramtop, "OutputFile", output_file);
+
+      if( paramtop.count("SkipTrajectories") == 1 ) {
+	read(paramtop, "SkipTrajectories", skip_traj);
+      }
+      if( paramtop.count("Order") == 1 ) {
+	read(paramtop, "Order", order);
+      }
+      if( paramtop.count("MaxSteps") == 1 ) {
+	read(paramtop, "MaxSteps", max_steps);
+      }
+      if( paramtop.count("Apply") == 1 ) {
+	read(paramtop, "Apply", apply);
+      }
+    }
+    catch(const std::string& e) {
+      QDPIO::cout << "Caught Exception Reading AutoTune XML: " << e << std::endl;
+      QDP_abort(1);
+    }
+
+    if( tune_traj < 2 || max_steps < 1 || order < 1
+	|| toBool(target_acc <= Real(0)) || toBool(target_acc >= Real(1)) ) {
+      QDPIO::cout << "AutoTune: need TuneTrajectories >= 2, MaxSteps >= 1, Order >= 1 and 0 < TargetAcceptance < 1" << std::endl;
+      QDP_abort(1);
+    }
+  }
+
+  // Read the autotuning params
+  void read(XMLReader& xml, const std::string& path, LCMStepAutoTuneParams& p)
+  {
+    LCMStepAutoTuneParams tmp(xml, path);
+    p = tmp;
+  }
+
+  // Write the autotuning params
+  void write(XMLWriter& xml, const std::string& path, const LCMStepAutoTuneParams& p)
+  {
+    push(xml, path);
+    write(xml, "SkipTrajectories", p.skip_traj);
+    write(xml, "TuneTrajectories", p.tune_traj);
+    write(xml, "TargetAcceptance", p.target_acc);
+    write(xml, "Order", p.order);
+    write(xml, "MaxSteps", p.max_steps);
+    write(xml, "Apply", p.apply);
+    write(xml, "OutputFile", p.output_file);
+    pop(xml);
+  }
+
+
+  namespace LCMMDIntegratorSteps
+  {
+    namespace
+    {
+      //! Inverse of erfc on (0,1) by bisection
+      double erfcInv(double y)
+      {
+	double lo = 0, hi = 10;
+	for(int i=0; i < 200; ++i)
+	{
+	  double mid = 0.5*(lo + hi);
+	  if (erfc(mid) > y)
+	    lo = mid;
+	  else
+	    hi = mid;
+	}
+	return 0.5*(lo + hi);
+      }
+    }
+
+
+    //! Replace the n_steps of each nesting level of an integrator XML
+    /*!
+     * The levels are counted by the SubIntegrator tags enclosing an
+     * n_steps element, so the element order within a level does not
+     * matter.
+     */
+    std::string setIntegratorSteps(const std::string& xml, const std::vector<int>& n_steps)
+    {
+      const std::string open_sub  = "<SubIntegrator>";
+      const std::string close_sub = "</SubIntegrator>";
+      const std::string open_n    = "<n_steps>";
+      const std::string close_n   = "</n_steps>";
+
+      std::string out;
+      int depth = 0;
+      std::string::size_type pos = 0;
+      while (pos < xml.size())
+      {
+	if (xml.compare(pos, open_sub.size(), open_sub) == 0) {
+	  ++depth;
+	  out += open_sub;
+	  pos += open_sub.size();
+	}
+	else if (xml.compare(pos, close_sub.size(), close_sub) == 0) {
+	  --depth;
+	  out += close_sub;
+	  pos += close_sub.size();
+	}
+	else if (xml.compare(pos, open_n.size(), open_n) == 0 && depth < n_steps.size()) {
+	  std::string::size_type end = xml.find(close_n, pos);
+	  if (end == std::string::npos)
+	    return xml;
+
+	  std::ostringstream os;
+	  os << open_n << n_steps[depth] << close_n;
+	  out += os.str();
+	  pos = end + close_n.size();
+	}
+	else {
+	  out += xml[pos++];
+	}
+      }
+      return out;
+    }
+
+
+    // Start tuning the integrator described by integrator_xml
+    void StepAutoTuner::start(const LCMStepAutoTuneParams& p, const std::string& integrator_xml_, const Real& tau0_)
+    {
+      params = p;
+      integrator_xml = integrator_xml_;
+      tau0 = toDouble(tau0_);
+      recording = false;
+      active = false;
+      done = false;
+      n_traj = 0;
+      levels.clear();
+      this_traj.clear();
+      stats.clear();
+      delta_h.clear();
+
+      if (! params.enabled)
+	return;
+
+      // The levels of the nested integrator
+      std::istringstream is(integrator_xml);
+      XMLReader int_reader(is);
+      std::string path = "/Integrator";
+
+      try {
+	while( int_reader.count(path) == 1 ) {
+	  XMLReader paramtop(int_reader, path);
+
+	  Level l;
+	  read(paramtop, "Name", l.name);
+
+	  if( paramtop.count("n_steps") != 1 ) {
+	    QDPIO::cout << "AutoTune: integrator " << l.name << " has no n_steps. Not tuning" << std::endl;
+	    return;
+	  }
+	  read(paramtop, "n_steps", l.n_steps);
+
+	  if( paramtop.count("monomial_ids") == 1 ) {
+	    multi1d<std::string> ids;
+	    read(paramtop, "monomial_ids", ids);
+	    for(int i=0; i < ids.size(); ++i)
+	      l.monomial_ids.push_back(ids[i]);
+	  }
+
+	  levels.push_back(l);
+	  path += "/SubIntegrator";
+	}
+      }
+      catch(const std::string& e) {
+	QDPIO::cout << "AutoTune: Caught Exception Reading Integrator XML: " << e << std::endl;
+	QDP_abort(1);
+      }
+
+      QDPIO::cout << "AutoTune: tuning " << levels.size() << " integrator levels over "
+		  << params.tune_traj << " trajectories after skipping " << params.skip_traj << std::endl;
+      recording = true;
+    }
+
+
+    // Record one force evaluation of a monomial
+    void StepAutoTuner::recordForce(const std::string& id, const multi1d<LatticeColorMatrix>& F, double secs)
+    {
+      if (! active)
+	return;
+
+      // Mean squared force per link
+      double nrm = toDouble(norm2(F)) / double(Nd*Layout::vol());
+
+      MonomialStats& m = this_traj[id];
+      m.norm += nrm;
+      m.secs += secs;
+      m.count += 1;
+    }
+
+
+    // Record the end of a trajectory
+    bool StepAutoTuner::endTrajectory(const Double& DeltaH)
+    {
+      if (! recording)
+	return false;
+
+      ++n_traj;
+      if (n_traj > params.skip_traj)
+      {
+	delta_h.push_back(toDouble(DeltaH));
+	for(std::map<std::string, MonomialStats>::const_iterator m = this_traj.begin(); m != this_traj.end(); ++m)
+	{
+	  MonomialStats& s = stats[m->first];
+	  s.norm  += m->second.norm;
+	  s.secs  += m->second.secs;
+	  s.count += m->second.count;
+	}
+      }
+      this_traj.clear();
+
+      if (delta_h.size() < params.tune_traj)
+	return false;
+
+      tune();
+      recording = false;
+      active = false;
+      done = true;
+      return true;
+    }
+
+
+    // Work out the tuned steps
+    void StepAutoTuner::tune()
+    {
+      START_CODE();
+
+      const int n_lev = levels.size();
+      const double n_rec = delta_h.size();
+
+      // Variance of dH
+      double mean = 0, var = 0;
+      for(int t=0; t < delta_h.size(); ++t)
+	mean += delta_h[t];
+      mean /= n_rec;
+      for(int t=0; t < delta_h.size(); ++t)
+	var += (delta_h[t] - mean)*(delta_h[t] - mean);
+      var /= (n_rec - 1);
+
+      // Force norm and time per trajectory of each level
+      std::vector<double> force(n_lev, 0.0);
+      std::vector<double> secs(n_lev, 0.0);
+      std::vector<int> n0(n_lev);
+      for(int l=0; l < n_lev; ++l)
+      {
+	n0[l] = levels[l].n_steps;
+	for(int i=0; i < levels[l].monomial_ids.size(); ++i)
+	{
+	  std::map<std::string, MonomialStats>::const_iterator m = stats.find(levels[l].monomial_ids[i]);
+	  if (m == stats.end() || m->second.count == 0)
+	    continue;
+
+	  force[l] += m->second.norm / m->second.count;
+	  secs[l]  += m->second.secs / n_rec;
+	}
+      }
+
+      // Error and cost of a choice of steps, relative to the current ones
+      const int p2 = 2*params.order;
+      std::vector<int> n = n0;
+
+      double model0 = 0;
+      {
+	double steps = 1;
+	for(int l=0; l < n_lev; ++l)
+	{
+	  steps *= n0[l];
+	  model0 += force[l] * std::pow(tau0/steps, p2);
+	}
+      }
+
+      const double var_target = 8.0 * std::pow(erfcInv(toDouble(params.target_acc)), 2);
+      std::vector<int> best = n0;
+
+      if (var <= 0 || model0 <= 0)
+      {
+	QDPIO::cout << "AutoTune: no measurable energy violation or force. Keeping the steps" << std::endl;
+      }
+      else
+      {
+	const double K = var / model0;
+	double best_cost = -1;
+
+	// All the steps from 1 to max_steps on the levels with monomials;
+	// the others keep their steps
+	std::vector<int> tunable;
+	for(int l=0; l < n_lev; ++l)
+	{
+	  if (levels[l].monomial_ids.size() > 0)
+	  {
+	    n[l] = 1;
+	    tunable.push_back(l);
+	  }
+	}
+
+	for(;;)
+	{
+	  double err = 0, cost = 0, steps = 1, rel = 1;
+	  for(int l=0; l < n_lev; ++l)
+	  {
+	    steps *= n[l];
+	    rel   *= double(n[l]) / double(n0[l]);
+	    err  += K * force[l] * std::pow(tau0/steps, p2);
+	    cost += secs[l] * rel;
+	  }
+
+	  if (err <= var_target && (best_cost < 0 || cost < best_cost))
+	  {
+	    best_cost = cost;
+	    best = n;
+	  }
+
+	  // Next choice
+	  int k = 0;
+	  for(; k < tunable.size(); ++k)
+	  {
+	    if (++n[tunable[k]] <= params.max_steps)
+	      break;
+	    n[tunable[k]] = 1;
+	  }
+	  if (k == tunable.size())
+	    break;
+	}
+
+	if (best_cost < 0)
+	{
+	  QDPIO::cout << "AutoTune: target acceptance out of reach with MaxSteps = " << params.max_steps
+		      << ". Using the largest steps" << std::endl;
+	  for(int i=0; i < tunable.size(); ++i)
+	    best[tunable[i]] = params.max_steps;
+	}
+      }
+
+      // Predicted acceptance
+      double var_pred = 0;
+      if (model0 > 0)
+      {
+	double steps = 1, model = 0;
+	for(int l=0; l < n_lev; ++l)
+	{
+	  steps *= best[l];
+	  model += force[l] * std::pow(tau0/steps, p2);
+	}
+	var_pred = var * model / model0;
+      }
+
+      tuned_xml = setIntegratorSteps(integrator_xml, best);
+
+      XMLWriter& xml_out = TheXMLLogWriter::Instance();
+      push(xml_out, "AutoTune");
+      write(xml_out, "VarDeltaH", var);
+      write(xml_out, "TargetVarDeltaH", var_target);
+      write(xml_out, "PredictedVarDeltaH", var_pred);
+      write(xml_out, "PredictedAcceptance", erfc(std::sqrt(var_pred/8)));
+      push(xml_out, "Levels");
+      for(int l=0; l < n_lev; ++l)
+      {
+	push(xml_out, "elem");
+	write(xml_out, "Name", levels[l].name);
+	write(xml_out, "ForceNorm", force[l]);
+	write(xml_out, "ForceTimePerTraj", secs[l]);
+	write(xml_out, "n_steps_old", n0[l]);
+	write(xml_out, "n_steps_new", best[l]);
+	pop(xml_out);
+
+	QDPIO::cout << "AutoTune: level " << l << " (" << levels[l].name << ") force norm = " << force[l]
+		    << " force time = " << secs[l] << " n_steps " << n0[l] << " -> " << best[l] << std::endl;
+      }
+      pop(xml_out);
+      pop(xml_out);
+
+      QDPIO::cout << "AutoTune: Var(dH) = " << var << " predicted = " << var_pred
+		  << " predicted acceptance = " << erfc(std::sqrt(var_pred/8)) << std::endl;
+
+      END_CODE();
+    }
+
+  } // End Namespace LCMMDIntegratorSteps
+
+} // End Namespace Chroma
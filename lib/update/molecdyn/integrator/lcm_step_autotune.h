@@ -0,0 +1,155 @@
+// -*- C++ -*-
+/*! @file
+ * @brief Step size autotuning for nested LatticeColorMatrix MD integrators
+ */
+
+#ifndef LCM_STEP_AUTOTUNE_H
+#define LCM_STEP_AUTOTUNE_H
+
+#include "chromabase.h"
+#include "singleton.h"
+#include <map>
+#include <vector>
+
+namespace Chroma
+{
+
+  //! Parameters of the step size autotuner
+  /*! @ingroup integrator
+   *
+   * Read from the optional AutoTune group of the toplevel integrator:
+   *
+   *   <AutoTune>
+   *     <SkipTrajectories>10</SkipTrajectories>
+   *     <TuneTrajectories>20</TuneTrajectories>
+   *     <TargetAcceptance>0.8</TargetAcceptance>
+   *     <Order>2</Order>
+   *     <MaxSteps>32</MaxSteps>
+   *     <Apply>true</Apply>
+   *     <OutputFile>tuned_integrator.xml</OutputFile>
+   *   </AutoTune>
+   */
+  struct LCMStepAutoTuneParams
+  {
+    //! Autotuning switched off
+    LCMStepAutoTuneParams();
+
+    //! Read from XML
+    LCMStepAutoTuneParams(XMLReader& xml, const std::string& path);
+
+    bool        enabled;          /*!< tuning switched on */
+    int         skip_traj;        /*!< trajectories ignored before measuring */
+    int         tune_traj;        /*!< trajectories measured */
+    Real        target_acc;       /*!< target acceptance rate */
+    int         order;            /*!< order of the integrator scheme */
+    int         max_steps;        /*!< largest n_steps tried on a level */
+    bool        apply;            /*!< switch to the tuned steps once done */
+    std::string output_file;      /*!< file for the tuned integrator XML */
+  };
+
+  //! Read the autotuning params
+  void read(XMLReader& xml, const std::string& path, LCMStepAutoTuneParams& p);
+
+  //! Write the autotuning params
+  void write(XMLWriter& xml, const std::string& path, const LCMStepAutoTuneParams& p);
+
+
+  namespace LCMMDIntegratorSteps
+  {
+    //! Replace the n_steps of the first n_steps.size() nesting levels of an integrator XML
+    std::string setIntegratorSteps(const std::string& xml, const std::vector<int>& n_steps);
+
+    //! Step size autotuner for nested integrators
+    /*!
+     * Over a number of trajectories it records the mean force norm and the
+     * force time of each monomial, and the variance of the energy
+     * violation dH. The error model is
+     *
+     *   Var(dH) = K sum_l  F_l  h_l^(2 order)
+     *
+     * with F_l the summed mean force norm of the monomials on level l and
+     * h_l the step size on that level. K is fitted to the measured
+     * variance at the current steps. The cost of a trajectory is the
+     * measured force time of each level scaled by its number of steps.
+     * The tuned steps are those of least cost whose predicted variance
+     * meets the target acceptance  erfc( sqrt(Var(dH)/8) ).
+     *
+     * Forces are only taken between beginTrajectory() and stopTrajectory(),
+     * which bracket the trajectory that goes to the accept/reject step,
+     * and not while suspended (eg. on the displaced field of a force
+     * gradient step).
+     */
+    class StepAutoTuner {
+    public:
+      StepAutoTuner() : recording(false), active(false), done(false), n_traj(0) {}
+
+      //! Start tuning the integrator described by integrator_xml
+      void start(const LCMStepAutoTuneParams& p, const std::string& integrator_xml, const Real& tau0);
+
+      //! Are forces to be recorded
+      bool isRecording() const {return active;}
+
+      //! MD of the trajectory to be measured starts
+      void beginTrajectory() {active = recording;}
+
+      //! MD of the trajectory is over
+      void stopTrajectory() {active = false;}
+
+      //! Stop recording for a while, returns whether it was recording
+      bool suspend() {bool was = active; active = false; return was;}
+
+      //! Carry on after suspend()
+      void resume(bool was_active) {active = was_active;}
+
+      //! Record one force evaluation of a monomial
+      void recordForce(const std::string& id, const multi1d<LatticeColorMatrix>& F, double secs);
+
+      //! Record the end of a trajectory
+      /*!
+       * \return true when this trajectory completed the tuning
+       */
+      bool endTrajectory(const Double& DeltaH);
+
+      //! The integrator XML with the tuned steps
+      const std::string& tunedIntegratorXML() const {return tuned_xml;}
+
+    private:
+      //! Work out the tuned steps
+      void tune();
+
+      //! One level of the nested integrator
+      struct Level {
+	std::string name;
+	int n_steps;
+	std::vector<std::string> monomial_ids;
+      };
+
+      //! Accumulated statistics of a monomial
+      struct MonomialStats {
+	MonomialStats() : norm(0), secs(0), count(0) {}
+	double norm;
+	double secs;
+	int count;
+      };
+
+      LCMStepAutoTuneParams params;
+      std::string integrator_xml;
+      std::string tuned_xml;
+      double tau0;
+      bool recording;
+      bool active;
+      bool done;
+      int n_traj;
+      std::vector<Level> levels;
+      std::map<std::string, MonomialStats> this_traj;
+      std::map<std::string, MonomialStats> stats;
+      std::vector<double> delta_h;
+    };
+
+    typedef SingletonHolder< StepAutoTuner > theStepAutoTuner;
+
+  } // End Namespace LCMMDIntegratorSteps
+
+} // End Namespace Chroma
+
+#endif
@@ -0,0 +1,178 @@
+#include "chromabase.h"
+#include "update/molecdyn/integrator/md_integrator_factory.h"
+#include "update/molecdyn/integrator/lcm_sts_force_grad_recursive.h"
+#include "update/molecdyn/integrator/lcm_exp_sdt.h"
+#include "update/molecdyn/integrator/lcm_integrator_leaps.h"
+#include "update/molecdyn/integrator/lcm_traj_checkpoint.h"
+#include "io/xmllog_io.h"
+
+#include <string>
+
+namespace Chroma 
+{ 
+  
+  namespace LatColMatSTSForceGradRecursiveIntegratorEnv 
+  {
+    namespace
+    {
+      AbsComponentIntegrator<multi1d<LatticeColorMatrix>, 
+			     multi1d<LatticeColorMatrix> >* 
+      createMDIntegrator(
+			 XMLReader& xml, 
+			 const std::string& path)
+      {
+	// Read the integrator params
+	LatColMatSTSForceGradRecursiveIntegratorParams p(xml, path);
+    
+	return new LatColMatSTSForceGradRecursiveIntegrator(p);
+      }
+      
+      //! Local registration flag
+      bool registered = false;
+    }
+
+    const std::string name = "LCM_STS_FORCE_GRAD";
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= TheMDComponentIntegratorFactory::Instance().registerObject(name, createMDIntegrator); 
+	registered = true;
+      }
+      return success;
+    }
+  }
+  
+  
+  LatColMatSTSForceGradRecursiveIntegratorParams::LatColMatSTSForceGradRecursiveIntegratorParams(XMLReader& xml_in, const std::string& path) 
+  {
+    XMLReader paramtop(xml_in, path);
+    try {
+      read(paramtop, "./n_steps", n_steps);
+      read(paramtop, "./monomial_ids", monomial_ids);
+      if( paramtop.count("./lambda") == 1 ) { 
+	read(paramtop, "./lambda", lambda );
+      }
+      else { 
+	lambda = Real(1)/Real(6);
+      }
+      if( paramtop.count("./xi") == 1 ) { 
+	read(paramtop, "./xi", xi );
+      }
+      else { 
+	xi = Real(1)/Real(72);
+      }
+      if( paramtop.count("./SubIntegrator") == 0 ) {
+	// BASE CASE: User does not supply sub-integrator 
+	//
+	// Sneaky way - create an XML document for EXP_T
+	XMLBufferWriter subintegrator_writer;
+	int one_sub_step=1;
+
+	push(subintegrator_writer, "SubIntegrator");
+	write(subintegrator_writer, "Name", "LCM_EXP_T");
+	write(subintegrator_writer, "n_steps", one_sub_step);
+	pop(subintegrator_writer);
+
+	subintegrator_xml = subintegrator_writer.str();
+
+      }
+      else {
+	// RECURSIVE CASE: User Does Supply Sub Integrator
+	//
+	// Read it
+	XMLReader subint_reader(paramtop, "./SubIntegrator");
+	std::ostringstream subintegrator_os;
+	subint_reader.print(subintegrator_os);
+	subintegrator_xml = subintegrator_os.str();
+	QDPIO::cout << "Subintegrator XML is: " << std::endl;
+	QDPIO::cout << subintegrator_xml << std::endl;
+      }
+    }
+    catch ( const std::string& e ) { 
+      QDPIO::cout << "Error reading XML in LatColMatSTSForceGradRecursiveIntegratorParams " << e << std::endl;
+      QDP_abort(1);
+    }
+  }
+  
+  void read(XMLReader& xml, 
+	    const std::string& path, 
+	    LatColMatSTSForceGradRecursiveIntegratorParams& p) {
+    LatColMatSTSForceGradRecursiveIntegratorParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, 
+	     const std::string& path, 
+	     const LatColMatSTSForceGradRecursiveIntegratorParams& p) {
+    push(xml, path);
+    write(xml, "n_steps", p.n_steps);
+    write(xml, "monomial_ids", p.monomial_ids);
+    write(xml, "lambda", p.lambda);
+    write(xml, "xi", p.xi);
+    xml << p.subintegrator_xml;
+    pop(xml);
+  }
+
+  
+
+  void LatColMatSTSForceGradRecursiveIntegrator::operator()( 
+					     AbsFieldState<multi1d<LatticeColorMatrix>,
+					     multi1d<LatticeColorMatrix> >& s, 
+					     const Real& traj_length) const
+  {
+   
+    START_CODE();
+    LatColMatExpSdtIntegrator expSdt(1,
+				     monomials);
+
+
+    const AbsComponentIntegrator< multi1d<LatticeColorMatrix>,
+      multi1d<LatticeColorMatrix> >& subIntegrator = getSubIntegrator();
+
+    				    
+    Real dtau = traj_length / Real(n_steps);
+    Real lambda_dt = dtau*lambda;
+    Real dtauby2 = dtau / Real(2);
+    Real one_minus_2lambda_dt = (Real(1)-Real(2)*lambda)*dtau;
+    Real two_lambda_dt = lambda_dt*Real(2);
+
+    // Displacement for the force gradient term  xi dtau^3 C
+    Real fg_dt = Real(2)*xi*dtau*dtau*dtau / one_minus_2lambda_dt;
+
+    // At the top level a resumed trajectory starts after its snapshot
+    LCMMDIntegratorSteps::TrajCheckpointer& checkpointer = 
+      LCMMDIntegratorSteps::theTrajCheckpointer::Instance();
+    int first_step = checkpointer.firstStep(this);
+
+    // Its sts so:
+    if( first_step == 0 ) { 
+      expSdt(s, lambda_dt); 
+    }
+    for(int i=first_step; i < n_steps-1; i++) {  // N-1 full steps
+      // Roll the exp(lambda_dt T) here and start
+      // Next iter into one
+      subIntegrator(s, dtauby2);
+      LCMMDIntegratorSteps::leapPForceGradient(monomials, one_minus_2lambda_dt, fg_dt, s);
+      subIntegrator(s, dtauby2);
+      expSdt(s, two_lambda_dt); 
+      checkpointer.stepDone(this, i, s);
+    }
+    // Last step, can't roll the first and last exp(lambda_dt T) 
+    // together.
+    subIntegrator(s, dtauby2);
+    LCMMDIntegratorSteps::leapPForceGradient(monomials, one_minus_2lambda_dt, fg_dt, s);
+    subIntegrator(s, dtauby2);
+    expSdt(s, lambda_dt);
+
+
+    END_CODE();
+    
+
+  }
+
+
+};
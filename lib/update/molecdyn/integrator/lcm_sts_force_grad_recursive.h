@@ -0,0 +1,144 @@
+// -*- C++ -*-
+
+/*! @file
+ * @brief Force gradient integrator
+ *
+ * A recursive Omelyan type PQPQP integrator whose central momentum
+ * step carries the (Hessian free) force gradient term
+ */
+
+#ifndef LCM_STS_FORCE_GRAD_RECURSIVE_H
+#define LCM_STS_FORCE_GRAD_RECURSIVE_H
+
+
+#include "chromabase.h"
+#include "update/molecdyn/hamiltonian/abs_hamiltonian.h"
+#include "update/molecdyn/integrator/abs_integrator.h"
+#include "update/molecdyn/integrator/integrator_shared.h"
+
+namespace Chroma 
+{
+
+  /*! @ingroup integrator */
+  namespace LatColMatSTSForceGradRecursiveIntegratorEnv 
+  {
+    extern const std::string name;
+    bool registerAll();
+  }
+
+
+  /*! @ingroup integrator */
+  struct  LatColMatSTSForceGradRecursiveIntegratorParams
+  {
+    LatColMatSTSForceGradRecursiveIntegratorParams();
+    LatColMatSTSForceGradRecursiveIntegratorParams(XMLReader& xml, const std::string& path);
+    int  n_steps;
+    Real lambda;
+    Real xi;
+    multi1d<std::string> monomial_ids;
+    std::string subintegrator_xml;
+  };
+
+  /*! @ingroup integrator */
+  void read(XMLReader& xml_in, 
+	    const std::string& path,
+	    LatColMatSTSForceGradRecursiveIntegratorParams& p);
+
+  /*! @ingroup integrator */
+  void write(XMLWriter& xml_out,
+	     const std::string& path, 
+	     const LatColMatSTSForceGradRecursiveIntegratorParams& p);
+
+  //! Force gradient integrator
+  /*! @ingroup integrator
+   *  Specialised to multi1d<LatticeColorMatrix>
+   *
+   *  One step of size dt is
+   *
+   *    exp(lambda dt S) T(dt/2) exp((1-2 lambda) dt S + xi dt^3 C) T(dt/2) exp(lambda dt S)
+   *
+   *  with T the sub integrator and C = [S,[T,S]] the force gradient term,
+   *  which is applied in the Hessian free approximation of
+   *  LCMMDIntegratorSteps::leapPForceGradient. The defaults lambda = 1/6,
+   *  xi = 1/72 give the fourth order scheme of Yin-Mawhinney and
+   *  Kennedy-Clark-Silva, at three force evaluations per step.
+   */
+  class LatColMatSTSForceGradRecursiveIntegrator 
+    : public AbsRecursiveIntegrator<multi1d<LatticeColorMatrix>,
+				    multi1d<LatticeColorMatrix> > 
+  {
+  public:
+
+    // Simplest Constructor
+    LatColMatSTSForceGradRecursiveIntegrator(int  n_steps_, 
+					 const multi1d<std::string>& monomial_ids_,
+					 Real lambda_, 
+					 Real xi_, 
+					 Handle< AbsComponentIntegrator< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > >& SubIntegrator_) : n_steps(n_steps_), lambda(lambda_), xi(xi_), SubIntegrator(SubIntegrator_) {
+
+      IntegratorShared::bindMonomials(monomial_ids_, monomials);
+    };
+
+    // Construct from params struct and Hamiltonian
+    LatColMatSTSForceGradRecursiveIntegrator(
+					 const LatColMatSTSForceGradRecursiveIntegratorParams& p) : n_steps(p.n_steps), lambda(p.lambda), xi(p.xi), SubIntegrator(IntegratorShared::createSubIntegrator(p.subintegrator_xml)) {
+
+      IntegratorShared::bindMonomials(p.monomial_ids, monomials);
+      
+    }
+
+
+    // Copy constructor
+    LatColMatSTSForceGradRecursiveIntegrator(const LatColMatSTSForceGradRecursiveIntegrator& l) :
+      n_steps(l.n_steps), monomials(l.monomials), lambda(l.lambda), xi(l.xi), SubIntegrator(l.SubIntegrator) {}
+
+    // ! Destruction is automagic
+    ~LatColMatSTSForceGradRecursiveIntegrator(void) {};
+
+
+    void operator()( AbsFieldState<multi1d<LatticeColorMatrix>,
+		                   multi1d<LatticeColorMatrix> >& s, 
+		     const Real& traj_length) const;
+   			    
+    AbsComponentIntegrator<multi1d<LatticeColorMatrix>,
+			   multi1d<LatticeColorMatrix> >& getSubIntegrator() const {
+      return (*SubIntegrator);
+    }
+
+    //! Reports its outermost steps to the in-flight checkpointer
+    bool checkpointable(void) const {return true;}
+    
+  protected:
+    //! Refresh fields in just this level
+    void refreshFieldsThisLevel(AbsFieldState<multi1d<LatticeColorMatrix>,
+				multi1d<LatticeColorMatrix> >& s) const {
+      for(int i=0; i < monomials.size(); i++) { 
+	monomials[i].mon->refreshInternalFields(s);
+      }
+    }
+
+    //! Reset Predictors in just this level
+    void resetPredictorsThisLevel(void) const {
+      for(int i=0; i < monomials.size(); ++i) {
+	monomials[i].mon->resetPredictors();
+      }
+    }
+
+  private:
+    
+    int  n_steps;
+    Real lambda;
+    Real xi;
+
+    multi1d< IntegratorShared::MonomialPair > monomials;
+
+    Handle< AbsComponentIntegrator<multi1d<LatticeColorMatrix>,
+				   multi1d<LatticeColorMatrix> > > SubIntegrator;
+	              
+
+  };
+
+}
+
+
+#endif
@@ -2,6 +2,7 @@
 #include "update/molecdyn/integrator/md_integrator_factory.h"
 #include "update/molecdyn/integrator/lcm_sts_leapfrog_recursive.h"
 #include "update/molecdyn/integrator/lcm_exp_sdt.h"
+#include "update/molecdyn/integrator/lcm_traj_checkpoint.h"
 #include "io/xmllog_io.h"
 
 #include <string>
@@ -123,11 +124,19 @@ namespace Chroma
     Real dtau = traj_length / n_steps;
     Real dtauby2 = dtau/2;
 
+    // At the top level a resumed trajectory starts after its snapshot
+    LCMMDIntegratorSteps::TrajCheckpointer& checkpointer = 
+      LCMMDIntegratorSteps::theTrajCheckpointer::Instance();
+    int first_step = checkpointer.firstStep(this);
+
     // Its sts so:
-    expSdt(s, dtauby2);  // First half step
-    for(int i=0; i < n_steps-1; i++) {  // N-1 full steps
+    if( first_step == 0 ) { 
+      expSdt(s, dtauby2);  // First half step
+    }
+    for(int i=first_step; i < n_steps-1; i++) {  // N-1 full steps
       subIntegrator(s, dtau); 
       expSdt(s, dtau);
+      checkpointer.stepDone(this, i, s);
     }
     subIntegrator(s, dtau);     // Last Full Step
     expSdt(s, dtauby2);  // Last Half Step
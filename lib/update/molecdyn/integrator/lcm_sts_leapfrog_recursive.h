@@ -89,6 +89,9 @@ namespace Chroma
       return (*SubIntegrator);
     }
 
+    //! Reports its outermost steps to the in-flight checkpointer
+    bool checkpointable(void) const {return true;}
+
   protected:
     //! Refresh fields in just this level
     void refreshFieldsThisLevel(AbsFieldState<multi1d<LatticeColorMatrix>,
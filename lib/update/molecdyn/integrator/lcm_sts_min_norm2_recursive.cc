@@ -2,6 +2,7 @@
 #include "update/molecdyn/integrator/md_integrator_factory.h"
 #include "update/molecdyn/integrator/lcm_sts_min_norm2_recursive.h"
 #include "update/molecdyn/integrator/lcm_exp_sdt.h"
+#include "update/molecdyn/integrator/lcm_traj_checkpoint.h"
 #include "io/xmllog_io.h"
 
 #include <string>
@@ -134,15 +135,23 @@ namespace Chroma
     Real one_minus_2lambda_dt = (Real(1)-Real(2)*lambda)*dtau;
     Real two_lambda_dt = lambda_dt*Real(2);
 
+    // At the top level a resumed trajectory starts after its snapshot
+    LCMMDIntegratorSteps::TrajCheckpointer& checkpointer = 
+      LCMMDIntegratorSteps::theTrajCheckpointer::Instance();
+    int first_step = checkpointer.firstStep(this);
+
     // Its sts so:
-    expSdt(s, lambda_dt); 
-    for(int i=0; i < n_steps-1; i++) {  // N-1 full steps
+    if( first_step == 0 ) { 
+      expSdt(s, lambda_dt); 
+    }
+    for(int i=first_step; i < n_steps-1; i++) {  // N-1 full steps
       // Roll the exp(lambda_dt T) here and start
       // Next iter into one
       subIntegrator(s, dtauby2);
       expSdt(s, one_minus_2lambda_dt);
       subIntegrator(s, dtauby2);
       expSdt(s, two_lambda_dt); 
+      checkpointer.stepDone(this, i, s);
     }
     // Last step, can't roll the first and last exp(lambda_dt T) 
     // together.
@@ -93,6 +93,9 @@ namespace Chroma
 			   multi1d<LatticeColorMatrix> >& getSubIntegrator() const {
       return (*SubIntegrator);
     }
+
+    //! Reports its outermost steps to the in-flight checkpointer
+    bool checkpointable(void) const {return true;}
     
   protected:
     //! Refresh fields in just this level
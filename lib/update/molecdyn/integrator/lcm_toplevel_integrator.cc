@@ -3,6 +3,8 @@
 #include "update/molecdyn/integrator/lcm_toplevel_integrator.h"
 #include "update/molecdyn/integrator/md_integrator_factory.h"
 #include "update/molecdyn/integrator/lcm_integrator_leaps.h"
+#include "update/molecdyn/integrator/lcm_traj_checkpoint.h"
+#include "util/gauge/reunit.h"
 
 namespace Chroma { 
 
@@ -62,6 +64,16 @@ namespace Chroma {
 	  xi_mom = 1;
 	}
 
+	// Step size autotuning (Optional)
+	if( paramtop.count("AutoTune") == 1 ) { 
+	  read(paramtop, "AutoTune", autotune);
+	}
+
+	// Shadow Hamiltonian monitoring (Optional)
+	if( paramtop.count("ShadowMonitor") == 1 ) { 
+	  read(paramtop, "ShadowMonitor", shadow);
+	}
+
       }
       catch(const std::string& e) { 
 	QDPIO::cout << "Caught Exception Reading XML: " << e << std::endl;
@@ -92,6 +104,12 @@ namespace Chroma {
       write(xml, "t_dir", p.t_dir);
       write(xml, "xi_mom", p.xi_mom);
     }
+    if( p.autotune.enabled ) { 
+      write(xml, "AutoTune", p.autotune);
+    }
+    if( p.shadow.enabled ) { 
+      write(xml, "ShadowMonitor", p.shadow);
+    }
     pop(xml);
   }
 
@@ -100,7 +118,29 @@ namespace Chroma {
 					       const LCMToplevelIntegratorParams& p) :
       params(p) {
 
-      std::istringstream is( p.integrator_xml );
+      createIntegrator();
+      
+      // Deal with Anisotropic integration
+      if ( p.anisoP ) { 
+	Real factor = Real(1) / p.xi_mom;
+	// Set the step size
+	LCMMDIntegratorSteps::theAnisoStepSizeArray::Instance().setAnisoStepSize(p.t_dir, factor);
+
+      }
+
+      // Deal with step size autotuning
+      if ( p.autotune.enabled ) { 
+	LCMMDIntegratorSteps::theStepAutoTuner::Instance().start(p.autotune, p.integrator_xml, p.tau0);
+      }
+
+      // Deal with shadow Hamiltonian monitoring
+      if ( p.shadow.enabled ) { 
+	LCMMDIntegratorSteps::theShadowMonitor::Instance().start(p.shadow);
+      }
+  }
+
+  void LCMToplevelIntegrator::createIntegrator(void) {
+      std::istringstream is( params.integrator_xml );
       XMLReader integrator_reader( is );
       std::string root="/Integrator";
       std::string integrator_name;
@@ -117,13 +157,96 @@ namespace Chroma {
 									TheMDComponentIntegratorFactory::Instance().createObject(integrator_name, integrator_reader, root));
       
       top_integrator = h;
-      
-      // Deal with Anisotropic integration
-      if ( p.anisoP ) { 
-	Real factor = Real(1) / p.xi_mom;
-	// Set the step size
-	LCMMDIntegratorSteps::theAnisoStepSizeArray::Instance().setAnisoStepSize(p.t_dir, factor);
 
+      // Only some integrators report their outermost steps for snapshots
+      if( LCMMDIntegratorSteps::theTrajCheckpointer::Instance().enabled() 
+	  && ! top_integrator->checkpointable() ) { 
+	QDPIO::cerr << "LCMToplevelIntegrator: in-flight checkpoints are not supported by the integrator "
+		    << integrator_name << ". Use one of LCM_STS_LEAPFROG, LCM_STS_MIN_NORM_2, LCM_STS_FORCE_GRAD"
+		    << std::endl;
+	QDP_abort(1);
+      }
+
+      // One outermost step of the same scheme, for the step checks
+      n_steps = 1;
+      if( integrator_reader.count("/Integrator/n_steps") == 1 ) { 
+	read(integrator_reader, "/Integrator/n_steps", n_steps);
+      }
+
+      if( n_steps > 1 ) { 
+	std::istringstream step_is( LCMMDIntegratorSteps::setIntegratorSteps(params.integrator_xml, 
+									      std::vector<int>(1, 1)) );
+	XMLReader step_reader( step_is );
+	Handle< AbsComponentIntegrator< multi1d<LatticeColorMatrix>,
+	                                multi1d<LatticeColorMatrix> > > hs(
+									 TheMDComponentIntegratorFactory::Instance().createObject(integrator_name, step_reader, root));
+	step_integrator = hs;
+      }
+      else { 
+	n_steps = 1;
+	step_integrator = top_integrator;
+      }
+  }
+
+  void LCMToplevelIntegrator::primaryTrajectory(AbsFieldState< multi1d<LatticeColorMatrix>,
+					                        multi1d<LatticeColorMatrix> >& s, 
+						 const Real& trajLength) const { 
+      LCMMDIntegratorSteps::StepAutoTuner& tuner = LCMMDIntegratorSteps::theStepAutoTuner::Instance();
+      LCMMDIntegratorSteps::ShadowMonitor& shadow = LCMMDIntegratorSteps::theShadowMonitor::Instance();
+      LCMMDIntegratorSteps::TrajCheckpointer& checkpointer = LCMMDIntegratorSteps::theTrajCheckpointer::Instance();
+
+      // May move s on to a snapshot of this trajectory
+      checkpointer.beginTrajectory(top_integrator.operator->(), s);
+      tuner.beginTrajectory();
+      shadow.beginTrajectory();
+
+      (*this)(s, trajLength);
+
+      shadow.stopTrajectory();
+      tuner.stopTrajectory();
+      checkpointer.endTrajectory();
+
+      // The link updates are unitary to rounding and are not reunitarized 
+      // on every step in double precision builds: check them once a trajectory
+      for(int mu=0; mu < Nd; mu++) { 
+	int numbad;
+	reunit((s.getQ())[mu], numbad, REUNITARIZE_ERROR);
+      }
+  }
+
+  void LCMToplevelIntegrator::oneStep(AbsFieldState< multi1d<LatticeColorMatrix>,
+				                     multi1d<LatticeColorMatrix> >& s, 
+				      const Real& trajLength) const { 
+      // The checks are not part of the trajectory: keep them from the observers
+      LCMMDIntegratorSteps::SuspendObservers off;
+
+      // Start from fresh predictors so repeated steps are identical
+      step_integrator->resetPredictors();
+      (*step_integrator)(s, trajLength / Real(n_steps));
+  }
+
+  void LCMToplevelIntegrator::endTrajectory(const Double& DeltaH) { 
+      LCMMDIntegratorSteps::theShadowMonitor::Instance().endTrajectory(DeltaH);
+
+      LCMMDIntegratorSteps::StepAutoTuner& tuner = LCMMDIntegratorSteps::theStepAutoTuner::Instance();
+      if ( ! tuner.endTrajectory(DeltaH) ) { 
+	return;
+      }
+
+      // Write out the tuned integrator
+      LCMToplevelIntegratorParams tuned(params);
+      tuned.integrator_xml = tuner.tunedIntegratorXML();
+      tuned.autotune = LCMStepAutoTuneParams();
+
+      QDPIO::cout << "AutoTune: writing the tuned integrator to " << params.autotune.output_file << std::endl;
+      XMLFileWriter tuned_out(params.autotune.output_file);
+      write(tuned_out, "MDIntegrator", tuned);
+      tuned_out.close();
+
+      if ( params.autotune.apply ) { 
+	QDPIO::cout << "AutoTune: switching to the tuned integrator" << std::endl;
+	params.integrator_xml = tuned.integrator_xml;
+	createIntegrator();
       }
   }
     
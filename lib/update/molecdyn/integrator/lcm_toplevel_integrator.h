@@ -5,6 +5,8 @@
 
 #include "chromabase.h"
 #include "update/molecdyn/integrator/abs_integrator.h"
+#include "update/molecdyn/integrator/lcm_step_autotune.h"
+#include "update/molecdyn/integrator/lcm_shadow_monitor.h"
 
 using namespace QDP;
 
@@ -34,6 +36,8 @@ namespace Chroma {
     bool anisoP;
     int t_dir;
     Real xi_mom;
+    LCMStepAutoTuneParams autotune; /*!< step size autotuning */
+    LCMShadowMonitorParams shadow;  /*!< Poisson bracket time series */
 
   };
 
@@ -53,11 +57,16 @@ namespace Chroma {
     LCMToplevelIntegrator(const LCMToplevelIntegratorParams& p);
 
     //! Copy Constructor
-    LCMToplevelIntegrator(const LCMToplevelIntegrator& i) : params(i.params), top_integrator(i.top_integrator) {}
+    LCMToplevelIntegrator(const LCMToplevelIntegrator& i) : params(i.params), top_integrator(i.top_integrator),
+							       step_integrator(i.step_integrator), n_steps(i.n_steps) {}
 
     //! Destructor is automagic
     ~LCMToplevelIntegrator() {} 
 
+    //! Do the trajectory that goes to the accept/reject step, checkpointing and monitoring it
+    void primaryTrajectory(AbsFieldState< multi1d<LatticeColorMatrix>,
+			                  multi1d<LatticeColorMatrix> >& s, const Real& trajLength) const;
+
     //! Get the length of a trajectory
     Real getTrajLength(void) const { 
       return params.tau0;
@@ -66,15 +75,35 @@ namespace Chroma {
     //! Copy fields between the monomials of a copy list
     void copyFields(void) const;
 
+    //! Feed the autotuner, and switch to the tuned steps when it is done
+    void endTrajectory(const Double& DeltaH);
+
+    //! Number of steps of the outermost integrator
+    int getNumSteps(void) const { 
+      return n_steps;
+    }
+
+    //! Integrate one outermost step of a trajectory of length trajLength, unseen by the MD observers
+    void oneStep(AbsFieldState< multi1d<LatticeColorMatrix>,
+		                multi1d<LatticeColorMatrix> >& s, const Real& trajLength) const;
+
     AbsComponentIntegrator< multi1d<LatticeColorMatrix>, 
 			    multi1d<LatticeColorMatrix> >& getIntegrator(void) const { 
       return *top_integrator;
     }
 
   private:
+    //! Create the component integrators from the integrator XML
+    void createIntegrator(void);
+
     LCMToplevelIntegratorParams params;
     Handle< AbsComponentIntegrator< multi1d<LatticeColorMatrix>, 
 				    multi1d<LatticeColorMatrix> > > top_integrator;
+
+    // The same integrator with a single outermost step
+    Handle< AbsComponentIntegrator< multi1d<LatticeColorMatrix>, 
+				    multi1d<LatticeColorMatrix> > > step_integrator;
+    int n_steps;
   };
 
 
@@ -0,0 +1,308 @@
+/*! @file
+ * @brief In-flight checkpoints of LatticeColorMatrix MD trajectories
+ */
+
+#include "update/molecdyn/integrator/lcm_traj_checkpoint.h"
+#include <cstdio>
+#include <cstring>
+
+namespace Chroma
+{
+
+  namespace LCMMDIntegratorSteps
+  {
+
+    namespace
+    {
+      const unsigned long checkpoint_magic = 0x4c434d43484cUL;
+
+      //! Bytes of the local sites of one LatticeColorMatrix
+      unsigned long localBytes()
+      {
+	return 2*Nc*Nc*Layout::sitesOnNode()*sizeof(WordType< LatticeColorMatrix >::Type_t);
+      }
+
+      //! FNV-1a digest of the local sites of the momenta and the gauge field
+      /*! Unlike a norm it tells apart states that differ only in sign,
+       *  such as a state and its flipped momenta */
+      unsigned long long stateDigest(const AbsFieldState< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s)
+      {
+	const unsigned long bytes = localBytes();
+	unsigned long long h = 14695981039346656037ULL;
+
+#if ! defined(QDP_IS_QDPJIT)
+	for(int mu=0; mu < Nd; ++mu) {
+	  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.getP()[mu].getF());
+	  const unsigned char* q = reinterpret_cast<const unsigned char*>(s.getQ()[mu].getF());
+
+	  for(unsigned long b=0; b < bytes; ++b) {
+	    h ^= p[b];
+	    h *= 1099511628211ULL;
+	  }
+	  for(unsigned long b=0; b < bytes; ++b) {
+	    h ^= q[b];
+	    h *= 1099511628211ULL;
+	  }
+	}
+#endif
+
+	return h;
+      }
+
+      //! Writer thread: put a slot on disk, then rename it into place
+      /*! Only plain stdio on node local files is used here, so the
+       *  thread never enters QDP++ or the message passing */
+      void* writeSlot(void* arg)
+      {
+	TrajCheckpointer::Slot& slot = *static_cast<TrajCheckpointer::Slot*>(arg);
+
+	std::string tmp = slot.filename + ".tmp";
+	FILE* fp = fopen(tmp.c_str(), "wb");
+	if (fp == 0) {
+	  fprintf(stderr, "TrajCheckpointer: cannot open %s\n", tmp.c_str());
+	  return 0;
+	}
+
+	bool ok = (fwrite(&slot.header, sizeof(slot.header), 1, fp) == 1);
+	ok = ok && (fwrite(&slot.data[0], 1, slot.data.size(), fp) == slot.data.size());
+	ok = (fclose(fp) == 0) && ok;
+
+	if (! ok || rename(tmp.c_str(), slot.filename.c_str()) != 0) {
+	  fprintf(stderr, "TrajCheckpointer: failed to write %s\n", slot.filename.c_str());
+	}
+
+	return 0;
+      }
+    }
+
+
+    TrajCheckpointer::TrajCheckpointer() :
+      interval(0), traj_no(0), top(0), resume_step(0), may_resume(false), start_digest(0), next_slot(0)
+    {}
+
+
+    TrajCheckpointer::~TrajCheckpointer()
+    {
+      wait(slots[0]);
+      wait(slots[1]);
+    }
+
+
+    // Checkpoint every interval outermost steps
+    void TrajCheckpointer::setup(int interval_, const std::string& prefix_)
+    {
+      interval = interval_;
+      prefix = prefix_;
+      may_resume = true;
+
+#if defined(QDP_IS_QDPJIT)
+      // The snapshots copy the host layout of the fields
+      if (interval > 0) {
+	QDPIO::cerr << "TrajCheckpointer: in-flight checkpoints are not supported with QDP-JIT" << std::endl;
+	QDP_abort(1);
+      }
+#endif
+
+      if (interval > 0) {
+	QDPIO::cout << "TrajCheckpointer: in-flight checkpoints every " << interval
+		    << " outermost MD steps to " << prefix << "_inflight_*" << std::endl;
+      }
+    }
+
+
+    // Number of the trajectory about to be done
+    void TrajCheckpointer::setTrajectory(unsigned long traj_no_)
+    {
+      traj_no = traj_no_;
+    }
+
+
+    // Wait for the writer of a slot
+    void TrajCheckpointer::wait(Slot& slot)
+    {
+      if (slot.busy) {
+	pthread_join(slot.thread, 0);
+	slot.busy = false;
+      }
+    }
+
+
+    // Name of the file of a slot on this node
+    std::string TrajCheckpointer::fileName(int slot) const
+    {
+      std::ostringstream os;
+      os << prefix << "_inflight_" << slot << "_" << Layout::nodeNumber() << ".dat";
+      return os.str();
+    }
+
+
+    // Read the step of the snapshot in a slot, -1 if unusable
+    long TrajCheckpointer::readHeader(int slot, unsigned long long digest) const
+    {
+      FILE* fp = fopen(fileName(slot).c_str(), "rb");
+      if (fp == 0)
+	return -1;
+
+      Header h;
+      bool ok = (fread(&h, sizeof(h), 1, fp) == 1);
+      fclose(fp);
+
+      if (! ok
+	  || h.magic != checkpoint_magic
+	  || h.traj_no != traj_no
+	  || h.bytes != 2*Nd*localBytes()
+	  || h.start_digest != digest)
+	return -1;
+
+      return h.step;
+    }
+
+
+    // Start the MD of a trajectory
+    void TrajCheckpointer::beginTrajectory(const void* top_,
+					   AbsFieldState< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s)
+    {
+      START_CODE();
+
+      top = top_;
+      resume_step = 0;
+      next_slot = 0;
+
+      if (interval <= 0) {
+	END_CODE();
+	return;
+      }
+
+      // The momenta and the configuration at its start fix the trajectory
+      start_digest = stateDigest(s);
+
+      // Snapshots of a repeated trajectory (eg. a reproducibility check)
+      // are not to be picked up
+      if (! may_resume) {
+	END_CODE();
+	return;
+      }
+      may_resume = false;
+
+      // Newest slot that every node holds for this trajectory
+      int slot = -1;
+      long step = -1;
+      for(int k=0; k < 2; ++k)
+      {
+	long st = readHeader(k, start_digest);
+	Double sum = Double(st);
+	Double sum_sq = Double(st)*Double(st);
+	QDPInternal::globalSum(sum);
+	QDPInternal::globalSum(sum_sq);
+
+	bool same = toBool(sum*sum == sum_sq*Double(Layout::numNodes()));
+	if (same && st >= 0 && st > step) {
+	  slot = k;
+	  step = st;
+	}
+      }
+
+      if (slot < 0) {
+	END_CODE();
+	return;
+      }
+
+      // Load the snapshot
+      const unsigned long bytes = localBytes();
+      std::vector<char> data(2*Nd*bytes);
+
+      FILE* fp = fopen(fileName(slot).c_str(), "rb");
+      Header h;
+      bool ok = (fp != 0);
+      ok = ok && (fread(&h, sizeof(h), 1, fp) == 1);
+      ok = ok && (fread(&data[0], 1, data.size(), fp) == data.size());
+      if (fp != 0)
+	fclose(fp);
+
+      Double all_ok = ok ? 1 : 0;
+      QDPInternal::globalSum(all_ok);
+      if (toBool(all_ok != Double(Layout::numNodes()))) {
+	QDPIO::cout << "TrajCheckpointer: could not read the snapshot of trajectory " << traj_no
+		    << ". Doing the trajectory from the start" << std::endl;
+	END_CODE();
+	return;
+      }
+
+#if ! defined(QDP_IS_QDPJIT)
+      for(int mu=0; mu < Nd; ++mu) {
+	memcpy(s.getP()[mu].getF(), &data[mu*bytes], bytes);
+	memcpy(s.getQ()[mu].getF(), &data[(Nd + mu)*bytes], bytes);
+      }
+#endif
+
+      resume_step = step + 1;
+      next_slot = 1 - slot;
+
+      QDPIO::cout << "TrajCheckpointer: resuming trajectory " << traj_no
+		  << " after outermost step " << step << std::endl;
+
+      END_CODE();
+    }
+
+
+    // End of the MD of a trajectory
+    void TrajCheckpointer::endTrajectory()
+    {
+      // Writes still in flight may finish during the next trajectory
+      top = 0;
+      resume_step = 0;
+    }
+
+
+    // First outermost step for integrator who
+    int TrajCheckpointer::firstStep(const void* who) const
+    {
+      return (who == top) ? resume_step : 0;
+    }
+
+
+    // Outermost step of who is complete
+    void TrajCheckpointer::stepDone(const void* who, int step,
+				    const AbsFieldState< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s)
+    {
+      if (interval <= 0 || who != top || (step + 1) % interval != 0)
+	return;
+
+      START_CODE();
+
+      Slot& slot = slots[next_slot];
+      wait(slot);
+
+      const unsigned long bytes = localBytes();
+
+      slot.header.magic   = checkpoint_magic;
+      slot.header.traj_no = traj_no;
+      slot.header.step    = step;
+      slot.header.start_digest = start_digest;
+      slot.header.bytes   = 2*Nd*bytes;
+      slot.filename = fileName(next_slot);
+
+      slot.data.resize(2*Nd*bytes);
+#if ! defined(QDP_IS_QDPJIT)
+      for(int mu=0; mu < Nd; ++mu) {
+	memcpy(&slot.data[mu*bytes], s.getP()[mu].getF(), bytes);
+	memcpy(&slot.data[(Nd + mu)*bytes], s.getQ()[mu].getF(), bytes);
+      }
+#endif
+
+      if (pthread_create(&slot.thread, 0, writeSlot, &slot) == 0) {
+	slot.busy = true;
+      }
+      else {
+	// No thread to be had: write it here
+	writeSlot(&slot);
+      }
+
+      next_slot = 1 - next_slot;
+
+      END_CODE();
+    }
+
+  } // End Namespace LCMMDIntegratorSteps
+
+} // End Namespace Chroma
@@ -0,0 +1,128 @@
+// -*- C++ -*-
+/*! @file
+ * @brief In-flight checkpoints of LatticeColorMatrix MD trajectories
+ */
+
+#ifndef LCM_TRAJ_CHECKPOINT_H
+#define LCM_TRAJ_CHECKPOINT_H
+
+#include "chromabase.h"
+#include "singleton.h"
+#include "update/molecdyn/field_state.h"
+#include <vector>
+#include <pthread.h>
+
+namespace Chroma
+{
+
+  namespace LCMMDIntegratorSteps
+  {
+    //! Checkpoints of the (P,Q) state at outermost integrator steps
+    /*!
+     * Every interval outermost steps the toplevel integrator hands its
+     * state to stepDone(). The local sites of P and Q are copied into one
+     * of two buffers, and a background thread writes that buffer to a
+     * node local file <prefix>_inflight_<slot>_<node>.dat, so the run does
+     * not wait for the disk. The two slots alternate, so one complete
+     * snapshot is always on disk while the next is written.
+     * Toplevel integrators that do this say so by checkpointable();
+     * setting up the toplevel with any other while checkpoints are
+     * enabled aborts. Not available with QDP-JIT.
+     *
+     * Only the first trajectory after setup() can be resumed: that is the
+     * one a restarted run redoes from the last restart file.
+     * Given the same configuration and random number state it regenerates
+     * the same momenta and pseudofermions. When the MD integration starts
+     * from the same momenta and gauge field as the snapshot, compared by
+     * a digest of the bits of the local sites, the integrator is moved
+     * to the snapshot state and continues after the checkpointed step.
+     *
+     * Only the trajectory going to the accept/reject step is to be
+     * bracketed by beginTrajectory() and endTrajectory(), not the
+     * integrations of the reversibility and step checks.
+     *
+     * The chronological predictor buffers are not saved. A resumed
+     * trajectory is bit reproducible when the solvers start from a zero
+     * guess. With predictors it agrees to the solver tolerance.
+     */
+    class TrajCheckpointer {
+    public:
+      TrajCheckpointer();
+
+      //! Writes outstanding snapshots
+      ~TrajCheckpointer();
+
+      //! Checkpoint every interval outermost steps, files named from prefix
+      void setup(int interval, const std::string& prefix);
+
+      //! Are checkpoints to be written
+      bool enabled() const {return interval > 0;}
+
+      //! Number of the trajectory about to be done
+      void setTrajectory(unsigned long traj_no);
+
+      //! Start the MD of a trajectory integrated by top
+      /*!
+       * If a matching snapshot is on disk, s is replaced by it and
+       * firstStep() returns the step after the checkpointed one
+       */
+      void beginTrajectory(const void* top,
+			   AbsFieldState< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s);
+
+      //! End of the MD of a trajectory
+      void endTrajectory();
+
+      //! First outermost step for integrator who
+      int firstStep(const void* who) const;
+
+      //! Outermost step step of who is complete and s can be resumed from
+      void stepDone(const void* who, int step,
+		    const AbsFieldState< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s);
+
+      //! Header of a snapshot file
+      struct Header {
+	unsigned long      magic;
+	unsigned long      traj_no;
+	long               step;
+	unsigned long long start_digest;   /*!< digest of P and Q at the start of the trajectory */
+	unsigned long      bytes;
+      };
+
+      //! One snapshot buffer and its writer thread
+      struct Slot {
+	Slot() : busy(false) {}
+	Header            header;
+	std::vector<char> data;
+	std::string       filename;
+	bool              busy;
+	pthread_t         thread;
+      };
+
+    private:
+      //! Wait for the writer of a slot
+      void wait(Slot& slot);
+
+      //! Name of the file of a slot on this node
+      std::string fileName(int slot) const;
+
+      //! Read the step of the snapshot in a slot, -1 if unusable
+      long readHeader(int slot, unsigned long long digest) const;
+
+      int interval;
+      std::string prefix;
+      unsigned long traj_no;
+      const void* top;
+      int resume_step;
+      bool may_resume;
+      unsigned long long start_digest;
+      int next_slot;
+      Slot slots[2];
+    };
+
+    typedef SingletonHolder< TrajCheckpointer > theTrajCheckpointer;
+
+  } // End Namespace LCMMDIntegratorSteps
+
+} // End Namespace Chroma
+
+#endif
@@ -62,6 +62,9 @@ namespace Chroma
     //! Return number of roots in used
     int getNPF() const {return num_pf;}
 
+    //! Solve for all the pseudofermions at once in the force
+    bool getBlockSolve() const {return block_solve;}
+
     //! Return the partial fraction expansion for the force calc
     const RemezCoeff_t& getFPFE() const {return fpfe;}
 
@@ -89,6 +92,9 @@ namespace Chroma
     // Number of nth-roots
     int num_pf;
 
+    // Block solve of the force
+    bool block_solve;
+
     // Coefficients and roots of partial fractions
     RemezCoeff_t  fpfe;
     RemezCoeff_t  spfe;
@@ -17,6 +17,10 @@ namespace Chroma
     {
       read(paramtop, "num_pf", num_pf);
       read(paramtop, "Action", numer);
+
+      block_solve = false;
+      if (paramtop.count("BlockSolve") != 0)
+	read(paramtop, "BlockSolve", block_solve);
     }
     catch(const std::string& s) 
     {
@@ -40,6 +44,7 @@ namespace Chroma
     push(xml, path);
 
     write(xml, "num_pf", params.num_pf);
+    write(xml, "BlockSolve", params.block_solve);
     write(xml, "Action", params.numer);
 
     pop(xml);
@@ -25,6 +25,7 @@ namespace Chroma
     // Params for each major group - action/heatbath & force
     CompApprox_t    numer;         /*!< Fermion action and rat. structure for numerator */
     int             num_pf;        /*!< Use "num_pf" copies of pseudo-fermions for chi^dag*f(M^dag*M)*chi  */
+    bool            block_solve;   /*!< Solve for all the pseudo-fermions of the force in one block multi-shift solve */
   };
 
   void read(XMLReader& xml, const std::string& path, OneFlavorWilsonTypeFermRatMonomialParams& param);
@@ -93,54 +93,84 @@ namespace Chroma
       multi1d<int> n_count(getNPF());
       QDPIO::cout << "num_pf = " << getNPF() << std::endl;
 
-      for(int n=0; n < getNPF(); ++n)
+      if (getBlockSolve())
       {
-	// The multi-shift inversion
-	SystemSolverResults_t res = (*invMdagM)(X, fpfe.pole, getPhi()[n]);
-	n_count[n] = res.n_count;
+	// One block multi-shift inversion for all the pseudoferms
+	multi1d< multi1d<Phi> > XX;
+	multi1d<SystemSolverResults_t> res = invMdagM->solveBlock(XX, fpfe.pole, getPhi());
+
+	// All the poles of all the pseudoferms go into one multipole force
+	const int n_pole = fpfe.pole.size();
+	X.resize(getNPF()*n_pole);
+	multi1d<Phi> YY(X.size());
+	for(int n=0; n < getNPF(); ++n)
+	{
+	  n_count[n] = res[n].n_count;
+
+	  for(int i=0; i < n_pole; ++i)
+	  {
+	    X[n*n_pole + i] = XX[n][i];
+	    (*lin)(YY[n*n_pole + i], X[n*n_pole + i], PLUS);
+	    YY[n*n_pole + i] *= -fpfe.res[i];
+	  }
+	}
 
-	// Loop over solns and accumulate force contributions
+	lin->derivMultipole(F_1, X, YY, MINUS);
+	F += F_1;
+	lin->derivMultipole(F_1, YY, X, PLUS);
+	F += F_1;
+      }
+      else
+      {
+	for(int n=0; n < getNPF(); ++n)
+	{
+	  // The multi-shift inversion
+	  SystemSolverResults_t res = (*invMdagM)(X, fpfe.pole, getPhi()[n]);
+	  n_count[n] = res.n_count;
+
+	  // Loop over solns and accumulate force contributions
 
 
 #if 0 
 
-	P F_2;
-	P F_tmp(Nd);
+	  P F_2;
+	  P F_tmp(Nd);
 
-	F_tmp = zero;
-	for(int i=0; i < X.size(); ++i)
-	{
-	  (*lin)(Y, X[i], PLUS);
+	  F_tmp = zero;
+	  for(int i=0; i < X.size(); ++i)
+	  {
+	    (*lin)(Y, X[i], PLUS);
 
-	  // The  d(M^dag)*M  term
-	  lin->deriv(F_1, X[i], Y, MINUS);
+	    // The  d(M^dag)*M  term
+	    lin->deriv(F_1, X[i], Y, MINUS);
       
-	  // The  M^dag*d(M)  term
-	  lin->deriv(F_2, Y, X[i], PLUS);
-	  F_1 += F_2;
-
-	  // Reweight each contribution in partial fraction
-	  for(int mu=0; mu < F.size(); mu++) {
-	    F_tmp[mu] -= fpfe.res[i] * F_1[mu];
+	    // The  M^dag*d(M)  term
+	    lin->deriv(F_2, Y, X[i], PLUS);
+	    F_1 += F_2;
+
+	    // Reweight each contribution in partial fraction
+	    for(int mu=0; mu < F.size(); mu++) {
+	      F_tmp[mu] -= fpfe.res[i] * F_1[mu];
+	    }
 	  }
-	}
-	F += F_tmp;
+	  F += F_tmp;
 #else
-	// New code with new force term
-	multi1d<Phi> Y(X.size());
-	for(int i=0; i < X.size(); i++) {
-	  (*lin)(Y[i], X[i], PLUS);
-	  Y[i]*= -fpfe.res[i];
-	}
+	  // New code with new force term
+	  multi1d<Phi> Y(X.size());
+	  for(int i=0; i < X.size(); i++) {
+	    (*lin)(Y[i], X[i], PLUS);
+	    Y[i]*= -fpfe.res[i];
+	  }
 
-	lin->derivMultipole(F_1, X, Y, MINUS);
-	F += F_1;
-	lin->derivMultipole(F_1, Y, X, PLUS);
-	F += F_1;
+	  lin->derivMultipole(F_1, X, Y, MINUS);
+	  F += F_1;
+	  lin->derivMultipole(F_1, Y, X, PLUS);
+	  F += F_1;
 #endif
-	// Concious choice. Don't monitor forces by pole 
-	// Just accumulate it
+	  // Concious choice. Don't monitor forces by pole 
+	  // Just accumulate it
 	
+	}
       }
 
       state->deriv(F);
@@ -362,6 +392,9 @@ namespace Chroma
     //! Return number of roots in used
     virtual int getNPF() const = 0;
 
+    //! Solve for all the pseudofermions at once in the force
+    virtual bool getBlockSolve() const = 0;
+
     //! Return the partial fraction expansion for the force calc
     virtual const RemezCoeff_t& getFPFE() const = 0;
 
@@ -59,6 +59,7 @@ namespace Chroma
     actionInvParam = param.numer.action.invParam;
     forceInvParam  = param.numer.force.invParam;
     num_pf         = param.num_pf;
+    block_solve    = param.block_solve;
 
     //*********************************************************************
     // Fermion action
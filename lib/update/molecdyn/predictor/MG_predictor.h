@@ -12,6 +12,8 @@
 #include "chromabase.h"
 #include "update/molecdyn/predictor/abs_MG_chrono_predictor.h"
 #include "update/molecdyn/predictor/chrono_predictor_factory.h"
+#include "actions/ferm/invert/mg_native/mg_native_hierarchy.h"
+#include "meas/inline/io/named_objmap.h"
 
 
 namespace Chroma 
@@ -46,30 +48,63 @@ namespace Chroma
       subspace_name(subspace_name_),
       refresh_rate(refresh_rate_){}
 
+    //! Report the work done on the subspace
     void getSubspace() 
     {
       START_CODE();
 
       QDPIO::cout << "MG4DChronoPredictor - Subspace Name: "<<subspace_name<<std::endl;
+
+      MGNative::Hierarchy* mg = findSubspace();
+      if (mg != 0x0)
+      {
+	const MGNative::Hierarchy::Stats_t& w = mg->stats();
+	QDPIO::cout << "MG4DChronoPredictor - Setups: " << w.setups 
+		    << " time = " << w.setup_time << " secs" << std::endl;
+	QDPIO::cout << "MG4DChronoPredictor - Refreshes: " << w.refreshes 
+		    << " time = " << w.refresh_time << " secs" << std::endl;
+	QDPIO::cout << "MG4DChronoPredictor - Coarsenings: " << w.coarsenings 
+		    << " time = " << w.coarsen_time << " secs" << std::endl;
+      }
     
       END_CODE();
     }
 
+    //! Regenerate the subspace every refresh_rate trajectories
     void resetSubspace(int counter) 
     { 
       START_CODE();
 
       QDPIO::cout << "MG4DChronoPredictor - Current Counter: "<<counter<<std::endl;
       QDPIO::cout << "MG4DChronoPredictor - Refresh Rate: "<<refresh_rate<<std::endl;
+
+      MGNative::Hierarchy* mg = findSubspace();
+      if (mg != 0x0 && refresh_rate > 0 && counter % refresh_rate == 0)
+      {
+	QDPIO::cout << "MG4DChronoPredictor - Subspace will be regenerated" << std::endl;
+	mg->requestRebuild();
+      }
     
       END_CODE();
     }
     
+    //! Called at the start of each trajectory: relax the null vectors on the new gauge field
     void reset(void) 
     {
+      START_CODE();
 
-      QDPIO::cout<<"MG4DChronoPredictor - Do nothing!"<<std::endl;
+      MGNative::Hierarchy* mg = findSubspace();
+      if (mg != 0x0)
+      {
+	QDPIO::cout << "MG4DChronoPredictor - Subspace will be refreshed" << std::endl;
+	mg->requestRefresh();
+      }
+      else
+      {
+	QDPIO::cout<<"MG4DChronoPredictor - Do nothing!"<<std::endl;
+      }
 
+      END_CODE();
     }
 
     void operator()(T& psi, 
@@ -90,6 +125,22 @@ namespace Chroma
 
 
   private:
+    //! The native multigrid subspace of this name, or null
+    MGNative::Hierarchy* findSubspace() const
+    {
+      if (! TheNamedObjMap::Instance().check(subspace_name))
+	return 0x0;
+
+      try 
+      {
+	return &*TheNamedObjMap::Instance().getData< Handle<MGNative::Hierarchy> >(subspace_name);
+      }
+      catch( std::bad_cast ) 
+      {
+	// Some other kind of subspace
+	return 0x0;
+      }
+    }
 
     std::string subspace_name;
     int refresh_rate;
@@ -0,0 +1,428 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Time slice ordered, memory mapped std::map object of color vectors
+ */
+
+#include "chromabase.h"
+#include "util/ferm/map_obj/map_obj_factory_w.h"
+#include "util/ferm/map_obj/map_obj_timeslice_mmap_w.h"
+#include "util/ft/time_slice_set.h"
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace Chroma
+{
+
+  namespace
+  {
+    const unsigned long slab_magic = 0x43565453424cUL;
+
+    //! Round up to a multiple of the page size
+    size_t pageRound(size_t bytes)
+    {
+      const size_t page = sysconf(_SC_PAGESIZE);
+      return ((bytes + page - 1) / page) * page;
+    }
+
+    //! Prefetch thread: touch every page of a range
+    void* touchPages(void* arg)
+    {
+      const MapObjectTimeSliceMmap::PrefetchArgs& a = *static_cast<MapObjectTimeSliceMmap::PrefetchArgs*>(arg);
+      const size_t page = sysconf(_SC_PAGESIZE);
+
+      volatile char sum = 0;
+      for(size_t i=0; i < a.bytes; i += page)
+	sum += a.begin[i];
+
+      return 0;
+    }
+  }
+
+
+  // Create the files, or reopen existing ones
+  MapObjectTimeSliceMmap::MapObjectTimeSliceMmap(const std::string& file_name_, int max_vecs_,
+						 int decay_dir_, bool reopen) :
+    max_vecs(max_vecs_), decay_dir(decay_dir_), fd(-1), base(0), file_bytes(0), prefetch_busy(false)
+  {
+    {
+      std::ostringstream os;
+      os << file_name_ << "_" << Layout::nodeNumber();
+      file_name = os.str();
+    }
+
+    // Local sites of the time slices
+    TimeSliceSet time_slices(decay_dir);
+    const int nt = time_slices.numSubsets();
+
+    sites.resize(nt);
+    slab_offset.resize(nt);
+    for(int t=0; t < nt; ++t)
+    {
+      const multi1d<int>& tab = time_slices.getSet()[t].siteTable();
+      sites[t].resize(tab.size());
+      for(int s=0; s < tab.size(); ++s)
+	sites[t][s] = tab[s];
+    }
+
+    // Layout: header, key list, eigenvalues, then the slab of each local time slice
+    size_t off = sizeof(Header);
+    const size_t present_offset = off;
+    off += max_vecs*sizeof(int);
+    off = ((off + sizeof(double) - 1) / sizeof(double)) * sizeof(double);
+    const size_t weights_offset = off;
+    off += max_vecs*nt*sizeof(double);
+    off = pageRound(off);
+
+    for(int t=0; t < nt; ++t)
+    {
+      slab_offset[t] = 0;
+      if (sites[t].empty())
+	continue;
+
+      slab_offset[t] = off;
+      off = pageRound(off + max_vecs*sites[t].size()*Nc*2*sizeof(REAL));
+    }
+    file_bytes = off;
+
+    // Open and map
+    const std::string slab_name = file_name + ".slab";
+    fd = open(slab_name.c_str(), reopen ? O_RDWR : (O_RDWR | O_CREAT | O_TRUNC), 0644);
+    if (fd < 0)
+      fail("cannot open");
+
+    if (! reopen && ftruncate(fd, file_bytes) != 0)
+      fail("cannot size");
+
+    if (reopen)
+    {
+      Header h;
+      if (pread(fd, &h, sizeof(h), 0) != sizeof(h)
+	  || h.magic != slab_magic || h.max_vecs != max_vecs || h.num_slices != nt
+	  || h.decay_dir != decay_dir || h.word_size != int(sizeof(REAL)) || h.file_bytes != file_bytes)
+	fail("is not a slab file of this lattice, layout and MaxNumVecs");
+
+      std::ifstream in((file_name + ".xml").c_str());
+      std::ostringstream os;
+      os << in.rdbuf();
+      user_data = os.str();
+    }
+
+    void* p = mmap(0, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+      fail("cannot map");
+    base = static_cast<char*>(p);
+
+    header  = reinterpret_cast<Header*>(base);
+    present = reinterpret_cast<int*>(base + present_offset);
+    weights = reinterpret_cast<double*>(base + weights_offset);
+
+    if (! reopen)
+    {
+      header->magic      = slab_magic;
+      header->max_vecs   = max_vecs;
+      header->num_slices = nt;
+      header->decay_dir  = decay_dir;
+      header->word_size  = sizeof(REAL);
+      header->file_bytes = file_bytes;
+      memset(present, 0, max_vecs*sizeof(int));
+    }
+  }
+
+
+  // Unmap the files
+  MapObjectTimeSliceMmap::~MapObjectTimeSliceMmap()
+  {
+    waitPrefetch();
+
+    if (base != 0)
+      munmap(base, file_bytes);
+    if (fd >= 0)
+      close(fd);
+  }
+
+
+  // Abort with a message naming the file of this node
+  void MapObjectTimeSliceMmap::fail(const std::string& what) const
+  {
+    std::cerr << "MapObjectTimeSliceMmap: node " << Layout::nodeNumber() << ": "
+	      << file_name << ".slab " << what << std::endl;
+    QDP_abort(1);
+  }
+
+
+  // Abort unless key fits
+  void MapObjectTimeSliceMmap::checkKey(int key) const
+  {
+    if (key < 0 || key >= max_vecs)
+    {
+      QDPIO::cerr << "MapObjectTimeSliceMmap: key " << key << " outside 0.." << max_vecs-1
+		  << ", increase MaxNumVecs" << std::endl;
+      QDP_abort(1);
+    }
+  }
+
+
+  // Start of the slab of vector key on time slice t
+  REAL* MapObjectTimeSliceMmap::slab(int key, int t) const
+  {
+    return reinterpret_cast<REAL*>(base + slab_offset[t]) + key*sites[t].size()*Nc*2;
+  }
+
+
+  // Check if a key exists
+  bool MapObjectTimeSliceMmap::exist(const int& key) const
+  {
+    return key >= 0 && key < max_vecs && present[key] != 0;
+  }
+
+
+  // Insert a vector and its eigenvalues
+  int MapObjectTimeSliceMmap::insert(const int& key, const EVPair<LatticeColorVector>& val)
+  {
+    checkKey(key);
+
+    const int nt = sites.size();
+    const int nw = std::min(val.eigenValue.weights.size(), nt);
+
+    for(int t=0; t < nt; ++t)
+    {
+      if (sites[t].empty())
+	continue;
+
+      REAL* p = slab(key, t);
+      for(int s=0; s < sites[t].size(); ++s)
+	for(int c=0; c < Nc; ++c)
+	{
+	  *p++ = val.eigenVector.elem(sites[t][s]).elem().elem(c).real();
+	  *p++ = val.eigenVector.elem(sites[t][s]).elem().elem(c).imag();
+	}
+    }
+
+    for(int t=0; t < nw; ++t)
+      weights[key*nt + t] = toDouble(val.eigenValue.weights[t]);
+
+    present[key] = nw + 1;
+
+    return 0;
+  }
+
+
+  // Get a whole vector and its eigenvalues
+  int MapObjectTimeSliceMmap::get(const int& key, EVPair<LatticeColorVector>& val) const
+  {
+    if (! exist(key))
+    {
+      QDPIO::cerr << "MapObjectTimeSliceMmap: key " << key << " not found" << std::endl;
+      QDP_abort(1);
+    }
+
+    const int nt = sites.size();
+
+    val.eigenVector = zero;
+    for(int t=0; t < nt; ++t)
+      getTimeSlice(key, t, val.eigenVector);
+
+    val.eigenValue.weights.resize(present[key] - 1);
+    for(int t=0; t < val.eigenValue.weights.size(); ++t)
+      val.eigenValue.weights[t] = Real(weights[key*nt + t]);
+
+    return 0;
+  }
+
+
+  // Time slice t of vector key into v
+  void MapObjectTimeSliceMmap::getTimeSlice(int key, int t, LatticeColorVector& v) const
+  {
+    if (! exist(key))
+    {
+      QDPIO::cerr << "MapObjectTimeSliceMmap: key " << key << " not found" << std::endl;
+      QDP_abort(1);
+    }
+
+    if (sites[t].empty())
+      return;
+
+    const REAL* p = slab(key, t);
+    for(int s=0; s < sites[t].size(); ++s)
+      for(int c=0; c < Nc; ++c)
+      {
+	v.elem(sites[t][s]).elem().elem(c).real() = *p++;
+	v.elem(sites[t][s]).elem().elem(c).imag() = *p++;
+      }
+  }
+
+
+  // Remove a key
+  int MapObjectTimeSliceMmap::erase(const int& key)
+  {
+    if (! exist(key))
+      return 1;
+
+    present[key] = 0;
+    return 0;
+  }
+
+
+  // Write the pages to disk
+  void MapObjectTimeSliceMmap::flush()
+  {
+    waitPrefetch();
+
+    if (msync(base, file_bytes, MS_SYNC) != 0)
+      fail("cannot be synced");
+  }
+
+
+  // Number of vectors
+  unsigned int MapObjectTimeSliceMmap::size() const
+  {
+    unsigned int n = 0;
+    for(int key=0; key < max_vecs; ++key)
+      if (present[key] != 0)
+	++n;
+
+    return n;
+  }
+
+
+  // The keys
+  void MapObjectTimeSliceMmap::keys(std::vector<int>& keys_) const
+  {
+    keys_.clear();
+    for(int key=0; key < max_vecs; ++key)
+      if (present[key] != 0)
+	keys_.push_back(key);
+  }
+
+
+  // Insert user data
+  int MapObjectTimeSliceMmap::insertUserdata(const std::string& user_data_)
+  {
+    user_data = user_data_;
+
+    std::ofstream out((file_name + ".xml").c_str());
+    out << user_data;
+    if (! out)
+      fail("user data cannot be written");
+
+    return 0;
+  }
+
+
+  // Get user data
+  int MapObjectTimeSliceMmap::getUserdata(std::string& user_data_) const
+  {
+    user_data_ = user_data;
+    return 0;
+  }
+
+
+  // Page in time slice t of all vectors in the background
+  void MapObjectTimeSliceMmap::prefetch(int t) const
+  {
+    waitPrefetch();
+
+    if (t < 0 || t >= sites.size() || sites[t].empty())
+      return;
+
+    prefetch_args.begin = base + slab_offset[t];
+    prefetch_args.bytes = max_vecs*sites[t].size()*Nc*2*sizeof(REAL);
+
+    // The kernel may already start the reads, the thread makes sure
+    madvise(const_cast<char*>(prefetch_args.begin), pageRound(prefetch_args.bytes), MADV_WILLNEED);
+
+    if (pthread_create(&prefetch_thread, 0, touchPages, &prefetch_args) == 0)
+      prefetch_busy = true;
+  }
+
+
+  // Wait for the prefetch thread
+  void MapObjectTimeSliceMmap::waitPrefetch() const
+  {
+    if (prefetch_busy)
+    {
+      pthread_join(prefetch_thread, 0);
+      prefetch_busy = false;
+    }
+  }
+
+
+  namespace MapObjectTimeSliceMmapEnv
+  {
+
+    namespace
+    {
+      // Parameter structure
+      struct Params
+      {
+	Params() {}
+	Params(XMLReader& xml_in, const std::string& path);
+
+	std::string   file_name;
+	int           max_vecs;
+	int           decay_dir;
+	bool          reopen;
+      };
+
+      // Reader for input parameters
+      Params::Params(XMLReader& xml, const std::string& path)
+      {
+	XMLReader paramtop(xml, path);
+
+	read(paramtop, "FileName", file_name);
+	read(paramtop, "MaxNumVecs", max_vecs);
+
+	decay_dir = Nd-1;
+	if (paramtop.count("DecayDir") == 1)
+	  read(paramtop, "DecayDir", decay_dir);
+
+	reopen = false;
+	if (paramtop.count("Reopen") == 1)
+	  read(paramtop, "Reopen", reopen);
+      }
+
+
+      //! Callback function
+      QDP::MapObject<int,EVPair<LatticeColorVector> >* createMapObjIntKeyCV(XMLReader& xml_in,
+									    const std::string& path,
+									    const std::string& user_data)
+      {
+	Params params(xml_in, path);
+
+	auto obj = new MapObjectTimeSliceMmap(params.file_name, params.max_vecs, params.decay_dir, params.reopen);
+	if (! params.reopen)
+	  obj->insertUserdata(user_data);
+
+	return obj;
+      }
+
+      //! Local registration flag
+      bool registered = false;
+
+      //! Name to be used
+      const std::string name = "MAP_OBJECT_TIMESLICE_MMAP";
+    } // namespace anonymous
+
+    std::string getName() {return name;}
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+      if (! registered)
+      {
+	success &= Chroma::TheMapObjIntKeyColorEigenVecFactory::Instance().registerObject(name, createMapObjIntKeyCV);
+	registered = true;
+      }
+      return success;
+    }
+  } // Namespace MapObjectTimeSliceMmapEnv
+
+
+} // Chroma
@@ -0,0 +1,138 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Time slice ordered, memory mapped std::map object of color vectors
+ */
+
+#ifndef __map_obj_timeslice_mmap_w_h__
+#define __map_obj_timeslice_mmap_w_h__
+
+#include "chromabase.h"
+#include "qdp_map_obj.h"
+#include "util/ferm/subset_ev_pair.h"
+#include <vector>
+#include <pthread.h>
+
+namespace Chroma
+{
+
+  //! Color vectors in node local memory mapped files, ordered by time slice
+  /*!
+   * \ingroup ferm
+   *
+   * Each node keeps the local sites of its time slices in the file
+   * <file_name>_<node>.slab. The vectors of a time slice are one
+   * contiguous slab (vec, site, color), so reading a time slice only
+   * pages in that slab and the whole 4D vectors are never held in memory.
+   * The eigenvalues and the list of keys are at the start of the file,
+   * the user data in <file_name>_<node>.xml.
+   *
+   * prefetch() pages in a time slice on a background thread while the
+   * caller works on the previous one.
+   */
+  class MapObjectTimeSliceMmap : public QDP::MapObject<int,EVPair<LatticeColorVector> >
+  {
+  public:
+    //! Create the files with room for max_vecs vectors, or reopen existing ones
+    MapObjectTimeSliceMmap(const std::string& file_name, int max_vecs, int decay_dir, bool reopen);
+
+    //! Unmap the files
+    ~MapObjectTimeSliceMmap();
+
+    //! Check if a key exists
+    bool exist(const int& key) const;
+
+    //! Insert a vector and its eigenvalues
+    int insert(const int& key, const EVPair<LatticeColorVector>& val);
+
+    //! Get a whole vector and its eigenvalues
+    int get(const int& key, EVPair<LatticeColorVector>& val) const;
+
+    //! Remove a key; the slab space stays reserved
+    int erase(const int& key);
+
+    //! Write the pages to disk
+    void flush();
+
+    //! Number of vectors
+    unsigned int size() const;
+
+    //! The keys
+    void keys(std::vector<int>& keys_) const;
+
+    //! Insert user data
+    int insertUserdata(const std::string& user_data);
+
+    //! Get user data
+    int getUserdata(std::string& user_data) const;
+
+    //! Time slice t of vector key into v, the other sites are not touched
+    void getTimeSlice(int key, int t, LatticeColorVector& v) const;
+
+    //! Page in time slice t of all vectors in the background
+    void prefetch(int t) const;
+
+    //! Direction of the time slices
+    int getDecayDir() const {return decay_dir;}
+
+    //! Header of a slab file
+    struct Header
+    {
+      unsigned long magic;
+      int           max_vecs;
+      int           num_slices;    /*!< global number of time slices */
+      int           decay_dir;
+      int           word_size;
+      unsigned long file_bytes;
+    };
+
+    //! Pages for the prefetch thread
+    struct PrefetchArgs
+    {
+      const char* begin;
+      size_t      bytes;
+    };
+
+  private:
+    //! Abort with a message naming the file of this node
+    void fail(const std::string& what) const;
+
+    //! Abort unless key fits
+    void checkKey(int key) const;
+
+    //! Start of the slab of vector key on time slice t
+    REAL* slab(int key, int t) const;
+
+    //! Wait for the prefetch thread
+    void waitPrefetch() const;
+
+    std::string file_name;
+    std::string user_data;
+    int max_vecs;
+    int decay_dir;
+    int fd;
+    char* base;
+    size_t file_bytes;
+
+    Header* header;
+    int* present;                             /*!< number of eigenvalues + 1, 0 if absent */
+    double* weights;                          /*!< [key][t] */
+
+    std::vector< std::vector<int> > sites;    /*!< local sites of each time slice */
+    std::vector<size_t> slab_offset;          /*!< slabs of each time slice, 0 if no local sites */
+
+    mutable bool prefetch_busy;
+    mutable pthread_t prefetch_thread;
+    mutable PrefetchArgs prefetch_args;
+  };
+
+
+  //! Private Namespace
+  namespace MapObjectTimeSliceMmapEnv
+  {
+    //! Registrations
+    bool registerAll();
+  }
+
+}
+
+#endif
@@ -0,0 +1,419 @@
+/*! \file
+ * \brief Time slice blocked inner products of sets of fermions
+ */
+
+#include "util/ferm/timeslice_contract.h"
+#include <algorithm>
+
+namespace Chroma
+{
+
+#if ! defined(QDP_IS_QDPJIT)
+  /* A namespace to hide the thread dispatcher in */
+  namespace TimeSliceContractEnv
+  {
+    typedef TimeSliceBlock::DComplex_t DComplex_t;
+
+    //! Vectors on a side of a tile
+    const int tile_vecs = 16;
+
+    //! Sites of a row chunk: 2*tile_vecs columns of it stay in L2
+    const int tile_sites = 32;
+
+    //! A tile of the result on a time slice
+    struct Tile
+    {
+      int t;
+      int i0;
+      int j0;
+    };
+
+    struct Args
+    {
+      const TimeSliceBlock& left;
+      const TimeSliceBlock& right;
+      const LatticeComplex& phase;
+      const std::vector<Tile>& tiles;
+      DComplex_t* result;          // [t][i][j]
+    };
+
+    //! Inner products of the tiles lo..hi-1
+    void tileLoop(int lo, int hi, int myId, Args* a)
+    {
+      const int ns_nc = a->left.siteDof();
+      const int nl = a->left.numVecs();
+      const int nr = a->right.numVecs();
+
+      // The right columns of a chunk with the phase applied
+      std::vector<DComplex_t> phased(tile_vecs*tile_sites*ns_nc);
+
+      for(int n=lo; n < hi; ++n)
+      {
+	const Tile& tile = a->tiles[n];
+	const std::vector<int>& sites = a->left.siteTable(tile.t);
+	const int num_sites = sites.size();
+	const int i1 = std::min(tile.i0 + tile_vecs, nl);
+	const int j1 = std::min(tile.j0 + tile_vecs, nr);
+
+	double acc[tile_vecs][tile_vecs][2];
+	for(int i=0; i < tile_vecs; ++i)
+	  for(int j=0; j < tile_vecs; ++j)
+	    acc[i][j][0] = acc[i][j][1] = 0;
+
+	for(int s0=0; s0 < num_sites; s0 += tile_sites)
+	{
+	  const int s1 = std::min(s0 + tile_sites, num_sites);
+	  const int rows = (s1 - s0)*ns_nc;
+
+	  for(int j=tile.j0; j < j1; ++j)
+	  {
+	    const DComplex_t* r = a->right.column(tile.t, j) + s0*ns_nc;
+	    DComplex_t* p = &phased[(j - tile.j0)*tile_sites*ns_nc];
+
+	    for(int s=s0; s < s1; ++s)
+	    {
+	      const int site = sites[s];
+	      DComplex_t ph(a->phase.elem(site).elem().elem().real(),
+			    a->phase.elem(site).elem().elem().imag());
+
+	      for(int k=0; k < ns_nc; ++k, ++r, ++p)
+		*p = ph * (*r);
+	    }
+	  }
+
+	  for(int i=tile.i0; i < i1; ++i)
+	  {
+	    const double* l = reinterpret_cast<const double*>(a->left.column(tile.t, i) + s0*ns_nc);
+
+	    for(int j=tile.j0; j < j1; ++j)
+	    {
+	      const double* p = reinterpret_cast<const double*>(&phased[(j - tile.j0)*tile_sites*ns_nc]);
+
+	      // conj(l) * p
+	      double re = 0;
+	      double im = 0;
+	      for(int k=0; k < 2*rows; k += 2)
+	      {
+		re += l[k]*p[k]   + l[k+1]*p[k+1];
+		im += l[k]*p[k+1] - l[k+1]*p[k];
+	      }
+
+	      acc[i - tile.i0][j - tile.j0][0] += re;
+	      acc[i - tile.i0][j - tile.j0][1] += im;
+	    }
+	  }
+	}
+
+	for(int i=tile.i0; i < i1; ++i)
+	  for(int j=tile.j0; j < j1; ++j)
+	    a->result[(tile.t*nl + i)*nr + j] = DComplex_t(acc[i - tile.i0][j - tile.j0][0],
+							   acc[i - tile.i0][j - tile.j0][1]);
+      }
+    }
+
+
+    //! A chunk of sites of a time slice
+    struct Chunk
+    {
+      int t;
+      int s0;
+    };
+
+    struct RotateArgs
+    {
+      TimeSliceBlock& out;
+      const TimeSliceBlock& in;
+      const std::vector<DComplex_t>& z;    // [t][n][k]
+      const std::vector<Chunk>& chunks;
+      bool accumulate;
+    };
+
+    //! Linear combinations on the chunks lo..hi-1
+    void rotateLoop(int lo, int hi, int myId, RotateArgs* a)
+    {
+      const int dof  = a->in.siteDof();
+      const int nin  = a->in.numVecs();
+      const int nout = a->out.numVecs();
+
+      for(int m=lo; m < hi; ++m)
+      {
+	const Chunk& chunk = a->chunks[m];
+	const int num_sites = a->in.siteTable(chunk.t).size();
+	const int rows = (std::min(chunk.s0 + tile_sites, num_sites) - chunk.s0)*dof;
+	const DComplex_t* z = &a->z[chunk.t*nin*nout];
+
+	for(int k=0; k < nout; ++k)
+	{
+	  DComplex_t* o = a->out.column(chunk.t, k) + chunk.s0*dof;
+
+	  if (! a->accumulate)
+	    for(int r=0; r < rows; ++r)
+	      o[r] = 0;
+
+	  for(int n=0; n < nin; ++n)
+	  {
+	    const DComplex_t c = z[n*nout + k];
+	    const DComplex_t* i = a->in.column(chunk.t, n) + chunk.s0*dof;
+
+	    for(int r=0; r < rows; ++r)
+	      o[r] += c * i[r];
+	  }
+	}
+      }
+    }
+
+  } // namespace TimeSliceContractEnv
+#endif
+
+
+  // Room for num_vecs vectors on the subsets of set
+  TimeSliceBlock::TimeSliceBlock(const Set& set, int num_vecs_, int site_dof_) :
+    num_vecs(num_vecs_), site_dof(site_dof_), sites(set.numSubsets()), data(set.numSubsets())
+  {
+    for(int t=0; t < set.numSubsets(); ++t)
+    {
+      const multi1d<int>& tab = set[t].siteTable();
+      sites[t].resize(tab.size());
+      for(int s=0; s < tab.size(); ++s)
+	sites[t][s] = tab[s];
+
+#if ! defined(QDP_IS_QDPJIT)
+      data[t].resize(tab.size()*site_dof*num_vecs);
+#endif
+    }
+
+#if defined(QDP_IS_QDPJIT)
+    vecs.resize(num_vecs);
+    subsets = set;
+#endif
+  }
+
+
+  // Abort unless the block has dof components per site
+  void TimeSliceBlock::checkDof(int n, int dof) const
+  {
+    if (n < 0 || n >= num_vecs)
+    {
+      QDPIO::cerr << "TimeSliceBlock: column " << n << " out of range 0.." << num_vecs-1 << std::endl;
+      QDP_abort(1);
+    }
+
+    if (dof != site_dof)
+    {
+      QDPIO::cerr << "TimeSliceBlock: vector with " << dof << " components per site in a block of "
+		  << site_dof << std::endl;
+      QDP_abort(1);
+    }
+  }
+
+
+  // Copy v into column n
+  void TimeSliceBlock::set(int n, const LatticeFermion& v)
+  {
+    checkDof(n, Ns*Nc);
+
+#if defined(QDP_IS_QDPJIT)
+    vecs[n] = v;
+#else
+    for(int t=0; t < sites.size(); ++t)
+    {
+      if (sites[t].empty())
+	continue;
+
+      DComplex_t* c = column(t, n);
+
+      for(int s=0; s < sites[t].size(); ++s)
+	for(int spin=0; spin < Ns; ++spin)
+	  for(int col=0; col < Nc; ++col, ++c)
+	    *c = DComplex_t(v.elem(sites[t][s]).elem(spin).elem(col).real(),
+			    v.elem(sites[t][s]).elem(spin).elem(col).imag());
+    }
+#endif
+  }
+
+
+#if ! defined(QDP_IS_QDPJIT)
+  // Copy v into column n
+  void TimeSliceBlock::set(int n, const LatticeColorVector& v)
+  {
+    checkDof(n, Nc);
+
+    for(int t=0; t < sites.size(); ++t)
+    {
+      if (sites[t].empty())
+	continue;
+
+      DComplex_t* c = column(t, n);
+
+      for(int s=0; s < sites[t].size(); ++s)
+	for(int col=0; col < Nc; ++col, ++c)
+	  *c = DComplex_t(v.elem(sites[t][s]).elem().elem(col).real(),
+			  v.elem(sites[t][s]).elem().elem(col).imag());
+    }
+  }
+
+
+  // Copy column n into v
+  void TimeSliceBlock::get(int n, LatticeColorVector& v) const
+  {
+    checkDof(n, Nc);
+
+    for(int t=0; t < sites.size(); ++t)
+    {
+      if (sites[t].empty())
+	continue;
+
+      const DComplex_t* c = column(t, n);
+
+      for(int s=0; s < sites[t].size(); ++s)
+	for(int col=0; col < Nc; ++col, ++c)
+	{
+	  v.elem(sites[t][s]).elem().elem(col).real() = c->real();
+	  v.elem(sites[t][s]).elem().elem(col).imag() = c->imag();
+	}
+    }
+  }
+#endif
+
+
+  // Exchange the contents with b
+  void TimeSliceBlock::swap(TimeSliceBlock& b)
+  {
+    std::swap(num_vecs, b.num_vecs);
+    std::swap(site_dof, b.site_dof);
+    sites.swap(b.sites);
+    data.swap(b.data);
+#if defined(QDP_IS_QDPJIT)
+    std::swap(vecs, b.vecs);
+    std::swap(subsets, b.subsets);
+#endif
+  }
+
+
+  // Column n of time slice t
+  const TimeSliceBlock::DComplex_t* TimeSliceBlock::column(int t, int n) const
+  {
+    return &data[t][n*sites[t].size()*site_dof];
+  }
+
+
+  // Column n of time slice t
+  TimeSliceBlock::DComplex_t* TimeSliceBlock::column(int t, int n)
+  {
+    return &data[t][n*sites[t].size()*site_dof];
+  }
+
+
+  // All inner products of two blocks on every time slice
+  void timeSliceInnerProducts(multi1d< multi2d<ComplexD> >& op,
+			      const TimeSliceBlock& left,
+			      const TimeSliceBlock& right,
+			      const LatticeComplex& phase)
+  {
+    START_CODE();
+
+    const int nt = left.numSubsets();
+    const int nl = left.numVecs();
+    const int nr = right.numVecs();
+
+    if (right.numSubsets() != nt || right.siteDof() != left.siteDof())
+    {
+      QDPIO::cerr << __func__ << ": blocks of different sets or vectors" << std::endl;
+      QDP_abort(1);
+    }
+
+    op.resize(nt);
+    for(int t=0; t < nt; ++t)
+      op[t].resize(nl, nr);
+
+#if defined(QDP_IS_QDPJIT)
+    for(int i=0; i < nl; ++i)
+      for(int j=0; j < nr; ++j)
+      {
+	multi1d<ComplexD> op_sum = sumMulti(phase * localInnerProduct(left.vecs[i], right.vecs[j]),
+					    left.subsets);
+	for(int t=0; t < nt; ++t)
+	  op[t](i,j) = op_sum[t];
+      }
+#else
+    using namespace TimeSliceContractEnv;
+
+    std::vector<Tile> tiles;
+    for(int t=0; t < nt; ++t)
+      for(int i0=0; i0 < nl; i0 += tile_vecs)
+	for(int j0=0; j0 < nr; j0 += tile_vecs)
+	{
+	  Tile tile = {t, i0, j0};
+	  tiles.push_back(tile);
+	}
+
+    std::vector<DComplex_t> result(nt*nl*nr);
+    Args args = {left, right, phase, tiles, &result[0]};
+    dispatch_to_threads(tiles.size(), args, tileLoop);
+
+    // One global sum for all of them
+    QDPInternal::globalSumArray(reinterpret_cast<REAL64*>(&result[0]), 2*result.size());
+
+    for(int t=0; t < nt; ++t)
+      for(int i=0; i < nl; ++i)
+	for(int j=0; j < nr; ++j)
+	{
+	  const DComplex_t& z = result[(t*nl + i)*nr + j];
+	  op[t](i,j) = cmplx(Double(z.real()), Double(z.imag()));
+	}
+#endif
+
+    END_CODE();
+  }
+
+
+#if ! defined(QDP_IS_QDPJIT)
+  // Linear combinations of the vectors of a block on every time slice
+  void timeSliceRotate(TimeSliceBlock& out,
+		       const TimeSliceBlock& in,
+		       const multi1d< multi2d<ComplexD> >& z,
+		       bool accumulate)
+  {
+    START_CODE();
+
+    using namespace TimeSliceContractEnv;
+
+    const int nt   = in.numSubsets();
+    const int nin  = in.numVecs();
+    const int nout = out.numVecs();
+
+    if (out.numSubsets() != nt || out.siteDof() != in.siteDof() || z.size() != nt)
+    {
+      QDPIO::cerr << __func__ << ": blocks of different sets or vectors" << std::endl;
+      QDP_abort(1);
+    }
+
+    std::vector<DComplex_t> zz(nt*nin*nout);
+    std::vector<Chunk> chunks;
+    for(int t=0; t < nt; ++t)
+    {
+      if (z[t].size2() != nin || z[t].size1() != nout)
+      {
+	QDPIO::cerr << __func__ << ": coefficients are not " << nin << " x " << nout << std::endl;
+	QDP_abort(1);
+      }
+
+      for(int n=0; n < nin; ++n)
+	for(int k=0; k < nout; ++k)
+	  zz[(t*nin + n)*nout + k] = DComplex_t(toDouble(real(z[t](n,k))), toDouble(imag(z[t](n,k))));
+
+      for(int s0=0; s0 < in.siteTable(t).size(); s0 += tile_sites)
+      {
+	Chunk chunk = {t, s0};
+	chunks.push_back(chunk);
+      }
+    }
+
+    RotateArgs args = {out, in, zz, chunks, accumulate};
+    dispatch_to_threads(chunks.size(), args, rotateLoop);
+
+    END_CODE();
+  }
+#endif
+
+} // namespace Chroma
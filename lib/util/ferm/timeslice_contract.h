@@ -0,0 +1,116 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Time slice blocked inner products of sets of fermions
+ */
+
+#ifndef __timeslice_contract_h__
+#define __timeslice_contract_h__
+
+#include "chromabase.h"
+#include <complex>
+#include <vector>
+
+namespace Chroma
+{
+  //----------------------------------------------------------------------------
+  /*!
+   * \ingroup ferm
+   * @{
+   */
+
+  //! A set of fermions or color vectors with the local sites grouped by time slice
+  /*!
+   * For every subset t of the Set the local sites of the N vectors are
+   * copied, in double precision, into one column major complex matrix
+   * of (sites on t)*site_dof rows and N columns. The inner products of two
+   * such blocks on a time slice are then a single matrix product.
+   */
+  class TimeSliceBlock
+  {
+  public:
+    typedef std::complex<double> DComplex_t;
+
+    //! Room for num_vecs vectors with site_dof components per site on the subsets of set
+    TimeSliceBlock(const Set& set, int num_vecs, int site_dof = Ns*Nc);
+
+    //! Copy v into column n
+    void set(int n, const LatticeFermion& v);
+
+#if ! defined(QDP_IS_QDPJIT)
+    //! Copy v into column n of a block with site_dof = Nc
+    void set(int n, const LatticeColorVector& v);
+
+    //! Copy column n into v, for site_dof = Nc
+    void get(int n, LatticeColorVector& v) const;
+#endif
+
+    //! Number of vectors
+    int numVecs() const {return num_vecs;}
+
+    //! Components per site
+    int siteDof() const {return site_dof;}
+
+    //! Exchange the contents with b
+    void swap(TimeSliceBlock& b);
+
+    //! Number of time slices
+    int numSubsets() const {return sites.size();}
+
+    //! Local sites of time slice t
+    const std::vector<int>& siteTable(int t) const {return sites[t];}
+
+    //! Column n of time slice t
+    const DComplex_t* column(int t, int n) const;
+
+    //! Column n of time slice t
+    DComplex_t* column(int t, int n);
+
+  private:
+    //! Abort unless the block has dof components per site
+    void checkDof(int n, int dof) const;
+
+    int num_vecs;
+    int site_dof;
+    std::vector< std::vector<int> > sites;          /*!< local sites of each subset */
+    std::vector< std::vector<DComplex_t> > data;    /*!< column major matrix of each subset */
+#if defined(QDP_IS_QDPJIT)
+    multi1d<LatticeFermion> vecs;
+    Set subsets;
+#endif
+
+    friend void timeSliceInnerProducts(multi1d< multi2d<ComplexD> >& op,
+				       const TimeSliceBlock& left,
+				       const TimeSliceBlock& right,
+				       const LatticeComplex& phase);
+  };
+
+
+  //! All inner products of two blocks on every time slice
+  /*!
+   * op[t](i,j) = sum_{x in t} phase(x) left_i(x)^dag right_j(x)
+   *
+   * The products are done tile by tile on all threads and summed over
+   * the nodes in one global sum, instead of one sumMulti per (i,j)
+   */
+  void timeSliceInnerProducts(multi1d< multi2d<ComplexD> >& op,
+			      const TimeSliceBlock& left,
+			      const TimeSliceBlock& right,
+			      const LatticeComplex& phase);
+
+#if ! defined(QDP_IS_QDPJIT)
+  //! Linear combinations of the vectors of a block on every time slice
+  /*!
+   * out_k = sum_n in_n z[t](n,k) on time slice t, or out_k += ... when accumulate.
+   * out and in must be different blocks
+   */
+  void timeSliceRotate(TimeSliceBlock& out,
+		       const TimeSliceBlock& in,
+		       const multi1d< multi2d<ComplexD> >& z,
+		       bool accumulate = false);
+#endif
+
+  /*! @} */  // end of group ferm
+
+} // namespace Chroma
+
+#endif
@@ -100,6 +100,7 @@
 #include "util/ft/sftmom.h"
 #include "util/ft/single_phase.h"
 #include "qdp_util.h"                 // part of QDP++, for crtesn()
+#include <algorithm>
 
 namespace Chroma 
 {
@@ -114,6 +115,7 @@ namespace Chroma
     origin_offset.resize(Nd);  /*<! Coordinate offset of the origin. Used to fix phase factor */
     origin_offset = 0;
     decay_dir = -1;            /*!< Decay direction */
+    use_fft = false;           /*!< separable transform instead of a phase table */
   };
 
 
@@ -137,6 +139,84 @@ namespace Chroma
     };
   }
 
+
+#if ! defined(QDP_IS_QDPJIT)
+  // Anonymous namespace
+  namespace
+  {
+    typedef std::complex<double> DComplex_t;
+
+    //! One direction of the separable transform
+    /*!
+     * out[(o*nk + k)*inner + i] = sum_x in[(o*ext + x)*inner + i] phase[k*ext + x]
+     */
+    struct StageArgs
+    {
+      const DComplex_t* in;
+      DComplex_t* out;
+      const DComplex_t* phase;
+      int inner;
+      int ext;
+      int nk;
+    };
+
+    //! The outer indices lo..hi-1 of a stage
+    void stageLoop(int lo, int hi, int myId, StageArgs* a)
+    {
+      const int inner = a->inner;
+      const int ext = a->ext;
+      const int nk = a->nk;
+
+      for(int o=lo; o < hi; ++o)
+      {
+	const DComplex_t* in = a->in + o*ext*inner;
+	DComplex_t* out = a->out + o*nk*inner;
+
+	for(int k=0; k < nk; ++k)
+	{
+	  DComplex_t* ok = out + k*inner;
+	  for(int i=0; i < inner; ++i)
+	    ok[i] = 0;
+
+	  for(int x=0; x < ext; ++x)
+	  {
+	    const DComplex_t ph = a->phase[k*ext + x];
+	    const DComplex_t* ix = in + x*inner;
+	    for(int i=0; i < inner; ++i)
+	      ok[i] += ph * ix[i];
+	  }
+	}
+      }
+    }
+
+    //! Local values of a field
+    void localValues(std::vector<DComplex_t>& f, const LatticeComplex& cf)
+    {
+      f.resize(Layout::sitesOnNode());
+      for(int s=0; s < f.size(); ++s)
+	f[s] = DComplex_t(cf.elem(s).elem().elem().real(), cf.elem(s).elem().elem().imag());
+    }
+
+    //! Local values of a field
+    void localValues(std::vector<DComplex_t>& f, const LatticeReal& cf)
+    {
+      f.resize(Layout::sitesOnNode());
+      for(int s=0; s < f.size(); ++s)
+	f[s] = DComplex_t(cf.elem(s).elem().elem().elem(), 0);
+    }
+
+#if BASE_PRECISION==32
+    //! Local values of a field
+    void localValues(std::vector<DComplex_t>& f, const LatticeComplexD& cf)
+    {
+      f.resize(Layout::sitesOnNode());
+      for(int s=0; s < f.size(); ++s)
+	f[s] = DComplex_t(cf.elem(s).elem().elem().real(), cf.elem(s).elem().elem().imag());
+    }
+#endif
+  }
+#endif
+
   int
   TimeSliceFunc::operator() (const multi1d<int>& coordinate) const
   {
@@ -193,9 +273,16 @@ namespace Chroma
     phases.resize(num_mom);
 
 
+    mom_degen.resize(num_mom);
+    mom_degen = 0;
+    contrib_num.clear();
+    contrib_mom.clear();
+
     for (int m = 0 ; m < num_mom ; ++m)
     {
       phases[m] = singlePhase(orig, mom_list[m], decay_dir);
+      contrib_num.push_back(m);
+      contrib_mom.push_back(mom_list[m]);
     }
 
   }
@@ -234,7 +321,7 @@ namespace Chroma
 
   void
   SftMom::init(int mom2_max, multi1d<int> origin_off, multi1d<int> mom_off,
-	       bool avg_mom, int j_decay)
+	       bool avg_mom, int j_decay, bool use_fft_)
   {
     decay_dir     = j_decay;    // private copy
     origin_offset = origin_off; // private copy
@@ -331,15 +418,10 @@ namespace Chroma
       }
     }
 
-    // Now resize and initialize the Fourier phase table.  Then, loop over
-    // allowed momenta, optionally averaging over equivalent momenta.
-    phases.resize(num_mom) ;
-    phases = 0. ;
-
-    // Coordinates for sink momenta
-    multi1d<LatticeInteger> my_coord(Nd);
-    for (int mu=0; mu < Nd; ++mu)
-      my_coord[mu] = Layout::latticeCoordinate(mu);
+    // Now loop over allowed momenta, optionally averaging over equivalent
+    // momenta, and record which of them contribute to each momentum id.
+    contrib_num.clear();
+    contrib_mom.clear();
 
     // Keep track of |mom| degeneracy for averaging
     mom_degen.resize(num_mom);
@@ -424,6 +506,54 @@ namespace Chroma
 	}
       } // end if (avg_equiv_mom)
 
+      // This momentum contributes to the phase of mom_num
+      contrib_num.push_back(mom_num);
+      contrib_mom.push_back(mom);
+
+      // increment mom_num for next valid momenta
+      ++mom_num ;
+
+    } // end for (int n=0; n < mom_vol; ++n)
+
+#if defined(QDP_IS_QDPJIT)
+    if (use_fft_) {
+      QDPIO::cout << "SftMom: no separable transform with QDP-JIT, using the phase table" << std::endl;
+      use_fft_ = false;
+    }
+#endif
+    use_fft = use_fft_;
+    phase_cache.clear();
+    phase_cache_order.clear();
+
+    if (use_fft) {
+      // No phase table: the transform needs only a few small tables
+      phases.resize(0);
+      initFT();
+    } else {
+      // Initialize the Fourier phase table
+      phases.resize(num_mom) ;
+      for (int mom_num=0; mom_num < num_mom; ++mom_num)
+	makePhase(phases[mom_num], mom_num);
+    }
+  }
+
+
+  // Build the phase of a momentum id
+  void
+  SftMom::makePhase(LatticeComplex& phase, int mom_num) const
+  {
+    phase = 0. ;
+
+    // Coordinates for sink momenta
+    multi1d<LatticeInteger> my_coord(Nd);
+    for (int mu=0; mu < Nd; ++mu)
+      my_coord[mu] = Layout::latticeCoordinate(mu);
+
+    for (int c=0; c < contrib_num.size(); ++c) {
+      if (contrib_num[c] != mom_num) continue;
+
+      const multi1d<int>& mom = contrib_mom[c];
+
       //
       // Build the phase. 
       // RGE: the origin_offset works with or without momentum averaging
@@ -435,28 +565,229 @@ namespace Chroma
       for(int mu = 0; mu < Nd; ++mu) {
 	const Real twopi = 6.283185307179586476925286;
 
-	if (mu == j_decay) continue ;
+	if (mu == decay_dir) continue ;
 
 	p_dot_x += LatticeReal(my_coord[mu] - origin_offset[mu]) * twopi *
           Real(mom[j]) / Layout::lattSize()[mu];
 	++j ;
       } // end for(mu)
 
-      phases[mom_num] += cmplx(cos(p_dot_x), sin(p_dot_x)) ;
-
-      // increment mom_num for next valid momenta
-      ++mom_num ;
-
-    } // end for (int n=0; n < mom_vol; ++n)
+      phase += cmplx(cos(p_dot_x), sin(p_dot_x)) ;
+    }
 
     // Finish averaging
     // Momentum averaging works even in the presence of an origin_offset
-    if (avg_equiv_mom) {
-      for (int mom_num=0; mom_num < num_mom; ++mom_num)
-	phases[mom_num] /= mom_degen[mom_num] ;
+    if (avg_equiv_mom)
+      phase /= mom_degen[mom_num] ;
+  }
+
+
+  // Return the phase for this particular momenta id
+  const LatticeComplex&
+  SftMom::operator[](int mom_num) const
+  {
+    if (! use_fft)
+      return phases[mom_num];
+
+    // Without a table the phase is built when first asked for. The last
+    // few are kept, so references handed out recently stay valid
+    std::map<int, LatticeComplex>::iterator it = phase_cache.find(mom_num);
+    if (it == phase_cache.end()) {
+      if (int(phase_cache_order.size()) >= max_cached_phases) {
+	phase_cache.erase(phase_cache_order.front());
+	phase_cache_order.pop_front();
+      }
+      phase_cache_order.push_back(mom_num);
+
+      LatticeComplex& phase = phase_cache[mom_num];
+      makePhase(phase, mom_num);
+      return phase;
+    }
+
+    return it->second;
+  }
+
+
+#if ! defined(QDP_IS_QDPJIT)
+  // Tables for the separable transform
+  void
+  SftMom::initFT()
+  {
+    const bool has_decay = (decay_dir >= 0) && (decay_dir < Nd);
+    const multi1d<int>& subgrid = Layout::subgridLattSize();
+    const int num_sites = Layout::sitesOnNode();
+
+    // The local sites are a box; find its corner
+    multi1d<int> lo(Nd);
+    lo = Layout::lattSize();
+    for(int s=0; s < num_sites; ++s)
+    {
+      multi1d<int> x = Layout::siteCoords(Layout::nodeNumber(), s);
+      for(int mu=0; mu < Nd; ++mu)
+	lo[mu] = std::min(lo[mu], x[mu]);
     }
+
+    ft_dirs.clear();
+    for(int mu=0; mu < Nd; ++mu)
+      if (mu != decay_dir)
+	ft_dirs.push_back(mu);
+
+    const int nd = ft_dirs.size();
+    ft_ext.resize(nd);
+    ft_kmin.resize(nd);
+    ft_nk.resize(nd);
+    ft_phase.resize(nd);
+
+    // Only the range of momentum components in the list is computed
+    for(int j=0; j < nd; ++j)
+    {
+      int kmin = 0, kmax = -1;
+      for(int c=0; c < contrib_mom.size(); ++c)
+      {
+	if (c == 0 || contrib_mom[c][j] < kmin) kmin = contrib_mom[c][j];
+	if (c == 0 || contrib_mom[c][j] > kmax) kmax = contrib_mom[c][j];
+      }
+
+      const int mu = ft_dirs[j];
+      const double twopi = 6.283185307179586476925286;
+
+      ft_ext[j]  = subgrid[mu];
+      ft_kmin[j] = kmin;
+      ft_nk[j]   = kmax - kmin + 1;
+      ft_phase[j].resize(ft_nk[j]*ft_ext[j]);
+
+      for(int k=0; k < ft_nk[j]; ++k)
+	for(int x=0; x < ft_ext[j]; ++x)
+	{
+	  const double p_dot_x = twopi * double(kmin + k) * double(lo[mu] + x - origin_offset[mu])
+	    / double(Layout::lattSize()[mu]);
+	  ft_phase[j][k*ft_ext[j] + x] = DComplex_t(cos(p_dot_x), sin(p_dot_x));
+	}
+    }
+
+    ft_t_lo  = has_decay ? lo[decay_dir] : 0;
+    ft_t_ext = has_decay ? subgrid[decay_dir] : 1;
+
+    // Box index of each site, the first direction runs fastest, time slowest
+    ft_site.resize(num_sites);
+    for(int s=0; s < num_sites; ++s)
+    {
+      multi1d<int> x = Layout::siteCoords(Layout::nodeNumber(), s);
+
+      int idx = has_decay ? x[decay_dir] - ft_t_lo : 0;
+      for(int j=nd-1; j >= 0; --j)
+	idx = idx*ft_ext[j] + x[ft_dirs[j]] - lo[ft_dirs[j]];
+
+      ft_site[s] = idx;
+    }
+
+    // Index of each contributing momentum in the box of momenta
+    ft_cell.resize(contrib_mom.size());
+    for(int c=0; c < contrib_mom.size(); ++c)
+    {
+      int idx = 0;
+      for(int j=nd-1; j >= 0; --j)
+	idx = idx*ft_nk[j] + contrib_mom[c][j] - ft_kmin[j];
+
+      ft_cell[c] = idx;
+    }
+  }
+
+
+  // Separable transform of the local values f
+  multi2d<DComplex>
+  SftMom::sftFT(const std::vector< std::complex<double> >& f, int subset_color) const
+  {
+    const int nt = sft_set.numSubsets();
+    const int nd = ft_dirs.size();
+
+    int box = 1;
+    for(int j=0; j < nd; ++j)
+      box *= ft_ext[j];
+
+    // Local time slices to transform
+    int t0 = 0, ntw = ft_t_ext;
+    if (subset_color >= 0)
+    {
+      t0 = subset_color - ft_t_lo;
+      ntw = (t0 >= 0 && t0 < ft_t_ext) ? 1 : 0;
+    }
+
+    std::vector<DComplex_t> work(ntw*box), next;
+
+    for(int s=0; s < f.size(); ++s)
+    {
+      const int idx = ft_site[s] - t0*box;
+      if (idx >= 0 && idx < ntw*box)
+	work[idx] = f[s];
+    }
+
+    // One direction at a time; the transformed ones run fastest
+    int inner = 1;
+    int outer = ntw*box;
+    for(int j=0; j < nd; ++j)
+    {
+      outer /= ft_ext[j];
+      next.resize(outer*ft_nk[j]*inner);
+
+      if (outer > 0)
+      {
+	StageArgs args = {&work[0], &next[0], &ft_phase[j][0], inner, ft_ext[j], ft_nk[j]};
+	dispatch_to_threads(outer, args, stageLoop);
+      }
+
+      work.swap(next);
+      inner *= ft_nk[j];
+    }
+
+    // Collect the momenta of the list and sum over the nodes
+    std::vector<DComplex_t> result(num_mom*nt, DComplex_t(0));
+
+    for(int tl=0; tl < ntw; ++tl)
+    {
+      const int t = ft_t_lo + t0 + tl;
+      for(int c=0; c < ft_cell.size(); ++c)
+      {
+	const int mom_num = contrib_num[c];
+	DComplex_t v = work[tl*inner + ft_cell[c]];
+	if (avg_equiv_mom)
+	  v /= double(mom_degen[mom_num]);
+
+	result[mom_num*nt + t] += v;
+      }
+    }
+
+    if (result.size() > 0)
+      QDPInternal::globalSumArray(reinterpret_cast<REAL64*>(&result[0]), 2*result.size());
+
+    multi2d<DComplex> hsum(num_mom, nt);
+    for(int mom_num=0; mom_num < num_mom; ++mom_num)
+      for(int t=0; t < nt; ++t)
+	hsum[mom_num][t] = cmplx(Double(result[mom_num*nt + t].real()), Double(result[mom_num*nt + t].imag()));
+
+    return hsum;
+  }
+
+#else
+
+  // Tables for the separable transform
+  void
+  SftMom::initFT()
+  {
+    QDPIO::cerr << "SftMom: separable transform not supported with QDP-JIT" << std::endl;
+    QDP_abort(1);
   }
 
+  // Separable transform of the local values f
+  multi2d<DComplex>
+  SftMom::sftFT(const std::vector< std::complex<double> >& f, int subset_color) const
+  {
+    QDPIO::cerr << "SftMom: separable transform not supported with QDP-JIT" << std::endl;
+    QDP_abort(1);
+    return multi2d<DComplex>();
+  }
+#endif
+
 
   // Canonically order an array of momenta
   /* \return abs(mom[0]) >= abs(mom[1]) >= ... >= abs(mom[mu]) >= ... >= 0 */
@@ -523,6 +854,15 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplex& cf) const
   {
+#if ! defined(QDP_IS_QDPJIT)
+    if (use_fft)
+    {
+      std::vector<DComplex_t> f;
+      localValues(f, cf);
+      return sftFT(f, -1);
+    }
+#endif
+
     multi2d<DComplex> hsum(num_mom, sft_set.numSubsets()) ;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
@@ -534,6 +874,15 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplex& cf, int subset_color) const
   {
+#if ! defined(QDP_IS_QDPJIT)
+    if (use_fft)
+    {
+      std::vector<DComplex_t> f;
+      localValues(f, cf);
+      return sftFT(f, subset_color);
+    }
+#endif
+
     int length = sft_set.numSubsets();
     multi2d<DComplex> hsum(num_mom, length);
 
@@ -549,6 +898,15 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeReal& cf) const
   {
+#if ! defined(QDP_IS_QDPJIT)
+    if (use_fft)
+    {
+      std::vector<DComplex_t> f;
+      localValues(f, cf);
+      return sftFT(f, -1);
+    }
+#endif
+
     multi2d<DComplex> hsum(num_mom, sft_set.numSubsets()) ;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
@@ -560,6 +918,15 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeReal& cf, int subset_color) const
   {
+#if ! defined(QDP_IS_QDPJIT)
+    if (use_fft)
+    {
+      std::vector<DComplex_t> f;
+      localValues(f, cf);
+      return sftFT(f, subset_color);
+    }
+#endif
+
     int length = sft_set.numSubsets();
     multi2d<DComplex> hsum(num_mom, length);
 
@@ -576,6 +943,15 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplexD& cf) const
   {
+#if ! defined(QDP_IS_QDPJIT)
+    if (use_fft)
+    {
+      std::vector<DComplex_t> f;
+      localValues(f, cf);
+      return sftFT(f, -1);
+    }
+#endif
+
     multi2d<DComplex> hsum(num_mom, sft_set.numSubsets()) ;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
@@ -587,6 +963,15 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplexD& cf, int subset_color) const
   {
+#if ! defined(QDP_IS_QDPJIT)
+    if (use_fft)
+    {
+      std::vector<DComplex_t> f;
+      localValues(f, cf);
+      return sftFT(f, subset_color);
+    }
+#endif
+
     int length = sft_set.numSubsets();
     multi2d<DComplex> hsum(num_mom, length);
 
@@ -8,6 +8,10 @@
 #define __sftmom_h__
 
 #include "chromabase.h"
+#include <complex>
+#include <vector>
+#include <map>
+#include <deque>
 
 namespace Chroma 
 {
@@ -24,12 +28,19 @@ namespace Chroma
     bool          avg_equiv_mom;      /*!< average over equivalent momenta */
     multi1d<int>  origin_offset;      /*<! Coordinate offset of the origin. Used to fix phase factor */
     int           decay_dir;          /*!< Decay direction */
+    bool          use_fft;            /*!< separable transform instead of a phase table */
   };
 
 
   //! Fourier transform phase factor support
   /*!
    * \ingroup ft
+   *
+   * By default a table of numMom() phase fields is built and sft() does one
+   * sumMulti per momentum. With use_fft the table is not built: sft() does
+   * the transform over the directions other than the decay direction one
+   * direction at a time on the local sites of each node, keeping only the
+   * momentum components in the list, and sums over the nodes once.
    */
   class SftMom
   {
@@ -46,12 +57,12 @@ namespace Chroma
 
     //! Construct around some fixed origin_offset and mom_offset
     SftMom(int mom2_max, multi1d<int> origin_offset_, multi1d<int> mom_offset_,
-	   bool avg_equiv_mom_=false, int j_decay=-1) 
-      { init(mom2_max, origin_offset_, mom_offset_, avg_equiv_mom_, j_decay); }
+	   bool avg_equiv_mom_=false, int j_decay=-1, bool use_fft_=false) 
+      { init(mom2_max, origin_offset_, mom_offset_, avg_equiv_mom_, j_decay, use_fft_); }
 
     //! General constructor
     SftMom(const SftMomParams_t& p)
-      { init(p.mom2_max, p.origin_offset, p.mom_offset, p.avg_equiv_mom, p.decay_dir); }
+      { init(p.mom2_max, p.origin_offset, p.mom_offset, p.avg_equiv_mom, p.decay_dir, p.use_fft); }
 
     //! The set to be used in sumMulti
     const Set& getSet() const { return sft_set; }
@@ -71,6 +82,9 @@ namespace Chroma
     //! Are momenta averaged?
     bool getAvg() const { return avg_equiv_mom; }
 
+    //! Is the separable transform used instead of a phase table?
+    bool getFFT() const { return use_fft; }
+
     //! Momentum offset
     multi1d<int> getMomOffset() const { return mom_offset; }
 
@@ -86,8 +100,10 @@ namespace Chroma
     multi1d<int> canonicalOrder(const multi1d<int>& mom) const;
 
     //! Return the phase for this particular momenta id
-    const LatticeComplex& operator[](int mom_num) const
-      { return phases[mom_num]; }
+    /*! Without a phase table each phase is built when first asked for
+     *  and kept among the last max_cached_phases built. A reference stays
+     *  valid until that many other phases have been built after it */
+    const LatticeComplex& operator[](int mom_num) const;
 
     //! Return the the multiplicity for this momenta id.
     /*! Only nonzero if momentum averaging is turned on */
@@ -116,7 +132,16 @@ namespace Chroma
     SftMom() {} // hide default constructor
 
     void init(int mom2_max, multi1d<int> origin_offset, multi1d<int> mom_offset,
-	      bool avg_mom_=false, int j_decay=-1);
+	      bool avg_mom_=false, int j_decay=-1, bool use_fft_=false);
+
+    //! Build the phase of a momentum id from its contributions
+    void makePhase(LatticeComplex& phase, int mom_num) const;
+
+    //! Tables for the separable transform
+    void initFT();
+
+    //! Separable transform of the local values f, on all subsets or only subset_color
+    multi2d<DComplex> sftFT(const std::vector< std::complex<double> >& f, int subset_color) const;
 
     multi2d<int> mom_list;
     bool         avg_equiv_mom;
@@ -127,6 +152,23 @@ namespace Chroma
     multi1d<LatticeComplex> phases;
     multi1d<int> mom_degen;
     Set sft_set;
+
+    bool use_fft;
+    std::vector<int> contrib_num;               /*!< momentum id of each contributing momentum */
+    std::vector< multi1d<int> > contrib_mom;    /*!< the contributing momenta */
+    mutable std::map<int, LatticeComplex> phase_cache;   /*!< phases built without a table */
+    mutable std::deque<int> phase_cache_order;           /*!< their momenta, oldest first */
+    static const int max_cached_phases = 8;
+
+    std::vector<int> ft_dirs;                   /*!< transformed directions */
+    std::vector<int> ft_ext;                    /*!< local extent in each of them */
+    std::vector<int> ft_kmin;                   /*!< smallest momentum component */
+    std::vector<int> ft_nk;                     /*!< number of momentum components */
+    std::vector< std::vector< std::complex<double> > > ft_phase;  /*!< [dir][k*ext + x] */
+    std::vector<int> ft_site;                   /*!< local box index of each site */
+    std::vector<int> ft_cell;                   /*!< momentum box index of each contribution */
+    int ft_t_lo;                                /*!< first local time slice */
+    int ft_t_ext;                               /*!< number of local time slices */
   };
 
 }  // end namespace Chroma
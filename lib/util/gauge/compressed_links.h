@@ -0,0 +1,410 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Compressed (12 or 8 parameter) storage of SU(3) links
+ */
+
+#ifndef __compressed_links_h__
+#define __compressed_links_h__
+
+#include "chromabase.h"
+#include "io/enum_io/enum_linkcompresstype_io.h"
+#include <complex>
+#include <cmath>
+#include <vector>
+
+namespace Chroma
+{
+
+  //! Element type of a multi1d of link fields
+  /*! \ingroup gauge */
+  template<typename Q>
+  struct LinkFieldType {};
+
+  template<typename U>
+  struct LinkFieldType< multi1d<U> >
+  {
+    typedef U Type_t;
+  };
+
+
+  //! Compressed storage of a link field
+  /*! \ingroup gauge
+   *
+   * Holds a field of links of the form  U = s V  with  V in SU(3) and
+   * s a complex number (s absorbs the anisotropy coefficients and the
+   * fermion boundary conditions, including twisted or other complex
+   * phases; s = 0 for Dirichlet links). s is a cube root of det(U).
+   * V is stored either as
+   *
+   *   LINK_COMPRESS_12:  its first two rows,   r2 = conj(r0 x r1)
+   *   LINK_COMPRESS_8:   V01, V02, V10 and the phases of V00 and V20
+   *
+   * s takes only a few values in a field of links (one for the bulk,
+   * one more for each boundary slice), so the distinct values are held
+   * once, in a table. When there is a single value, as for a periodic
+   * direction, nothing else is stored; otherwise each link has a one
+   * byte index into the table. So one link costs 12 or 8 reals (plus
+   * at most one byte) instead of 18. Values of s are taken equal when
+   * they agree to a relative 1e-5; at most 256 are allowed.
+   *
+   *   LINK_COMPRESS_FIXED16:  all 18 reals of U as int16, relative to
+   *                           s = the largest modulus of the link's reals
+   *
+   * costs the space of 10 reals and works for any link, to a relative
+   * precision of about 3e-5 (for the inner operator of a solver with
+   * reliable updates). The 8 parameter form
+   * can not represent links with V01 = V02 = 0 (e.g. a unit gauge);
+   * create() checks the round trip and stops if the links can not be
+   * represented.
+   *
+   * Only Nc = 3 is supported.
+   */
+  template<typename U>
+  class CompressedLinksT
+  {
+  public:
+    typedef typename WordType<U>::Type_t REALT;
+    typedef OLattice< PScalar< PScalar< RComplex<REALT> > > > LatticeComplexT;
+    typedef OLattice< PScalar< PScalar< RScalar<REALT> > > > LatticeRealT;
+    typedef PScalar< PColorMatrix< RComplex<REALT>, Nc> > SiteMatrix_t;
+
+    //! Empty, uncompressed
+    CompressedLinksT() : ctype(LINK_COMPRESS_NONE) {}
+
+    //! Compress a link field
+    /*!
+     * \param u       link field ( Read )
+     * \param ctype_  compression ( Read )
+     */
+    void create(const U& u, LinkCompressType ctype_);
+
+    //! The compression in use
+    LinkCompressType type() const {return ctype;}
+
+    //! Reals stored per link, not counting the scale index
+    int numReals() const 
+    {
+      switch(ctype)
+      {
+      case LINK_COMPRESS_12:      return 12;
+      case LINK_COMPRESS_8:       return 8;
+      case LINK_COMPRESS_FIXED16: return 10;
+      default:                    return 18;
+      }
+    }
+
+    //! Distinct scales s on this node (12 and 8 parameters)
+    int numScales() const {return s_table.size();}
+
+    //! Rebuild the link on a single site
+    inline void reconstructSite(SiteMatrix_t& m, int site) const;
+
+    //! Rebuild the full link field
+    void uncompress(U& u) const;
+
+  private:
+    //! Compress the link on a single site. Returns false if the parameters are degenerate
+    bool compressSite(const SiteMatrix_t& m, int site);
+
+    //! Entry of s in the table of scales, added if new
+    int scaleIndex(const std::complex<double>& s);
+
+    LinkCompressType ctype;
+    multi1d<LatticeComplexT> comp;   /*!< 6 (12 param) or 4 (8 param) complex numbers */
+    std::vector< std::complex<REALT> > s_table;  /*!< the distinct scales s */
+    std::vector<unsigned char> s_index;          /*!< entry of s per site, empty if only one */
+    std::vector<short> fixed;         /*!< 18 int16 per site (fixed point) */
+    LatticeRealT scale;               /*!< the norm of the fixed point link */
+  };
+
+
+  // Find or add a scale
+  template<typename U>
+  int
+  CompressedLinksT<U>::scaleIndex(const std::complex<double>& s)
+  {
+    for(int k=0; k < s_table.size(); ++k)
+    {
+      const std::complex<double> t(s_table[k].real(), s_table[k].imag());
+      if (std::abs(s - t) <= 1.0e-5 * std::max(std::abs(s), std::abs(t)))
+	return k;
+    }
+
+    s_table.push_back(std::complex<REALT>(s.real(), s.imag()));
+    return s_table.size() - 1;
+  }
+
+
+  // Compress one site
+  template<typename U>
+  bool
+  CompressedLinksT<U>::compressSite(const SiteMatrix_t& m, int site)
+  {
+    typedef std::complex<double> cd;
+
+    if (ctype == LINK_COMPRESS_FIXED16)
+    {
+      REALT mx = 0;
+      for(int i=0; i < 3; ++i)
+	for(int j=0; j < 3; ++j)
+	{
+	  mx = std::max(mx, REALT(fabs(m.elem().elem(i,j).real())));
+	  mx = std::max(mx, REALT(fabs(m.elem().elem(i,j).imag())));
+	}
+
+      scale.elem(site).elem().elem().elem() = mx;
+      const double isc = (mx > 0) ? 32767.0/mx : 0.0;
+      short* d = &fixed[18*site];
+      for(int i=0; i < 3; ++i)
+	for(int j=0; j < 3; ++j)
+	{
+	  *d++ = short(lrint(isc * m.elem().elem(i,j).real()));
+	  *d++ = short(lrint(isc * m.elem().elem(i,j).imag()));
+	}
+
+      return true;
+    }
+
+    cd a[3][3];
+    for(int i=0; i < 3; ++i)
+      for(int j=0; j < 3; ++j)
+	a[i][j] = cd(m.elem().elem(i,j).real(), m.elem().elem(i,j).imag());
+
+    // s^3 = det(U)
+    cd det = a[0][0]*(a[1][1]*a[2][2] - a[1][2]*a[2][1])
+      - a[0][1]*(a[1][0]*a[2][2] - a[1][2]*a[2][0])
+      + a[0][2]*(a[1][0]*a[2][1] - a[1][1]*a[2][0]);
+
+    // Any cube root will do, the others only move V by a center element.
+    // Keep real links real so the common case rebuilds bit for bit.
+    cd s_site = (det.imag() == 0.0) ? cd(std::cbrt(det.real()), 0.0)
+      : std::polar(std::cbrt(std::abs(det)), std::arg(det)/3.0);
+
+    // V is taken relative to the shared value of s
+    const int k = scaleIndex(s_site);
+    s_index[site] = (unsigned char)(k);
+    const cd s(s_table[k].real(), s_table[k].imag());
+    cd is = (s == cd(0.0)) ? cd(0.0) : 1.0/s;
+
+    for(int i=0; i < 3; ++i)
+      for(int j=0; j < 3; ++j)
+	a[i][j] *= is;
+
+    bool ok = true;
+    cd c[6];
+    int nc = 0;
+
+    switch(ctype)
+    {
+    case LINK_COMPRESS_12:
+      for(int j=0; j < 3; ++j)
+      {
+	c[nc++] = a[0][j];
+      }
+      for(int j=0; j < 3; ++j)
+      {
+	c[nc++] = a[1][j];
+      }
+      break;
+
+    case LINK_COMPRESS_8:
+      c[nc++] = a[0][1];
+      c[nc++] = a[0][2];
+      c[nc++] = a[1][0];
+      c[nc++] = cd(std::arg(a[0][0]), std::arg(a[2][0]));
+      ok = (s == cd(0.0)) || (std::norm(a[0][1]) + std::norm(a[0][2]) > 1.0e-12);
+      break;
+
+    default:
+      break;
+    }
+
+    for(int k=0; k < nc; ++k)
+    {
+      comp[k].elem(site).elem().elem().real() = c[k].real();
+      comp[k].elem(site).elem().elem().imag() = c[k].imag();
+    }
+
+    return ok;
+  }
+
+
+  // Rebuild one site
+  template<typename U>
+  inline void
+  CompressedLinksT<U>::reconstructSite(SiteMatrix_t& m, int site) const
+  {
+    typedef std::complex<REALT> cr;
+
+    if (ctype == LINK_COMPRESS_FIXED16)
+    {
+      const REALT sc = scale.elem(site).elem().elem().elem() * (REALT(1)/REALT(32767));
+      const short* d = &fixed[18*site];
+      for(int i=0; i < 3; ++i)
+	for(int j=0; j < 3; ++j)
+	{
+	  m.elem().elem(i,j).real() = sc * REALT(*d++);
+	  m.elem().elem(i,j).imag() = sc * REALT(*d++);
+	}
+      return;
+    }
+
+    cr c[6];
+    const int nc = (ctype == LINK_COMPRESS_12) ? 6 : 4;
+    for(int k=0; k < nc; ++k)
+      c[k] = cr(comp[k].elem(site).elem().elem().real(),
+		comp[k].elem(site).elem().elem().imag());
+
+    const cr s = s_index.empty() ? s_table[0] : s_table[s_index[site]];
+    cr v[3][3];
+
+    if (ctype == LINK_COMPRESS_12)
+    {
+      for(int j=0; j < 3; ++j)
+      {
+	v[0][j] = c[j];
+	v[1][j] = c[3+j];
+      }
+    }
+    else
+    {
+      const cr a2 = c[0];
+      const cr a3 = c[1];
+      const cr b1 = c[2];
+      const REALT n  = std::norm(a2) + std::norm(a3);
+      const REALT in = (n > REALT(0)) ? REALT(1)/n : REALT(0);
+
+      const cr a1 = std::polar(std::sqrt(std::max(REALT(0), REALT(1) - n)), c[3].real());
+      const cr c1 = std::polar(std::sqrt(std::max(REALT(0), n - std::norm(b1))), c[3].imag());
+
+      // Orthogonality of the rows and conj(V) = cofactor(V)
+      v[0][0] = a1;  v[0][1] = a2;  v[0][2] = a3;
+      v[1][0] = b1;
+      v[1][1] = in * (-std::conj(a1)*b1*a2 - std::conj(c1)*std::conj(a3));
+      v[1][2] = in * (-std::conj(a1)*b1*a3 + std::conj(c1)*std::conj(a2));
+    }
+
+    // r2 = conj(r0 x r1)
+    v[2][0] = std::conj(v[0][1]*v[1][2] - v[0][2]*v[1][1]);
+    v[2][1] = std::conj(v[0][2]*v[1][0] - v[0][0]*v[1][2]);
+    v[2][2] = std::conj(v[0][0]*v[1][1] - v[0][1]*v[1][0]);
+
+    for(int i=0; i < 3; ++i)
+      for(int j=0; j < 3; ++j)
+      {
+	const cr sv = s * v[i][j];
+	m.elem().elem(i,j).real() = sv.real();
+	m.elem().elem(i,j).imag() = sv.imag();
+      }
+  }
+
+
+  // Compress a field
+  template<typename U>
+  void
+  CompressedLinksT<U>::create(const U& u, LinkCompressType ctype_)
+  {
+    START_CODE();
+
+    ctype = ctype_;
+
+    comp.resize(0);
+    fixed.clear();
+    s_table.clear();
+    s_index.clear();
+
+    if (ctype == LINK_COMPRESS_NONE)
+    {
+      END_CODE();
+      return;
+    }
+
+    if (Nc != 3)
+    {
+      QDPIO::cerr << "CompressedLinks: only implemented for Nc=3" << std::endl;
+      QDP_abort(1);
+    }
+
+    const int nodeSites = Layout::sitesOnNode();
+    if (ctype == LINK_COMPRESS_FIXED16)
+      fixed.resize(18*nodeSites);
+    else
+    {
+      comp.resize((ctype == LINK_COMPRESS_12) ? 6 : 4);
+      s_index.resize(nodeSites);
+    }
+
+    int num_bad = 0;
+    for(int site=0; site < nodeSites; ++site)
+    {
+      if (! compressSite(u.elem(site), site))
+	++num_bad;
+
+      if (s_table.size() > 256)
+	break;
+    }
+
+    int too_many = (s_table.size() > 256) ? 1 : 0;
+    QDPInternal::globalSum(too_many);
+    if (too_many > 0)
+    {
+      QDPIO::cerr << "CompressedLinks: more than 256 distinct link scales s on a node."
+		  << " The links are not s*SU(3) with few values of s. Use NONE" << std::endl;
+      QDP_abort(1);
+    }
+
+    // A single scale needs no index
+    if (s_table.size() <= 1)
+      s_index.clear();
+
+    QDPInternal::globalSum(num_bad);
+    if (num_bad > 0)
+    {
+      QDPIO::cerr << "CompressedLinks: " << num_bad
+		  << " links can not be represented with 8 parameters. Use RECONSTRUCT_12" << std::endl;
+      QDP_abort(1);
+    }
+
+    // Check the round trip. This fails for links that are not s*SU(3)
+    {
+      U u_r;
+      uncompress(u_r);
+      Double nrm = norm2(u);
+      Double err = (toDouble(nrm) > 0) ? Double(sqrt(norm2(u_r - u)/nrm)) : Double(sqrt(norm2(u_r - u)));
+
+      if (toDouble(err) > 1.0e-4)
+      {
+	QDPIO::cerr << "CompressedLinks: relative reconstruction error = " << err
+		    << " : links are not of the form s*SU(3), s complex. Use NONE" << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    END_CODE();
+  }
+
+
+  // Uncompress a field
+  template<typename U>
+  void
+  CompressedLinksT<U>::uncompress(U& u) const
+  {
+    START_CODE();
+
+    if (ctype == LINK_COMPRESS_NONE)
+    {
+      QDPIO::cerr << "CompressedLinks: no compressed links held" << std::endl;
+      QDP_abort(1);
+    }
+
+    const int nodeSites = Layout::sitesOnNode();
+    for(int site=0; site < nodeSites; ++site)
+      reconstructSite(u.elem(site), site);
+
+    END_CODE();
+  }
+
+} // End Namespace Chroma
+
+
+#endif
@@ -5,10 +5,169 @@
 
 #include "chromabase.h"
 #include "util/gauge/eesu3.h"
+#include <complex>
 
 namespace Chroma 
 {
 
+#if ! defined(QDP_IS_QDPJIT)
+  /* A namespace to hide the thread dispatcher in */
+  namespace EESU3Env
+  {
+    typedef std::complex<double> DComplex_t;
+
+    struct EESU3Args
+    {
+      LatticeColorMatrix& u;        // updated (or overwritten by the exponential)
+      const LatticeColorMatrix& a;  // lie algebra element
+      double eps;
+      bool multiply;                // u <- exp(eps a) u, else u <- exp(eps a)
+    };
+
+    //! exp(iQ) of a hermitian traceless Q on one site
+    /*! Section III of hep-lat/0311018, with the small c1 expansion of
+     *  eesu3() and the f_j(-c0,c1) = (-1)^j f*_j(c0,c1) symmetry */
+    inline void expiQSite(DComplex_t e[3][3], const DComplex_t q[3][3])
+    {
+      DComplex_t qq[3][3];
+      for(int i=0; i < 3; ++i)
+	for(int j=0; j < 3; ++j)
+	  qq[i][j] = q[i][0]*q[0][j] + q[i][1]*q[1][j] + q[i][2]*q[2][j];
+
+      double tr_qqq = 0;
+      for(int i=0; i < 3; ++i)
+	for(int k=0; k < 3; ++k)
+	  tr_qqq += std::real(qq[i][k]*q[k][i]);
+
+      const double c0 = tr_qqq/3.0;
+      const double c1 = 0.5*std::real(qq[0][0] + qq[1][1] + qq[2][2]);
+
+      DComplex_t f0, f1, f2;
+      if (c1 > 1.0e-4)
+      {
+	const double c0abs = std::fabs(c0);
+	const double c0max = 2.0*std::pow(c1/3.0, 1.5);
+	double ratio = c0abs/c0max;
+	if (ratio > 1.0) ratio = 1.0;      // rounding near degenerate eigenvalues
+
+	const double theta = std::acos(ratio);
+	const double u     = std::sqrt(c1/3.0)*std::cos(theta/3.0);
+	const double w     = std::sqrt(c1)*std::sin(theta/3.0);
+	const double uu    = u*u;
+	const double ww    = w*w;
+	const double cosw  = std::cos(w);
+	const double xi0   = (std::fabs(w) > 0.05) ? std::sin(w)/w
+	  : 1.0 - (1.0/6.0)*ww*(1.0 - (1.0/20.0)*ww*(1.0 - (1.0/42.0)*ww));
+
+	const DComplex_t exp2iu(std::cos(2.0*u), std::sin(2.0*u));
+	const DComplex_t expmiu(std::cos(u), -std::sin(u));
+	const double denom = 9.0*uu - ww;
+
+	f0 = ((uu - ww)*exp2iu + expmiu*DComplex_t(8.0*uu*cosw, 2.0*u*(3.0*uu + ww)*xi0))/denom;
+	f1 = (2.0*u*exp2iu - expmiu*DComplex_t(2.0*u*cosw, (ww - 3.0*uu)*xi0))/denom;
+	f2 = (exp2iu - expmiu*DComplex_t(cosw, 3.0*u*xi0))/denom;
+
+	if (c0 < 0)
+	{
+	  f0 = std::conj(f0);
+	  f1 = -std::conj(f1);
+	  f2 = std::conj(f2);
+	}
+      }
+      else
+      {
+	f0 = DComplex_t(1.0 - c0*c0/720.0, -c0/6.0*(1.0 - c1/20.0*(1.0 - c1/42.0)));
+	f1 = DComplex_t(c0/24.0*(1.0 - c1/15.0*(1.0 - 3.0*c1/112.0)),
+			1.0 - c1/6.0*(1.0 - c1/20.0*(1.0 - c1/42.0)) - c0*c0/5040.0);
+	f2 = 0.5*DComplex_t(-1.0 + c1/12.0*(1.0 - c1/30.0*(1.0 - c1/56.0)) + c0*c0/20160.0,
+			    c0/60.0*(1.0 - c1/21.0*(1.0 - c1/48.0)));
+      }
+
+      for(int i=0; i < 3; ++i)
+	for(int j=0; j < 3; ++j)
+	  e[i][j] = f1*q[i][j] + f2*qq[i][j];
+
+      for(int i=0; i < 3; ++i)
+	e[i][i] += f0;
+    }
+
+    inline
+    void eesu3SiteLoop(int lo, int hi, int myId, EESU3Args* arg)
+    {
+      LatticeColorMatrix& u = arg->u;
+      const LatticeColorMatrix& a = arg->a;
+      const double eps = arg->eps;
+
+      for(int site=lo; site < hi; ++site)
+      {
+	// Q = -i eps a, so that exp(eps a) = exp(iQ)
+	DComplex_t q[3][3];
+	for(int i=0; i < 3; ++i)
+	  for(int j=0; j < 3; ++j)
+	  {
+	    const double re = a.elem(site).elem().elem(i,j).real();
+	    const double im = a.elem(site).elem().elem(i,j).imag();
+	    q[i][j] = DComplex_t(eps*im, -eps*re);
+	  }
+
+	DComplex_t e[3][3];
+	expiQSite(e, q);
+
+	if (arg->multiply)
+	{
+	  DComplex_t v[3][3];
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	      v[i][j] = DComplex_t(u.elem(site).elem().elem(i,j).real(),
+				   u.elem(site).elem().elem(i,j).imag());
+
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	    {
+	      DComplex_t r = e[i][0]*v[0][j] + e[i][1]*v[1][j] + e[i][2]*v[2][j];
+	      u.elem(site).elem().elem(i,j).real() = std::real(r);
+	      u.elem(site).elem().elem(i,j).imag() = std::imag(r);
+	    }
+	}
+	else
+	{
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	    {
+	      u.elem(site).elem().elem(i,j).real() = std::real(e[i][j]);
+	      u.elem(site).elem().elem(i,j).imag() = std::imag(e[i][j]);
+	    }
+	}
+      }
+    }
+  }
+#endif
+
+
+  //! Multiply a field by the exact exponential of a SU(3) lie algebra field
+  void eesu3Update(LatticeColorMatrix& u, const LatticeColorMatrix& a, const Real& eps)
+  {
+    START_CODE();
+
+    if (Nc != 3)
+    {
+      QDPIO::cerr << __func__ << ": only for Nc=3, here Nc=" << Nc << std::endl;
+      QDP_abort(1);
+    }
+
+#if defined(QDP_IS_QDPJIT)
+    LatticeColorMatrix e = eps*a;
+    eesu3(e);
+    LatticeColorMatrix tmp = e*u;
+    u = tmp;
+#else
+    EESU3Env::EESU3Args args = {u, a, toDouble(eps), true};
+    dispatch_to_threads(Layout::sitesOnNode(), args, EESU3Env::eesu3SiteLoop);
+#endif
+
+    END_CODE();
+  }
+
   //! Exact exponentiation of SU(3) matrix.
   /*!
    *  Input: 3x3 anti-Hermitian, traceless matrix iQ
@@ -21,6 +180,15 @@ namespace Chroma
   {
     START_CODE( );
 
+#if ! defined(QDP_IS_QDPJIT)
+    // Site by site in double precision
+    {
+      LatticeColorMatrix a = iQ;
+      EESU3Env::EESU3Args args = {iQ, a, 1.0, false};
+      dispatch_to_threads(Layout::sitesOnNode(), args, EESU3Env::eesu3SiteLoop);
+    }
+#else
+
     LatticeColorMatrix Q = timesMinusI(iQ);
 
     LatticeComplex f0, f1, f2;
@@ -92,6 +260,7 @@ namespace Chroma
 
     // Relpace Q by exp(iQ)
     // Q = expiQ;
+#endif
 
 
     END_CODE( );
@@ -16,6 +16,20 @@ namespace Chroma
    */
   void eesu3(LatticeColorMatrix& m);
 
+  //! Multiply a field by the exact exponential of a SU(3) lie algebra field
+  /*!
+   * \ingroup gauge
+   *
+   *  u <- exp(eps a) u, with exp(eps a) by Cayley-Hamilton in double
+   *  precision on each site. exp(eps a) is unitary to machine precision
+   *  when a is traceless anti-hermitian.
+   *
+   *  \param u        LatticeColorMatrix          (Modify)
+   *  \param a        LatticeColorMatrix          (Read)
+   *  \param eps      step                        (Read)
+   */
+  void eesu3Update(LatticeColorMatrix& u, const LatticeColorMatrix& a, const Real& eps);
+
 }  // end namespace Chroma
 
 #endif
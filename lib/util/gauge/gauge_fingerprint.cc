@@ -0,0 +1,93 @@
+/*! \file
+ *  \brief Fingerprint of a gauge configuration
+ */
+
+#include "chromabase.h"
+#include "util/gauge/gauge_fingerprint.h"
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+namespace Chroma
+{
+
+  // Fingerprint of a gauge configuration
+  std::string gaugeFingerprint(const multi1d<LatticeColorMatrix>& u)
+  {
+    START_CODE();
+
+#ifndef QDP_IS_QDPJIT
+    // The 64 bit site hashes are summed in four 16 bit lanes, exactly in
+    // double for up to 2^37 sites, so the result does not depend on the
+    // order of the sum over nodes
+    multi1d<REAL64> lanes(4);
+    lanes = 0;
+
+    const multi1d<int>& latt_size = Layout::lattSize();
+    const int nodeSites = Layout::sitesOnNode();
+
+    for(int site=0; site < nodeSites; ++site)
+    {
+      // Global lexicographic index of the site
+      multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), site);
+      unsigned long long gsite = 0;
+      for(int mu=Nd-1; mu >= 0; --mu)
+	gsite = gsite*latt_size[mu] + coord[mu];
+
+      // FNV-1a of the site index and the bytes of the links
+      unsigned long long h = 14695981039346656037ULL;
+      for(int b=0; b < 8; ++b)
+      {
+	h ^= (gsite >> (8*b)) & 0xff;
+	h *= 1099511628211ULL;
+      }
+
+      for(int mu=0; mu < u.size(); ++mu)
+      {
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(&(u[mu].elem(site)));
+	for(int b=0; b < sizeof(u[mu].elem(site)); ++b)
+	{
+	  h ^= p[b];
+	  h *= 1099511628211ULL;
+	}
+      }
+
+      for(int l=0; l < 4; ++l)
+	lanes[l] += REAL64((h >> (16*l)) & 0xffff);
+    }
+
+    QDPInternal::globalSumArray(lanes.slice(), lanes.size());
+
+    // Fold each lane to 16 bits
+    unsigned long long cksum = 0;
+    for(int l=0; l < 4; ++l)
+    {
+      unsigned long long v = (unsigned long long)(fmod(lanes[l], 65536.0));
+      cksum |= v << (16*l);
+    }
+
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << cksum;
+#else
+    // No site access: fall back to traces weighted by a site dependent
+    // phase, which still tells apart configurations and boundary conditions
+    LatticeReal w = zero;
+    for(int mu=0; mu < Nd; ++mu)
+      w += Real(mu+1) * Real(0.7071067811865476) * LatticeReal(Layout::latticeCoordinate(mu));
+
+    LatticeComplex ph = cmplx(cos(w), sin(w));
+
+    std::ostringstream os;
+    os << std::setprecision(15);
+    for(int mu=0; mu < u.size(); ++mu)
+    {
+      DComplex t = sum(ph * trace(u[mu]));
+      os << (mu == 0 ? "" : ":") << toDouble(real(t)) << ":" << toDouble(imag(t));
+    }
+#endif
+
+    END_CODE();
+    return os.str();
+  }
+
+} // namespace Chroma
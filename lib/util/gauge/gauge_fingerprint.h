@@ -0,0 +1,29 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Fingerprint of a gauge configuration
+ */
+
+#ifndef __gauge_fingerprint_h__
+#define __gauge_fingerprint_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+  //! Fingerprint of a gauge configuration
+  /*!
+   * \ingroup gauge
+   *
+   * A 64 bit checksum: each site's links (with the boundary conditions
+   * folded in) are hashed bit for bit together with the site's global
+   * index, and the site hashes are summed over the lattice. Any change
+   * of a single link changes it.
+   *
+   * Used to key data derived from a configuration: deflation spaces,
+   * multigrid hierarchies and displaced vectors.
+   */
+  std::string gaugeFingerprint(const multi1d<LatticeColorMatrix>& u);
+
+}
+
+#endif
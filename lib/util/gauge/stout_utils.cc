@@ -6,6 +6,7 @@
 #include "chroma_config.h"
 #include "chromabase.h"
 #include "util/gauge/stout_utils.h"
+#include "util/gauge/eesu3.h"
 
 //#if defined(BUILD_JIT_CLOVER_TERM)
 //#include "util/gauge/stout_utils_ptx.h"
@@ -180,96 +181,54 @@ namespace Chroma
       END_CODE();
     }
     
-    /*! \ingroup gauge */
-    // Do the force recursion from level i+1, to level i
-    // The input fat_force F is modified.
-    void deriv_recurse(multi1d<LatticeColorMatrix>& F,
-		       const multi1d<bool>& smear_in_this_dirP,
-		       const multi2d<Real>& rho,
-		       const multi1d<LatticeColorMatrix>& u)
+    //! Traceless hermitian Lambda_mu of eq 72 and the exp(iQ) part of the force
+    /*! F_mu is overwritten with F_plus_mu exp(iQ_mu), eq 75 first 3 terms */
+    static void derivLambda(LatticeColorMatrix& F_mu,
+			    LatticeColorMatrix& Lambda_mu,
+			    const LatticeColorMatrix& F_plus_mu,
+			    const LatticeColorMatrix& u_mu,
+			    const LatticeColorMatrix& Q,
+			    const LatticeColorMatrix& QQ,
+			    const LatticeColorMatrix& expiQ,
+			    const LatticeColorMatrix& B_1,
+			    const LatticeColorMatrix& B_2,
+			    const multi1d<LatticeComplex>& f)
     {
-      START_CODE();
-      
-      // Things I need
-      // C_{\mu} = staple multiplied appropriately by the rho
-      // Lambda matrices asper eq(73) 
-      multi1d<LatticeColorMatrix> F_plus(Nd);
-      
-      // Save the fat force
-      F_plus = F;
-      
-      
-      multi1d<LatticeColorMatrix> Lambda(Nd);
-      multi1d<LatticeColorMatrix> C(Nd);
-      
-      // The links at this level (unprimed in the paper).
-      //const multi1d<LatticeColorMatrix>& u = smeared_links[level];
-      
-      for(int mu=0; mu < Nd; mu++) 
-      {
-	if( smear_in_this_dirP[mu] ) 
-	{ 
-	  LatticeColorMatrix Q,QQ;   // This is the C U^{dag}_mu suitably antisymmetrized
-	  
-	  // Get Q, Q^2, C, c0 and c1 -- this code is the same as used in stout_smear()
-	  getQsandCs(u, Q, QQ, C[mu], mu, smear_in_this_dirP,rho);
-	  
-	  // Now work the f-s and b-s
-	  multi1d<LatticeComplex> f;
-	  multi1d<LatticeComplex> b_1;
-	  multi1d<LatticeComplex> b_2;
-	  
-	  // Get the fs and bs  -- does internal resize to make them arrays of length 3
-	  //	QDPIO::cout << __func__ << ": mu=" << mu << std::endl;
-	  getFsAndBs(Q,QQ, f, b_1, b_2, true);
-	  
-	  
-	  LatticeColorMatrix B_1 = b_1[0] + b_1[1]*Q + b_1[2]*QQ;
-	  LatticeColorMatrix B_2 = b_2[0] + b_2[1]*Q + b_2[2]*QQ;
-	  
-	  
-	  // Construct the Gamma ( eq 74 and 73 )
-	  LatticeColorMatrix USigma = u[mu]*F_plus[mu];
-	  LatticeColorMatrix Gamma = f[1]*USigma + f[2]*(USigma*Q + Q*USigma)
-	    + trace(B_1*USigma)*Q
-	    + trace(B_2*USigma)*QQ;
+      // Construct the Gamma ( eq 74 and 73 )
+      LatticeColorMatrix USigma = u_mu*F_plus_mu;
+      LatticeColorMatrix Gamma = f[1]*USigma + f[2]*(USigma*Q + Q*USigma)
+	+ trace(B_1*USigma)*Q
+	+ trace(B_2*USigma)*QQ;
 	  
-	  // Take the traceless hermitian part to form Lambda_mu (eq 72)
-	  Lambda[mu] = Gamma + adj(Gamma);    // Make it hermitian
-	  LatticeColorMatrix tmp3 = (Double(1)/Double(Nc))*trace(Lambda[mu]); // Subtract off the trace
-	  Lambda[mu] -= tmp3;
-	  Lambda[mu] *= Double(0.5);         // overall factor of 1/2
+      // Take the traceless hermitian part to form Lambda_mu (eq 72)
+      Lambda_mu = Gamma + adj(Gamma);    // Make it hermitian
+      LatticeColorMatrix tmp3 = (Double(1)/Double(Nc))*trace(Lambda_mu); // Subtract off the trace
+      Lambda_mu -= tmp3;
+      Lambda_mu *= Double(0.5);         // overall factor of 1/2
 	  
-	  // The first 3 terms of eq 75
-	  // Now the Fat force * the exp(iQ)
-	  F[mu]  = F_plus[mu]*(f[0] + f[1]*Q + f[2]*QQ);
-	  
-#if 0
-	  QDPIO::cout << __func__ << ": F[" << mu << "]= " << norm2(F[mu]) 
-		      << "  F_plus[mu]=" << norm2(F_plus[mu])
-		      << "  f[0]=" << norm2(f[0]) 
-		      << "  f[1]=" << norm2(f[1]) 
-		      << "  f[2]=" << norm2(f[2]) 
-		      << "  B_1=" << norm2(B_1) 
-		      << "  B_2=" << norm2(B_2) 
-		      << "  Q=" << norm2(Q) 
-		      << "  QQ=" << norm2(QQ) 
-		      << std::endl;
-#endif
-	  
-	} // End of if( smear_in_this_dirP[mu] )
-	// else what is in F_mu is the right force
-      }
-      
-      // At this point we should have 
-      //
-      //  F[mu] = F_plus[mu]*exp(iQ) 
-      //
-      //  We need the 8 staple terms left in dOmega/dU (last 6 terms in eq 75 + the iC{+}Lambda
-      //  term in eq 75 which in reality just covers 2 staples.
-      
-      //  We have to make this a separate loop from the above, because we need to know the 
-      //  Lambda[mu] and [nu] for all the avaliable mu-nu combinations
+      // The first 3 terms of eq 75
+      // Now the Fat force * the exp(iQ)
+      F_mu = F_plus_mu*expiQ;
+    }
+
+
+    //! The staple terms of eq 75
+    /*!
+     *  On entry F[mu] = F_plus[mu]*exp(iQ). 
+     *
+     *  We need the 8 staple terms left in dOmega/dU (last 6 terms in eq 75 + the iC{+}Lambda
+     *  term in eq 75 which in reality just covers 2 staples.
+     *
+     *  This has to be a separate loop from the Lambda one, because we need to know the 
+     *  Lambda[mu] and [nu] for all the avaliable mu-nu combinations
+     */
+    static void derivStaples(multi1d<LatticeColorMatrix>& F,
+			     const multi1d<LatticeColorMatrix>& Lambda,
+			     const multi1d<LatticeColorMatrix>& C,
+			     const multi1d<bool>& smear_in_this_dirP,
+			     const multi2d<Real>& rho,
+			     const multi1d<LatticeColorMatrix>& u)
+    {
       for(int mu = 0; mu < Nd; mu++) 
       { 
 	if( smear_in_this_dirP[mu] ) 
@@ -372,12 +331,103 @@ namespace Chroma
 	} // End of if(smear_in_this_dirP[mu]
 	// Else nothing needs done to the force
       } // end mu loop
+    }
+
+
+    /*! \ingroup gauge */
+    // Do the force recursion from level i+1, to level i
+    // The input fat_force F is modified.
+    void deriv_recurse(multi1d<LatticeColorMatrix>& F,
+		       const multi1d<bool>& smear_in_this_dirP,
+		       const multi2d<Real>& rho,
+		       const multi1d<LatticeColorMatrix>& u)
+    {
+      START_CODE();
+      
+      // Things I need
+      // C_{\mu} = staple multiplied appropriately by the rho
+      // Lambda matrices asper eq(73) 
+      multi1d<LatticeColorMatrix> F_plus(Nd);
+      
+      // Save the fat force
+      F_plus = F;
       
       
+      multi1d<LatticeColorMatrix> Lambda(Nd);
+      multi1d<LatticeColorMatrix> C(Nd);
+      
+      for(int mu=0; mu < Nd; mu++) 
+      {
+	if( smear_in_this_dirP[mu] ) 
+	{ 
+	  LatticeColorMatrix Q,QQ;   // This is the C U^{dag}_mu suitably antisymmetrized
+	  
+	  // Get Q, Q^2, C, c0 and c1 -- this code is the same as used in stout_smear()
+	  getQsandCs(u, Q, QQ, C[mu], mu, smear_in_this_dirP,rho);
+	  
+	  // exp(iQ), the B-s and the f-s in one go
+	  LatticeColorMatrix expiQ, B_1, B_2;
+	  multi1d<LatticeComplex> f;
+	  getExpiQAndBs(Q, QQ, expiQ, B_1, B_2, f);
+	  
+	  derivLambda(F[mu], Lambda[mu], F_plus[mu], u[mu], Q, QQ, expiQ, B_1, B_2, f);
+	} // End of if( smear_in_this_dirP[mu] )
+	// else what is in F_mu is the right force
+      }
+      
+      derivStaples(F, Lambda, C, smear_in_this_dirP, rho, u);
       
       // Done
       END_CODE();
     }
+
+
+    /*! \ingroup gauge */
+    // Do the force recursion from level i+1, to level i
+    // reusing Q, C, exp(iQ) and the B-s kept when this level was smeared.
+    // The input fat_force F is modified.
+    void deriv_recurse(multi1d<LatticeColorMatrix>& F,
+		       const multi1d<bool>& smear_in_this_dirP,
+		       const multi2d<Real>& rho,
+		       const multi1d<LatticeColorMatrix>& u,
+		       const StoutLevelCache& cache)
+    {
+      START_CODE();
+
+      if( cache.f.size() != Nd )
+      {
+	QDPIO::cerr << __func__ << ": stout level cache has not been filled" << std::endl;
+	QDP_abort(1);
+      }
+
+      multi1d<LatticeColorMatrix> F_plus(Nd);
+      F_plus = F;
+      
+      multi1d<LatticeColorMatrix> Lambda(Nd);
+      
+      for(int mu=0; mu < Nd; mu++) 
+      {
+	if( smear_in_this_dirP[mu] ) 
+	{ 
+	  const LatticeColorMatrix& Q = cache.Q[mu];
+	  const multi1d<LatticeComplex>& f = cache.f[mu];
+	  const multi1d<LatticeComplex>& b_1 = cache.b1[mu];
+	  const multi1d<LatticeComplex>& b_2 = cache.b2[mu];
+
+	  LatticeColorMatrix QQ = Q*Q;
+	  LatticeColorMatrix expiQ = f[0] + f[1]*Q + f[2]*QQ;
+	  LatticeColorMatrix B_1 = b_1[0] + b_1[1]*Q + b_1[2]*QQ;
+	  LatticeColorMatrix B_2 = b_2[0] + b_2[1]*Q + b_2[2]*QQ;
+
+	  derivLambda(F[mu], Lambda[mu], F_plus[mu], u[mu], 
+		      Q, QQ, expiQ, B_1, B_2, f);
+	}
+      }
+      
+      derivStaples(F, Lambda, cache.C, smear_in_this_dirP, rho, u);
+      
+      END_CODE();
+    }
      
     /*! \ingroup gauge */
     void getFs(const LatticeColorMatrix& Q,
@@ -949,17 +999,78 @@ namespace Chroma
 	  // Q contains the staple term. C is a throwaway
 	  getQs(current, Q, QQ, mu, smear_in_this_dirP, rho);
 	  
-	  // Now compute the f's
-	  multi1d<LatticeComplex> f;   // routine will resize these
-	  getFs(Q,QQ,f);   // This routine computes the f-s
+	  // Assemble the stout links exp(iQ)U_{mu} without the f-s
+	  LatticeColorMatrix iQ = timesI(Q);
+	  next[mu] = current[mu];
+	  eesu3Update(next[mu], iQ, Real(1));
+	}
+	else { 
+	  next[mu]=current[mu];  // Unsmeared
+	}
+	
+      }
+      
+      END_CODE();
+    }
+    
+
+    /*! \ingroup gauge */
+    void getExpiQAndBs(const LatticeColorMatrix& Q,
+		       const LatticeColorMatrix& QQ,
+		       LatticeColorMatrix& expiQ,
+		       LatticeColorMatrix& B1,
+		       LatticeColorMatrix& B2,
+		       multi1d<LatticeComplex>& f)
+    {
+      START_CODE();
+
+      multi1d<LatticeComplex> b_1;
+      multi1d<LatticeComplex> b_2;
+
+      // One site loop gives the f-s and the b-s together
+      getFsAndBs(Q, QQ, f, b_1, b_2, true);
+
+      expiQ = f[0] + f[1]*Q + f[2]*QQ;
+      B1 = b_1[0] + b_1[1]*Q + b_1[2]*QQ;
+      B2 = b_2[0] + b_2[1]*Q + b_2[2]*QQ;
+
+      END_CODE();
+    }
+
+
+    /*! \ingroup gauge */
+    void smear_links(const multi1d<LatticeColorMatrix>& current, 
+		     multi1d<LatticeColorMatrix>& next,
+		     const multi1d<bool>& smear_in_this_dirP,
+		     const multi2d<Real>& rho,
+		     StoutLevelCache& cache)
+    {
+      START_CODE();
+
+      cache.Q.resize(Nd);
+      cache.C.resize(Nd);
+      cache.f.resize(Nd);
+      cache.b1.resize(Nd);
+      cache.b2.resize(Nd);
+      
+      for(int mu = 0; mu < Nd; mu++) 
+      {
+	if( smear_in_this_dirP[mu] ) 
+	{
+	  // Keep the staples: the force recursion needs them
+	  LatticeColorMatrix QQ;
+	  getQsandCs(current, cache.Q[mu], QQ, cache.C[mu], mu, smear_in_this_dirP, rho);
+	  
+	  // The b-s come for free with the f-s
+	  getFsAndBs(cache.Q[mu], QQ, cache.f[mu], cache.b1[mu], cache.b2[mu], true);
 	  
 	  // Assemble the stout links exp(iQ)U_{mu} 
-	  next[mu]=(f[0] + f[1]*Q + f[2]*QQ)*current[mu];      
+	  const multi1d<LatticeComplex>& f = cache.f[mu];
+	  next[mu] = (f[0] + f[1]*cache.Q[mu] + f[2]*QQ)*current[mu];
 	}
 	else { 
 	  next[mu]=current[mu];  // Unsmeared
 	}
-	
       }
       
       END_CODE();
@@ -980,12 +1091,10 @@ namespace Chroma
       // Q contains the staple term. C is a throwaway
       getQs(current, Q, QQ, mu, smear_in_this_dirP, rho);
 	  
-      // Now compute the f's
-      multi1d<LatticeComplex> f;   // routine will resize these
-      getFs(Q,QQ,f);   // This routine computes the f-s
-	  
-      // Assemble the stout links exp(iQ)U_{mu} 
-      next = (f[0] + f[1]*Q + f[2]*QQ)*current[mu];      
+      // Assemble the stout links exp(iQ)U_{mu} without the f-s
+      LatticeColorMatrix iQ = timesI(Q);
+      next = current[mu];
+      eesu3Update(next, iQ, Real(1));
       
       END_CODE();
     }
@@ -49,6 +49,25 @@ namespace Chroma
   /*! \ingroup gauge */
   namespace Stouting 
   {
+    //! Per level quantities of the stout smearing reused by the force recursion
+    /*!
+     * Filled by the caching smear_links() when a level is smeared and read
+     * back by the caching deriv_recurse(), so the staples and the f and b
+     * coefficients of a level are built only once per thin field. Q^2,
+     * exp(iQ) and the B matrices are cheap site local products of these
+     * and are rebuilt in the recursion. That is 2 LatticeColorMatrix and
+     * 9 LatticeComplex per smeared direction and level.
+     * Only the entries of smeared directions are set.
+     */
+    struct StoutLevelCache
+    {
+      multi1d<LatticeColorMatrix> Q;      /*!< Q_mu */
+      multi1d<LatticeColorMatrix> C;      /*!< rho weighted staple sum C_mu */
+      multi1d< multi1d<LatticeComplex> > f;   /*!< f-coefficients */
+      multi1d< multi1d<LatticeComplex> > b1;  /*!< b1-coefficients */
+      multi1d< multi1d<LatticeComplex> > b2;  /*!< b2-coefficients */
+    };
+
     //! Given field U, form Q and Q^2
     void getQs(const multi1d<LatticeColorMatrix>& u, 
 	       LatticeColorMatrix& Q, 
@@ -81,6 +100,15 @@ namespace Chroma
 		    multi1d<LatticeComplex>& b2,
 		    bool do_bs=true);
     
+    //! Given Q and Q^2 form exp(iQ) and the B matrices in a single pass
+    /*! The f-s and b-s come out of one site loop. f is resized internally */
+    void getExpiQAndBs(const LatticeColorMatrix& Q,
+		       const LatticeColorMatrix& QQ,
+		       LatticeColorMatrix& expiQ,
+		       LatticeColorMatrix& B1,
+		       LatticeColorMatrix& B2,
+		       multi1d<LatticeComplex>& f);
+
     //! Stout smear in a specific link direction
     void stout_smear(LatticeColorMatrix& next,
 		     const multi1d<LatticeColorMatrix>& current, 
@@ -100,6 +128,20 @@ namespace Chroma
 		       const multi2d<Real>& rho,
 		       const multi1d<LatticeColorMatrix>& u);
 
+    //! Do the smearing from level i to level i+1 and keep what the force needs
+    void smear_links(const multi1d<LatticeColorMatrix>& current,
+		     multi1d<LatticeColorMatrix>& next, 
+		     const multi1d<bool>& smear_in_this_dirP,
+		     const multi2d<Real>& rho,
+		     StoutLevelCache& cache);
+    
+    //! Do the force recursion from level i+1, to level i using a filled cache
+    void deriv_recurse(multi1d<LatticeColorMatrix>&  F,
+		       const multi1d<bool>& smear_in_this_dirP,
+		       const multi2d<Real>& rho,
+		       const multi1d<LatticeColorMatrix>& u,
+		       const StoutLevelCache& cache);
+
   }
 
   /*! @} */   // end of group gauge
@@ -27,6 +27,9 @@ namespace Chroma
     int           repro_check_frequency;
     bool          rev_checkP;
     int           rev_check_frequency;
+    bool          step_checkP;
+    int           step_check_frequency;
+    int           inflight_checkpoint_interval;
     bool          monitorForcesP;
 
   };
@@ -98,6 +101,32 @@ namespace Chroma
 	}
       }
 
+      // Single step checks are off by default. A check integrates the
+      // steps up to a randomly chosen one again, half a trajectory on average
+      p.step_checkP = false;
+      p.step_check_frequency = 1;
+
+      if( paramtop.count("./StepCheckP") == 1 ) {
+	read(paramtop, "./StepCheckP", p.step_checkP);
+      }
+
+      if( p.step_checkP ) { 
+	if( paramtop.count("./StepCheckFrequency") == 1 ) {
+	  read(paramtop, "./StepCheckFrequency", p.step_check_frequency);
+	}
+
+	if( p.step_check_frequency < 1 ) { 
+	  QDPIO::cerr << "StepCheckFrequency must be at least 1. It is " << p.step_check_frequency << std::endl;
+	  QDP_abort(1);
+	}
+      }
+
+      // In-flight checkpoints of trajectories: off by default
+      p.inflight_checkpoint_interval = 0;
+      if( paramtop.count("./InFlightCheckpointInterval") == 1 ) {
+	read(paramtop, "./InFlightCheckpointInterval", p.inflight_checkpoint_interval);
+      }
+
       if( paramtop.count("./MonitorForces") == 1 ) {
 	read(paramtop, "./MonitorForces", p.monitorForcesP);
       }
@@ -158,6 +187,13 @@ namespace Chroma
       if( p.rev_checkP ) { 
 	write(xml, "ReverseCheckFrequency", p.rev_check_frequency);
       }
+      write(xml, "StepCheckP", p.step_checkP);
+      if( p.step_checkP ) { 
+	write(xml, "StepCheckFrequency", p.step_check_frequency);
+      }
+      if( p.inflight_checkpoint_interval > 0 ) { 
+	write(xml, "InFlightCheckpointInterval", p.inflight_checkpoint_interval);
+      }
       write(xml, "MonitorForces", p.monitorForcesP);
 
       xml << p.inline_measurement_xml;
@@ -366,6 +402,7 @@ namespace Chroma
     // Turn monitoring off/on
     QDPIO::cout << "Setting Force monitoring to " << mc_control.monitorForcesP  << std::endl;
     setForceMonitoring(mc_control.monitorForcesP) ;
+
     QDP::StopWatch swatch;
 
     XMLWriter& xml_out = TheXMLOutputWriter::Instance();
@@ -439,6 +476,15 @@ namespace Chroma
 	  QDPIO::cout << "Doing Reversibility Test this traj" << std::endl;
 	}
 
+	LCMMDIntegratorSteps::theTrajCheckpointer::Instance().setTrajectory(cur_update);
+
+	bool do_step_check = false;
+	if( mc_control.step_checkP 
+	    && ( cur_update % mc_control.step_check_frequency == 0 )) {
+	  do_step_check = true;
+	  QDPIO::cout << "Doing single step checks this traj" << std::endl;
+	}
+
 
 	// Check if I need to do any reproducibility testing
 	if( mc_control.repro_checkP 
@@ -459,7 +505,7 @@ namespace Chroma
 	  swatch.start();
 
 	  // This may do a reversibility check 
-	  theHMCTrj( gauge_state, warm_up_p, do_reverse ); 
+	  theHMCTrj( gauge_state, warm_up_p, do_reverse, do_step_check ); 
 	  swatch.stop(); 
 	  
 	  QDPIO::cout << "After HMC trajectory call: time= "
@@ -532,7 +578,7 @@ namespace Chroma
 	  QDPIO::cout << "Before HMC trajectory call" << std::endl;
 	  swatch.reset();
 	  swatch.start();
-	  theHMCTrj( gauge_state, warm_up_p, do_reverse  );
+	  theHMCTrj( gauge_state, warm_up_p, do_reverse, do_step_check );
 	  swatch.stop();
 	
 	  QDPIO::cout << "After HMC trajectory call: time= "
@@ -831,6 +877,11 @@ int main(int argc, char *argv[])
     multi1d<LatticeColorMatrix> > > H_MC(new ExactHamiltonian(ham_params));
  
 
+  // Snapshots during trajectories, and resuming the first one from them.
+  // Set up before the integrator, which checks that it can make them
+  LCMMDIntegratorSteps::theTrajCheckpointer::Instance().setup(mc_control.inflight_checkpoint_interval,
+							       mc_control.save_prefix);
+
   std::istringstream MDInt_is(trj_params.Integrator_xml);
   XMLReader MDInt_xml(MDInt_is);
   LCMToplevelIntegratorParams int_par(MDInt_xml, "/MDIntegrator");
@@ -0,0 +1,181 @@
+/*! \file
+ *  \brief Test the block multishift force of the one flavor rational monomial
+ *
+ *  The force with BlockSolve must agree with the force computed one
+ *  pseudofermion at a time, to the accuracy of the solver.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+
+#include "chroma.h"
+
+using namespace Chroma;
+
+//! To insure linking of code, place the registered code flags here
+/*! This is the bit of code that dictates what fermacts are in use */
+bool linkageHack(void)
+{
+  bool foo = true;
+
+  // Ferm Monomials
+  foo &= WilsonTypeFermMonomialAggregrateEnv::registerAll();
+
+  return foo;
+}
+
+
+//! The XML of a one flavor rational monomial
+std::string monomialXML(bool block_solve)
+{
+  std::ostringstream os;
+
+  os << "<?xml version=\"1.0\"?>"
+     << "<Monomial>"
+     << "<Name>ONE_FLAVOR_EOPREC_CONSTDET_FERM_RAT_MONOMIAL</Name>"
+     << "<num_pf>3</num_pf>"
+     << "<BlockSolve>" << (block_solve ? "true" : "false") << "</BlockSolve>"
+     << "<Action>"
+     << "<FermionAction>"
+     << "<FermAct>CLOVER</FermAct>"
+     << "<Kappa>0.115</Kappa>"
+     << "<clovCoeff>1.17</clovCoeff>"
+     << "<FermState>"
+     << "<Name>SIMPLE_FERM_STATE</Name>"
+     << "<FermionBC>"
+     << "<FermBC>SIMPLE_FERMBC</FermBC>"
+     << "<boundary>1 1 1 -1</boundary>"
+     << "</FermionBC>"
+     << "</FermState>"
+     << "</FermionAction>"
+     << "<ActionApprox>"
+     << "<RationalApprox>"
+     << "<ratApproxType>REMEZ</ratApproxType>"
+     << "<numPower>-1</numPower>"
+     << "<denPower>6</denPower>"
+     << "<lowerMin>0.01</lowerMin>"
+     << "<upperMax>40</upperMax>"
+     << "<degree>10</degree>"
+     << "</RationalApprox>"
+     << "<InvertParam>"
+     << "<invType>CG_INVERTER</invType>"
+     << "<RsdCG>1.0e-12</RsdCG>"
+     << "<MaxCG>2000</MaxCG>"
+     << "</InvertParam>"
+     << "</ActionApprox>"
+     << "<ForceApprox>"
+     << "<RationalApprox>"
+     << "<ratApproxType>REMEZ</ratApproxType>"
+     << "<numPower>-1</numPower>"
+     << "<denPower>3</denPower>"
+     << "<lowerMin>0.01</lowerMin>"
+     << "<upperMax>40</upperMax>"
+     << "<degree>8</degree>"
+     << "</RationalApprox>"
+     << "<InvertParam>"
+     << "<invType>CG_INVERTER</invType>"
+     << "<RsdCG>1.0e-12</RsdCG>"
+     << "<MaxCG>2000</MaxCG>"
+     << "</InvertParam>"
+     << "</ForceApprox>"
+     << "</Action>"
+     << "</Monomial>";
+
+  return os.str();
+}
+
+
+//! Create the monomial
+Handle< Monomial< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > >
+createMonomial(bool block_solve)
+{
+  std::istringstream is(monomialXML(block_solve));
+  XMLReader xml(is);
+
+  std::string monomial_name;
+  read(xml, "/Monomial/Name", monomial_name);
+
+  return Handle< Monomial< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > >(
+    TheMonomialFactory::Instance().createObject(monomial_name, xml, "/Monomial"));
+}
+
+
+int main(int argc, char *argv[])
+{
+  Chroma::initialize(&argc, &argv);
+
+  START_CODE();
+
+  QDPIO::cout << "Linkage = " << linkageHack() << std::endl;
+
+  const int foo[] = {4,4,4,8};
+  multi1d<int> nrow(Nd);
+  nrow = foo;
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter& xml_out = Chroma::getXMLOutputInstance();
+  push(xml_out, "t_block_rat_force");
+
+  // A rough gauge field
+  multi1d<LatticeColorMatrix> u(Nd);
+  multi1d<LatticeColorMatrix> p(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    gaussian(u[mu]);
+    reunit(u[mu]);
+
+    gaussian(p[mu]);
+    p[mu] *= sqrt(0.5);
+    taproj(p[mu]);
+  }
+
+  GaugeFieldState gauge_state(p,u);
+
+  typedef multi1d<LatticeColorMatrix> P;
+  typedef multi1d<LatticeColorMatrix> Q;
+
+  Handle< Monomial<P,Q> > mon_block = createMonomial(true);
+  Handle< Monomial<P,Q> > mon_serial = createMonomial(false);
+
+  // Same pseudofermions in both
+  QDP::Seed ran_seed;
+  QDP::RNG::savern(ran_seed);
+
+  mon_block->refreshInternalFields(gauge_state);
+
+  QDP::RNG::setrn(ran_seed);
+  mon_serial->refreshInternalFields(gauge_state);
+
+  P F_block;
+  P F_serial;
+  mon_block->dsdq(F_block, gauge_state);
+  mon_serial->dsdq(F_serial, gauge_state);
+
+  Double f_norm = zero;
+  Double diff_norm = zero;
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    f_norm += norm2(F_serial[mu]);
+    diff_norm += norm2(F_block[mu] - F_serial[mu]);
+  }
+
+  Double rel_diff = sqrt(diff_norm / f_norm);
+
+  QDPIO::cout << "|F_serial| = " << sqrt(f_norm)
+	      << "  |F_block - F_serial| / |F_serial| = " << rel_diff << std::endl;
+
+  write(xml_out, "f_norm", sqrt(f_norm));
+  write(xml_out, "rel_diff", rel_diff);
+  pop(xml_out);
+
+  // Each solution is good to RsdCG, so the forces agree to about that
+  bool passP = toBool(rel_diff < Double(1.0e-8));
+  QDPIO::cout << (passP ? "PASSED" : "FAILED") << std::endl;
+
+  END_CODE();
+
+  Chroma::finalize();
+  return passP ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/*! \file
+ *  \brief Test the fused multipole derivative of the Wilson dslash
+ *
+ *  derivMultipole over N pairs of vectors must equal the sum of the N
+ *  single pair deriv calls, for the dslash on either checkerboard and
+ *  on the whole lattice, and for the even-odd Wilson and clover
+ *  operators built on it.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+
+#include "chroma.h"
+
+using namespace Chroma;
+
+typedef LatticeFermion T;
+typedef multi1d<LatticeColorMatrix> P;
+typedef multi1d<LatticeColorMatrix> Q;
+
+
+//! Relative difference of two forces
+Double relDiff(const P& a, const P& b)
+{
+  Double diff = zero;
+  Double nrm = zero;
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    diff += norm2(a[mu] - b[mu]);
+    nrm  += norm2(b[mu]);
+  }
+
+  return sqrt(diff / nrm);
+}
+
+
+//! Add ds_1 to ds_u, resizing ds_u on first use
+void accum(P& ds_u, const P& ds_1)
+{
+  if (ds_u.size() == 0)
+  {
+    ds_u = ds_1;
+    return;
+  }
+
+  for(int mu=0; mu < Nd; ++mu)
+    ds_u[mu] += ds_1[mu];
+}
+
+
+//! Print one comparison and return whether it passed
+bool report(const std::string& what, enum PlusMinus isign, const Double& d, const Double& tol)
+{
+  bool passP = toBool(d < tol);
+  QDPIO::cout << what << (isign == PLUS ? " PLUS " : " MINUS")
+	      << "  |multipole - sum of deriv| / |sum| = " << d
+	      << (passP ? "  ok" : "  FAILED") << std::endl;
+  return passP;
+}
+
+
+//! Compare the dslash derivatives
+bool checkDslash(const WilsonDslash& D, const multi1d<T>& chi, const multi1d<T>& psi,
+		 const Double& tol)
+{
+  bool passP = true;
+  const int N = chi.size();
+
+  for(int s=0; s < 2; ++s)
+  {
+    enum PlusMinus isign = (s == 0) ? PLUS : MINUS;
+
+    // Per checkerboard
+    for(int cb=0; cb < 2; ++cb)
+    {
+      P ds_mp, ds_sum, ds_1;
+      D.derivMultipole(ds_mp, chi, psi, isign, cb);
+      for(int n=0; n < N; ++n)
+      {
+	D.deriv(ds_1, chi[n], psi[n], isign, cb);
+	accum(ds_sum, ds_1);
+      }
+
+      std::ostringstream what;
+      what << "WilsonDslash cb=" << cb;
+      passP &= report(what.str(), isign, relDiff(ds_mp, ds_sum), tol);
+    }
+
+    // Whole lattice
+    {
+      P ds_mp, ds_sum, ds_1;
+      D.derivMultipole(ds_mp, chi, psi, isign);
+      for(int n=0; n < N; ++n)
+      {
+	D.deriv(ds_1, chi[n], psi[n], isign);
+	accum(ds_sum, ds_1);
+      }
+
+      passP &= report("WilsonDslash all ", isign, relDiff(ds_mp, ds_sum), tol);
+    }
+  }
+
+  return passP;
+}
+
+
+//! Compare the derivatives of an even-odd operator
+bool checkLinOp(const std::string& what, const DiffLinearOperator<T,P,Q>& M,
+		const multi1d<T>& chi, const multi1d<T>& psi, const Double& tol)
+{
+  bool passP = true;
+  const int N = chi.size();
+
+  for(int s=0; s < 2; ++s)
+  {
+    enum PlusMinus isign = (s == 0) ? PLUS : MINUS;
+
+    P ds_mp, ds_sum, ds_1;
+    M.derivMultipole(ds_mp, chi, psi, isign);
+    for(int n=0; n < N; ++n)
+    {
+      M.deriv(ds_1, chi[n], psi[n], isign);
+      accum(ds_sum, ds_1);
+    }
+
+    passP &= report(what, isign, relDiff(ds_mp, ds_sum), tol);
+  }
+
+  return passP;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Chroma::initialize(&argc, &argv);
+
+  START_CODE();
+
+  const int foo[] = {4,4,4,8};
+  multi1d<int> nrow(Nd);
+  nrow = foo;
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  // A rough gauge field
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    gaussian(u[mu]);
+    reunit(u[mu]);
+  }
+
+  multi1d<int> boundary(Nd);
+  boundary = 1;
+  boundary[Nd-1] = -1;
+  Handle< FermBC<T,P,Q> > fbc(new SimpleFermBC<T,P,Q>(boundary));
+  Handle< FermState<T,P,Q> > state(new SimpleFermState<T,P,Q>(fbc, u));
+
+  // Five poles
+  const int N = 5;
+  multi1d<T> chi(N);
+  multi1d<T> psi(N);
+  for(int n=0; n < N; ++n)
+  {
+    gaussian(chi[n]);
+    gaussian(psi[n]);
+  }
+
+#if BASE_PRECISION == 32
+  const Double tol = 1.0e-5;
+#else
+  const Double tol = 1.0e-12;
+#endif
+
+  bool passP = true;
+
+  WilsonDslash D(state);
+  passP &= checkDslash(D, chi, psi, tol);
+
+  EvenOddPrecWilsonLinOp M_wils(state, Real(0.1));
+  passP &= checkLinOp("EvenOddPrecWilsonLinOp", M_wils, chi, psi, tol);
+
+  CloverFermActParams clov;
+  clov.Mass = Real(0.1);
+  clov.clovCoeffR = Real(1.17);
+  clov.clovCoeffT = Real(1.17);
+  clov.twisted_m_usedP = false;
+  EvenOddPrecCloverLinOp M_clov(state, clov);
+  passP &= checkLinOp("EvenOddPrecCloverLinOp", M_clov, chi, psi, tol);
+
+  QDPIO::cout << (passP ? "PASSED" : "FAILED") << std::endl;
+
+  END_CODE();
+
+  Chroma::finalize();
+  return passP ? 0 : 1;
+}
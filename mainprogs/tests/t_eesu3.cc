@@ -0,0 +1,130 @@
+/*! \file
+ *  \brief Test the site-local SU(3) exponential link update
+ *
+ *  eesu3Update(u, a, eps) must agree with  exp(eps a) u, both for steps
+ *  large enough for the closed form and for steps so small that the
+ *  expansion in c1 is used, and must stay unitary. The reference
+ *  exponential is a Taylor series with scaling and squaring, which
+ *  shares no code with eesu3.
+ */
+
+#include <iostream>
+#include <cstdio>
+
+#include "chroma.h"
+
+using namespace Chroma;
+
+
+//! exp(m) by the 12-th order series of m/2^k, squared k times
+/*! For the steps here |m/2^k| < 0.5, where the truncation is below 1e-13 */
+void expmRef(LatticeColorMatrix& m)
+{
+  const int k = 4;
+  m *= Real(1.0/16.0);
+  expm12(m);
+
+  for(int i=0; i < k; ++i)
+  {
+    LatticeColorMatrix tmp = m*m;
+    m = tmp;
+  }
+}
+
+
+//! Relative difference of eesu3Update and the series for the step eps
+bool checkStep(const multi1d<LatticeColorMatrix>& u,
+	       const multi1d<LatticeColorMatrix>& a,
+	       const Real& eps, const Double& tol)
+{
+  Double diff_norm = zero;
+  Double ref_norm = zero;
+  Double unit_norm = zero;
+
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    // The reference: u <- exp(eps a) u
+    LatticeColorMatrix e = eps*a[mu];
+    expmRef(e);
+    LatticeColorMatrix u_ref = e*u[mu];
+
+    LatticeColorMatrix u_new = u[mu];
+    eesu3Update(u_new, a[mu], eps);
+
+    diff_norm += norm2(u_new - u_ref);
+    ref_norm  += norm2(u_ref);
+
+    LatticeColorMatrix one = 1.0;
+    unit_norm += norm2(adj(u_new)*u_new - one);
+  }
+
+  Double rel_diff = sqrt(diff_norm / ref_norm);
+  Double unit_dev = sqrt(unit_norm / Double(Nd*Layout::vol()));
+
+  QDPIO::cout << "eps = " << eps
+	      << "  |eesu3Update - series| / |series| = " << rel_diff
+	      << "  unitarity deviation per link = " << unit_dev << std::endl;
+
+  return toBool(rel_diff < tol) && toBool(unit_dev < tol);
+}
+
+
+int main(int argc, char *argv[])
+{
+  Chroma::initialize(&argc, &argv);
+
+#if QDP_NC == 3
+  START_CODE();
+
+  const int foo[] = {4,4,4,4};
+  multi1d<int> nrow(Nd);
+  nrow = foo;
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  // Random links and traceless anti-hermitian momenta
+  multi1d<LatticeColorMatrix> u(Nd);
+  multi1d<LatticeColorMatrix> a(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    gaussian(u[mu]);
+    reunit(u[mu]);
+
+    gaussian(a[mu]);
+    taproj(a[mu]);
+  }
+
+#if BASE_PRECISION == 32
+  const Double tol = 1.0e-5;
+#else
+  const Double tol = 1.0e-11;
+#endif
+
+  bool passP = true;
+
+  // Large steps: the closed form in c0, c1
+  passP &= checkStep(u, a, Real(1.0), tol);
+  passP &= checkStep(u, a, Real(0.1), tol);
+
+  // c1 about the cutoff of 1e-4: both forms on different sites
+  passP &= checkStep(u, a, Real(5.0e-3), tol);
+
+  // Steps small enough that c1 < 1e-4 everywhere: the expansion in c1
+  passP &= checkStep(u, a, Real(1.0e-3), tol);
+  passP &= checkStep(u, a, Real(1.0e-5), tol);
+
+  // And backwards, so c0 changes sign
+  passP &= checkStep(u, a, Real(-0.1), tol);
+  passP &= checkStep(u, a, Real(-1.0e-3), tol);
+
+  QDPIO::cout << (passP ? "PASSED" : "FAILED") << std::endl;
+
+  END_CODE();
+
+  Chroma::finalize();
+  return passP ? 0 : 1;
+#else
+  Chroma::finalize();
+  return 0;
+#endif
+}
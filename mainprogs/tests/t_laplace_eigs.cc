@@ -0,0 +1,167 @@
+/*! \file
+ *  \brief Test the block Chebyshev eigensolver of LAPLACE_EIGS
+ *
+ *  The lowest eigenvalues of -Laplacian on every time slice found by
+ *  BLOCK_CHEBYSHEV must agree with those of the Lanczos method.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+
+#include "chroma.h"
+#include "meas/inline/hadron/inline_laplace_eigs.h"
+
+using namespace Chroma;
+
+//! To insure linking of code, place the registered code flags here
+bool linkageHack(void)
+{
+  bool foo = true;
+
+  foo &= InlineLaplaceEigsEnv::registerAll();
+  foo &= LinkSmearingEnv::registerAll();
+
+  return foo;
+}
+
+
+//! The XML of a LAPLACE_EIGS measurement
+std::string measXML(const std::string& method, int num_vecs, const std::string& colorvec_id)
+{
+  std::ostringstream os;
+
+  os << "<?xml version=\"1.0\"?>"
+     << "<elem>"
+     << "<Name>LAPLACE_EIGS</Name>"
+     << "<Frequency>1</Frequency>"
+     << "<Param>"
+     << "<num_vecs>" << num_vecs << "</num_vecs>"
+     << "<decay_dir>" << Nd-1 << "</decay_dir>"
+     << "<max_iter>200</max_iter>"
+     << "<tol>1.0e-8</tol>"
+     << "<method>" << method << "</method>"
+     << "<LinkSmearing><LinkSmearingType>NONE</LinkSmearingType></LinkSmearing>"
+     << "</Param>"
+     << "<NamedObject>"
+     << "<gauge_id>default_gauge_field</gauge_id>"
+     << "<colorvec_id>" << colorvec_id << "</colorvec_id>"
+     << "<ColorVecMapObject><MapObjType>MAP_OBJECT_MEMORY</MapObjType></ColorVecMapObject>"
+     << "</NamedObject>"
+     << "</elem>";
+
+  return os.str();
+}
+
+
+//! Run LAPLACE_EIGS and return the eigenvalues [k][t]
+multi1d< multi1d<Real> > laplaceEigs(const std::string& method, int num_vecs)
+{
+  const std::string colorvec_id = "eigs_" + method;
+
+  std::istringstream is(measXML(method, num_vecs, colorvec_id));
+  XMLReader xml(is);
+
+  InlineLaplaceEigsEnv::InlineMeas meas(InlineLaplaceEigsEnv::Params(xml, "/elem"));
+
+  XMLBufferWriter xml_out;
+  meas(0, xml_out);
+
+  QDP::MapObject<int,EVPair<LatticeColorVector> >& color_vecs =
+    *(TheNamedObjMap::Instance().getData< Handle< QDP::MapObject<int,EVPair<LatticeColorVector> > > >(colorvec_id));
+
+  multi1d< multi1d<Real> > evals(num_vecs);
+  for(int k=0; k < num_vecs; ++k)
+  {
+    EVPair<LatticeColorVector> ev;
+    color_vecs.get(k, ev);
+    evals[k] = ev.eigenValue.weights;
+  }
+
+  TheNamedObjMap::Instance().erase(colorvec_id);
+
+  return evals;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Chroma::initialize(&argc, &argv);
+
+#if ! defined(QDP_IS_QDPJIT)
+  START_CODE();
+
+  QDPIO::cout << "Linkage = " << linkageHack() << std::endl;
+
+  const int foo[] = {4,4,4,4};
+  multi1d<int> nrow(Nd);
+  nrow = foo;
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  // A rough gauge field
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+  {
+    gaussian(u[mu]);
+    reunit(u[mu]);
+  }
+
+  {
+    XMLBufferWriter file_xml, record_xml;
+    push(file_xml, "gauge");
+    write(file_xml, "id", int(0));
+    pop(file_xml);
+    push(record_xml, "gauge");
+    write(record_xml, "id", int(0));
+    pop(record_xml);
+
+    TheNamedObjMap::Instance().create< multi1d<LatticeColorMatrix> >("default_gauge_field");
+    TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >("default_gauge_field") = u;
+    TheNamedObjMap::Instance().get("default_gauge_field").setFileXML(file_xml);
+    TheNamedObjMap::Instance().get("default_gauge_field").setRecordXML(record_xml);
+  }
+
+  // The Krylov space of Lanczos is 3*num_vecs: ask for more than are
+  // compared, so the compared ones are well converged
+  const int num_cmp = 4;
+  multi1d< multi1d<Real> > evals_lanczos = laplaceEigs("LANCZOS", 3*num_cmp);
+  multi1d< multi1d<Real> > evals_cheb = laplaceEigs("BLOCK_CHEBYSHEV", num_cmp);
+
+#if BASE_PRECISION == 32
+  const Double tol = 1.0e-4;
+#else
+  const Double tol = 1.0e-6;
+#endif
+
+  bool passP = true;
+  for(int k=0; k < num_cmp; ++k)
+  {
+    Double diff = zero;
+    for(int t=0; t < evals_cheb[k].size(); ++t)
+    {
+      Double d = fabs(evals_cheb[k][t] - evals_lanczos[k][t]) / evals_lanczos[k][t];
+      if (toBool(d > diff))
+	diff = d;
+    }
+
+    bool okP = toBool(diff < tol);
+    passP &= okP;
+
+    QDPIO::cout << "k = " << k << "  lanczos[t=0] = " << evals_lanczos[k][0]
+		<< "  block chebyshev[t=0] = " << evals_cheb[k][0]
+		<< "  max relative difference = " << diff
+		<< (okP ? "  ok" : "  FAILED") << std::endl;
+  }
+
+  QDPIO::cout << (passP ? "PASSED" : "FAILED") << std::endl;
+
+  END_CODE();
+
+  Chroma::finalize();
+  return passP ? 0 : 1;
+#else
+  Chroma::finalize();
+  return 0;
+#endif
+}
@@ -0,0 +1,148 @@
+/*! \file
+ *  \brief Test the separable momentum projection of SftMom
+ *
+ *  With use_fft the projections, and the phases built on demand, must
+ *  agree with those from the phase table, also with an origin offset,
+ *  a momentum offset and momentum averaging.
+ */
+
+#include <iostream>
+#include <cstdio>
+
+#include "chroma.h"
+
+using namespace Chroma;
+
+
+//! Largest difference of two projections relative to the largest entry
+Double relDiff(const multi2d<DComplex>& a, const multi2d<DComplex>& b)
+{
+  Double diff = zero;
+  Double big = zero;
+
+  for(int m=0; m < a.size2(); ++m)
+    for(int t=0; t < a.size1(); ++t)
+    {
+      DComplex dc = a[m][t] - b[m][t];
+      Double d = sqrt(real(dc)*real(dc) + imag(dc)*imag(dc));
+      Double n = sqrt(real(b[m][t])*real(b[m][t]) + imag(b[m][t])*imag(b[m][t]));
+      if (toBool(d > diff))
+	diff = d;
+      if (toBool(n > big))
+	big = n;
+    }
+
+  return diff / big;
+}
+
+
+//! Compare the table and the separable transform for one set of parameters
+bool checkParams(const SftMomParams_t& p, const LatticeComplex& cf, const Double& tol)
+{
+  SftMomParams_t p_fft = p;
+  p_fft.use_fft = true;
+
+  SftMom table(p);
+  SftMom fft(p_fft);
+
+  if (table.numMom() != fft.numMom())
+  {
+    QDPIO::cout << "numMom differs: " << table.numMom() << " " << fft.numMom() << std::endl;
+    return false;
+  }
+
+  bool passP = true;
+
+  // All time slices
+  Double d_all = relDiff(fft.sft(cf), table.sft(cf));
+  passP &= toBool(d_all < tol);
+
+  // One time slice
+  const int t_slice = 1;
+  Double d_slice = relDiff(fft.sft(cf, t_slice), table.sft(cf, t_slice));
+  passP &= toBool(d_slice < tol);
+
+  // The phases built on demand. Hold two at once: the first must not
+  // change when the second is built
+  Double d_phase = zero;
+  for(int m=0; m < table.numMom(); ++m)
+  {
+    const LatticeComplex& ph_m = fft[m];
+    const LatticeComplex& ph_0 = fft[0];
+
+    Double d = sqrt(norm2(ph_m - table[m]) / norm2(table[m]))
+      + sqrt(norm2(ph_0 - table[0]) / norm2(table[0]));
+    if (toBool(d > d_phase))
+      d_phase = d;
+  }
+  passP &= toBool(d_phase < tol);
+
+  QDPIO::cout << "mom2_max = " << p.mom2_max
+	      << " avg_equiv_mom = " << p.avg_equiv_mom
+	      << " origin_offset = " << p.origin_offset[0] << " " << p.origin_offset[1]
+	      << " " << p.origin_offset[2] << " " << p.origin_offset[3]
+	      << " : sft " << d_all << "  slice " << d_slice << "  phases " << d_phase
+	      << (passP ? "  ok" : "  FAILED") << std::endl;
+
+  return passP;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Chroma::initialize(&argc, &argv);
+
+  START_CODE();
+
+  const int foo[] = {4,6,4,8};
+  multi1d<int> nrow(Nd);
+  nrow = foo;
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  LatticeComplex cf;
+  gaussian(cf);
+
+#if BASE_PRECISION == 32
+  const Double tol = 1.0e-5;
+#else
+  const Double tol = 1.0e-12;
+#endif
+
+  bool passP = true;
+
+  SftMomParams_t p;
+  p.mom2_max  = 3;
+  p.decay_dir = Nd-1;
+  p.mom_offset.resize(Nd);
+  p.mom_offset = 0;
+  p.origin_offset.resize(Nd);
+  p.origin_offset = 0;
+
+  // About the origin
+  p.avg_equiv_mom = false;
+  passP &= checkParams(p, cf, tol);
+
+  // Shifted origin
+  p.origin_offset[0] = 1;
+  p.origin_offset[1] = 3;
+  p.origin_offset[2] = 2;
+  p.origin_offset[3] = 5;
+  passP &= checkParams(p, cf, tol);
+
+  // Shifted origin, averaged momenta
+  p.avg_equiv_mom = true;
+  passP &= checkParams(p, cf, tol);
+
+  // And a momentum offset
+  p.avg_equiv_mom = false;
+  p.mom_offset[0] = 1;
+  passP &= checkParams(p, cf, tol);
+
+  QDPIO::cout << (passP ? "PASSED" : "FAILED") << std::endl;
+
+  END_CODE();
+
+  Chroma::finalize();
+  return passP ? 0 : 1;
+}